@@ -1,5 +1,7 @@
 ﻿#include "TREE.h"
 #include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -26,14 +28,30 @@
 #include <linux/input.h>
 #include <linux/limits.h>
 #include <poll.h>
+#include <pthread.h>
 #include <signal.h>
+#include <stdio_ext.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
 #include <sys/time.h>
+#include <sys/timerfd.h>
 #include <sys/types.h>
 #include <termios.h>
 #include <unistd.h>
 #endif // TREE_LINUX
 
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TREE_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif // TREE_X86
+
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define CLAMP(a, min, max) ((a) < (min) ? (min) : ((a) > (max) ? (max) : (a)))
@@ -75,10 +93,16 @@ TREE_Char const *TREE_Result_ToString(TREE_Result code)
 		return "Memory allocation failed";
 	case TREE_ERROR_PRESENTATION:
 		return "Presentation failed";
+	case TREE_ERROR_PRESENTATION_THREAD:
+		return "Failed to start presentation thread";
 	case TREE_ERROR_FILE_OPEN:
 		return "Failed to open file";
 	case TREE_ERROR_FILE_DELETE:
 		return "Failed to delete file";
+	case TREE_ERROR_FILE_READ:
+		return "Failed to read file";
+	case TREE_ERROR_FILE_WRITE:
+		return "Failed to write file";
 	case TREE_ERROR_DIRECTORY_CREATE:
 		return "Failed to create directory";
 	case TREE_ERROR_DIRECTORY_DELETE:
@@ -116,6 +140,10 @@ TREE_Char const *TREE_Result_ToString(TREE_Result code)
 		return "Failed to get console cursor info";
 	case TREE_ERROR_WINDOWS_CONSOLE_SET_CURSOR_INFO:
 		return "Failed to set console cursor info";
+	case TREE_ERROR_WINDOWS_EVENT_INIT:
+		return "Failed to initialize event loop";
+	case TREE_ERROR_WINDOWS_EVENT_WAIT:
+		return "Failed to wait for events";
 
 	case TREE_ERROR_LINUX_CLIPBOARD_OPEN:
 		return "Failed to open clipboard";
@@ -133,6 +161,12 @@ TREE_Char const *TREE_Result_ToString(TREE_Result code)
 		return "Failed to read from keyboard device";
 	case TREE_ERROR_LINUX_KEYBOARD_POLL:
 		return "Failed to poll keyboard device";
+	case TREE_ERROR_LINUX_EVENT_INIT:
+		return "Failed to initialize event loop";
+	case TREE_ERROR_LINUX_EVENT_WAIT:
+		return "Failed to wait for events";
+	case TREE_ERROR_LINUX_TERMINAL_READ:
+		return "Failed to read from terminal";
 
 	default:
 		return "Unknown error";
@@ -166,6 +200,29 @@ TREE_Time TREE_Time_Now()
 #endif
 }
 
+TREE_Microseconds TREE_Time_NowMicroseconds()
+{
+#ifdef TREE_WINDOWS
+	LARGE_INTEGER frequency, counter;
+	if (!QueryPerformanceFrequency(&frequency) || !QueryPerformanceCounter(&counter))
+	{
+		return 0;
+	}
+
+	// split the conversion, so that the multiplication does not overflow
+	return (TREE_Microseconds)(counter.QuadPart / frequency.QuadPart * 1000000 + counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#elif defined(TREE_LINUX)
+	struct timespec ts;
+	if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+	{
+		return 0;
+	}
+	return (TREE_Microseconds)ts.tv_sec * 1000000 + (TREE_Microseconds)ts.tv_nsec / 1000;
+#else
+	return 0;
+#endif
+}
+
 #ifdef TREE_WINDOWS
 
 BOOL WINAPI _ConsoleCtrlHandler(DWORD dwCtrlType)
@@ -186,7 +243,108 @@ BOOL WINAPI _ConsoleCtrlHandler(DWORD dwCtrlType)
 #elif defined(TREE_LINUX)
 
 static struct termios g_originalTermios;
-static TREE_Char *g_keyboardDevicePath = NULL;
+// the most keyboards read at once
+#define KEYBOARD_CAPACITY 16
+
+typedef struct _TREE_Keyboard
+{
+	// the open device, or -1 while closed
+	int device;
+
+	// the name of the device in /dev/input, such as event3
+	TREE_Char name[NAME_MAX + 1];
+} _TREE_Keyboard;
+
+// the keyboards in use, kept after TREE_Free so the next TREE_Init does not have to search again
+static _TREE_Keyboard g_keyboards[KEYBOARD_CAPACITY];
+static TREE_Size g_keyboardCount = 0;
+
+// all of the keyboards, and the watch for keyboards being plugged in or out, waited on and read as one
+static int g_keyboardEvents = -1;
+static int g_keyboardWatch = -1;
+
+// the bytes of an escape sequence that was cut off by the end of a read
+static TREE_Char g_terminalInput[64];
+static TREE_Size g_terminalInputSize = 0;
+
+// the keys that the terminal reported as typed, without a release to follow
+static TREE_Key g_terminalTyped[TREE_KEY_COUNT];
+static TREE_Size g_terminalTypedCount = 0;
+
+// set when the terminal reports key releases, using the kitty keyboard protocol
+static TREE_Bool g_terminalKeyEvents = TREE_FALSE;
+
+// the text of a bracketed paste, while the terminal sends it
+static TREE_Char *g_terminalPaste = NULL;
+static TREE_Size g_terminalPasteSize = 0;
+static TREE_Size g_terminalPasteCapacity = 0;
+static TREE_Bool g_terminalPasting = TREE_FALSE;
+
+// set when the terminal was resized, so the cached extent has to be queried again
+static volatile sig_atomic_t g_windowExtentStale = 1;
+
+// the wakeup of the running main loop, for signals caught by threads that do not block them
+static volatile sig_atomic_t g_eventLoopWake = -1;
+
+TREE_Bool _TREE_HasDeviceAttributes(TREE_Char const *reply)
+{
+	// the primary device attributes reply: ESC [ ? digits and semicolons c
+	for (TREE_Char const *sequence = strstr(reply, "\033[?"); sequence; sequence = strstr(sequence + 1, "\033[?"))
+	{
+		TREE_Char const *end = sequence + 3;
+		while (isdigit((unsigned char)*end) || *end == ';')
+		{
+			++end;
+		}
+		if (*end == 'c')
+		{
+			return TREE_TRUE;
+		}
+	}
+	return TREE_FALSE;
+}
+
+TREE_Bool _TREE_QuerySynchronizedOutput()
+{
+	// only a terminal can answer
+	if (!isatty(STDIN_FILENO) || !isatty(STDOUT_FILENO))
+	{
+		return TREE_FALSE;
+	}
+
+	// ask for the state of mode 2026 (DECRQM), then for the device attributes (DA1), which every terminal answers
+	static TREE_Char const query[] = "\033[?2026$p\033[c";
+	if (write(STDOUT_FILENO, query, sizeof(query) - 1) != (ssize_t)(sizeof(query) - 1))
+	{
+		return TREE_FALSE;
+	}
+
+	// read until the device attributes arrive, or the terminal stops answering
+	TREE_Char reply[256];
+	TREE_Size size = 0;
+	reply[0] = '\0';
+	while (size < sizeof(reply) - 1 && !_TREE_HasDeviceAttributes(reply))
+	{
+		struct pollfd pfd;
+		pfd.fd = STDIN_FILENO;
+		pfd.events = POLLIN;
+		if (poll(&pfd, 1, 200) <= 0)
+		{
+			break;
+		}
+		ssize_t count = read(STDIN_FILENO, &reply[size], sizeof(reply) - 1 - size);
+		if (count <= 0)
+		{
+			break;
+		}
+		size += (TREE_Size)count;
+		reply[size] = '\0';
+	}
+
+	// the mode is supported if it is set (1) or reset (2): ESC [ ? 2026 ; state $ y
+	TREE_Char const *mode = strstr(reply, "\033[?2026;");
+	return mode && (mode[8] == '1' || mode[8] == '2') && mode[9] == '$';
+}
 
 void _TREE_HandleSignal(int signal)
 {
@@ -198,71 +356,395 @@ void _TREE_HandleSignal(int signal)
 		// Handle the signal gracefully
 		TREE_Free();
 		break;
+	case SIGWINCH:
+		g_windowExtentStale = 1;
+		if (g_eventLoopWake >= 0)
+		{
+			uint64_t value = 1;
+			ssize_t count = write(g_eventLoopWake, &value, sizeof(value));
+			(void)count;
+		}
+		break;
 	default:
 		break;
 	}
 }
 
-TREE_Char *_TREE_FindKeyboard()
+TREE_Bool _TREE_IsKeyboard(int device)
+{
+	// a keyboard has keys for letters, space and enter, which mice, buttons and controllers do not
+	unsigned char keyBits[KEY_MAX / 8 + 1];
+	memset(keyBits, 0, sizeof(keyBits));
+	if (ioctl(device, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0)
+	{
+		return TREE_FALSE;
+	}
+	static int const keys[] = {KEY_A, KEY_Z, KEY_SPACE, KEY_ENTER};
+	for (TREE_Size i = 0; i < sizeof(keys) / sizeof(keys[0]); ++i)
+	{
+		if (!((keyBits[keys[i] / 8] >> (keys[i] % 8)) & 1))
+		{
+			return TREE_FALSE;
+		}
+	}
+	return TREE_TRUE;
+}
+
+TREE_Result _TREE_AddKeyboard(TREE_Char const *name)
+{
+	// only event devices, once each
+	if (strncmp(name, "event", 5) != 0 || strlen(name) > NAME_MAX)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+	for (TREE_Size i = 0; i < g_keyboardCount; ++i)
+	{
+		if (g_keyboards[i].device >= 0 && !strcmp(g_keyboards[i].name, name))
+		{
+			return TREE_OK;
+		}
+	}
+	if (g_keyboardCount >= KEYBOARD_CAPACITY)
+	{
+		return TREE_ERROR_FULL;
+	}
+
+	TREE_Char path[PATH_MAX];
+	snprintf(path, sizeof(path), "/dev/input/%s", name);
+	int device = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (device < 0)
+	{
+		return TREE_ERROR_LINUX_KEYBOARD_OPEN;
+	}
+	if (!_TREE_IsKeyboard(device))
+	{
+		close(device);
+		return TREE_ERROR_LINUX_KEYBOARD_NOT_FOUND;
+	}
+
+	// time the events on the same clock as TREE_Time_NowMicroseconds, if the kernel can not, they are timed when read
+	int clock = CLOCK_MONOTONIC;
+	ioctl(device, EVIOCSCLOCKID, &clock);
+
+	// read it along with the others
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.fd = device;
+	if (epoll_ctl(g_keyboardEvents, EPOLL_CTL_ADD, device, &event) < 0)
+	{
+		close(device);
+		return TREE_ERROR_LINUX_KEYBOARD_OPEN;
+	}
+	_TREE_Keyboard *keyboard = &g_keyboards[g_keyboardCount++];
+	keyboard->device = device;
+	strcpy(keyboard->name, name);
+
+	return TREE_OK;
+}
+
+void _TREE_RemoveKeyboard(TREE_Size index)
+{
+	// closing the device also takes it out of the epoll
+	if (g_keyboards[index].device >= 0)
+	{
+		close(g_keyboards[index].device);
+	}
+	g_keyboards[index] = g_keyboards[--g_keyboardCount];
+}
+
+TREE_Result _TREE_FindKeyboards()
 {
-	// open the /dev/input directory
+	// try the keyboards found last time first
+	TREE_Size cachedCount = g_keyboardCount;
+	_TREE_Keyboard cached[KEYBOARD_CAPACITY];
+	memcpy(cached, g_keyboards, cachedCount * sizeof(_TREE_Keyboard));
+	g_keyboardCount = 0;
+	for (TREE_Size i = 0; i < cachedCount; ++i)
+	{
+		_TREE_AddKeyboard(cached[i].name);
+	}
+	if (g_keyboardCount)
+	{
+		return TREE_OK;
+	}
+
+	// udev links each keyboard in by-id and by-path, which finds them without opening every device
+	TREE_Result result = TREE_ERROR_LINUX_KEYBOARD_NOT_FOUND;
+	static TREE_Char const *const linkDirectories[] = {"/dev/input/by-id", "/dev/input/by-path"};
+	static TREE_Char const linkSuffix[] = "-event-kbd";
+	TREE_Size const linkSuffixLength = sizeof(linkSuffix) - 1;
+	for (TREE_Size i = 0; i < sizeof(linkDirectories) / sizeof(linkDirectories[0]); ++i)
+	{
+		DIR *dir = opendir(linkDirectories[i]);
+		if (!dir)
+		{
+			continue;
+		}
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != NULL)
+		{
+			TREE_Size nameLength = strlen(entry->d_name);
+			if (nameLength < linkSuffixLength || strcmp(&entry->d_name[nameLength - linkSuffixLength], linkSuffix) != 0)
+			{
+				continue;
+			}
+
+			// the link points to ../eventN
+			TREE_Char path[PATH_MAX];
+			TREE_Char target[PATH_MAX];
+			snprintf(path, sizeof(path), "%s/%s", linkDirectories[i], entry->d_name);
+			ssize_t targetLength = readlink(path, target, sizeof(target) - 1);
+			if (targetLength <= 0)
+			{
+				continue;
+			}
+			target[targetLength] = '\0';
+			TREE_Char const *name = strrchr(target, '/');
+			name = name ? name + 1 : target;
+			TREE_Result added = _TREE_AddKeyboard(name);
+			if (added == TREE_OK || added == TREE_ERROR_LINUX_KEYBOARD_OPEN)
+			{
+				result = added;
+			}
+		}
+		closedir(dir);
+	}
+	if (g_keyboardCount)
+	{
+		return TREE_OK;
+	}
+
+	// without udev, check what keys each device has
 	DIR *dir = opendir("/dev/input");
 	if (!dir)
 	{
-		return NULL;
+		return result;
 	}
-
-	static char devicePath[PATH_MAX];
 	struct dirent *entry;
 	while ((entry = readdir(dir)) != NULL)
 	{
-		if (strncmp(entry->d_name, "event", 5) != 0)
+		TREE_Result added = _TREE_AddKeyboard(entry->d_name);
+		if (added == TREE_ERROR_LINUX_KEYBOARD_OPEN && errno == EACCES)
 		{
-			continue;
+			result = added;
 		}
+	}
+	closedir(dir);
+
+	return g_keyboardCount ? TREE_OK : result;
+}
 
-		snprintf(devicePath, sizeof(devicePath), "/dev/input/%s", entry->d_name);
-		int fd = open(devicePath, O_RDONLY | O_NONBLOCK);
-		if (fd < 0)
+void _TREE_CloseKeyboards()
+{
+	// keep the names, to try them first next time
+	for (TREE_Size i = 0; i < g_keyboardCount; ++i)
+	{
+		if (g_keyboards[i].device >= 0)
 		{
-			continue; // skip if we can't open the device
+			close(g_keyboards[i].device);
+			g_keyboards[i].device = -1;
 		}
+	}
+	if (g_keyboardWatch >= 0)
+	{
+		close(g_keyboardWatch);
+		g_keyboardWatch = -1;
+	}
+	if (g_keyboardEvents >= 0)
+	{
+		close(g_keyboardEvents);
+		g_keyboardEvents = -1;
+	}
+}
+
+TREE_Result _TREE_OpenKeyboards()
+{
+	// one epoll for every keyboard, so they can be waited on and read as one
+	g_keyboardEvents = epoll_create1(EPOLL_CLOEXEC);
+	if (g_keyboardEvents < 0)
+	{
+		return TREE_ERROR_LINUX_INPUT_INIT;
+	}
 
-		char name[256] = "Unknown";
-		if (ioctl(fd, EVIOCGNAME(sizeof(name)), name) >= 0)
+	// watch for keyboards being plugged in or out, and for new devices being given permissions after they appear
+	g_keyboardWatch = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (g_keyboardWatch >= 0)
+	{
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = g_keyboardWatch;
+		if (inotify_add_watch(g_keyboardWatch, "/dev/input", IN_CREATE | IN_ATTRIB | IN_DELETE) < 0 ||
+			epoll_ctl(g_keyboardEvents, EPOLL_CTL_ADD, g_keyboardWatch, &event) < 0)
 		{
-			if (strstr(name, "keyboard") || strstr(name, "Keyboard"))
-			{
-				close(fd);
-				closedir(dir);
+			close(g_keyboardWatch);
+			g_keyboardWatch = -1;
+		}
+	}
 
-				// found the keyboard
-				TREE_Char *output = TREE_NEW_ARRAY(TREE_Char, strlen(devicePath) + 1);
-				if (!output)
-				{
-					return NULL;
-				}
+	TREE_Result result = _TREE_FindKeyboards();
+	if (result)
+	{
+		_TREE_CloseKeyboards();
+	}
+	return result;
+}
+
+#endif
 
-				TREE_Size devicePathLength = strlen(devicePath);
-				memcpy(output, devicePath, devicePathLength);
-				output[devicePathLength] = '\0';
+TREE_Size _TREE_FindDifference_Scalar(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end)
+{
+	TREE_Size i = start;
 
-				return output;
-			}
+	// compare eight cells at a time, then find the exact cell
+	for (; i + sizeof(unsigned long long) <= end; i += sizeof(unsigned long long))
+	{
+		unsigned long long a, b, c, d;
+		memcpy(&a, &text[i], sizeof(a));
+		memcpy(&b, &otherText[i], sizeof(b));
+		memcpy(&c, &colors[i], sizeof(c));
+		memcpy(&d, &otherColors[i], sizeof(d));
+		if ((a ^ b) | (c ^ d))
+		{
+			break;
+		}
+	}
+	for (; i < end; ++i)
+	{
+		if (text[i] != otherText[i] || colors[i] != otherColors[i])
+		{
+			return i;
+		}
+	}
+	return end;
+}
+
+#ifdef TREE_X86
+
+#if defined(__GNUC__) || defined(__clang__)
+#define _TREE_TARGET_SSE2 __attribute__((target("sse2")))
+#define _TREE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define _TREE_TARGET_SSE2
+#define _TREE_TARGET_AVX2
+#endif
+
+TREE_UInt _TREE_CountTrailingZeros(TREE_UInt value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return (TREE_UInt)index;
+#else
+	return (TREE_UInt)__builtin_ctz(value);
+#endif
+}
+
+_TREE_TARGET_SSE2 TREE_Size _TREE_FindDifference_SSE2(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end)
+{
+	TREE_Size i = start;
+
+	// compare 16 cells of both planes at a time
+	for (; i + 16 <= end; i += 16)
+	{
+		__m128i textEqual = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)&text[i]), _mm_loadu_si128((__m128i const *)&otherText[i]));
+		__m128i colorsEqual = _mm_cmpeq_epi8(_mm_loadu_si128((__m128i const *)&colors[i]), _mm_loadu_si128((__m128i const *)&otherColors[i]));
+		TREE_UInt mask = (TREE_UInt)_mm_movemask_epi8(_mm_and_si128(textEqual, colorsEqual)) ^ 0xFFFFu;
+		if (mask)
+		{
+			return i + _TREE_CountTrailingZeros(mask);
 		}
+	}
+	return _TREE_FindDifference_Scalar(text, otherText, colors, otherColors, i, end);
+}
+
+_TREE_TARGET_AVX2 TREE_Size _TREE_FindDifference_AVX2(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end)
+{
+	TREE_Size i = start;
 
-		// this file was not a keyboard
-		close(fd);
+	// compare 32 cells of both planes at a time
+	for (; i + 32 <= end; i += 32)
+	{
+		__m256i textEqual = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const *)&text[i]), _mm256_loadu_si256((__m256i const *)&otherText[i]));
+		__m256i colorsEqual = _mm256_cmpeq_epi8(_mm256_loadu_si256((__m256i const *)&colors[i]), _mm256_loadu_si256((__m256i const *)&otherColors[i]));
+		TREE_UInt mask = ~(TREE_UInt)_mm256_movemask_epi8(_mm256_and_si256(textEqual, colorsEqual));
+		if (mask)
+		{
+			return i + _TREE_CountTrailingZeros(mask);
+		}
 	}
+	return _TREE_FindDifference_SSE2(text, otherText, colors, otherColors, i, end);
+}
 
-	closedir(dir);
-	printf("No keyboard found. Try running with sudo.\n");
-	return NULL;
+TREE_Bool _TREE_SupportsSSE2(void)
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	return (info[3] & (1 << 26)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("sse2") != 0;
+#endif
 }
 
+TREE_Bool _TREE_SupportsAVX2(void)
+{
+#if defined(_MSC_VER)
+	// the CPU has to support AVX and AVX2, and the OS has to save the YMM registers
+	int info[4];
+	__cpuid(info, 1);
+	if (!(info[2] & (1 << 27)) || !(info[2] & (1 << 28)) || (_xgetbv(0) & 6) != 6)
+	{
+		return TREE_FALSE;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
 #endif
+}
+
+#endif // TREE_X86
+
+typedef TREE_Size (*_TREE_FindDifferenceFunction)(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end);
+
+TREE_Size _TREE_FindDifference_Dispatch(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end);
+
+// resolved to the widest supported kernel by TREE_Init, or on the first call if it was not called,
+// and always before the presenter thread starts, so that thread only ever reads it
+static _TREE_FindDifferenceFunction g_findDifference = _TREE_FindDifference_Dispatch;
+
+void _TREE_FindDifference_Resolve(void)
+{
+	if (g_findDifference != _TREE_FindDifference_Dispatch)
+	{
+		return;
+	}
+	_TREE_FindDifferenceFunction function = _TREE_FindDifference_Scalar;
+#ifdef TREE_X86
+	if (_TREE_SupportsAVX2())
+	{
+		function = _TREE_FindDifference_AVX2;
+	}
+	else if (_TREE_SupportsSSE2())
+	{
+		function = _TREE_FindDifference_SSE2;
+	}
+#endif // TREE_X86
+	g_findDifference = function;
+}
+
+TREE_Size _TREE_FindDifference_Dispatch(TREE_Char const *text, TREE_Char const *otherText, TREE_ColorPair const *colors, TREE_ColorPair const *otherColors, TREE_Size start, TREE_Size end)
+{
+	_TREE_FindDifference_Resolve();
+	return g_findDifference(text, otherText, colors, otherColors, start, end);
+}
 
 static TREE_Bool g_treeInitialized = TREE_FALSE;
+static TREE_Bool g_synchronizedOutput = TREE_FALSE;
+static TREE_Bool g_nonBlockingOutput = TREE_FALSE;
+static TREE_InputBackend g_inputBackend = TREE_INPUT_BACKEND_AUTOMATIC;
 
 TREE_Result TREE_Init()
 {
@@ -273,13 +755,42 @@ TREE_Result TREE_Init()
 
 	TREE_Result result;
 
+	// pick the widest difference kernel now, before any thread can use it
+	_TREE_FindDifference_Resolve();
+
 #ifdef TREE_WINDOWS
 	// handle CTRL +C, etc.
 	if (!SetConsoleCtrlHandler(_ConsoleCtrlHandler, TRUE))
 	{
 		return TREE_ERROR_WINDOWS_SET_CONTROL_HANDLER;
 	}
+
+	// the console ignores private modes it does not know, so synchronized output is always safe to use
+	g_synchronizedOutput = TREE_TRUE;
+
+	// keys are read from the keyboard state
+	g_inputBackend = TREE_INPUT_BACKEND_KEYBOARD;
 #elif defined(TREE_LINUX)
+	// find keyboard to use, unless it would be the keyboard of a different machine
+	if (g_inputBackend == TREE_INPUT_BACKEND_KEYBOARD ||
+		(g_inputBackend == TREE_INPUT_BACKEND_AUTOMATIC && !getenv("SSH_CONNECTION") && !getenv("SSH_TTY")))
+	{
+		// keep the keyboards open, so they can be waited on
+		result = _TREE_OpenKeyboards();
+		if (!result)
+		{
+			g_inputBackend = TREE_INPUT_BACKEND_KEYBOARD;
+		}
+		else if (g_inputBackend == TREE_INPUT_BACKEND_KEYBOARD)
+		{
+			return result;
+		}
+	}
+	if (g_inputBackend != TREE_INPUT_BACKEND_KEYBOARD)
+	{
+		// read the keys from the terminal instead
+		g_inputBackend = TREE_INPUT_BACKEND_TERMINAL;
+	}
 	{
 		struct termios newTermios;
 
@@ -292,22 +803,40 @@ TREE_Result TREE_Init()
 		// disable echoing and canonical mode
 		newTermios.c_lflag &= ~(ECHO | ICANON);
 
+		// pass every key through as soon as it is typed, including CTRL+S, CTRL+Q and enter
+		if (g_inputBackend == TREE_INPUT_BACKEND_TERMINAL)
+		{
+			newTermios.c_iflag &= ~(IXON | ICRNL);
+			newTermios.c_cc[VMIN] = 0;
+			newTermios.c_cc[VTIME] = 0;
+		}
+
 		// set the new terminal attributes
 		if (tcsetattr(STDIN_FILENO, TCSANOW, &newTermios) < 0)
 		{
 			return TREE_ERROR_LINUX_CONSOLE_INIT;
 		}
 	}
-	// find keyboard to use
-	g_keyboardDevicePath = _TREE_FindKeyboard();
-	if (!g_keyboardDevicePath)
+	// ask the terminal if it can hold back partial frames
+	g_synchronizedOutput = _TREE_QuerySynchronizedOutput();
+	if (g_inputBackend == TREE_INPUT_BACKEND_TERMINAL)
 	{
-		return TREE_ERROR_LINUX_KEYBOARD_NOT_FOUND;
+		// ask for key releases with the kitty keyboard protocol, the reply to the query says if they were turned on,
+		// and for pastes to be marked, so they are not typed out key by key
+		g_terminalInputSize = 0;
+		g_terminalKeyEvents = TREE_FALSE;
+		g_terminalTypedCount = 0;
+		g_terminalPasting = TREE_FALSE;
+		printf("\033[>11u\033[?u\033[?2004h");
+		fflush(stdout);
 	}
 	// handle signals
 	signal(SIGINT, _TREE_HandleSignal);
 	signal(SIGTERM, _TREE_HandleSignal);
 	signal(SIGHUP, _TREE_HandleSignal);
+	signal(SIGWINCH, _TREE_HandleSignal);
+	// anything cached so far was not watched for resizes
+	g_windowExtentStale = 1;
 #endif
 
 	// hide cursor
@@ -329,6 +858,9 @@ void TREE_Free()
 	}
 	g_treeInitialized = TREE_FALSE;
 
+	// the shell expects blocking output
+	TREE_Window_SetNonBlocking(TREE_FALSE);
+
 	// show cursor
 	TREE_Cursor_SetVisible(TREE_TRUE);
 
@@ -336,9 +868,18 @@ void TREE_Free()
 	// Clear pending key presses so they do not leak to the shell.
 	FlushConsoleInputBuffer(GetStdHandle(STD_INPUT_HANDLE));
 #elif defined(TREE_LINUX)
-	// free keyboard device path
-	free(g_keyboardDevicePath);
-	g_keyboardDevicePath = NULL;
+	// close the keyboards
+	_TREE_CloseKeyboards();
+
+	// put the terminal back to reporting keys and pastes as text
+	if (g_inputBackend == TREE_INPUT_BACKEND_TERMINAL)
+	{
+		printf("\033[<u\033[?2004l");
+		fflush(stdout);
+	}
+	TREE_DELETE(g_terminalPaste);
+	g_terminalPasteSize = 0;
+	g_terminalPasteCapacity = 0;
 
 	// Clear pending key presses so they do not leak to the shell.
 	tcflush(STDIN_FILENO, TCIFLUSH);
@@ -346,6 +887,9 @@ void TREE_Free()
 	// restore original terminal attributes
 	tcsetattr(STDIN_FILENO, TCSANOW, &g_originalTermios);
 #endif
+
+	// the backend is picked again by the next TREE_Init
+	g_inputBackend = TREE_INPUT_BACKEND_AUTOMATIC;
 }
 
 TREE_Result TREE_String_CreateCopy(TREE_Char **dest, TREE_String src)
@@ -1285,6 +1829,15 @@ TREE_Rect TREE_Rect_GetIntersection(TREE_Rect const *rectA, TREE_Rect const *rec
 	return result;
 }
 
+// checks if the inner Rect is entirely within the outer Rect
+TREE_Bool _TREE_Rect_IsWithin(TREE_Rect const *outer, TREE_Rect const *inner)
+{
+	return inner->offset.x >= outer->offset.x &&
+		   inner->offset.y >= outer->offset.y &&
+		   inner->offset.x + (TREE_Int)inner->extent.width <= outer->offset.x + (TREE_Int)outer->extent.width &&
+		   inner->offset.y + (TREE_Int)inner->extent.height <= outer->offset.y + (TREE_Int)outer->extent.height;
+}
+
 TREE_Pixel TREE_Pixel_Create(TREE_Char character, TREE_Color foreground, TREE_Color background)
 {
 	TREE_Pixel pixel;
@@ -1500,6 +2053,7 @@ TREE_Result TREE_Image_Init(TREE_Image *image, TREE_Extent extent)
 		image->colors = NULL;
 		image->extent.width = 0;
 		image->extent.height = 0;
+		image->capacity = 0;
 
 		return TREE_OK;
 	}
@@ -1528,6 +2082,7 @@ TREE_Result TREE_Image_Init(TREE_Image *image, TREE_Extent extent)
 	image->text[imageSize] = '\0'; // null terminator
 	memset(image->colors, TREE_ColorPair_CreateDefault(), colorSize);
 	image->extent = extent;
+	image->capacity = imageSize;
 
 	return TREE_OK;
 }
@@ -1543,6 +2098,7 @@ void TREE_Image_Free(TREE_Image *image)
 	// free data
 	TREE_DELETE(image->text);
 	TREE_DELETE(image->colors);
+	image->capacity = 0;
 }
 
 TREE_Result TREE_Image_Set(TREE_Image *image, TREE_Offset offset, TREE_Pixel pixel)
@@ -1605,13 +2161,63 @@ TREE_Result TREE_Image_Resize(TREE_Image *image, TREE_Extent extent)
 		return TREE_OK;
 	}
 
-	TREE_Image_Free(image);
-	TREE_Result result = TREE_Image_Init(image, extent);
-	if (result)
+	// an empty Image keeps its memory, for when it grows again
+	if (extent.width <= 0 || extent.height <= 0)
 	{
-		return result;
-	}
-
+		image->extent.width = 0;
+		image->extent.height = 0;
+		if (image->text)
+		{
+			image->text[0] = '\0';
+		}
+		return TREE_OK;
+	}
+
+	TREE_Extent oldExtent = image->extent;
+	TREE_Size size = (TREE_Size)extent.width * (TREE_Size)extent.height;
+
+	// only grow the memory past the capacity, the old pixels stay at the start
+	if (size > image->capacity)
+	{
+		TREE_Char *text = (TREE_Char *)realloc(image->text, (size + 1) * sizeof(TREE_Char)); // +1 for null terminator
+		if (!text)
+		{
+			return TREE_ERROR_ALLOC;
+		}
+		image->text = text;
+		TREE_ColorPair *colors = (TREE_ColorPair *)realloc(image->colors, size * sizeof(TREE_ColorPair));
+		if (!colors)
+		{
+			return TREE_ERROR_ALLOC;
+		}
+		image->colors = colors;
+		image->capacity = size;
+	}
+
+	// move the overlapping rows into place, in the order that does not overwrite the rows still to be moved
+	TREE_Size copyWidth = (TREE_Size)MIN(oldExtent.width, extent.width);
+	TREE_Size copyHeight = (TREE_Size)MIN(oldExtent.height, extent.height);
+	TREE_Size oldWidth = (TREE_Size)oldExtent.width;
+	TREE_Size newWidth = (TREE_Size)extent.width;
+	for (TREE_Size i = 0; i < copyHeight; ++i)
+	{
+		TREE_Size y = newWidth <= oldWidth ? i : copyHeight - 1 - i;
+		memmove(&image->text[y * newWidth], &image->text[y * oldWidth], copyWidth * sizeof(TREE_Char));
+		memmove(&image->colors[y * newWidth], &image->colors[y * oldWidth], copyWidth * sizeof(TREE_ColorPair));
+	}
+
+	// blank the new pixels
+	TREE_ColorPair color = TREE_ColorPair_CreateDefault();
+	for (TREE_Size y = 0; y < copyHeight && copyWidth < newWidth; ++y)
+	{
+		memset(&image->text[y * newWidth + copyWidth], ' ', (newWidth - copyWidth) * sizeof(TREE_Char));
+		memset(&image->colors[y * newWidth + copyWidth], color, (newWidth - copyWidth) * sizeof(TREE_ColorPair));
+	}
+	memset(&image->text[copyHeight * newWidth], ' ', (size - copyHeight * newWidth) * sizeof(TREE_Char));
+	memset(&image->colors[copyHeight * newWidth], color, (size - copyHeight * newWidth) * sizeof(TREE_ColorPair));
+	image->text[size] = '\0';
+	image->extent = extent;
+
 	return TREE_OK;
 }
 
@@ -1623,78 +2229,331 @@ TREE_Result TREE_Image_DrawImage(TREE_Image *image, TREE_Offset offset, TREE_Ima
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// ignore if out of bounds
-	if (offset.x + extent.width <= 0 || offset.y + extent.height <= 0 ||
-		offset.x >= (TREE_Int)image->extent.width ||
-		offset.y >= (TREE_Int)image->extent.height)
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_DrawImage(&view, offset, other, otherOffset, extent);
+}
+
+TREE_Result TREE_Image_DrawString(TREE_Image *image, TREE_Offset offset, TREE_String string, TREE_ColorPair colorPair)
+{
+	if (!image || !string)
 	{
-		return TREE_OK;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	// calculate sizes
-	TREE_Int otherOffsetX = offset.x < -otherOffset.x ? otherOffset.x - offset.x : otherOffset.x;
-	TREE_Int otherOffsetY = offset.y < -otherOffset.y ? otherOffset.y - offset.y : otherOffset.y;
-	TREE_Int offsetX = offset.x < 0 ? 0 : offset.x;
-	TREE_Int offsetY = offset.y < 0 ? 0 : offset.y;
-	TREE_Int width = MIN(extent.width, image->extent.width - offsetX);
-	TREE_Int height = MIN(extent.height, image->extent.height - offsetY);
-	TREE_Size textCopySize = width * sizeof(TREE_Char);
-	TREE_Size colorCopySize = width * sizeof(TREE_ColorPair);
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_DrawString(&view, offset, string, colorPair);
+}
+
+TREE_Result TREE_Image_DrawLine(TREE_Image *image, TREE_Offset start, TREE_Offset end, TREE_Pattern const *pattern)
+{
+	// validate
+	if (!image || !pattern)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_DrawLine(&view, start, end, pattern);
+}
+
+TREE_Result TREE_Image_DrawRect(TREE_Image *image, TREE_Rect const *rect, TREE_Pattern const *pattern)
+{
+	// validate
+	if (!image || !rect || !pattern)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_DrawRect(&view, rect, pattern);
+}
+
+TREE_Result TREE_Image_FillRect(TREE_Image *image, TREE_Rect const *rect, TREE_Pixel pixel)
+{
+	// validate
+	if (!image || !rect)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-	// draw the image
-	TREE_UInt index, otherIndex;
-	for (TREE_Int row = 0; row < height; ++row)
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_FillRect(&view, rect, pixel);
+}
+
+TREE_Result TREE_Image_Clear(TREE_Image *image, TREE_Pixel pixel)
+{
+	// validate
+	if (!image)
 	{
-		// get indexes to "pixel"
-		index = (row + offsetY) * image->extent.width + offsetX;
-		otherIndex = (row + otherOffsetY) * extent.width + otherOffsetX;
+		return TREE_ERROR_ARG_NULL;
+	}
 
-		// copy data over from other
-		memcpy(&image->text[index], &other->text[otherIndex], textCopySize);
-		memcpy(&image->colors[index], &other->colors[otherIndex], colorCopySize);
+	TREE_ImageView view;
+	TREE_ImageView_Init(&view, image);
+	return TREE_ImageView_Clear(&view, pixel);
+}
+
+TREE_Result TREE_ImageView_Init(TREE_ImageView *view, TREE_Image *image)
+{
+	// validate
+	if (!view || !image)
+	{
+		return TREE_ERROR_ARG_NULL;
 	}
 
+	view->text = image->text;
+	view->colors = image->colors;
+	view->stride = (TREE_Size)image->extent.width;
+	view->offset = (TREE_Offset){0, 0};
+	view->extent = image->extent;
+	view->clip.offset = (TREE_Offset){0, 0};
+	view->clip.extent = image->extent;
+
 	return TREE_OK;
 }
 
-TREE_Result TREE_Image_DrawString(TREE_Image *image, TREE_Offset offset, TREE_String string, TREE_ColorPair colorPair)
+TREE_Result TREE_ImageView_InitSub(TREE_ImageView *view, TREE_ImageView const *other, TREE_Rect const *rect)
 {
-	if (!image || !string)
+	// validate
+	if (!view || !other || !rect)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	TREE_Size stringLength = strlen(string);
+	// the same Image, moved over
+	TREE_ImageView sub = *other;
+	sub.offset.x += rect->offset.x;
+	sub.offset.y += rect->offset.y;
+	sub.extent = rect->extent;
+	sub.clip.offset.x -= rect->offset.x;
+	sub.clip.offset.y -= rect->offset.y;
+	*view = sub;
 
-	// ignore if out of bounds
-	if (offset.x + stringLength <= 0 || offset.y < 0 ||
-		offset.x >= (TREE_Int)image->extent.width ||
-		offset.y >= (TREE_Int)image->extent.height)
+	// within both
+	TREE_Rect area = {{0, 0}, rect->extent};
+	return TREE_ImageView_Clip(view, &area);
+}
+
+TREE_Result TREE_ImageView_Clip(TREE_ImageView *view, TREE_Rect const *rect)
+{
+	// validate
+	if (!view || !rect)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	view->clip = TREE_Rect_GetIntersection(&view->clip, rect);
+	if (view->clip.extent.width <= 0 || view->clip.extent.height <= 0)
+	{
+		view->clip.extent.width = 0;
+		view->clip.extent.height = 0;
+	}
+
+	return TREE_OK;
+}
+
+static inline TREE_Size _TREE_ImageView_GetIndex(TREE_ImageView const *view, TREE_Int x, TREE_Int y)
+{
+	// the clip keeps it within the Image
+	return (TREE_Size)(view->offset.y + y) * view->stride + (TREE_Size)(view->offset.x + x);
+}
+
+TREE_Result TREE_ImageView_Set(TREE_ImageView *view, TREE_Offset offset, TREE_Pixel pixel)
+{
+	// validate
+	if (!view)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	TREE_Rect const *clip = &view->clip;
+	if (offset.x < clip->offset.x || offset.y < clip->offset.y ||
+		offset.x >= clip->offset.x + clip->extent.width ||
+		offset.y >= clip->offset.y + clip->extent.height)
+	{
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+
+	// set data
+	TREE_Size index = _TREE_ImageView_GetIndex(view, offset.x, offset.y);
+	view->text[index] = pixel.character;
+	view->colors[index] = pixel.colorPair;
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_ImageView_DrawImage(TREE_ImageView *view, TREE_Offset offset, TREE_Image const *other, TREE_Offset otherOffset, TREE_Extent extent)
+{
+	// validate
+	if (!view || !other)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// keep the source within the other Image
+	if (otherOffset.x < 0)
+	{
+		offset.x -= otherOffset.x;
+		extent.width += otherOffset.x;
+		otherOffset.x = 0;
+	}
+	if (otherOffset.y < 0)
+	{
+		offset.y -= otherOffset.y;
+		extent.height += otherOffset.y;
+		otherOffset.y = 0;
+	}
+	extent.width = MIN(extent.width, other->extent.width - otherOffset.x);
+	extent.height = MIN(extent.height, other->extent.height - otherOffset.y);
+
+	// and the destination within the clip
+	TREE_Rect const *clip = &view->clip;
+	TREE_Int startX = MAX(offset.x, clip->offset.x);
+	TREE_Int startY = MAX(offset.y, clip->offset.y);
+	TREE_Int endX = MIN(offset.x + extent.width, clip->offset.x + clip->extent.width);
+	TREE_Int endY = MIN(offset.y + extent.height, clip->offset.y + clip->extent.height);
+	if (startX >= endX || startY >= endY)
 	{
 		return TREE_OK;
 	}
+	TREE_Size width = (TREE_Size)(endX - startX);
 
-	// calculate sizes
-	TREE_UInt stringOffsetX = offset.x < 0 ? -offset.x : 0;
-	TREE_UInt offsetX = offset.x < 0 ? 0 : offset.x;
-	TREE_UInt width = MIN((TREE_UInt)stringLength, image->extent.width - offsetX);
+	// copy a row at a time, each Image with its own width
+	TREE_Size otherStride = (TREE_Size)other->extent.width;
+	TREE_Size otherIndex = (TREE_Size)(otherOffset.y + startY - offset.y) * otherStride + (TREE_Size)(otherOffset.x + startX - offset.x);
+	TREE_Size index = _TREE_ImageView_GetIndex(view, startX, startY);
+	for (TREE_Int y = startY; y < endY; ++y, index += view->stride, otherIndex += otherStride)
+	{
+		memcpy(&view->text[index], &other->text[otherIndex], width * sizeof(TREE_Char));
+		memcpy(&view->colors[index], &other->colors[otherIndex], width * sizeof(TREE_ColorPair));
+	}
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_ImageView_DrawString(TREE_ImageView *view, TREE_Offset offset, TREE_String string, TREE_ColorPair colorPair)
+{
+	if (!view || !string)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// ignore if out of bounds
+	TREE_Rect const *clip = &view->clip;
+	if (offset.y < clip->offset.y || offset.y >= clip->offset.y + clip->extent.height)
+	{
+		return TREE_OK;
+	}
+	TREE_Int stringLength = (TREE_Int)MIN(strlen(string), (TREE_Size)INT_MAX);
+	TREE_Int startX = MAX(offset.x, clip->offset.x);
+	TREE_Int endX = MIN(offset.x + stringLength, clip->offset.x + clip->extent.width);
+	if (startX >= endX)
+	{
+		return TREE_OK;
+	}
 
 	// draw the string
-	TREE_UInt index = offset.y * image->extent.width + offsetX;
-	TREE_UInt stringIndex = stringOffsetX;
-	memcpy(&image->text[index], &string[stringIndex], width * sizeof(TREE_Char));
-	memset(&image->colors[index], colorPair, width * sizeof(TREE_Byte));
+	TREE_Size index = _TREE_ImageView_GetIndex(view, startX, offset.y);
+	TREE_Size width = (TREE_Size)(endX - startX);
+	memcpy(&view->text[index], &string[startX - offset.x], width * sizeof(TREE_Char));
+	memset(&view->colors[index], colorPair, width * sizeof(TREE_ColorPair));
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Image_DrawLine(TREE_Image *image, TREE_Offset start, TREE_Offset end, TREE_Pattern const *pattern)
+void _TREE_ImageView_DrawPatternSpan(TREE_Char *text, TREE_ColorPair *colors, TREE_Size count, TREE_Pattern const *pattern, TREE_UInt patternIndex, TREE_Int step)
+{
+	// a pattern of one pixel is a plain fill
+	TREE_UInt size = pattern->size;
+	if (size == 1)
+	{
+		memset(text, pattern->pixels[0].character, count * sizeof(TREE_Char));
+		memset(colors, pattern->pixels[0].colorPair, count * sizeof(TREE_ColorPair));
+		return;
+	}
+
+	// lay out one repeat of the pattern, forwards or backwards
+	TREE_Size first = MIN(count, (TREE_Size)size);
+	for (TREE_Size i = 0; i < first; ++i)
+	{
+		TREE_Pixel const *pixel = &pattern->pixels[patternIndex];
+		text[i] = pixel->character;
+		colors[i] = pixel->colorPair;
+		patternIndex = step > 0 ? (patternIndex + 1 == size ? 0 : patternIndex + 1) : (patternIndex == 0 ? size - 1 : patternIndex - 1);
+	}
+
+	// then copy what is done so far, which is always whole repeats, doubling each time
+	for (TREE_Size done = first; done < count; done *= 2)
+	{
+		TREE_Size copy = MIN(done, count - done);
+		memcpy(&text[done], text, copy * sizeof(TREE_Char));
+		memcpy(&colors[done], colors, copy * sizeof(TREE_ColorPair));
+	}
+}
+
+TREE_Result TREE_ImageView_DrawLine(TREE_ImageView *view, TREE_Offset start, TREE_Offset end, TREE_Pattern const *pattern)
 {
 	// validate
-	if (!image || !pattern)
+	if (!view || !pattern)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
+	if (!pattern->size)
+	{
+		return TREE_OK;
+	}
+
+	TREE_Int clipX = view->clip.offset.x;
+	TREE_Int clipY = view->clip.offset.y;
+	TREE_Int clipEndX = clipX + view->clip.extent.width;
+	TREE_Int clipEndY = clipY + view->clip.extent.height;
+	TREE_UInt size = pattern->size;
+
+	// a row is drawn as one span, starting from the leftmost point that is within the clip
+	if (start.y == end.y)
+	{
+		TREE_Int startX = MAX(MIN(start.x, end.x), clipX);
+		TREE_Int endX = MIN(MAX(start.x, end.x), clipEndX - 1);
+		if (start.y < clipY || start.y >= clipEndY || startX > endX)
+		{
+			return TREE_OK;
+		}
+		TREE_Size index = _TREE_ImageView_GetIndex(view, startX, start.y);
+		TREE_UInt patternIndex = (TREE_UInt)(abs(startX - start.x) % size);
+		_TREE_ImageView_DrawPatternSpan(&view->text[index], &view->colors[index], (TREE_Size)(endX - startX + 1), pattern, patternIndex, start.x <= end.x ? 1 : -1);
+		return TREE_OK;
+	}
+
+	// a column steps a whole row at a time
+	if (start.x == end.x)
+	{
+		TREE_Int startY = MAX(MIN(start.y, end.y), clipY);
+		TREE_Int endY = MIN(MAX(start.y, end.y), clipEndY - 1);
+		if (start.x < clipX || start.x >= clipEndX || startY > endY)
+		{
+			return TREE_OK;
+		}
+		TREE_Int sy = start.y < end.y ? 1 : -1;
+		TREE_Int firstY = sy > 0 ? startY : endY;
+		TREE_Int lastY = sy > 0 ? endY : startY;
+		TREE_UInt patternIndex = (TREE_UInt)(abs(firstY - start.y) % size);
+		for (TREE_Int y = firstY;; y += sy)
+		{
+			TREE_Size index = _TREE_ImageView_GetIndex(view, start.x, y);
+			view->text[index] = pattern->pixels[patternIndex].character;
+			view->colors[index] = pattern->pixels[patternIndex].colorPair;
+			if (y == lastY)
+			{
+				break;
+			}
+			patternIndex = patternIndex + 1 == size ? 0 : patternIndex + 1;
+		}
+		return TREE_OK;
+	}
 
 	// calculate differences
 	TREE_Int dx = abs(end.x - start.x);
@@ -1704,22 +2563,20 @@ TREE_Result TREE_Image_DrawLine(TREE_Image *image, TREE_Offset start, TREE_Offse
 	TREE_Int err = dx - dy;
 
 	TREE_UInt patternIndex = 0;
-	TREE_Pixel pixel;
 
 	// draw the line
 	while (1)
 	{
-		// draw the current point
-		pixel = TREE_Pattern_Get(
-			pattern,
-			patternIndex);
-		TREE_Image_Set(
-			image,
-			start,
-			pixel);
+		// draw the current point, if within the clip
+		if (start.x >= clipX && start.y >= clipY && start.x < clipEndX && start.y < clipEndY)
+		{
+			TREE_Size index = _TREE_ImageView_GetIndex(view, start.x, start.y);
+			view->text[index] = pattern->pixels[patternIndex].character;
+			view->colors[index] = pattern->pixels[patternIndex].colorPair;
+		}
 
 		// move to the next point in the pattern
-		patternIndex = (patternIndex + 1) % pattern->size;
+		patternIndex = patternIndex + 1 == size ? 0 : patternIndex + 1;
 
 		// check if we've reached the end point
 		if (start.x == end.x && start.y == end.y)
@@ -1745,10 +2602,10 @@ TREE_Result TREE_Image_DrawLine(TREE_Image *image, TREE_Offset start, TREE_Offse
 	return TREE_OK;
 }
 
-TREE_Result TREE_Image_DrawRect(TREE_Image *image, TREE_Rect const *rect, TREE_Pattern const *pattern)
+TREE_Result TREE_ImageView_DrawRect(TREE_ImageView *view, TREE_Rect const *rect, TREE_Pattern const *pattern)
 {
 	// validate
-	if (!image || !rect || !pattern)
+	if (!view || !rect || !pattern)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
@@ -1760,22 +2617,22 @@ TREE_Result TREE_Image_DrawRect(TREE_Image *image, TREE_Rect const *rect, TREE_P
 	TREE_Offset p3 = {p0.x, p0.y + (TREE_Int)rect->extent.height - 1};
 
 	// draw the lines
-	TREE_Result result = TREE_Image_DrawLine(image, p0, p1, pattern);
+	TREE_Result result = TREE_ImageView_DrawLine(view, p0, p1, pattern);
 	if (result)
 	{
 		return result;
 	}
-	result = TREE_Image_DrawLine(image, p1, p2, pattern);
+	result = TREE_ImageView_DrawLine(view, p1, p2, pattern);
 	if (result)
 	{
 		return result;
 	}
-	result = TREE_Image_DrawLine(image, p2, p3, pattern);
+	result = TREE_ImageView_DrawLine(view, p2, p3, pattern);
 	if (result)
 	{
 		return result;
 	}
-	result = TREE_Image_DrawLine(image, p3, p0, pattern);
+	result = TREE_ImageView_DrawLine(view, p3, p0, pattern);
 	if (result)
 	{
 		return result;
@@ -1784,10 +2641,41 @@ TREE_Result TREE_Image_DrawRect(TREE_Image *image, TREE_Rect const *rect, TREE_P
 	return TREE_OK;
 }
 
-TREE_Result TREE_Image_FillRect(TREE_Image *image, TREE_Rect const *rect, TREE_Pixel pixel)
+void _TREE_ImageView_Fill(TREE_ImageView *view, TREE_Rect const *rect, TREE_Pixel pixel)
+{
+	// calculate bounds
+	TREE_Rect const *clip = &view->clip;
+	TREE_Int startX = MAX(rect->offset.x, clip->offset.x);
+	TREE_Int startY = MAX(rect->offset.y, clip->offset.y);
+	TREE_Int endX = MIN(rect->offset.x + (TREE_Int)rect->extent.width, clip->offset.x + clip->extent.width);
+	TREE_Int endY = MIN(rect->offset.y + (TREE_Int)rect->extent.height, clip->offset.y + clip->extent.height);
+	if (startX >= endX || startY >= endY)
+	{
+		return;
+	}
+
+	// full rows of the Image are one block, so they are filled all at once
+	TREE_Size spanWidth = (TREE_Size)(endX - startX);
+	TREE_Size spanCount = (TREE_Size)(endY - startY);
+	if (spanWidth == view->stride)
+	{
+		spanWidth *= spanCount;
+		spanCount = 1;
+	}
+
+	// fill the rectangle a row at a time
+	TREE_Size index = _TREE_ImageView_GetIndex(view, startX, startY);
+	for (TREE_Size i = 0; i < spanCount; ++i, index += view->stride)
+	{
+		memset(&view->text[index], pixel.character, spanWidth * sizeof(TREE_Char));
+		memset(&view->colors[index], pixel.colorPair, spanWidth * sizeof(TREE_ColorPair));
+	}
+}
+
+TREE_Result TREE_ImageView_FillRect(TREE_ImageView *view, TREE_Rect const *rect, TREE_Pixel pixel)
 {
 	// validate
-	if (!image || !rect)
+	if (!view || !rect)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
@@ -1800,31 +2688,15 @@ TREE_Result TREE_Image_FillRect(TREE_Image *image, TREE_Rect const *rect, TREE_P
 		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// calculate bounds
-	TREE_Int startX = MAX(rect->offset.x, 0);
-	TREE_Int startY = MAX(rect->offset.y, 0);
-	TREE_Int endX = MIN(rect->offset.x + (TREE_Int)rect->extent.width, (TREE_Int)image->extent.width);
-	TREE_Int endY = MIN(rect->offset.y + (TREE_Int)rect->extent.height, (TREE_Int)image->extent.height);
-
-	// fill the rectangle
-	for (TREE_Int y = startY; y < endY; ++y)
-	{
-		for (TREE_Int x = startX; x < endX; ++x)
-		{
-			TREE_Offset offset = {x, y};
-			TREE_Size index = _TREE_Image_GetIndex(image, offset);
-			image->text[index] = pixel.character;
-			image->colors[index] = pixel.colorPair;
-		}
-	}
+	_TREE_ImageView_Fill(view, rect, pixel);
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Image_Clear(TREE_Image *image, TREE_Pixel pixel)
+TREE_Result TREE_ImageView_Clear(TREE_ImageView *view, TREE_Pixel pixel)
 {
 	// validate
-	if (!image)
+	if (!view)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
@@ -1833,1429 +2705,3861 @@ TREE_Result TREE_Image_Clear(TREE_Image *image, TREE_Pixel pixel)
 		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// fill the image with the pixel
-	TREE_Size pixelCount = (TREE_Size)(image->extent.width * image->extent.height);
-	memset(image->text, pixel.character, pixelCount * sizeof(TREE_Char));
-	memset(image->colors, pixel.colorPair, pixelCount * sizeof(TREE_ColorPair));
+	// fill the view with the pixel
+	_TREE_ImageView_Fill(view, &view->clip, pixel);
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Surface_Init(TREE_Surface *surface, TREE_Extent size)
+TREE_Result TREE_ImagePool_Init(TREE_ImagePool *pool, TREE_Size capacity)
 {
 	// validate
-	if (!surface)
+	if (!pool)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (size.width == 0 || size.height == 0)
+	if (capacity == 0)
 	{
 		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
 
-	// initialize image
-	TREE_Result code = TREE_Image_Init(&surface->image, size);
-	if (code)
-	{
-		return code;
-	}
-
-	// initialize text
-	TREE_Size textSize = (size.width * size.height + 1) * sizeof(TREE_Char); // +1 for null terminator
-	surface->text = malloc(textSize);
-	if (!surface->text)
+	// allocate data
+	pool->images = TREE_NEW_ARRAY(TREE_Image, capacity);
+	if (!pool->images)
 	{
-		TREE_Image_Free(&surface->image);
 		return TREE_ERROR_ALLOC;
 	}
 
 	// set data
-	memset(surface->text, ' ', textSize);
-	surface->text[size.width * size.height] = '\0'; // null terminator
+	pool->imagesSize = 0;
+	pool->imagesCapacity = capacity;
 
 	return TREE_OK;
 }
 
-void TREE_Surface_Free(TREE_Surface *surface)
+void TREE_ImagePool_Free(TREE_ImagePool *pool)
 {
 	// validate
-	if (!surface)
+	if (!pool)
 	{
 		return;
 	}
 
 	// free data
-	TREE_Image_Free(&surface->image);
-	TREE_DELETE(surface->text);
+	for (TREE_Size i = 0; i < pool->imagesSize; ++i)
+	{
+		TREE_Image_Free(&pool->images[i]);
+	}
+	TREE_DELETE(pool->images);
+	pool->imagesSize = 0;
+	pool->imagesCapacity = 0;
 }
 
-TREE_Result TREE_Surface_Refresh(TREE_Surface *surface)
+// gets the index of the first unused Image with at least the given capacity
+TREE_Size _TREE_ImagePool_Find(TREE_ImagePool const *pool, TREE_Size capacity)
 {
-	if (!surface)
+	TREE_Size low = 0;
+	TREE_Size high = pool->imagesSize;
+	while (low < high)
 	{
-		return TREE_ERROR_ARG_NULL;
+		TREE_Size middle = low + (high - low) / 2;
+		if (pool->images[middle].capacity < capacity)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
 	}
+	return low;
+}
 
-	// destroy old data, if any
-	if (surface->text)
+void TREE_ImagePool_Release(TREE_ImagePool *pool, TREE_Image *image)
+{
+	// validate
+	if (!pool || !image)
 	{
-		free(surface->text);
-		surface->text = NULL;
+		return;
 	}
 
-	TREE_Image *image = &surface->image;
-
-	// count number of times the color changes
-	TREE_Color lastFgColor = TREE_ColorPair_GetForeground(image->colors[0]) + 1;
-	TREE_Color lastBgColor = TREE_ColorPair_GetBackground(image->colors[0]) + 1;
-	TREE_Size fgCount = 1;
-	TREE_Size bgCount = 1;
-	TREE_Size pixelCount = (TREE_Size)(image->extent.width * image->extent.height);
-	for (TREE_Size i = 1; i < pixelCount; ++i)
+	// nothing to keep
+	if (!image->text || !image->colors || image->capacity == 0)
 	{
-		TREE_Color fgColor = TREE_ColorPair_GetForeground(image->colors[i]);
-		TREE_Color bgColor = TREE_ColorPair_GetBackground(image->colors[i]);
+		TREE_Image_Free(image);
+		image->extent = (TREE_Extent){0, 0};
+		return;
+	}
 
-		if (fgColor != lastFgColor)
+	// when full, make room by freeing the smallest, unless this one is smaller still
+	if (pool->imagesSize == pool->imagesCapacity)
+	{
+		if (pool->imagesSize == 0 || pool->images[0].capacity >= image->capacity)
 		{
-			lastFgColor = fgColor;
-			++fgCount;
-		}
-		if (bgColor != lastBgColor)
-		{
-			lastBgColor = bgColor;
-			++bgCount;
+			TREE_Image_Free(image);
+			image->extent = (TREE_Extent){0, 0};
+			return;
 		}
+		TREE_Image_Free(&pool->images[0]);
+		memmove(&pool->images[0], &pool->images[1], (pool->imagesSize - 1) * sizeof(TREE_Image));
+		pool->imagesSize--;
 	}
 
-	// calculate total size of the final text string
-	TREE_Size textSize = (pixelCount + 1) * sizeof(TREE_Char);									  // +1 for null terminator
-	TREE_Size colorSize = (fgCount + bgCount + 1) * TREE_COLOR_STRING_LENGTH * sizeof(TREE_Char); // +1 for the reset
-	TREE_Size totalSize = textSize + colorSize;
+	// insert it in order of capacity
+	TREE_Size index = _TREE_ImagePool_Find(pool, image->capacity);
+	memmove(&pool->images[index + 1], &pool->images[index], (pool->imagesSize - index) * sizeof(TREE_Image));
+	pool->images[index] = *image;
+	pool->images[index].extent = (TREE_Extent){0, 0};
+	pool->imagesSize++;
 
-	// allocate data
-	surface->text = (TREE_Char *)malloc(totalSize);
-	if (!surface->text)
+	// the Image no longer owns the memory
+	image->text = NULL;
+	image->colors = NULL;
+	image->extent = (TREE_Extent){0, 0};
+	image->capacity = 0;
+}
+
+TREE_Result TREE_ImagePool_Reserve(TREE_ImagePool *pool, TREE_Image *image, TREE_Extent extent)
+{
+	// validate
+	if (!pool || !image)
 	{
-		return TREE_ERROR_ALLOC;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set data
-	lastFgColor = TREE_ColorPair_GetForeground(image->colors[0]) + 1;
-	lastBgColor = TREE_ColorPair_GetBackground(image->colors[0]) + 1;
-	TREE_Size index = 0;
-	for (TREE_Size i = 0; i < pixelCount; ++i)
+	// already fits
+	if (extent.width <= 0 || extent.height <= 0)
+	{
+		return TREE_OK;
+	}
+	TREE_Size size = (TREE_Size)extent.width * (TREE_Size)extent.height;
+	if (size <= image->capacity)
 	{
-		TREE_ColorPair color = image->colors[i];
-		TREE_Color fgColor = TREE_ColorPair_GetForeground(color);
-		TREE_Color bgColor = TREE_ColorPair_GetBackground(color);
+		return TREE_OK;
+	}
 
-		// update colors
-		if (fgColor != lastFgColor)
-		{
-			lastFgColor = fgColor;
-			memcpy(&surface->text[index], TREE_Color_GetForegroundString(fgColor), TREE_COLOR_STRING_LENGTH * sizeof(TREE_Char));
-			index += TREE_COLOR_STRING_LENGTH;
-		}
-		if (bgColor != lastBgColor)
+	TREE_Size used = image->text ? (TREE_Size)image->extent.width * (TREE_Size)image->extent.height : 0;
+	TREE_Size index = _TREE_ImagePool_Find(pool, size);
+	if (index < pool->imagesSize)
+	{
+		// take the smallest unused Image that fits, and keep the pixels
+		TREE_Image taken = pool->images[index];
+		memmove(&pool->images[index], &pool->images[index + 1], (pool->imagesSize - index - 1) * sizeof(TREE_Image));
+		pool->imagesSize--;
+		if (used)
 		{
-			lastBgColor = bgColor;
-			memcpy(&surface->text[index], TREE_Color_GetBackgroundString(bgColor), TREE_COLOR_STRING_LENGTH * sizeof(TREE_Char));
-			index += TREE_COLOR_STRING_LENGTH;
+			memcpy(taken.text, image->text, used * sizeof(TREE_Char));
+			memcpy(taken.colors, image->colors, used * sizeof(TREE_ColorPair));
 		}
+		taken.text[used] = '\0';
+		taken.extent = image->extent;
+
+		// the old memory goes back to the pool
+		TREE_ImagePool_Release(pool, image);
+		*image = taken;
+		return TREE_OK;
+	}
 
-		// copy character
-		memcpy(&surface->text[index], &image->text[i], sizeof(TREE_Char));
-		index++;
+	// grow with room to spare, so that the next few resizes fit
+	TREE_Size capacity = size + size / 2;
+	TREE_Char *text = (TREE_Char *)realloc(image->text, (capacity + 1) * sizeof(TREE_Char)); // +1 for null terminator
+	if (!text)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	image->text = text;
+	image->text[used] = '\0';
+	TREE_ColorPair *colors = (TREE_ColorPair *)realloc(image->colors, capacity * sizeof(TREE_ColorPair));
+	if (!colors)
+	{
+		return TREE_ERROR_ALLOC;
 	}
+	image->colors = colors;
+	image->capacity = capacity;
 
-	// add reset string
-	memcpy(&surface->text[index], TREE_Color_GetResetString(), TREE_COLOR_STRING_LENGTH * sizeof(TREE_Char));
-	index += TREE_COLOR_STRING_LENGTH;
+	return TREE_OK;
+}
 
-	// add null terminator
-	surface->text[index] = '\0';
+// the file starts with these bytes, the last one being the version, then the width and height
+static TREE_Byte const g_imageFileHeader[8] = {'T', 'R', 'E', 'E', 'I', 'M', 'G', TREE_IMAGE_FILE_VERSION};
+#define IMAGE_FILE_HEADER_SIZE 16
 
-	if (index >= totalSize)
+TREE_Result TREE_Image_Save(TREE_Image const *image, TREE_String path)
+{
+	// validate
+	if (!image || !path)
 	{
-		free(surface->text);
-		surface->text = NULL;
-		return TREE_ERROR_OVERFLOW;
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// the header, little endian
+	TREE_Byte header[IMAGE_FILE_HEADER_SIZE];
+	memcpy(header, g_imageFileHeader, sizeof(g_imageFileHeader));
+	TREE_UInt width = (TREE_UInt)MAX(image->extent.width, 0);
+	TREE_UInt height = (TREE_UInt)MAX(image->extent.height, 0);
+	for (TREE_Size i = 0; i < 4; ++i)
+	{
+		header[8 + i] = (TREE_Byte)(width >> (i * 8));
+		header[12 + i] = (TREE_Byte)(height >> (i * 8));
+	}
+
+	FILE *file = fopen(path, "wb");
+	if (!file)
+	{
+		return TREE_ERROR_FILE_OPEN;
+	}
+
+	// the planes, as they are in memory, the text with its null terminator
+	TREE_Size size = (TREE_Size)width * (TREE_Size)height;
+	TREE_Char const terminator = '\0';
+	TREE_Bool written = fwrite(header, 1, IMAGE_FILE_HEADER_SIZE, file) == IMAGE_FILE_HEADER_SIZE &&
+						(!size || fwrite(image->text, sizeof(TREE_Char), size, file) == size) &&
+						fwrite(&terminator, sizeof(TREE_Char), 1, file) == 1 &&
+						(!size || fwrite(image->colors, sizeof(TREE_ColorPair), size, file) == size);
+	if (fclose(file) != 0 || !written)
+	{
+		return TREE_ERROR_FILE_WRITE;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Window_SetTitle(TREE_String title)
+TREE_Result TREE_ImageFile_Load(TREE_ImageFile *file, TREE_String path)
 {
+	// validate
+	if (!file || !path)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// map the whole file, privately, so that drawing onto it copies only the pages drawn to
+	TREE_Data data;
+	TREE_Size size;
 #ifdef TREE_WINDOWS
-	if (!SetConsoleTitleA(title))
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
 	{
-		return TREE_ERROR_WINDOW_SET_TITLE;
+		return TREE_ERROR_FILE_OPEN;
 	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart < IMAGE_FILE_HEADER_SIZE)
+	{
+		CloseHandle(handle);
+		return TREE_ERROR_FILE_READ;
+	}
+	size = (TREE_Size)fileSize.QuadPart;
+	HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	CloseHandle(handle);
+	if (!mapping)
+	{
+		return TREE_ERROR_FILE_READ;
+	}
+	data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!data)
+	{
+		return TREE_ERROR_FILE_READ;
+	}
+#else
+	int descriptor = open(path, O_RDONLY | O_CLOEXEC);
+	if (descriptor < 0)
+	{
+		return TREE_ERROR_FILE_OPEN;
+	}
+	struct stat status;
+	if (fstat(descriptor, &status) < 0 || status.st_size < IMAGE_FILE_HEADER_SIZE)
+	{
+		close(descriptor);
+		return TREE_ERROR_FILE_READ;
+	}
+	size = (TREE_Size)status.st_size;
+	data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (data == MAP_FAILED)
+	{
+		return TREE_ERROR_FILE_READ;
+	}
+#endif
+
+	file->data = data;
+	file->size = size;
+
+	// check the header, and that the planes fill the rest of the file exactly
+	TREE_Byte const *bytes = (TREE_Byte const *)data;
+	TREE_UInt width = 0;
+	TREE_UInt height = 0;
+	for (TREE_Size i = 0; i < 4; ++i)
+	{
+		width |= (TREE_UInt)bytes[8 + i] << (i * 8);
+		height |= (TREE_UInt)bytes[12 + i] << (i * 8);
+	}
+	// the sizes are worked out in 64 bits, and the planes must fit in memory, so that they do not wrap around
+	uint64_t const pixelSize = sizeof(TREE_Char) + sizeof(TREE_ColorPair);
+	uint64_t const planesSize = (uint64_t)width * (uint64_t)height * pixelSize + sizeof(TREE_Char);
+	TREE_Size pixels = (TREE_Size)width * (TREE_Size)height;
+	TREE_Char *text = (TREE_Char *)&bytes[IMAGE_FILE_HEADER_SIZE];
+	if (memcmp(bytes, g_imageFileHeader, sizeof(g_imageFileHeader)) != 0 ||
+		width > INT_MAX || height > INT_MAX ||
+		(uint64_t)width * (uint64_t)height > (SIZE_MAX - sizeof(TREE_Char)) / pixelSize ||
+		(uint64_t)(size - IMAGE_FILE_HEADER_SIZE) != planesSize ||
+		text[pixels] != '\0')
+	{
+		TREE_ImageFile_Free(file);
+		return TREE_ERROR_FILE_READ;
+	}
+
+	// point the Image at the planes
+	file->image.extent.width = (TREE_Int)width;
+	file->image.extent.height = (TREE_Int)height;
+	file->image.text = text;
+	file->image.colors = (TREE_ColorPair *)&text[pixels + 1];
+	file->image.capacity = pixels;
+
 	return TREE_OK;
-#elif defined(TREE_LINUX)
-	printf("\033]0;%s\007", title);
-	fflush(stdout);
-	return TREE_OK;
+}
+
+void TREE_ImageFile_Free(TREE_ImageFile *file)
+{
+	// validate
+	if (!file || !file->data)
+	{
+		return;
+	}
+
+	// unmap the file
+#ifdef TREE_WINDOWS
+	UnmapViewOfFile(file->data);
 #else
-	return TREE_NOT_IMPLEMENTED;
+	munmap(file->data, file->size);
 #endif
+	file->data = NULL;
+	file->size = 0;
+	file->image.text = NULL;
+	file->image.colors = NULL;
+	file->image.extent = (TREE_Extent){0, 0};
+	file->image.capacity = 0;
 }
 
-TREE_Result TREE_Window_Present(TREE_Surface *surface)
+TREE_Size TREE_Image_FindDifference(TREE_Image const *image, TREE_Image const *other, TREE_Size start, TREE_Size end)
 {
 	// validate
-	if (!surface)
+	if (!image || !other ||
+		image->extent.width != other->extent.width ||
+		image->extent.height != other->extent.height)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return end;
 	}
-	if (!surface->text)
+
+	// stay within the Images
+	TREE_Size pixelCount = (TREE_Size)(image->extent.width * image->extent.height);
+	end = MIN(end, pixelCount);
+	if (start >= end)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return end;
 	}
 
-	// move the cursor to the top left corner
-#ifdef TREE_WINDOWS
+	return g_findDifference(image->text, other->text, image->colors, other->colors, start, end);
+}
+
+// the longest unchanged gap that may be printed again, instead of moving the cursor past it
+#define _TREE_SURFACE_GAP_LENGTH 16
+
+// the longest cursor movement: ESC [ row ; column H
+#define _TREE_SURFACE_CURSOR_LENGTH 24
+
+// the longest color change: ESC [ 97 ; 107 m
+#define _TREE_SURFACE_COLOR_LENGTH 10
+
+// the color reset at the end of a frame: ESC [ 0 m
+#define _TREE_SURFACE_RESET_LENGTH 4
+
+// the longest scroll of one band of rows: ESC [ left ; right s, ESC [ top ; bottom r, ESC [ count S
+#define _TREE_SURFACE_SCROLL_LENGTH 64
+
+// the margin reset after scrolling: ESC [ ? 69 h, ESC [ r, ESC [ ? 69 l
+#define _TREE_SURFACE_SCROLL_RESET_LENGTH 15
+
+// the start or end of a synchronized frame: ESC [ ? 2026 h
+#define _TREE_SURFACE_SYNCHRONIZE_LENGTH 8
+
+TREE_Size _TREE_Surface_GetTextCapacity(TREE_Extent extent)
+{
+	// worst case: every cell changes colors, and every other cell is skipped with a cursor movement
+	TREE_Size cellSize = (1 + _TREE_SURFACE_COLOR_LENGTH) * sizeof(TREE_Char);
+	TREE_Size runsPerRow = (TREE_Size)extent.width / 2 + 1;
+	TREE_Size rowSize = (TREE_Size)extent.width * cellSize + runsPerRow * _TREE_SURFACE_CURSOR_LENGTH;
+
+	// bands of scrolled rows are at least three rows tall, and separated by at least one row
+	TREE_Size scrollSize = ((TREE_Size)extent.height / 4 + 1) * _TREE_SURFACE_SCROLL_LENGTH + _TREE_SURFACE_SCROLL_RESET_LENGTH;
+
+	return (TREE_Size)extent.height * rowSize + scrollSize + _TREE_SURFACE_RESET_LENGTH + 2 * _TREE_SURFACE_SYNCHRONIZE_LENGTH + 1; // +1 for null terminator
+}
+
+TREE_Result _TREE_Surface_Reserve(TREE_Surface *surface, TREE_Extent extent)
+{
+	// only grow, so the text is reused from frame to frame
+	TREE_Size capacity = _TREE_Surface_GetTextCapacity(extent);
+	if (surface->text && surface->textCapacity >= capacity)
 	{
-		HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-		COORD coord = {0, 0};
-		SetConsoleCursorPosition(hConsole, coord);
+		return TREE_OK;
 	}
-#elif defined(TREE_LINUX)
-	printf("\033[H"); // Move cursor to home position (top-left corner)
-#endif
 
-	// print to the console
-	int result = printf("%s", surface->text);
-	if (result < 0)
+	TREE_Char *text = (TREE_Char *)realloc(surface->text, capacity * sizeof(TREE_Char));
+	if (!text)
 	{
-		return TREE_ERROR_PRESENTATION;
+		return TREE_ERROR_ALLOC;
+	}
+	surface->text = text;
+	surface->textCapacity = capacity;
+
+	return TREE_OK;
+}
+
+TREE_Result _TREE_Surface_Match(TREE_Surface *surface)
+{
+	TREE_Extent extent = surface->image.extent;
+
+	// nothing to do if the Image was not resized
+	if (surface->front.extent.width == extent.width &&
+		surface->front.extent.height == extent.height &&
+		surface->damageStart && surface->damageEnd && surface->rowHashes)
+	{
+		return TREE_OK;
 	}
 
-	// flush the output
-	result = fflush(stdout);
+	// the terminal has to be redrawn entirely after a resize
+	TREE_Result result = TREE_Image_Resize(&surface->front, extent);
 	if (result)
 	{
-		return TREE_ERROR_PRESENTATION;
+		return result;
+	}
+	surface->invalid = TREE_TRUE;
+
+	// one damaged span per row
+	TREE_Int *damageStart = (TREE_Int *)realloc(surface->damageStart, (TREE_Size)MAX(extent.height, 1) * sizeof(TREE_Int));
+	if (!damageStart)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	surface->damageStart = damageStart;
+	TREE_Int *damageEnd = (TREE_Int *)realloc(surface->damageEnd, (TREE_Size)MAX(extent.height, 1) * sizeof(TREE_Int));
+	if (!damageEnd)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	surface->damageEnd = damageEnd;
+
+	// the hashes of the Image rows, followed by the hashes of the front Image rows
+	TREE_Size *rowHashes = (TREE_Size *)realloc(surface->rowHashes, (TREE_Size)MAX(extent.height, 1) * 2 * sizeof(TREE_Size));
+	if (!rowHashes)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	surface->rowHashes = rowHashes;
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		surface->damageStart[y] = extent.width;
+		surface->damageEnd[y] = 0;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Extent TREE_Window_GetExtent()
+TREE_Size _TREE_Surface_WriteString(TREE_Char *output, TREE_Size index, TREE_String string, TREE_Size length)
 {
-	TREE_Extent extent;
-	extent.width = 0;
-	extent.height = 0;
+	memcpy(&output[index], string, length * sizeof(TREE_Char));
+	return index + length;
+}
 
-#ifdef TREE_WINDOWS
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi))
+TREE_Size _TREE_Surface_WriteNumber(TREE_Char *output, TREE_Size index, TREE_UInt value)
+{
+	// get the digits in reverse order
+	TREE_Char digits[10];
+	TREE_Size digitCount = 0;
+	do
 	{
-		extent.width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
-		extent.height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+		digits[digitCount++] = (TREE_Char)('0' + value % 10);
+		value /= 10;
+	} while (value);
+
+	for (TREE_Size i = 0; i < digitCount; ++i)
+	{
+		output[index + i] = digits[digitCount - 1 - i];
 	}
-#elif defined(TREE_LINUX)
-	struct winsize w;
-	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0)
+	return index + digitCount;
+}
+
+TREE_Size _TREE_Surface_WriteCursor(TREE_Char *output, TREE_Size index, TREE_Int x, TREE_Int y)
+{
+	// the terminal uses 1 based rows and columns
+	index = _TREE_Surface_WriteString(output, index, "\033[", 2);
+	index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)(y + 1));
+	index = _TREE_Surface_WriteString(output, index, ";", 1);
+	index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)(x + 1));
+	return _TREE_Surface_WriteString(output, index, "H", 1);
+}
+
+TREE_Size _TREE_Surface_GetNumberLength(TREE_UInt value)
+{
+	TREE_Size length = 1;
+	while (value >= 10)
 	{
-		extent.width = w.ws_col;
-		extent.height = w.ws_row;
+		value /= 10;
+		++length;
 	}
-	else
+	return length;
+}
+
+TREE_Size _TREE_Surface_GetCursorLength(TREE_Int x, TREE_Int y)
+{
+	// ESC [ row ; column H
+	return 4 + _TREE_Surface_GetNumberLength((TREE_UInt)(y + 1)) + _TREE_Surface_GetNumberLength((TREE_UInt)(x + 1));
+}
+
+TREE_Size _TREE_Surface_GetSequenceLength(TREE_UInt value)
+{
+	// ESC [ value final, the value is left out when it is the default of 1
+	return value == 1 ? 3 : 3 + _TREE_Surface_GetNumberLength(value);
+}
+
+TREE_Size _TREE_Surface_WriteSequence(TREE_Char *output, TREE_Size index, TREE_UInt value, TREE_Char final)
+{
+	index = _TREE_Surface_WriteString(output, index, "\033[", 2);
+	if (value != 1)
 	{
-		printf("Error getting terminal size\n");
+		index = _TREE_Surface_WriteNumber(output, index, value);
 	}
-#endif
+	output[index] = final;
+	return index + 1;
+}
 
-	return extent;
+TREE_UInt _TREE_Surface_GetColorCode(TREE_Int color, TREE_UInt base)
+{
+	// the bright colors start 60 codes after the normal colors
+	return color < 8 ? base + (TREE_UInt)color : base + 60 + (TREE_UInt)(color - 8);
 }
 
-TREE_EXTERN void TREE_Window_Beep()
+TREE_Size _TREE_Surface_GetColorLength(TREE_Int fgColor, TREE_Int bgColor, TREE_Int newFgColor, TREE_Int newBgColor)
 {
-#ifdef TREE_WINDOWS
-	MessageBeep(MB_ICONEXCLAMATION);
-#else
-	printf("\a"); // ASCII Bell character
-#endif
+	// a new foreground color of -1 keeps the current one
+	TREE_Bool fgChanged = newFgColor >= 0 && newFgColor != fgColor;
+	TREE_Bool bgChanged = newBgColor != bgColor;
+	if (!fgChanged && !bgChanged)
+	{
+		return 0;
+	}
+
+	// ESC [ fg ; bg m
+	TREE_Size length = 3;
+	if (fgChanged)
+	{
+		length += _TREE_Surface_GetNumberLength(_TREE_Surface_GetColorCode(newFgColor, 30));
+	}
+	if (bgChanged)
+	{
+		length += _TREE_Surface_GetNumberLength(_TREE_Surface_GetColorCode(newBgColor, 40));
+	}
+	if (fgChanged && bgChanged)
+	{
+		++length;
+	}
+	return length;
 }
 
-TREE_Result TREE_Cursor_SetVisible(TREE_Bool visible)
+TREE_Bool _TREE_Surface_IsChanged(TREE_Surface const *surface, TREE_Size index)
 {
-	if (visible)
+	return surface->invalid ||
+		   surface->image.text[index] != surface->front.text[index] ||
+		   surface->image.colors[index] != surface->front.colors[index];
+}
+
+TREE_Int _TREE_Surface_GetForeground(TREE_Image const *image, TREE_Size index)
+{
+	// the foreground of a space is never seen, so it can be anything
+	if (image->text[index] == ' ')
 	{
-		printf("\033[?25h"); // Show cursor
+		return -1;
 	}
-	else
+	return (TREE_Int)TREE_ColorPair_GetForeground(image->colors[index]);
+}
+
+TREE_Int _TREE_Surface_GetBackground(TREE_Image const *image, TREE_Size index)
+{
+	return (TREE_Int)TREE_ColorPair_GetBackground(image->colors[index]);
+}
+
+TREE_Bool _TREE_Surface_IsSameCell(TREE_Image const *image, TREE_Size index, TREE_Size otherIndex)
+{
+	return image->text[index] == image->text[otherIndex] &&
+		   _TREE_Surface_GetForeground(image, index) == _TREE_Surface_GetForeground(image, otherIndex) &&
+		   _TREE_Surface_GetBackground(image, index) == _TREE_Surface_GetBackground(image, otherIndex);
+}
+
+// the state of the terminal while encoding a frame
+typedef struct _TREE_SurfaceEncoder
+{
+	TREE_Surface *surface;
+	TREE_Char *output;
+	TREE_Size index;
+
+	// the cursor position and colors of the terminal, -1 while they are unknown
+	TREE_Int cursorX;
+	TREE_Int cursorY;
+	TREE_Int fgColor;
+	TREE_Int bgColor;
+
+	// true while the cursor is still at the end of the previous row, and only moves down once the next character is printed
+	TREE_Bool wrapping;
+} _TREE_SurfaceEncoder;
+
+void _TREE_Surface_EncodeColor(_TREE_SurfaceEncoder *encoder, TREE_Int fgColor, TREE_Int bgColor)
+{
+	TREE_Bool fgChanged = fgColor >= 0 && fgColor != encoder->fgColor;
+	TREE_Bool bgChanged = bgColor != encoder->bgColor;
+	if (!fgChanged && !bgChanged)
 	{
-		printf("\033[?25l"); // Hide cursor
+		return;
 	}
-	fflush(stdout);
 
-	return TREE_OK;
+	// both colors are changed with a single sequence
+	TREE_Char *output = encoder->output;
+	TREE_Size index = _TREE_Surface_WriteString(output, encoder->index, "\033[", 2);
+	if (fgChanged)
+	{
+		index = _TREE_Surface_WriteNumber(output, index, _TREE_Surface_GetColorCode(fgColor, 30));
+		encoder->fgColor = fgColor;
+	}
+	if (fgChanged && bgChanged)
+	{
+		index = _TREE_Surface_WriteString(output, index, ";", 1);
+	}
+	if (bgChanged)
+	{
+		index = _TREE_Surface_WriteNumber(output, index, _TREE_Surface_GetColorCode(bgColor, 40));
+		encoder->bgColor = bgColor;
+	}
+	encoder->index = _TREE_Surface_WriteString(output, index, "m", 1);
 }
 
-TREE_String TREE_Key_ToString(TREE_Key key)
+void _TREE_Surface_EncodeCells(_TREE_SurfaceEncoder *encoder, TREE_Size rowIndex, TREE_Int start, TREE_Int end)
 {
-	switch (key)
+	TREE_Image *image = &encoder->surface->image;
+	TREE_Image *front = &encoder->surface->front;
+
+	// print each cell as it is
+	for (TREE_Int x = start; x < end; ++x)
 	{
-	case TREE_KEY_NONE:
-		return "None";
-	case TREE_KEY_BACKSPACE:
-		return "Backspace";
-	case TREE_KEY_TAB:
-		return "Tab";
-	case TREE_KEY_ENTER:
-		return "Enter";
-	case TREE_KEY_SHIFT:
-		return "Shift";
-	case TREE_KEY_CONTROL:
-		return "Control";
-	case TREE_KEY_ALT:
-		return "Alt";
-	case TREE_KEY_PAUSE:
-		return "Pause";
-	case TREE_KEY_CAPS_LOCK:
-		return "Caps Lock";
-	case TREE_KEY_ESCAPE:
-		return "Escape";
-	case TREE_KEY_SPACE:
-		return "Space";
-	case TREE_KEY_PAGE_UP:
-		return "Page Up";
-	case TREE_KEY_PAGE_DOWN:
-		return "Page Down";
-	case TREE_KEY_END:
-		return "End";
-	case TREE_KEY_HOME:
-		return "Home";
-	case TREE_KEY_LEFT_ARROW:
-		return "Left Arrow";
-	case TREE_KEY_UP_ARROW:
-		return "Up Arrow";
-	case TREE_KEY_RIGHT_ARROW:
-		return "Right Arrow";
-	case TREE_KEY_DOWN_ARROW:
-		return "Down Arrow";
-	case TREE_KEY_PRINT_SCREEN:
-		return "Print Screen";
-	case TREE_KEY_INSERT:
-		return "Insert";
-	case TREE_KEY_DELETE:
-		return "Delete";
-	case TREE_KEY_0:
-		return "0";
-	case TREE_KEY_1:
-		return "1";
-	case TREE_KEY_2:
-		return "2";
-	case TREE_KEY_3:
-		return "3";
-	case TREE_KEY_4:
-		return "4";
-	case TREE_KEY_5:
-		return "5";
-	case TREE_KEY_6:
-		return "6";
-	case TREE_KEY_7:
-		return "7";
-	case TREE_KEY_8:
-		return "8";
-	case TREE_KEY_9:
-		return "9";
-	case TREE_KEY_A:
-		return "A";
-	case TREE_KEY_B:
-		return "B";
-	case TREE_KEY_C:
-		return "C";
-	case TREE_KEY_D:
-		return "D";
-	case TREE_KEY_E:
-		return "E";
-	case TREE_KEY_F:
-		return "F";
-	case TREE_KEY_G:
-		return "G";
-	case TREE_KEY_H:
-		return "H";
-	case TREE_KEY_I:
-		return "I";
-	case TREE_KEY_J:
-		return "J";
-	case TREE_KEY_K:
-		return "K";
-	case TREE_KEY_L:
-		return "L";
-	case TREE_KEY_M:
-		return "M";
-	case TREE_KEY_N:
-		return "N";
-	case TREE_KEY_O:
-		return "O";
-	case TREE_KEY_P:
-		return "P";
-	case TREE_KEY_Q:
-		return "Q";
-	case TREE_KEY_R:
-		return "R";
-	case TREE_KEY_S:
-		return "S";
-	case TREE_KEY_T:
-		return "T";
-	case TREE_KEY_U:
-		return "U";
-	case TREE_KEY_V:
-		return "V";
-	case TREE_KEY_W:
-		return "W";
-	case TREE_KEY_X:
-		return "X";
-	case TREE_KEY_Y:
-		return "Y";
-	case TREE_KEY_Z:
-		return "Z";
-	case TREE_KEY_NUMPAD_0:
-		return "Numpad 0";
-	case TREE_KEY_NUMPAD_1:
-		return "Numpad 1";
-	case TREE_KEY_NUMPAD_2:
-		return "Numpad 2";
-	case TREE_KEY_NUMPAD_3:
-		return "Numpad 3";
-	case TREE_KEY_NUMPAD_4:
-		return "Numpad 4";
-	case TREE_KEY_NUMPAD_5:
-		return "Numpad 5";
-	case TREE_KEY_NUMPAD_6:
-		return "Numpad 6";
-	case TREE_KEY_NUMPAD_7:
-		return "Numpad 7";
-	case TREE_KEY_NUMPAD_8:
-		return "Numpad 8";
-	case TREE_KEY_NUMPAD_9:
-		return "Numpad 9";
-	case TREE_KEY_MULTIPLY:
-		return "Multiply";
-	case TREE_KEY_ADD:
-		return "Add";
-	case TREE_KEY_SUBTRACT:
-		return "Subtract";
-	case TREE_KEY_DECIMAL:
-		return "Decimal";
-	case TREE_KEY_DIVIDE:
-		return "Divide";
-	case TREE_KEY_F1:
-		return "F1";
-	case TREE_KEY_F2:
-		return "F2";
-	case TREE_KEY_F3:
-		return "F3";
-	case TREE_KEY_F4:
-		return "F4";
-	case TREE_KEY_F5:
-		return "F5";
-	case TREE_KEY_F6:
-		return "F6";
-	case TREE_KEY_F7:
-		return "F7";
-	case TREE_KEY_F8:
-		return "F8";
-	case TREE_KEY_F9:
-		return "F9";
-	case TREE_KEY_F10:
-		return "F10";
-	case TREE_KEY_F11:
-		return "F11";
-	case TREE_KEY_F12:
-		return "F12";
-	case TREE_KEY_NUM_LOCK:
-		return "Num Lock";
-	case TREE_KEY_SCROLL_LOCK:
-		return "Scroll Lock";
-	case TREE_KEY_SEMICOLON:
-		return "Semicolon";
-	case TREE_KEY_EQUALS:
-		return "Equals";
-	case TREE_KEY_COMMA:
-		return "Comma";
-	case TREE_KEY_MINUS:
-		return "Minus";
-	case TREE_KEY_PERIOD:
-		return "Period";
-	case TREE_KEY_SLASH:
-		return "Slash";
-	case TREE_KEY_TILDE:
-		return "Tilde";
-	case TREE_KEY_LEFT_BRACKET:
-		return "Left Bracket";
-	case TREE_KEY_BACKSLASH:
-		return "Backslash";
-	case TREE_KEY_RIGHT_BRACKET:
-		return "Right Bracket";
-	case TREE_KEY_APOSTROPHE:
-		return "Apostrophe";
-	case TREE_KEY_LEFT_CONTROL:
-		return "Left Control";
-	case TREE_KEY_LEFT_SHIFT:
-		return "Left Shift";
-	case TREE_KEY_LEFT_ALT:
-		return "Left Alt";
-	case TREE_KEY_LEFT_COMMAND:
-		return "Left Command";
-	case TREE_KEY_RIGHT_CONTROL:
-		return "Right Control";
-	case TREE_KEY_RIGHT_SHIFT:
-		return "Right Shift";
-	case TREE_KEY_RIGHT_ALT:
-		return "Right Alt";
-	case TREE_KEY_RIGHT_COMMAND:
-		return "Right Command";
-	case TREE_KEY_APPLICATION:
-		return "Application";
-	default:
-		return "Unknown";
+		TREE_Size cellIndex = rowIndex + (TREE_Size)x;
+		_TREE_Surface_EncodeColor(encoder, _TREE_Surface_GetForeground(image, cellIndex), _TREE_Surface_GetBackground(image, cellIndex));
+		encoder->index = _TREE_Surface_WriteString(encoder->output, encoder->index, &image->text[cellIndex], 1);
+		front->text[cellIndex] = image->text[cellIndex];
+		front->colors[cellIndex] = image->colors[cellIndex];
 	}
+	encoder->cursorX = end;
 }
 
-TREE_CharType TREE_Char_GetType(TREE_Char character)
+TREE_Size _TREE_Surface_GetCellsLength(_TREE_SurfaceEncoder const *encoder, TREE_Size rowIndex, TREE_Int start, TREE_Int end)
 {
-	// letters
-	if (isalpha(character))
+	TREE_Image const *image = &encoder->surface->image;
+	TREE_Int fgColor = encoder->fgColor;
+	TREE_Int bgColor = encoder->bgColor;
+
+	// the same as _TREE_Surface_EncodeCells, without printing
+	TREE_Size length = 0;
+	for (TREE_Int x = start; x < end; ++x)
 	{
-		return TREE_CHAR_TYPE_LETTER;
+		TREE_Size cellIndex = rowIndex + (TREE_Size)x;
+		TREE_Int cellFgColor = _TREE_Surface_GetForeground(image, cellIndex);
+		TREE_Int cellBgColor = _TREE_Surface_GetBackground(image, cellIndex);
+		length += _TREE_Surface_GetColorLength(fgColor, bgColor, cellFgColor, cellBgColor) + 1;
+		fgColor = cellFgColor >= 0 ? cellFgColor : fgColor;
+		bgColor = cellBgColor;
 	}
+	return length;
+}
 
-	// numbers
-	if (isdigit(character))
+void _TREE_Surface_EncodeMove(_TREE_SurfaceEncoder *encoder, TREE_Int x, TREE_Int y)
+{
+	TREE_Int width = encoder->surface->image.extent.width;
+	TREE_Int cursorX = encoder->cursorX;
+	TREE_Int cursorY = encoder->cursorY;
+
+	// nothing to do if the cursor is already there, or wraps there from the end of the previous row
+	if ((cursorY == y && cursorX == x) ||
+		(x == 0 && cursorY == y - 1 && cursorX == width))
 	{
-		return TREE_CHAR_TYPE_NUMBER;
+		encoder->wrapping = cursorY != y;
+		encoder->cursorX = x;
+		encoder->cursorY = y;
+		return;
 	}
+	encoder->wrapping = TREE_FALSE;
 
-	// whitespace
-	if (isspace(character))
+	// pick the shortest way to get there
+	TREE_Size length = _TREE_Surface_GetCursorLength(x, y);
+	TREE_Char final = 'H';
+	if (cursorY == y && cursorX >= 0)
 	{
-		return TREE_CHAR_TYPE_WHITESPACE;
+		// move to the column
+		TREE_Size columnLength = _TREE_Surface_GetSequenceLength((TREE_UInt)(x + 1));
+		if (columnLength < length)
+		{
+			length = columnLength;
+			final = 'G';
+		}
+
+		if (cursorX < x)
+		{
+			// move forward
+			TREE_Size forwardLength = _TREE_Surface_GetSequenceLength((TREE_UInt)(x - cursorX));
+			if (forwardLength < length)
+			{
+				length = forwardLength;
+				final = 'C';
+			}
+
+			// print the unchanged cells in between again
+			if (x - cursorX <= _TREE_SURFACE_GAP_LENGTH &&
+				_TREE_Surface_GetCellsLength(encoder, (TREE_Size)y * (TREE_Size)width, cursorX, x) <= length)
+			{
+				_TREE_Surface_EncodeCells(encoder, (TREE_Size)y * (TREE_Size)width, cursorX, x);
+				return;
+			}
+		}
 	}
 
-	// symbols
-	if (ispunct(character))
+	switch (final)
 	{
-		return TREE_CHAR_TYPE_SYMBOL;
+	case 'G':
+		encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, (TREE_UInt)(x + 1), 'G');
+		break;
+	case 'C':
+		encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, (TREE_UInt)(x - cursorX), 'C');
+		break;
+	default:
+		encoder->index = _TREE_Surface_WriteCursor(encoder->output, encoder->index, x, y);
+		break;
 	}
-
-	return TREE_CHAR_TYPE_NONE;
+	encoder->cursorX = x;
+	encoder->cursorY = y;
 }
 
-TREE_Char TREE_Key_ToChar(TREE_Key key, TREE_KeyModifierFlags modifiers)
+void _TREE_Surface_EncodeRun(_TREE_SurfaceEncoder *encoder, TREE_Int y, TREE_Int start, TREE_Int end)
 {
-	TREE_Bool isShiftPressed = (modifiers & TREE_KEY_MODIFIER_FLAGS_SHIFT) != 0;
-	TREE_Bool isCapsLockOn = (modifiers & TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK) != 0;
-
-	// handle alphabetic characters
-	if (key >= TREE_KEY_A && key <= TREE_KEY_Z)
-	{
-		TREE_Bool isUpperCase = isShiftPressed ^ isCapsLockOn;		 // XOR: Shift or Caps Lock toggles case
-		return isUpperCase ? (TREE_Char)key : (TREE_Char)(key + 32); // Convert to lowercase if not uppercase
-	}
+	TREE_Surface *surface = encoder->surface;
+	TREE_Image *image = &surface->image;
+	TREE_Image *front = &surface->front;
+	TREE_Int width = image->extent.width;
+	TREE_Int height = image->extent.height;
+	TREE_Size rowIndex = (TREE_Size)y * (TREE_Size)width;
 
-	// handle number keys (0-9) and their shifted symbols
-	if (key >= TREE_KEY_0 && key <= TREE_KEY_9)
+	TREE_Int x = start;
+	while (x < end)
 	{
-		if (isShiftPressed)
+		// find the identical cells that follow
+		TREE_Size cellIndex = rowIndex + (TREE_Size)x;
+		TREE_Int count = 1;
+		while (x + count < end && _TREE_Surface_IsSameCell(image, cellIndex, cellIndex + (TREE_Size)count))
 		{
-			// Shifted symbols for number keys
-			static const TREE_Char shiftedSymbols[] = {')', '!', '@', '#', '$', '%', '^', '&', '*', '('};
-			return shiftedSymbols[key - TREE_KEY_0];
+			++count;
 		}
-		return (TREE_Char)key;
-	}
+		TREE_Int groupEnd = x + count;
 
-	// handle special characters and symbols
-	if (key >= TREE_KEY_SEMICOLON && key <= TREE_KEY_TILDE)
-	{
-		static const TREE_Char normalChars[] = {
-			';', '=', ',', '-', '.', '/', '`'};
-		static const TREE_Char shiftedChars[] = {
-			':', '+', '<', '_', '>', '?', '~'};
-		TREE_Size index = key - TREE_KEY_SEMICOLON;
-		return isShiftPressed ? shiftedChars[index] : normalChars[index];
-	}
-	if (key >= TREE_KEY_LEFT_BRACKET && key <= TREE_KEY_APOSTROPHE)
-	{
-		static const TREE_Char normalChars[] = {
-			'[',
-			'\\',
-			']',
-			'\'',
-		};
-		static const TREE_Char shiftedChars[] = {
-			'{',
-			'|',
-			'}',
-			'"',
-		};
-		TREE_Size index = key - TREE_KEY_LEFT_BRACKET;
-		return isShiftPressed ? shiftedChars[index] : normalChars[index];
-	}
+		_TREE_Surface_EncodeColor(encoder, _TREE_Surface_GetForeground(image, cellIndex), _TREE_Surface_GetBackground(image, cellIndex));
 
-	// handle numpad keys (if Num Lock is on)
-	if (key >= TREE_KEY_NUMPAD_0 && key <= TREE_KEY_NUMPAD_9)
-	{
-		TREE_Bool isNumLockOn = (modifiers & TREE_KEY_MODIFIER_FLAGS_NUM_LOCK) != 0;
-		if (isNumLockOn)
+		// pick the shortest way to print them: as they are, repeated, or erased with the background color
+		TREE_Size length = (TREE_Size)count;
+		TREE_Char final = '\0';
+		if ((surface->features & TREE_SURFACE_FEATURE_FLAGS_REPEAT) && count > 1)
 		{
-			return (TREE_Char)(key - TREE_KEY_NUMPAD_0 + '0'); // Convert to corresponding number
+			TREE_Size repeatLength = 1 + _TREE_Surface_GetSequenceLength((TREE_UInt)(count - 1));
+			if (repeatLength < length)
+			{
+				length = repeatLength;
+				final = 'b';
+			}
+		}
+		if ((surface->features & TREE_SURFACE_FEATURE_FLAGS_ERASE) && image->text[cellIndex] == ' ' && !encoder->wrapping)
+		{
+			// erasing does not move the cursor, so it has to be moved afterwards
+			TREE_Size eraseLength;
+			if (groupEnd == width)
+			{
+				eraseLength = _TREE_Surface_GetSequenceLength(1) + (y + 1 < height ? _TREE_Surface_GetCursorLength(0, y + 1) : 0);
+			}
+			else if (groupEnd == end)
+			{
+				eraseLength = _TREE_Surface_GetSequenceLength((TREE_UInt)count);
+			}
+			else
+			{
+				eraseLength = 2 * _TREE_Surface_GetSequenceLength((TREE_UInt)count);
+			}
+			if (eraseLength < length)
+			{
+				length = eraseLength;
+				final = groupEnd == width ? 'K' : 'X';
+			}
 		}
-	}
-	if (key >= TREE_KEY_MULTIPLY && key <= TREE_KEY_DIVIDE)
-	{
-		static const TREE_Char numpadSymbols[] = {'*', '+', ' ', '-', '.', '/'};
-		return numpadSymbols[key - TREE_KEY_MULTIPLY];
-	}
 
-	// handle other keys
-	switch (key)
-	{
-	case TREE_KEY_SPACE:
-		return ' ';
-	case TREE_KEY_TAB:
-		return '\t';
-	case TREE_KEY_BACKSPACE:
-		return '\b';
-	case TREE_KEY_ENTER:
-		return '\n';
-	case TREE_KEY_ESCAPE:
-		return '\033';
-	default:
-		return '\0'; // Return null for unhandled keys
+		switch (final)
+		{
+		case 'b':
+			encoder->index = _TREE_Surface_WriteString(encoder->output, encoder->index, &image->text[cellIndex], 1);
+			encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, (TREE_UInt)(count - 1), 'b');
+			encoder->cursorX = groupEnd;
+			break;
+		case 'K':
+			encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, 1, 'K');
+			break;
+		case 'X':
+			encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, (TREE_UInt)count, 'X');
+			if (groupEnd < end)
+			{
+				encoder->index = _TREE_Surface_WriteSequence(encoder->output, encoder->index, (TREE_UInt)count, 'C');
+				encoder->cursorX = groupEnd;
+			}
+			break;
+		default:
+			for (TREE_Int i = 0; i < count; ++i)
+			{
+				encoder->index = _TREE_Surface_WriteString(encoder->output, encoder->index, &image->text[cellIndex], 1);
+			}
+			encoder->cursorX = groupEnd;
+			break;
+		}
+
+		// the terminal now shows these cells
+		encoder->wrapping = TREE_FALSE;
+		memset(&front->text[cellIndex], image->text[cellIndex], (TREE_Size)count * sizeof(TREE_Char));
+		memcpy(&front->colors[cellIndex], &image->colors[cellIndex], (TREE_Size)count * sizeof(TREE_ColorPair));
+
+		x = groupEnd;
 	}
 }
 
-TREE_Result TREE_Input_Init(TREE_Input *input)
+TREE_Size _TREE_Surface_Encode(TREE_Surface *surface, TREE_Char *output, TREE_Size index)
 {
-	// validate
-	if (!input)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
+	TREE_Image *image = &surface->image;
+	TREE_Image *front = &surface->front;
+	TREE_Int width = image->extent.width;
+	TREE_Int height = image->extent.height;
+
+	// the cursor position and colors of the terminal are unknown until they are set
+	_TREE_SurfaceEncoder encoder;
+	encoder.surface = surface;
+	encoder.output = output;
+	encoder.index = index;
+	encoder.cursorX = -1;
+	encoder.cursorY = -1;
+	encoder.fgColor = -1;
+	encoder.bgColor = -1;
+	encoder.wrapping = TREE_FALSE;
+
+	for (TREE_Int y = 0; y < height; ++y)
+	{
+		// only look at the damaged span of the row, unless redrawing everything
+		TREE_Int x = 0;
+		TREE_Int end = width;
+		if (!surface->invalid)
+		{
+			x = surface->damageStart[y];
+			end = surface->damageEnd[y];
+		}
+		surface->damageStart[y] = width;
+		surface->damageEnd[y] = 0;
+
+		TREE_Size rowIndex = (TREE_Size)y * width;
+		while (x < end)
+		{
+			// skip cells the terminal already shows
+			if (!surface->invalid)
+			{
+				x = (TREE_Int)(g_findDifference(image->text, front->text, image->colors, front->colors, rowIndex + (TREE_Size)x, rowIndex + (TREE_Size)end) - rowIndex);
+				if (x >= end)
+				{
+					break;
+				}
+			}
 
-	// set data
-	input->keys[0] = TREE_KEY_TAB;
-	input->keys[1] = TREE_KEY_BACKSPACE;
-	input->keys[2] = TREE_KEY_SHIFT;
-	input->keys[3] = TREE_KEY_ENTER;
-	input->keys[4] = TREE_KEY_CONTROL;
-	input->keys[5] = TREE_KEY_ALT;
-	input->keys[6] = TREE_KEY_PAUSE;
-	input->keys[7] = TREE_KEY_CAPS_LOCK;
-	input->keys[8] = TREE_KEY_ESCAPE;
-	input->keys[9] = TREE_KEY_SPACE;
-	input->keys[10] = TREE_KEY_PAGE_UP;
-	input->keys[11] = TREE_KEY_PAGE_DOWN;
-	input->keys[12] = TREE_KEY_END;
-	input->keys[13] = TREE_KEY_HOME;
-	input->keys[14] = TREE_KEY_LEFT_ARROW;
-	input->keys[15] = TREE_KEY_UP_ARROW;
-	input->keys[16] = TREE_KEY_RIGHT_ARROW;
-	input->keys[17] = TREE_KEY_DOWN_ARROW;
-	input->keys[18] = TREE_KEY_PRINT_SCREEN;
-	input->keys[19] = TREE_KEY_INSERT;
-	input->keys[20] = TREE_KEY_DELETE;
-	input->keys[21] = TREE_KEY_0;
-	input->keys[22] = TREE_KEY_1;
-	input->keys[23] = TREE_KEY_2;
-	input->keys[24] = TREE_KEY_3;
-	input->keys[25] = TREE_KEY_4;
-	input->keys[26] = TREE_KEY_5;
-	input->keys[27] = TREE_KEY_6;
-	input->keys[28] = TREE_KEY_7;
-	input->keys[29] = TREE_KEY_8;
-	input->keys[30] = TREE_KEY_9;
-	input->keys[31] = TREE_KEY_A;
-	input->keys[32] = TREE_KEY_B;
-	input->keys[33] = TREE_KEY_C;
-	input->keys[34] = TREE_KEY_D;
-	input->keys[35] = TREE_KEY_E;
-	input->keys[36] = TREE_KEY_F;
-	input->keys[37] = TREE_KEY_G;
-	input->keys[38] = TREE_KEY_H;
-	input->keys[39] = TREE_KEY_I;
-	input->keys[40] = TREE_KEY_J;
-	input->keys[41] = TREE_KEY_K;
-	input->keys[42] = TREE_KEY_L;
-	input->keys[43] = TREE_KEY_M;
-	input->keys[44] = TREE_KEY_N;
-	input->keys[45] = TREE_KEY_O;
-	input->keys[46] = TREE_KEY_P;
-	input->keys[47] = TREE_KEY_Q;
-	input->keys[48] = TREE_KEY_R;
-	input->keys[49] = TREE_KEY_S;
-	input->keys[50] = TREE_KEY_T;
-	input->keys[51] = TREE_KEY_U;
-	input->keys[52] = TREE_KEY_V;
-	input->keys[53] = TREE_KEY_W;
-	input->keys[54] = TREE_KEY_X;
-	input->keys[55] = TREE_KEY_Y;
-	input->keys[56] = TREE_KEY_Z;
-	input->keys[57] = TREE_KEY_F1;
-	input->keys[58] = TREE_KEY_F2;
-	input->keys[59] = TREE_KEY_F3;
-	input->keys[60] = TREE_KEY_F4;
-	input->keys[61] = TREE_KEY_F5;
-	input->keys[62] = TREE_KEY_F6;
-	input->keys[63] = TREE_KEY_F7;
-	input->keys[64] = TREE_KEY_F8;
-	input->keys[65] = TREE_KEY_F9;
-	input->keys[66] = TREE_KEY_F10;
-	input->keys[67] = TREE_KEY_F11;
-	input->keys[68] = TREE_KEY_F12;
-	input->keys[69] = TREE_KEY_NUM_LOCK;
-	input->keys[70] = TREE_KEY_SCROLL_LOCK;
-	input->keys[71] = TREE_KEY_NUMPAD_0;
-	input->keys[72] = TREE_KEY_NUMPAD_1;
-	input->keys[73] = TREE_KEY_NUMPAD_2;
-	input->keys[74] = TREE_KEY_NUMPAD_3;
-	input->keys[75] = TREE_KEY_NUMPAD_4;
-	input->keys[76] = TREE_KEY_NUMPAD_5;
-	input->keys[77] = TREE_KEY_NUMPAD_6;
-	input->keys[78] = TREE_KEY_NUMPAD_7;
-	input->keys[79] = TREE_KEY_NUMPAD_8;
-	input->keys[80] = TREE_KEY_NUMPAD_9;
-	input->keys[81] = TREE_KEY_MULTIPLY;
-	input->keys[82] = TREE_KEY_ADD;
-	input->keys[83] = TREE_KEY_SUBTRACT;
-	input->keys[84] = TREE_KEY_DECIMAL;
-	input->keys[85] = TREE_KEY_DIVIDE;
-	input->keys[86] = TREE_KEY_SEMICOLON;
-	input->keys[87] = TREE_KEY_EQUALS;
-	input->keys[88] = TREE_KEY_COMMA;
-	input->keys[89] = TREE_KEY_MINUS;
-	input->keys[90] = TREE_KEY_PERIOD;
-	input->keys[91] = TREE_KEY_SLASH;
-	input->keys[92] = TREE_KEY_TILDE;
-	input->keys[93] = TREE_KEY_LEFT_BRACKET;
-	input->keys[94] = TREE_KEY_BACKSLASH;
-	input->keys[95] = TREE_KEY_RIGHT_BRACKET;
-	input->keys[96] = TREE_KEY_APOSTROPHE;
+			// find the end of the changed run
+			TREE_Int runEnd = x + 1;
+			while (runEnd < end && _TREE_Surface_IsChanged(surface, rowIndex + (TREE_Size)runEnd))
+			{
+				++runEnd;
+			}
 
-	for (TREE_Size i = 0; i <= TREE_KEY_MAX; i++)
+			_TREE_Surface_EncodeMove(&encoder, x, y);
+			_TREE_Surface_EncodeRun(&encoder, y, x, runEnd);
+			x = runEnd;
+		}
+	}
+
+	// reset the colors, if anything was printed
+	if (encoder.index != index)
 	{
-		input->states[i] = TREE_INPUT_STATE_RELEASED;
+		encoder.index = _TREE_Surface_WriteString(output, encoder.index, "\033[0m", _TREE_SURFACE_RESET_LENGTH);
 	}
 
-	return TREE_OK;
+	return encoder.index;
 }
 
-void TREE_Input_Free(TREE_Input *input)
+TREE_Size _TREE_Surface_HashRow(TREE_Image const *image, TREE_Int y, TREE_Int start, TREE_Int end)
 {
-	// validate
-	if (!input)
+	// FNV-1a over the text and the colors of the row
+	TREE_Size rowIndex = (TREE_Size)y * (TREE_Size)image->extent.width;
+	TREE_Size hash = 14695981039346656037ull;
+	for (TREE_Int x = start; x < end; ++x)
 	{
-		return;
+		hash = (hash ^ (TREE_Byte)image->text[rowIndex + (TREE_Size)x]) * 1099511628211ull;
+		hash = (hash ^ image->colors[rowIndex + (TREE_Size)x]) * 1099511628211ull;
 	}
-
-	// nothing to free
+	return hash;
 }
 
-TREE_EXTERN TREE_Result TREE_Input_Refresh(TREE_Input *input)
+TREE_Int _TREE_Surface_FindShift(TREE_Surface const *surface, TREE_Int top, TREE_Int bottom, TREE_Int *matchCount)
 {
-	// validate
-	if (!input)
+	TREE_Size const *imageHashes = surface->rowHashes;
+	TREE_Size const *frontHashes = &surface->rowHashes[surface->image.extent.height];
+	TREE_Int count = bottom - top + 1;
+
+	// find the shift that moves the most changed rows into place, preferring shorter shifts
+	TREE_Int bestShift = 0;
+	TREE_Int bestMatches = 0;
+	for (TREE_Int distance = 1; distance < count; ++distance)
 	{
-		return TREE_ERROR_ARG_NULL;
+		for (TREE_Int sign = 1; sign >= -1; sign -= 2)
+		{
+			// a positive shift moves the rows up, so row y shows what row y + shift showed
+			TREE_Int shift = distance * sign;
+			TREE_Int matches = 0;
+			for (TREE_Int y = MAX(top, top - shift); y <= MIN(bottom, bottom - shift); ++y)
+			{
+				if (imageHashes[y] == frontHashes[y + shift] && imageHashes[y] != frontHashes[y])
+				{
+					++matches;
+				}
+			}
+			if (matches > bestMatches)
+			{
+				bestShift = shift;
+				bestMatches = matches;
+			}
+		}
 	}
 
-// get new key states
-#ifdef TREE_WINDOWS
-	for (TREE_Size i = 0; i < TREE_KEY_COUNT; i++)
-	{
-		// get key at index
-		TREE_Key key = input->keys[i];
+	*matchCount = bestMatches;
+	return bestShift;
+}
 
-		// set the key state
-		input->states[key] = (GetAsyncKeyState(key) & 0x8000) ? TREE_TRUE : TREE_FALSE;
+void _TREE_Surface_ShiftFront(TREE_Surface *surface, TREE_Int top, TREE_Int bottom, TREE_Int left, TREE_Int right, TREE_Int shift)
+{
+	TREE_Image *front = &surface->front;
+	TREE_Size width = (TREE_Size)front->extent.width;
+	TREE_Size length = (TREE_Size)(right - left);
+
+	// move the rows the same way the terminal does
+	if (shift > 0)
+	{
+		for (TREE_Int y = top; y <= bottom - shift; ++y)
+		{
+			TREE_Size index = (TREE_Size)y * width + (TREE_Size)left;
+			TREE_Size sourceIndex = (TREE_Size)(y + shift) * width + (TREE_Size)left;
+			memcpy(&front->text[index], &front->text[sourceIndex], length * sizeof(TREE_Char));
+			memcpy(&front->colors[index], &front->colors[sourceIndex], length * sizeof(TREE_ColorPair));
+		}
 	}
-#else // TREE_LINUX
-	// open the keyboard event file
-	int fd = open(g_keyboardDevicePath, O_RDONLY | O_NONBLOCK); // | O_NONBLOCK
-	if (fd < 0)
+	else
 	{
-		return TREE_ERROR_LINUX_KEYBOARD_OPEN;
+		for (TREE_Int y = bottom; y >= top - shift; --y)
+		{
+			TREE_Size index = (TREE_Size)y * width + (TREE_Size)left;
+			TREE_Size sourceIndex = (TREE_Size)(y + shift) * width + (TREE_Size)left;
+			memcpy(&front->text[index], &front->text[sourceIndex], length * sizeof(TREE_Char));
+			memcpy(&front->colors[index], &front->colors[sourceIndex], length * sizeof(TREE_ColorPair));
+		}
 	}
 
-	// map KEY_ to TREE_Key
-	// 127 is KEY_COMPOSE, which is the highest key value used in TREE
-	static TREE_Byte keyMap[128] =
-		{
-			TREE_KEY_NONE,			// 0
-			TREE_KEY_ESCAPE,		// 1
-			TREE_KEY_1,				// 2
-			TREE_KEY_2,				// 3
-			TREE_KEY_3,				// 4
-			TREE_KEY_4,				// 5
-			TREE_KEY_5,				// 6
-			TREE_KEY_6,				// 7
-			TREE_KEY_7,				// 8
-			TREE_KEY_8,				// 9
-			TREE_KEY_9,				// 10
-			TREE_KEY_0,				// 11
-			TREE_KEY_MINUS,			// 12
-			TREE_KEY_EQUALS,		// 13
-			TREE_KEY_BACKSPACE,		// 14
-			TREE_KEY_TAB,			// 15
-			TREE_KEY_Q,				// 16
-			TREE_KEY_W,				// 17
-			TREE_KEY_E,				// 18
-			TREE_KEY_R,				// 19
-			TREE_KEY_T,				// 20
-			TREE_KEY_Y,				// 21
-			TREE_KEY_U,				// 22
-			TREE_KEY_I,				// 23
-			TREE_KEY_O,				// 24
-			TREE_KEY_P,				// 25
-			TREE_KEY_LEFT_BRACKET,	// 26
-			TREE_KEY_RIGHT_BRACKET, // 27
-			TREE_KEY_ENTER,			// 28
-			TREE_KEY_LEFT_CONTROL,	// 29
-			TREE_KEY_A,				// 30
-			TREE_KEY_S,				// 31
-			TREE_KEY_D,				// 32
-			TREE_KEY_F,				// 33
-			TREE_KEY_G,				// 34
-			TREE_KEY_H,				// 35
-			TREE_KEY_J,				// 36
-			TREE_KEY_K,				// 37
-			TREE_KEY_L,				// 38
-			TREE_KEY_SEMICOLON,		// 39
-			TREE_KEY_APOSTROPHE,	// 40
-			TREE_KEY_TILDE,			// 41
-			TREE_KEY_LEFT_SHIFT,	// 42
-			TREE_KEY_BACKSLASH,		// 43
-			TREE_KEY_Z,				// 44
-			TREE_KEY_X,				// 45
-			TREE_KEY_C,				// 46
-			TREE_KEY_V,				// 47
-			TREE_KEY_B,				// 48
-			TREE_KEY_N,				// 49
-			TREE_KEY_M,				// 50
-			TREE_KEY_COMMA,			// 51
-			TREE_KEY_PERIOD,		// 52
-			TREE_KEY_SLASH,			// 53
-			TREE_KEY_RIGHT_SHIFT,	// 54
-			TREE_KEY_MULTIPLY,		// 55
-			TREE_KEY_LEFT_ALT,		// 56
-			TREE_KEY_SPACE,			// 57
-			TREE_KEY_CAPS_LOCK,		// 58
-			TREE_KEY_F1,			// 59
-			TREE_KEY_F2,			// 60
-			TREE_KEY_F3,			// 61
-			TREE_KEY_F4,			// 62
-			TREE_KEY_F5,			// 63
-			TREE_KEY_F6,			// 64
-			TREE_KEY_F7,			// 65
-			TREE_KEY_F8,			// 66
-			TREE_KEY_F9,			// 67
-			TREE_KEY_F10,			// 68
-			TREE_KEY_NUM_LOCK,		// 69
-			TREE_KEY_SCROLL_LOCK,	// 70
-			TREE_KEY_NUMPAD_7,		// 71
-			TREE_KEY_NUMPAD_8,		// 72
-			TREE_KEY_NUMPAD_9,		// 73
-			TREE_KEY_SUBTRACT,		// 74
-			TREE_KEY_NUMPAD_4,		// 75
-			TREE_KEY_NUMPAD_5,		// 76
-			TREE_KEY_NUMPAD_6,		// 77
-			TREE_KEY_ADD,			// 78
-			TREE_KEY_NUMPAD_1,		// 79
-			TREE_KEY_NUMPAD_2,		// 80
-			TREE_KEY_NUMPAD_3,		// 81
-			TREE_KEY_NUMPAD_0,		// 82
-			TREE_KEY_DECIMAL,		// 83
-			TREE_KEY_NONE,			// 84
-			TREE_KEY_NONE,			// 85
-			TREE_KEY_NONE,			// 86
-			TREE_KEY_F11,			// 87
-			TREE_KEY_F12,			// 88
-			TREE_KEY_NONE,			// 89
-			TREE_KEY_NONE,			// 90
-			TREE_KEY_NONE,			// 91
-			TREE_KEY_NONE,			// 92
-			TREE_KEY_NONE,			// 93
-			TREE_KEY_NONE,			// 94
-			TREE_KEY_NONE,			// 95
-			TREE_KEY_ENTER,			// 96
-			TREE_KEY_RIGHT_CONTROL, // 97
-			TREE_KEY_DIVIDE,		// 98
-			TREE_KEY_PRINT_SCREEN,	// 99
-			TREE_KEY_RIGHT_ALT,		// 100
-			TREE_KEY_ENTER,			// 101
-			TREE_KEY_HOME,			// 102
-			TREE_KEY_UP_ARROW,		// 103
-			TREE_KEY_PAGE_UP,		// 104
-			TREE_KEY_LEFT_ARROW,	// 105
-			TREE_KEY_RIGHT_ARROW,	// 106
-			TREE_KEY_END,			// 107
-			TREE_KEY_DOWN_ARROW,	// 108
-			TREE_KEY_PAGE_DOWN,		// 109
-			TREE_KEY_INSERT,		// 110
-			TREE_KEY_DELETE,		// 111
-			TREE_KEY_NONE,			// 112
-			TREE_KEY_NONE,			// 113
-			TREE_KEY_NONE,			// 114
-			TREE_KEY_NONE,			// 115
-			TREE_KEY_NONE,			// 116
-			TREE_KEY_EQUALS,		// 117
-			TREE_KEY_NONE,			// 118
-			TREE_KEY_PAUSE,			// 119
-			TREE_KEY_NONE,			// 120
-
-			TREE_KEY_NONE,			// 121
-			TREE_KEY_NONE,			// 122
-			TREE_KEY_NONE,			// 123
-			TREE_KEY_NONE,			// 124
-			TREE_KEY_LEFT_COMMAND,	// 125
-			TREE_KEY_RIGHT_COMMAND, // 126
-			TREE_KEY_APPLICATION,	// 127
-		};
-	// poll events from the keyboard device
-	struct pollfd pfd;
-	pfd.fd = fd;
-	pfd.events = POLLIN;				  // only read events
-	int pollResult = poll(&pfd, 1, 1000); // 1 s timeout
-	if (pollResult < 0)
+	// the rows scrolled into view are blank in an unknown color, so they never match the Image
+	TREE_Int exposedTop = shift > 0 ? bottom - shift + 1 : top;
+	TREE_Int exposedBottom = shift > 0 ? bottom : top - shift - 1;
+	for (TREE_Int y = exposedTop; y <= exposedBottom; ++y)
 	{
-		close(fd);
-		return TREE_ERROR_LINUX_KEYBOARD_POLL;
+		memset(&front->text[(TREE_Size)y * width + (TREE_Size)left], '\0', length * sizeof(TREE_Char));
 	}
-	else if (pollResult <= 0)
+}
+
+TREE_Size _TREE_Surface_Scroll(TREE_Surface *surface, TREE_Char *output, TREE_Size index)
+{
+	// scrolling only helps if the terminal shows the previous frame
+	if (surface->invalid || !(surface->features & TREE_SURFACE_FEATURE_FLAGS_SCROLL))
 	{
-		// no events, return
-		close(fd);
-		return TREE_OK;
+		return index;
 	}
 
-	// read the keyboard events
-	struct input_event ev;
-	while (TREE_TRUE)
+	TREE_Image *image = &surface->image;
+	TREE_Int width = image->extent.width;
+	TREE_Int height = image->extent.height;
+	TREE_Size *imageHashes = surface->rowHashes;
+	TREE_Size *frontHashes = &surface->rowHashes[height];
+	TREE_Bool scrolled = TREE_FALSE;
+	TREE_Bool marginsEnabled = TREE_FALSE;
+
+	TREE_Int y = 0;
+	while (y < height)
 	{
-		ssize_t bytesRead = read(fd, &ev, sizeof(struct input_event));
-		if (bytesRead < 0)
+		// find the next band of damaged rows
+		if (surface->damageStart[y] >= surface->damageEnd[y])
 		{
-			if (errno == EAGAIN)
-			{
-				break;
-			}
-
-			// if not EAGAIN, an error occurred
-			close(fd);
-			return TREE_ERROR_LINUX_KEYBOARD_READ;
+			++y;
+			continue;
 		}
-		if (bytesRead == 0)
+		TREE_Int top = y;
+		TREE_Int left = surface->damageStart[y];
+		TREE_Int right = surface->damageEnd[y];
+		while (y + 1 < height && surface->damageStart[y + 1] < surface->damageEnd[y + 1])
 		{
-			// no more events, break
-			break;
+			++y;
+			left = MIN(left, surface->damageStart[y]);
+			right = MAX(right, surface->damageEnd[y]);
 		}
+		TREE_Int bottom = y++;
 
-		// handle the event
-		if (ev.type == EV_KEY && ev.code <= 128)
+		// the terminal scrolls whole rows, unless it supports left and right margins
+		TREE_Bool useMargins = (surface->features & TREE_SURFACE_FEATURE_FLAGS_MARGINS) && (left > 0 || right < width);
+		if (!useMargins)
 		{
-			// get the key code as TREE_Key
-			TREE_Key key = (TREE_Key)keyMap[ev.code];
+			left = 0;
+			right = width;
+		}
 
-			// save if pressed or released
-			input->states[key] = ev.value ? TREE_TRUE : TREE_FALSE;
+		// a scroll region needs at least two rows, and one more to scroll something into place
+		if (bottom - top < 2)
+		{
+			continue;
 		}
-	}
 
-	close(fd);
-#endif
+		for (TREE_Int row = top; row <= bottom; ++row)
+		{
+			imageHashes[row] = _TREE_Surface_HashRow(image, row, left, right);
+			frontHashes[row] = _TREE_Surface_HashRow(&surface->front, row, left, right);
+		}
 
-	// get modifiers from new states
-	TREE_KeyModifierFlags modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
-	if (input->states[TREE_KEY_LEFT_SHIFT] || input->states[TREE_KEY_RIGHT_SHIFT] || input->states[TREE_KEY_SHIFT])
-	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_SHIFT;
-	}
-	if (input->states[TREE_KEY_LEFT_CONTROL] || input->states[TREE_KEY_RIGHT_CONTROL] || input->states[TREE_KEY_CONTROL])
-	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_CONTROL;
+		// only scroll if it saves more than it costs
+		TREE_Int matches;
+		TREE_Int shift = _TREE_Surface_FindShift(surface, top, bottom, &matches);
+		if (!shift || (TREE_Size)matches * (TREE_Size)(right - left) <= _TREE_SURFACE_SCROLL_LENGTH)
+		{
+			continue;
+		}
+
+		// set the margins, then scroll up (SU) or down (SD)
+		if (useMargins)
+		{
+			if (!marginsEnabled)
+			{
+				index = _TREE_Surface_WriteString(output, index, "\033[?69h", 6);
+				marginsEnabled = TREE_TRUE;
+			}
+			index = _TREE_Surface_WriteString(output, index, "\033[", 2);
+			index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)(left + 1));
+			index = _TREE_Surface_WriteString(output, index, ";", 1);
+			index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)right);
+			index = _TREE_Surface_WriteString(output, index, "s", 1);
+		}
+		else if (marginsEnabled)
+		{
+			index = _TREE_Surface_WriteString(output, index, "\033[s", 3);
+		}
+		index = _TREE_Surface_WriteString(output, index, "\033[", 2);
+		index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)(top + 1));
+		index = _TREE_Surface_WriteString(output, index, ";", 1);
+		index = _TREE_Surface_WriteNumber(output, index, (TREE_UInt)(bottom + 1));
+		index = _TREE_Surface_WriteString(output, index, "r", 1);
+		index = _TREE_Surface_WriteSequence(output, index, (TREE_UInt)(shift > 0 ? shift : -shift), shift > 0 ? 'S' : 'T');
+		scrolled = TREE_TRUE;
+
+		_TREE_Surface_ShiftFront(surface, top, bottom, left, right, shift);
+
+		// the whole scrolled area has to be compared again
+		for (TREE_Int row = top; row <= bottom; ++row)
+		{
+			surface->damageStart[row] = MIN(surface->damageStart[row], left);
+			surface->damageEnd[row] = MAX(surface->damageEnd[row], right);
+		}
 	}
-	if (input->states[TREE_KEY_LEFT_ALT] || input->states[TREE_KEY_RIGHT_ALT] || input->states[TREE_KEY_ALT])
+
+	// reset the margins, which also moved the cursor to the top left
+	if (scrolled)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+		index = _TREE_Surface_WriteString(output, index, "\033[r", 3);
 	}
-	if (input->states[TREE_KEY_LEFT_COMMAND] || input->states[TREE_KEY_RIGHT_COMMAND])
+	if (marginsEnabled)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_COMMAND;
+		index = _TREE_Surface_WriteString(output, index, "\033[?69l", 6);
 	}
-#ifdef TREE_WINDOWS
-	if (GetKeyState(VK_CAPITAL) & 0x0001)
+
+	return index;
+}
+
+TREE_Result TREE_Surface_Init(TREE_Surface *surface, TREE_Extent size)
+{
+	// validate
+	if (!surface)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK;
+		return TREE_ERROR_ARG_NULL;
 	}
-	if (GetKeyState(VK_NUMLOCK) & 0x0001)
+	if (size.width == 0 || size.height == 0)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_NUM_LOCK;
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
-	if (GetKeyState(VK_SCROLL) & 0x0001)
+
+	// initialize image
+	TREE_Result code = TREE_Image_Init(&surface->image, size);
+	if (code)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_SCROLL_LOCK;
+		return code;
 	}
-#else
-	if (input->states[TREE_KEY_CAPS_LOCK])
+
+	// initialize front image
+	code = TREE_Image_Init(&surface->front, size);
+	if (code)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK;
+		TREE_Image_Free(&surface->image);
+		return code;
 	}
-	if (input->states[TREE_KEY_NUM_LOCK])
+
+	// use every optional sequence that common terminals support
+	surface->features = TREE_SURFACE_FEATURE_FLAGS_DEFAULT;
+
+	// nothing is damaged yet, the first refresh prints everything
+	surface->invalid = TREE_TRUE;
+	surface->damageStart = NULL;
+	surface->damageEnd = NULL;
+	surface->rowHashes = NULL;
+	code = _TREE_Surface_Match(surface);
+	if (code)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_NUM_LOCK;
+		TREE_DELETE(surface->damageStart);
+		TREE_DELETE(surface->damageEnd);
+		TREE_DELETE(surface->rowHashes);
+		TREE_Image_Free(&surface->front);
+		TREE_Image_Free(&surface->image);
+		return code;
 	}
-	if (input->states[TREE_KEY_SCROLL_LOCK])
+
+	// initialize text, large enough for any frame of this size
+	surface->text = NULL;
+	surface->textCapacity = 0;
+	code = _TREE_Surface_Reserve(surface, size);
+	if (code)
 	{
-		modifiers |= TREE_KEY_MODIFIER_FLAGS_SCROLL_LOCK;
+		TREE_DELETE(surface->damageStart);
+		TREE_DELETE(surface->damageEnd);
+		TREE_DELETE(surface->rowHashes);
+		TREE_Image_Free(&surface->front);
+		TREE_Image_Free(&surface->image);
+		return code;
 	}
-#endif
-	input->modifiers = modifiers;
+
+	// set data
+	surface->text[0] = '\0';
+	surface->textSize = 0;
+	surface->textWritten = 0;
+	surface->writing = TREE_FALSE;
+	surface->droppedFrames = 0;
+	surface->coalescedFrames = 0;
+	surface->framesDropped = TREE_FALSE;
 
 	return TREE_OK;
 }
 
-TREE_Direction TREE_Direction_Opposite(TREE_Direction direction)
+void TREE_Surface_Free(TREE_Surface *surface)
 {
-	// if none, no opposite
-	if (direction == TREE_DIRECTION_NONE)
+	// validate
+	if (!surface)
 	{
-		return TREE_DIRECTION_NONE;
+		return;
 	}
 
-	// add 2 to invert it
-	return (TREE_Direction)(((TREE_Size)direction + 1) % 4 + 1);
+	// free data
+	TREE_Image_Free(&surface->image);
+	TREE_Image_Free(&surface->front);
+	TREE_DELETE(surface->damageStart);
+	TREE_DELETE(surface->damageEnd);
+	TREE_DELETE(surface->rowHashes);
+	TREE_DELETE(surface->text);
+	surface->textSize = 0;
+	surface->textCapacity = 0;
+	surface->textWritten = 0;
+	surface->writing = TREE_FALSE;
 }
 
-TREE_Result TREE_Transform_Init(TREE_Transform *transform, TREE_Offset localOffset, TREE_Pivot localPivot, TREE_Extent localExtent, TREE_Alignment localAlignment)
+TREE_Result TREE_Surface_Refresh(TREE_Surface *surface)
 {
-	// validate
-	if (!transform)
+	if (!surface)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set data
-	transform->localOffset = localOffset;
-	transform->localPivot = localPivot;
-	transform->localExtent = localExtent;
-	transform->localAlignment = localAlignment;
-	transform->parent = NULL;
-	transform->child = NULL;
-	transform->sibling = NULL;
-	transform->dirty = TREE_TRUE;
-	transform->globalRect.offset.x = 0;
-	transform->globalRect.offset.y = 0;
-	transform->globalRect.extent.width = 0;
-	transform->globalRect.extent.height = 0;
-
-	return TREE_OK;
-}
+	TREE_Result result;
+	TREE_Image *image = &surface->image;
 
-void TREE_Transform_Free(TREE_Transform *transform)
-{
-}
+	// the last frame is still being written, so drop this one and keep its damage for the next
+	if (surface->writing)
+	{
+		++surface->droppedFrames;
+		surface->framesDropped = TREE_TRUE;
+		return TREE_OK;
+	}
 
-TREE_Result TREE_Transform_Dirty(TREE_Transform *transform)
-{
-	// validate
-	if (!transform)
+	// catch up with a resized Image
+	result = _TREE_Surface_Match(surface);
+	if (result)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return result;
 	}
 
-	// mark as dirty
-	transform->dirty = TREE_TRUE;
+	// make sure the worst case fits, only allocates when the Surface grew
+	result = _TREE_Surface_Reserve(surface, image->extent);
+	if (result)
+	{
+		return result;
+	}
 
-	// mark children as dirty
-	TREE_Transform *child = transform->child;
-	while (child)
+	// have the terminal show the frame all at once
+	TREE_Size start = 0;
+	if (surface->features & TREE_SURFACE_FEATURE_FLAGS_SYNCHRONIZE)
 	{
-		TREE_Transform_Dirty(child);
-		child = child->sibling;
+		start = _TREE_Surface_WriteString(surface->text, start, "\033[?2026h", _TREE_SURFACE_SYNCHRONIZE_LENGTH);
 	}
 
-	return TREE_OK;
-}
+	// scroll the terminal where rows only moved, then print what is still different
+	TREE_Size index = _TREE_Surface_Scroll(surface, surface->text, start);
+	index = _TREE_Surface_Encode(surface, surface->text, index);
 
-TREE_Result TREE_Transform_SetParent(TREE_Transform *transform, TREE_Transform *parent)
-{
-	// validate
-	if (!transform)
+	// end the frame, or leave the text empty if nothing changed
+	if (index == start)
 	{
-		return TREE_ERROR_ARG_NULL;
+		index = 0;
 	}
-
-	// ignore if no change
-	if (transform->parent == parent)
+	else if (start)
 	{
-		return TREE_OK;
+		index = _TREE_Surface_WriteString(surface->text, index, "\033[?2026l", _TREE_SURFACE_SYNCHRONIZE_LENGTH);
 	}
 
-	// unconnect from old family
-	if (transform->parent)
-	{
-		TREE_Transform *firstSibling = transform->parent->child;
+	// add null terminator
+	surface->text[index] = '\0';
+	surface->textSize = index;
+	surface->textWritten = 0;
 
-		if (firstSibling == transform)
-		{
-			// if this is the first child, set the parent's child to the next sibling
-			transform->parent->child = transform->sibling;
-		}
-		else
-		{
-			// find the previous sibling
-			TREE_Transform *sibling = firstSibling;
-			while (sibling && sibling->sibling != transform)
-			{
-				sibling = sibling->sibling;
-			}
-			// connect to next sibling
-			if (sibling)
-			{
-				sibling->sibling = transform->sibling;
-			}
-		}
+	if (index >= surface->textCapacity)
+	{
+		return TREE_ERROR_OVERFLOW;
 	}
 
-	// set new parent
-	transform->sibling = NULL;
-	transform->parent = parent;
-
-	// connect to new family
-	if (parent)
+	// this frame also carries the changes of the frames dropped before it
+	if (surface->framesDropped)
 	{
-		// if the parent has no children, set this as the first child
-		if (!parent->child)
+		if (index)
 		{
-			parent->child = transform;
-		}
-		else
-		{
-			// otherwise, find the last sibling and set this as the next sibling
-			TREE_Transform *lastSibling = parent->child;
-			while (lastSibling->sibling)
-			{
-				lastSibling = lastSibling->sibling;
-			}
-			lastSibling->sibling = transform;
+			++surface->coalescedFrames;
 		}
+		surface->framesDropped = TREE_FALSE;
 	}
 
-	// mark as dirty
-	return TREE_Transform_Dirty(transform);
+	// the terminal matches the front image again
+	surface->invalid = TREE_FALSE;
+
+	return TREE_OK;
 }
 
-TREE_Result TREE_Transform_DisconnectChildren(TREE_Transform *transform)
+TREE_Result TREE_Surface_Damage(TREE_Surface *surface, TREE_Rect const *rect)
 {
 	// validate
-	if (!transform)
+	if (!surface || !rect)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// if no children, nothing to do
-	if (!transform->child)
+	// catch up with a resized Image
+	TREE_Result result = _TREE_Surface_Match(surface);
+	if (result)
 	{
-		return TREE_OK;
+		return result;
 	}
 
-	// disconnect all children from this parent, and each sibling
-	TREE_Transform *child = transform->child;
-	while (child)
+	// clip to the Surface
+	TREE_Extent extent = surface->image.extent;
+	TREE_Int startX = MAX(rect->offset.x, 0);
+	TREE_Int startY = MAX(rect->offset.y, 0);
+	TREE_Int endX = MIN(rect->offset.x + rect->extent.width, extent.width);
+	TREE_Int endY = MIN(rect->offset.y + rect->extent.height, extent.height);
+	if (startX >= endX)
 	{
-		TREE_Transform *nextSibling = child->sibling;
-		child->parent = NULL;  // disconnect from parent
-		child->sibling = NULL; // disconnect from siblings
-		TREE_Result result = TREE_Transform_Dirty(child);
-		if (result)
-		{
-			return result;
-		}
-		child = nextSibling; // move to next sibling
+		return TREE_OK;
 	}
 
-	// set child to NULL
-	transform->child = NULL;
-
-	// mark as dirty
-	TREE_Transform_Dirty(transform);
+	// widen the damaged span of each row
+	for (TREE_Int y = startY; y < endY; ++y)
+	{
+		surface->damageStart[y] = MIN(surface->damageStart[y], startX);
+		surface->damageEnd[y] = MAX(surface->damageEnd[y], endX);
+	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Transform_Refresh(TREE_Transform *transform, TREE_Extent windowExtent)
+TREE_Result TREE_Surface_Invalidate(TREE_Surface *surface)
 {
 	// validate
-	if (!transform)
+	if (!surface)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// calculate global rectangle
+	surface->invalid = TREE_TRUE;
 
-	// is parent offset and extent if there is one
-	// otherwise use origin and window extent
-	TREE_Transform *parent = transform->parent;
-	TREE_Offset offset;
-	TREE_Extent extent;
-	if (parent)
+	return TREE_OK;
+}
+
+TREE_Result _TREE_Window_FlushOutput(void)
+{
+#ifdef TREE_LINUX
+	// stdio drops what it could not write when the terminal is busy, so let it block for the few bytes it holds
+	if (g_nonBlockingOutput && __fpending(stdout))
 	{
-		offset = parent->globalRect.offset;
-		extent = parent->globalRect.extent;
+		int flags = fcntl(STDOUT_FILENO, F_GETFL);
+		if (flags < 0 || fcntl(STDOUT_FILENO, F_SETFL, flags & ~O_NONBLOCK) < 0)
+		{
+			return TREE_ERROR_PRESENTATION;
+		}
+		int failed = fflush(stdout);
+		if (fcntl(STDOUT_FILENO, F_SETFL, flags) < 0 || failed)
+		{
+			return TREE_ERROR_PRESENTATION;
+		}
+		return TREE_OK;
 	}
-	else
+#endif
+	return fflush(stdout) ? TREE_ERROR_PRESENTATION : TREE_OK;
+}
+
+TREE_Result TREE_Window_SetTitle(TREE_String title)
+{
+#ifdef TREE_WINDOWS
+	if (!SetConsoleTitleA(title))
 	{
-		offset = (TREE_Offset){0, 0};
-		extent = windowExtent;
+		return TREE_ERROR_WINDOW_SET_TITLE;
 	}
-
-	TREE_Alignment alignment = transform->localAlignment;
-	TREE_Rect result;
-
-	// top<-->bottom
-	if ((alignment & TREE_ALIGNMENT_VERTICALSTRETCH) == TREE_ALIGNMENT_VERTICALSTRETCH)
-	{
-		result.offset.y = offset.y + transform->localOffset.y;
-		result.extent.height = extent.height - transform->localExtent.height - transform->localOffset.y;
-	}
-	else if (alignment & TREE_ALIGNMENT_TOP)
-	{
-		result.offset.y = offset.y + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
-		result.extent.height = transform->localExtent.height;
-	}
-	else if (alignment & TREE_ALIGNMENT_BOTTOM)
-	{
-		result.offset.y = offset.y + extent.height + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
-		result.extent.height = transform->localExtent.height;
-	}
-	else
-	{
-		result.offset.y = offset.y + (extent.height + transform->localExtent.height) / 2 + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
-		result.extent.height = transform->localExtent.height;
-	}
-
-	// left<-->right
-	if ((alignment & TREE_ALIGNMENT_HORIZONTALSTRETCH) == TREE_ALIGNMENT_HORIZONTALSTRETCH)
-	{
-		result.offset.x = offset.x + transform->localOffset.x;
-		result.extent.width = extent.width - transform->localExtent.width - transform->localOffset.x;
-	}
-	else if (alignment & TREE_ALIGNMENT_LEFT)
-	{
-		result.offset.x = offset.x + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
-		result.extent.width = transform->localExtent.width;
-	}
-	else if (alignment & TREE_ALIGNMENT_RIGHT)
-	{
-		result.offset.x = offset.x + extent.width + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
-		result.extent.width = transform->localExtent.width;
-	}
-	else
-	{
-		result.offset.x = offset.x + (extent.width + transform->localExtent.width) / 2 + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
-		result.extent.width = transform->localExtent.width;
-	}
-
-	// set global rectangle
-	transform->globalRect = result;
-
 	return TREE_OK;
+#elif defined(TREE_LINUX)
+	printf("\033]0;%s\007", title);
+	_TREE_Window_FlushOutput();
+	return TREE_OK;
+#else
+	return TREE_NOT_IMPLEMENTED;
+#endif
 }
 
-TREE_Result TREE_Control_Init(TREE_Control *control, TREE_Transform *parent, TREE_EventHandler eventHandler, TREE_Data data)
+TREE_Result TREE_Window_Present(TREE_Surface *surface)
 {
 	// validate
-	if (!control || !eventHandler)
+	if (!surface)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-
-	TREE_Result result;
-
-	// allocate data
-	control->transform = TREE_NEW(TREE_Transform);
-	if (!control->transform)
+	if (!surface->text)
 	{
-		return TREE_ERROR_ALLOC;
+		return TREE_ERROR_ARG_NULL;
 	}
-	control->image = TREE_NEW(TREE_Image);
-	if (!control->image)
+
+	// nothing left to write since the last refresh
+	if (surface->textWritten >= surface->textSize)
 	{
-		TREE_DELETE(control->transform);
-		return TREE_ERROR_ALLOC;
+		return TREE_OK;
 	}
 
-	// set data
-	control->type = TREE_CONTROL_TYPE_NONE;
-	control->flags = TREE_CONTROL_FLAGS_NONE;
-	control->stateFlags = TREE_CONTROL_STATE_FLAGS_DIRTY;
-	result = TREE_Transform_Init(control->transform, (TREE_Offset){0, 0}, (TREE_Pivot){0.0f, 0.0f}, (TREE_Extent){0, 0}, TREE_ALIGNMENT_TOPLEFT);
+	// anything still buffered by stdio has to come before the frame
+	TREE_Result result = _TREE_Window_FlushOutput();
 	if (result)
 	{
-		TREE_DELETE(control->image);
-		TREE_DELETE(control->transform);
 		return result;
 	}
-	result = TREE_Image_Init(control->image, (TREE_Extent){0, 0});
-	if (result)
+
+	// write the text straight to the console, the text positions the cursor itself
+#ifdef TREE_WINDOWS
+	HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+	while (surface->textWritten < surface->textSize)
 	{
-		TREE_Transform_Free(control->transform);
-		TREE_DELETE(control->image);
-		TREE_DELETE(control->transform);
-		return result;
+		DWORD count;
+		if (!WriteFile(hConsole, &surface->text[surface->textWritten], (DWORD)(surface->textSize - surface->textWritten), &count, NULL))
+		{
+			return TREE_ERROR_PRESENTATION;
+		}
+		surface->textWritten += count;
 	}
-	memset(control->adjacent, 0, 4 * sizeof(TREE_Control *));
-	control->eventHandler = eventHandler;
-	control->data = data;
+#elif defined(TREE_LINUX)
+	while (surface->textWritten < surface->textSize)
+	{
+		ssize_t count = write(STDOUT_FILENO, &surface->text[surface->textWritten], surface->textSize - surface->textWritten);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
 
-	if (parent)
+			// the terminal is busy, the rest is written by a later call
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+			{
+				surface->writing = TREE_TRUE;
+				return TREE_OK;
+			}
+			return TREE_ERROR_PRESENTATION;
+		}
+		surface->textWritten += (TREE_Size)count;
+	}
+#endif
+	surface->writing = TREE_FALSE;
+
+	// the frames dropped while this one was written kept their damage, so write them now instead of when something else changes
+	if (surface->framesDropped)
 	{
-		TREE_Result result = TREE_Transform_SetParent(control->transform, parent);
+		result = TREE_Surface_Refresh(surface);
 		if (result)
 		{
 			return result;
 		}
+		return TREE_Window_Present(surface);
 	}
 
 	return TREE_OK;
 }
 
-void TREE_Control_Free(TREE_Control *control)
+TREE_Bool TREE_Window_IsPresenting(TREE_Surface const *surface)
 {
-	if (!control)
-	{
-		return;
-	}
-
-	// free data
-	TREE_Transform_Free(control->transform);
-	TREE_DELETE(control->transform);
-	TREE_Image_Free(control->image);
-	TREE_DELETE(control->image);
+	return surface && surface->writing;
 }
 
-TREE_Result TREE_Control_Link(TREE_Control *control, TREE_Direction direction, TREE_ControlLink link, TREE_Control *other)
+TREE_Result TREE_Window_Flush(TREE_Surface *surface, TREE_Time timeout)
 {
 	// validate
-	if (!control)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (direction == TREE_DIRECTION_NONE)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
-	if (link != TREE_CONTROL_LINK_NONE && !other)
+	if (!surface)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (!(other->flags & TREE_CONTROL_FLAGS_FOCUSABLE))
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
-
-	// calculate indices
-	TREE_Size index = (TREE_Size)direction - 1;
-	TREE_Direction opposite = TREE_Direction_Opposite(direction);
-	TREE_Size oppositeIndex = (TREE_Size)opposite - 1;
-	TREE_Control *old = control->adjacent[index];
 
-	// perform linking
-	switch (link)
+	TREE_Time endTime = TREE_Time_Now() + timeout;
+	TREE_Result result = TREE_Window_Present(surface);
+	while (!result && TREE_Window_IsPresenting(surface))
 	{
-	case TREE_CONTROL_LINK_NONE:
-		if (old && old->adjacent[oppositeIndex] == control)
+		// wait until the terminal accepts more
+		TREE_Time remaining = timeout < 0 ? -1 : endTime - TREE_Time_Now();
+		if (timeout >= 0 && remaining <= 0)
 		{
-			old->adjacent[oppositeIndex] = NULL;
+			break;
 		}
-		control->adjacent[index] = NULL;
-		break;
-	case TREE_CONTROL_LINK_SINGLE:
-		control->adjacent[index] = other;
-		break;
-	case TREE_CONTROL_LINK_DOUBLE:
-		control->adjacent[index] = other;
-		other->adjacent[oppositeIndex] = control;
-		break;
-	default:
-		return TREE_NOT_IMPLEMENTED;
+#ifdef TREE_LINUX
+		struct pollfd pfd;
+		pfd.fd = STDOUT_FILENO;
+		pfd.events = POLLOUT;
+		if (poll(&pfd, 1, (int)remaining) < 0 && errno != EINTR)
+		{
+			return TREE_ERROR_PRESENTATION;
+		}
+#endif
+		result = TREE_Window_Present(surface);
 	}
 
-	return TREE_OK;
+	return result;
 }
 
-TREE_Result TREE_Control_HandleEvent(TREE_Control *control, TREE_Event const *event)
+TREE_Result TREE_Window_SetNonBlocking(TREE_Bool nonBlocking)
 {
-	// validate
-	if (!control || !event)
+#ifdef TREE_LINUX
+	if (g_nonBlockingOutput == (nonBlocking != TREE_FALSE))
 	{
-		return TREE_ERROR_ARG_NULL;
+		return TREE_OK;
 	}
 
-	// if event handler, call it
-	if (control->eventHandler)
+	// stdio output has to be written while it still can block
+	fflush(stdout);
+
+	int flags = fcntl(STDOUT_FILENO, F_GETFL);
+	if (flags < 0)
 	{
-		return control->eventHandler(event);
+		return TREE_ERROR_PRESENTATION;
+	}
+	flags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+	if (fcntl(STDOUT_FILENO, F_SETFL, flags) < 0)
+	{
+		return TREE_ERROR_PRESENTATION;
 	}
+	g_nonBlockingOutput = nonBlocking != TREE_FALSE;
 
-	// no event handler, so ignore the event
 	return TREE_OK;
+#else
+	return nonBlocking ? TREE_NOT_IMPLEMENTED : TREE_OK;
+#endif
 }
 
-TREE_Size _TREE_ClampScroll(TREE_Size scroll, TREE_Size offset, TREE_Size extent)
+TREE_Bool TREE_Window_SupportsSynchronizedOutput()
 {
-	// adjust scroll
-	if (scroll + extent <= offset)
+	return g_synchronizedOutput;
+}
+
+static TREE_Extent g_windowExtent = {0, 0};
+
+TREE_Extent TREE_Window_GetExtent()
+{
+#ifdef TREE_LINUX
+	// the extent only changes along with a SIGWINCH, which is caught once TREE is initialized
+	if (g_treeInitialized && !g_windowExtentStale)
 	{
-		// scroll towards END
-		return offset + 1 - extent;
+		return g_windowExtent;
 	}
-	else if (scroll > offset)
+	g_windowExtentStale = 0;
+#endif
+
+	TREE_Extent extent;
+	extent.width = 0;
+	extent.height = 0;
+
+#ifdef TREE_WINDOWS
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &csbi))
 	{
-		// scroll towards HOME
-		return offset;
+		extent.width = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+		extent.height = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
 	}
-	return scroll;
+#elif defined(TREE_LINUX)
+	// not a terminal leaves the extent empty
+	struct winsize w;
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == 0)
+	{
+		extent.width = w.ws_col;
+		extent.height = w.ws_row;
+	}
+#endif
+	g_windowExtent = extent;
+
+	return extent;
 }
 
-TREE_Size _TREE_WordWrapPass(TREE_String text, TREE_Size width, TREE_Char ***result, TREE_Size lineCount)
+TREE_EXTERN void TREE_Window_Beep()
 {
-	if (!text || !*text || width == 0)
+#ifdef TREE_WINDOWS
+	MessageBeep(MB_ICONEXCLAMATION);
+#else
+	printf("\a"); // ASCII Bell character
+#endif
+}
+
+TREE_Result TREE_Cursor_SetVisible(TREE_Bool visible)
+{
+	if (visible)
 	{
-		return 0;
+		printf("\033[?25h"); // Show cursor
 	}
-
-	// allocate lines, if count given
-	TREE_Char **lines = NULL;
-	if (result && lineCount > 0)
+	else
 	{
-		lines = TREE_NEW_ARRAY(TREE_Char *, lineCount);
-		if (!lines)
-		{
-			return 0;
-		}
+		printf("\033[?25l"); // Hide cursor
 	}
+	_TREE_Window_FlushOutput();
 
-	// get number of lines
-	TREE_Size count = 0;
-	TREE_Size lastSpace = 0;
-	TREE_Size lastLine = 0;
-	TREE_Size textLength = strlen(text);
-	TREE_Char ch;
-	for (TREE_Size i = 0; i < textLength; i++)
-	{
-		ch = text[i];
+	return TREE_OK;
+}
 
-		if (ch == '\n')
-		{
+TREE_String TREE_Key_ToString(TREE_Key key)
+{
+	switch (key)
+	{
+	case TREE_KEY_NONE:
+		return "None";
+	case TREE_KEY_BACKSPACE:
+		return "Backspace";
+	case TREE_KEY_TAB:
+		return "Tab";
+	case TREE_KEY_ENTER:
+		return "Enter";
+	case TREE_KEY_SHIFT:
+		return "Shift";
+	case TREE_KEY_CONTROL:
+		return "Control";
+	case TREE_KEY_ALT:
+		return "Alt";
+	case TREE_KEY_PAUSE:
+		return "Pause";
+	case TREE_KEY_CAPS_LOCK:
+		return "Caps Lock";
+	case TREE_KEY_ESCAPE:
+		return "Escape";
+	case TREE_KEY_SPACE:
+		return "Space";
+	case TREE_KEY_PAGE_UP:
+		return "Page Up";
+	case TREE_KEY_PAGE_DOWN:
+		return "Page Down";
+	case TREE_KEY_END:
+		return "End";
+	case TREE_KEY_HOME:
+		return "Home";
+	case TREE_KEY_LEFT_ARROW:
+		return "Left Arrow";
+	case TREE_KEY_UP_ARROW:
+		return "Up Arrow";
+	case TREE_KEY_RIGHT_ARROW:
+		return "Right Arrow";
+	case TREE_KEY_DOWN_ARROW:
+		return "Down Arrow";
+	case TREE_KEY_PRINT_SCREEN:
+		return "Print Screen";
+	case TREE_KEY_INSERT:
+		return "Insert";
+	case TREE_KEY_DELETE:
+		return "Delete";
+	case TREE_KEY_0:
+		return "0";
+	case TREE_KEY_1:
+		return "1";
+	case TREE_KEY_2:
+		return "2";
+	case TREE_KEY_3:
+		return "3";
+	case TREE_KEY_4:
+		return "4";
+	case TREE_KEY_5:
+		return "5";
+	case TREE_KEY_6:
+		return "6";
+	case TREE_KEY_7:
+		return "7";
+	case TREE_KEY_8:
+		return "8";
+	case TREE_KEY_9:
+		return "9";
+	case TREE_KEY_A:
+		return "A";
+	case TREE_KEY_B:
+		return "B";
+	case TREE_KEY_C:
+		return "C";
+	case TREE_KEY_D:
+		return "D";
+	case TREE_KEY_E:
+		return "E";
+	case TREE_KEY_F:
+		return "F";
+	case TREE_KEY_G:
+		return "G";
+	case TREE_KEY_H:
+		return "H";
+	case TREE_KEY_I:
+		return "I";
+	case TREE_KEY_J:
+		return "J";
+	case TREE_KEY_K:
+		return "K";
+	case TREE_KEY_L:
+		return "L";
+	case TREE_KEY_M:
+		return "M";
+	case TREE_KEY_N:
+		return "N";
+	case TREE_KEY_O:
+		return "O";
+	case TREE_KEY_P:
+		return "P";
+	case TREE_KEY_Q:
+		return "Q";
+	case TREE_KEY_R:
+		return "R";
+	case TREE_KEY_S:
+		return "S";
+	case TREE_KEY_T:
+		return "T";
+	case TREE_KEY_U:
+		return "U";
+	case TREE_KEY_V:
+		return "V";
+	case TREE_KEY_W:
+		return "W";
+	case TREE_KEY_X:
+		return "X";
+	case TREE_KEY_Y:
+		return "Y";
+	case TREE_KEY_Z:
+		return "Z";
+	case TREE_KEY_NUMPAD_0:
+		return "Numpad 0";
+	case TREE_KEY_NUMPAD_1:
+		return "Numpad 1";
+	case TREE_KEY_NUMPAD_2:
+		return "Numpad 2";
+	case TREE_KEY_NUMPAD_3:
+		return "Numpad 3";
+	case TREE_KEY_NUMPAD_4:
+		return "Numpad 4";
+	case TREE_KEY_NUMPAD_5:
+		return "Numpad 5";
+	case TREE_KEY_NUMPAD_6:
+		return "Numpad 6";
+	case TREE_KEY_NUMPAD_7:
+		return "Numpad 7";
+	case TREE_KEY_NUMPAD_8:
+		return "Numpad 8";
+	case TREE_KEY_NUMPAD_9:
+		return "Numpad 9";
+	case TREE_KEY_MULTIPLY:
+		return "Multiply";
+	case TREE_KEY_ADD:
+		return "Add";
+	case TREE_KEY_SUBTRACT:
+		return "Subtract";
+	case TREE_KEY_DECIMAL:
+		return "Decimal";
+	case TREE_KEY_DIVIDE:
+		return "Divide";
+	case TREE_KEY_F1:
+		return "F1";
+	case TREE_KEY_F2:
+		return "F2";
+	case TREE_KEY_F3:
+		return "F3";
+	case TREE_KEY_F4:
+		return "F4";
+	case TREE_KEY_F5:
+		return "F5";
+	case TREE_KEY_F6:
+		return "F6";
+	case TREE_KEY_F7:
+		return "F7";
+	case TREE_KEY_F8:
+		return "F8";
+	case TREE_KEY_F9:
+		return "F9";
+	case TREE_KEY_F10:
+		return "F10";
+	case TREE_KEY_F11:
+		return "F11";
+	case TREE_KEY_F12:
+		return "F12";
+	case TREE_KEY_NUM_LOCK:
+		return "Num Lock";
+	case TREE_KEY_SCROLL_LOCK:
+		return "Scroll Lock";
+	case TREE_KEY_SEMICOLON:
+		return "Semicolon";
+	case TREE_KEY_EQUALS:
+		return "Equals";
+	case TREE_KEY_COMMA:
+		return "Comma";
+	case TREE_KEY_MINUS:
+		return "Minus";
+	case TREE_KEY_PERIOD:
+		return "Period";
+	case TREE_KEY_SLASH:
+		return "Slash";
+	case TREE_KEY_TILDE:
+		return "Tilde";
+	case TREE_KEY_LEFT_BRACKET:
+		return "Left Bracket";
+	case TREE_KEY_BACKSLASH:
+		return "Backslash";
+	case TREE_KEY_RIGHT_BRACKET:
+		return "Right Bracket";
+	case TREE_KEY_APOSTROPHE:
+		return "Apostrophe";
+	case TREE_KEY_LEFT_CONTROL:
+		return "Left Control";
+	case TREE_KEY_LEFT_SHIFT:
+		return "Left Shift";
+	case TREE_KEY_LEFT_ALT:
+		return "Left Alt";
+	case TREE_KEY_LEFT_COMMAND:
+		return "Left Command";
+	case TREE_KEY_RIGHT_CONTROL:
+		return "Right Control";
+	case TREE_KEY_RIGHT_SHIFT:
+		return "Right Shift";
+	case TREE_KEY_RIGHT_ALT:
+		return "Right Alt";
+	case TREE_KEY_RIGHT_COMMAND:
+		return "Right Command";
+	case TREE_KEY_APPLICATION:
+		return "Application";
+	default:
+		return "Unknown";
+	}
+}
+
+TREE_CharType TREE_Char_GetType(TREE_Char character)
+{
+	// letters
+	if (isalpha(character))
+	{
+		return TREE_CHAR_TYPE_LETTER;
+	}
+
+	// numbers
+	if (isdigit(character))
+	{
+		return TREE_CHAR_TYPE_NUMBER;
+	}
+
+	// whitespace
+	if (isspace(character))
+	{
+		return TREE_CHAR_TYPE_WHITESPACE;
+	}
+
+	// symbols
+	if (ispunct(character))
+	{
+		return TREE_CHAR_TYPE_SYMBOL;
+	}
+
+	return TREE_CHAR_TYPE_NONE;
+}
+
+TREE_Char TREE_Key_ToChar(TREE_Key key, TREE_KeyModifierFlags modifiers)
+{
+	TREE_Bool isShiftPressed = (modifiers & TREE_KEY_MODIFIER_FLAGS_SHIFT) != 0;
+	TREE_Bool isCapsLockOn = (modifiers & TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK) != 0;
+
+	// handle alphabetic characters
+	if (key >= TREE_KEY_A && key <= TREE_KEY_Z)
+	{
+		TREE_Bool isUpperCase = isShiftPressed ^ isCapsLockOn;		 // XOR: Shift or Caps Lock toggles case
+		return isUpperCase ? (TREE_Char)key : (TREE_Char)(key + 32); // Convert to lowercase if not uppercase
+	}
+
+	// handle number keys (0-9) and their shifted symbols
+	if (key >= TREE_KEY_0 && key <= TREE_KEY_9)
+	{
+		if (isShiftPressed)
+		{
+			// Shifted symbols for number keys
+			static const TREE_Char shiftedSymbols[] = {')', '!', '@', '#', '$', '%', '^', '&', '*', '('};
+			return shiftedSymbols[key - TREE_KEY_0];
+		}
+		return (TREE_Char)key;
+	}
+
+	// handle special characters and symbols
+	if (key >= TREE_KEY_SEMICOLON && key <= TREE_KEY_TILDE)
+	{
+		static const TREE_Char normalChars[] = {
+			';', '=', ',', '-', '.', '/', '`'};
+		static const TREE_Char shiftedChars[] = {
+			':', '+', '<', '_', '>', '?', '~'};
+		TREE_Size index = key - TREE_KEY_SEMICOLON;
+		return isShiftPressed ? shiftedChars[index] : normalChars[index];
+	}
+	if (key >= TREE_KEY_LEFT_BRACKET && key <= TREE_KEY_APOSTROPHE)
+	{
+		static const TREE_Char normalChars[] = {
+			'[',
+			'\\',
+			']',
+			'\'',
+		};
+		static const TREE_Char shiftedChars[] = {
+			'{',
+			'|',
+			'}',
+			'"',
+		};
+		TREE_Size index = key - TREE_KEY_LEFT_BRACKET;
+		return isShiftPressed ? shiftedChars[index] : normalChars[index];
+	}
+
+	// handle numpad keys (if Num Lock is on)
+	if (key >= TREE_KEY_NUMPAD_0 && key <= TREE_KEY_NUMPAD_9)
+	{
+		TREE_Bool isNumLockOn = (modifiers & TREE_KEY_MODIFIER_FLAGS_NUM_LOCK) != 0;
+		if (isNumLockOn)
+		{
+			return (TREE_Char)(key - TREE_KEY_NUMPAD_0 + '0'); // Convert to corresponding number
+		}
+	}
+	if (key >= TREE_KEY_MULTIPLY && key <= TREE_KEY_DIVIDE)
+	{
+		static const TREE_Char numpadSymbols[] = {'*', '+', ' ', '-', '.', '/'};
+		return numpadSymbols[key - TREE_KEY_MULTIPLY];
+	}
+
+	// handle other keys
+	switch (key)
+	{
+	case TREE_KEY_SPACE:
+		return ' ';
+	case TREE_KEY_TAB:
+		return '\t';
+	case TREE_KEY_BACKSPACE:
+		return '\b';
+	case TREE_KEY_ENTER:
+		return '\n';
+	case TREE_KEY_ESCAPE:
+		return '\033';
+	default:
+		return '\0'; // Return null for unhandled keys
+	}
+}
+
+TREE_Result TREE_Input_Init(TREE_Input *input)
+{
+	// validate
+	if (!input)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set data
+	input->keys[0] = TREE_KEY_TAB;
+	input->keys[1] = TREE_KEY_BACKSPACE;
+	input->keys[2] = TREE_KEY_SHIFT;
+	input->keys[3] = TREE_KEY_ENTER;
+	input->keys[4] = TREE_KEY_CONTROL;
+	input->keys[5] = TREE_KEY_ALT;
+	input->keys[6] = TREE_KEY_PAUSE;
+	input->keys[7] = TREE_KEY_CAPS_LOCK;
+	input->keys[8] = TREE_KEY_ESCAPE;
+	input->keys[9] = TREE_KEY_SPACE;
+	input->keys[10] = TREE_KEY_PAGE_UP;
+	input->keys[11] = TREE_KEY_PAGE_DOWN;
+	input->keys[12] = TREE_KEY_END;
+	input->keys[13] = TREE_KEY_HOME;
+	input->keys[14] = TREE_KEY_LEFT_ARROW;
+	input->keys[15] = TREE_KEY_UP_ARROW;
+	input->keys[16] = TREE_KEY_RIGHT_ARROW;
+	input->keys[17] = TREE_KEY_DOWN_ARROW;
+	input->keys[18] = TREE_KEY_PRINT_SCREEN;
+	input->keys[19] = TREE_KEY_INSERT;
+	input->keys[20] = TREE_KEY_DELETE;
+	input->keys[21] = TREE_KEY_0;
+	input->keys[22] = TREE_KEY_1;
+	input->keys[23] = TREE_KEY_2;
+	input->keys[24] = TREE_KEY_3;
+	input->keys[25] = TREE_KEY_4;
+	input->keys[26] = TREE_KEY_5;
+	input->keys[27] = TREE_KEY_6;
+	input->keys[28] = TREE_KEY_7;
+	input->keys[29] = TREE_KEY_8;
+	input->keys[30] = TREE_KEY_9;
+	input->keys[31] = TREE_KEY_A;
+	input->keys[32] = TREE_KEY_B;
+	input->keys[33] = TREE_KEY_C;
+	input->keys[34] = TREE_KEY_D;
+	input->keys[35] = TREE_KEY_E;
+	input->keys[36] = TREE_KEY_F;
+	input->keys[37] = TREE_KEY_G;
+	input->keys[38] = TREE_KEY_H;
+	input->keys[39] = TREE_KEY_I;
+	input->keys[40] = TREE_KEY_J;
+	input->keys[41] = TREE_KEY_K;
+	input->keys[42] = TREE_KEY_L;
+	input->keys[43] = TREE_KEY_M;
+	input->keys[44] = TREE_KEY_N;
+	input->keys[45] = TREE_KEY_O;
+	input->keys[46] = TREE_KEY_P;
+	input->keys[47] = TREE_KEY_Q;
+	input->keys[48] = TREE_KEY_R;
+	input->keys[49] = TREE_KEY_S;
+	input->keys[50] = TREE_KEY_T;
+	input->keys[51] = TREE_KEY_U;
+	input->keys[52] = TREE_KEY_V;
+	input->keys[53] = TREE_KEY_W;
+	input->keys[54] = TREE_KEY_X;
+	input->keys[55] = TREE_KEY_Y;
+	input->keys[56] = TREE_KEY_Z;
+	input->keys[57] = TREE_KEY_F1;
+	input->keys[58] = TREE_KEY_F2;
+	input->keys[59] = TREE_KEY_F3;
+	input->keys[60] = TREE_KEY_F4;
+	input->keys[61] = TREE_KEY_F5;
+	input->keys[62] = TREE_KEY_F6;
+	input->keys[63] = TREE_KEY_F7;
+	input->keys[64] = TREE_KEY_F8;
+	input->keys[65] = TREE_KEY_F9;
+	input->keys[66] = TREE_KEY_F10;
+	input->keys[67] = TREE_KEY_F11;
+	input->keys[68] = TREE_KEY_F12;
+	input->keys[69] = TREE_KEY_NUM_LOCK;
+	input->keys[70] = TREE_KEY_SCROLL_LOCK;
+	input->keys[71] = TREE_KEY_NUMPAD_0;
+	input->keys[72] = TREE_KEY_NUMPAD_1;
+	input->keys[73] = TREE_KEY_NUMPAD_2;
+	input->keys[74] = TREE_KEY_NUMPAD_3;
+	input->keys[75] = TREE_KEY_NUMPAD_4;
+	input->keys[76] = TREE_KEY_NUMPAD_5;
+	input->keys[77] = TREE_KEY_NUMPAD_6;
+	input->keys[78] = TREE_KEY_NUMPAD_7;
+	input->keys[79] = TREE_KEY_NUMPAD_8;
+	input->keys[80] = TREE_KEY_NUMPAD_9;
+	input->keys[81] = TREE_KEY_MULTIPLY;
+	input->keys[82] = TREE_KEY_ADD;
+	input->keys[83] = TREE_KEY_SUBTRACT;
+	input->keys[84] = TREE_KEY_DECIMAL;
+	input->keys[85] = TREE_KEY_DIVIDE;
+	input->keys[86] = TREE_KEY_SEMICOLON;
+	input->keys[87] = TREE_KEY_EQUALS;
+	input->keys[88] = TREE_KEY_COMMA;
+	input->keys[89] = TREE_KEY_MINUS;
+	input->keys[90] = TREE_KEY_PERIOD;
+	input->keys[91] = TREE_KEY_SLASH;
+	input->keys[92] = TREE_KEY_TILDE;
+	input->keys[93] = TREE_KEY_LEFT_BRACKET;
+	input->keys[94] = TREE_KEY_BACKSLASH;
+	input->keys[95] = TREE_KEY_RIGHT_BRACKET;
+	input->keys[96] = TREE_KEY_APOSTROPHE;
+
+	for (TREE_Size i = 0; i <= TREE_KEY_MAX; i++)
+	{
+		input->states[i] = TREE_INPUT_STATE_RELEASED;
+		input->repeatTimes[i] = 0;
+	}
+	input->timeout = 1000;
+	input->repeatDelay = TREE_INPUT_REPEAT_DELAY;
+	input->repeatInterval = TREE_INPUT_REPEAT_INTERVAL;
+	input->heldCount = 0;
+	input->deltaCount = 0;
+	input->pasteText = NULL;
+	input->pasteSize = 0;
+
+	return TREE_OK;
+}
+
+void TREE_Input_Free(TREE_Input *input)
+{
+	// validate
+	if (!input)
+	{
+		return;
+	}
+
+	// free data
+	TREE_DELETE(input->pasteText);
+	input->pasteSize = 0;
+}
+
+TREE_Result TREE_Input_SetBackend(TREE_InputBackend backend)
+{
+	// the backend is opened by TREE_Init
+	if (g_treeInitialized)
+	{
+		return TREE_ERROR_INVALID_STATE;
+	}
+	if (backend < TREE_INPUT_BACKEND_AUTOMATIC || backend > TREE_INPUT_BACKEND_TERMINAL)
+	{
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+#ifdef TREE_WINDOWS
+	if (backend == TREE_INPUT_BACKEND_TERMINAL)
+	{
+		return TREE_NOT_IMPLEMENTED;
+	}
+#endif
+
+	g_inputBackend = backend;
+	return TREE_OK;
+}
+
+TREE_InputBackend TREE_Input_GetBackend()
+{
+	return g_inputBackend;
+}
+
+TREE_KeyModifierFlags _TREE_Input_GetModifiers(TREE_Input const *input)
+{
+	// get modifiers from the key states
+	TREE_KeyModifierFlags modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
+	if (input->states[TREE_KEY_LEFT_SHIFT] || input->states[TREE_KEY_RIGHT_SHIFT] || input->states[TREE_KEY_SHIFT])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_SHIFT;
+	}
+	if (input->states[TREE_KEY_LEFT_CONTROL] || input->states[TREE_KEY_RIGHT_CONTROL] || input->states[TREE_KEY_CONTROL])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_CONTROL;
+	}
+	if (input->states[TREE_KEY_LEFT_ALT] || input->states[TREE_KEY_RIGHT_ALT] || input->states[TREE_KEY_ALT])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+	}
+	if (input->states[TREE_KEY_LEFT_COMMAND] || input->states[TREE_KEY_RIGHT_COMMAND])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_COMMAND;
+	}
+#ifdef TREE_WINDOWS
+	if (GetKeyState(VK_CAPITAL) & 0x0001)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK;
+	}
+	if (GetKeyState(VK_NUMLOCK) & 0x0001)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_NUM_LOCK;
+	}
+	if (GetKeyState(VK_SCROLL) & 0x0001)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_SCROLL_LOCK;
+	}
+#else
+	if (input->states[TREE_KEY_CAPS_LOCK])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_CAPS_LOCK;
+	}
+	if (input->states[TREE_KEY_NUM_LOCK])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_NUM_LOCK;
+	}
+	if (input->states[TREE_KEY_SCROLL_LOCK])
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_SCROLL_LOCK;
+	}
+#endif
+	return modifiers;
+}
+
+void _TREE_Input_PushDelta(TREE_Input *input, TREE_Key key, TREE_InputState state, TREE_Time time, TREE_Microseconds sourceTime)
+{
+	// the key states stay right when the deltas are full, only the later changes are not listed
+	if (input->deltaCount >= TREE_INPUT_DELTA_CAPACITY)
+	{
+		return;
+	}
+
+	TREE_InputDelta *delta = &input->deltas[input->deltaCount++];
+	delta->key = key;
+	delta->state = state;
+	delta->modifiers = _TREE_Input_GetModifiers(input);
+	delta->time = time;
+	delta->sourceTime = sourceTime;
+}
+
+void _TREE_Input_SetKey(TREE_Input *input, TREE_Key key, TREE_Bool pressed, TREE_Time time, TREE_Microseconds sourceTime)
+{
+	// only changes matter
+	if (key == TREE_KEY_NONE || (input->states[key] != TREE_INPUT_STATE_RELEASED) == (pressed != TREE_FALSE))
+	{
+		return;
+	}
+
+	if (pressed)
+	{
+		// start counting down to the first repeat
+		input->states[key] = TREE_INPUT_STATE_PRESSED;
+		input->repeatTimes[key] = time + input->repeatDelay;
+		if (input->heldCount < TREE_KEY_COUNT)
+		{
+			input->heldKeys[input->heldCount++] = key;
+		}
+		_TREE_Input_PushDelta(input, key, TREE_INPUT_STATE_PRESSED, time, sourceTime);
+	}
+	else
+	{
+		// stop repeating
+		input->states[key] = TREE_INPUT_STATE_RELEASED;
+		for (TREE_Size i = 0; i < input->heldCount; ++i)
+		{
+			if (input->heldKeys[i] == key)
+			{
+				input->heldKeys[i] = input->heldKeys[--input->heldCount];
+				break;
+			}
+		}
+		_TREE_Input_PushDelta(input, key, TREE_INPUT_STATE_RELEASED, time, sourceTime);
+	}
+}
+
+void _TREE_Input_Repeat(TREE_Input *input, TREE_Time currentTime)
+{
+	// every repeat that came due since the last refresh, at the time it was due,
+	// leaving half of the deltas for the presses and releases read after
+	TREE_Time interval = MAX(input->repeatInterval, 1);
+	TREE_Microseconds now = TREE_Time_NowMicroseconds();
+	for (TREE_Size i = 0; i < input->heldCount; ++i)
+	{
+		TREE_Key key = input->heldKeys[i];
+		while (input->repeatTimes[key] <= currentTime && input->deltaCount < TREE_INPUT_DELTA_CAPACITY / 2)
+		{
+			input->states[key] = TREE_INPUT_STATE_HELD;
+			_TREE_Input_PushDelta(input, key, TREE_INPUT_STATE_HELD, input->repeatTimes[key], now - (currentTime - input->repeatTimes[key]) * 1000);
+			input->repeatTimes[key] += interval;
+		}
+
+		// after a long stall, skip the repeats that did not fit
+		if (input->repeatTimes[key] <= currentTime)
+		{
+			input->repeatTimes[key] = currentTime + interval;
+		}
+	}
+}
+
+#ifdef TREE_LINUX
+
+// maps each ASCII character to the key that types it, and the modifiers it is typed with
+static struct
+{
+	TREE_Byte key;
+	TREE_Byte modifiers;
+} const g_terminalCharKeys[128] =
+	{
+		{TREE_KEY_SPACE, TREE_KEY_MODIFIER_FLAGS_CONTROL},		// 0 ^@
+		{TREE_KEY_A, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 1 ^A
+		{TREE_KEY_B, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 2 ^B
+		{TREE_KEY_C, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 3 ^C
+		{TREE_KEY_D, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 4 ^D
+		{TREE_KEY_E, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 5 ^E
+		{TREE_KEY_F, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 6 ^F
+		{TREE_KEY_G, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 7 ^G
+		{TREE_KEY_BACKSPACE, 0},								// 8 backspace
+		{TREE_KEY_TAB, 0},										// 9 tab
+		{TREE_KEY_J, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 10 ^J
+		{TREE_KEY_K, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 11 ^K
+		{TREE_KEY_L, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 12 ^L
+		{TREE_KEY_ENTER, 0},									// 13 enter
+		{TREE_KEY_N, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 14 ^N
+		{TREE_KEY_O, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 15 ^O
+		{TREE_KEY_P, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 16 ^P
+		{TREE_KEY_Q, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 17 ^Q
+		{TREE_KEY_R, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 18 ^R
+		{TREE_KEY_S, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 19 ^S
+		{TREE_KEY_T, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 20 ^T
+		{TREE_KEY_U, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 21 ^U
+		{TREE_KEY_V, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 22 ^V
+		{TREE_KEY_W, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 23 ^W
+		{TREE_KEY_X, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 24 ^X
+		{TREE_KEY_Y, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 25 ^Y
+		{TREE_KEY_Z, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 26 ^Z
+		{TREE_KEY_ESCAPE, 0},									// 27 escape
+		{TREE_KEY_BACKSLASH, TREE_KEY_MODIFIER_FLAGS_CONTROL},	// 28 ^backslash
+		{TREE_KEY_RIGHT_BRACKET, TREE_KEY_MODIFIER_FLAGS_CONTROL},// 29 ^]
+		{TREE_KEY_6, TREE_KEY_MODIFIER_FLAGS_CONTROL},			// 30 ^^
+		{TREE_KEY_MINUS, TREE_KEY_MODIFIER_FLAGS_CONTROL},		// 31 ^_
+		{TREE_KEY_SPACE, 0},									// 32 space
+		{TREE_KEY_1, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 33 !
+		{TREE_KEY_APOSTROPHE, TREE_KEY_MODIFIER_FLAGS_SHIFT},	// 34 "
+		{TREE_KEY_3, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 35 #
+		{TREE_KEY_4, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 36 $
+		{TREE_KEY_5, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 37 %
+		{TREE_KEY_7, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 38 &
+		{TREE_KEY_APOSTROPHE, 0},								// 39 '
+		{TREE_KEY_9, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 40 (
+		{TREE_KEY_0, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 41 )
+		{TREE_KEY_8, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 42 *
+		{TREE_KEY_EQUALS, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 43 +
+		{TREE_KEY_COMMA, 0},									// 44 ,
+		{TREE_KEY_MINUS, 0},									// 45 -
+		{TREE_KEY_PERIOD, 0},									// 46 .
+		{TREE_KEY_SLASH, 0},									// 47 /
+		{TREE_KEY_0, 0},										// 48 0
+		{TREE_KEY_1, 0},										// 49 1
+		{TREE_KEY_2, 0},										// 50 2
+		{TREE_KEY_3, 0},										// 51 3
+		{TREE_KEY_4, 0},										// 52 4
+		{TREE_KEY_5, 0},										// 53 5
+		{TREE_KEY_6, 0},										// 54 6
+		{TREE_KEY_7, 0},										// 55 7
+		{TREE_KEY_8, 0},										// 56 8
+		{TREE_KEY_9, 0},										// 57 9
+		{TREE_KEY_SEMICOLON, TREE_KEY_MODIFIER_FLAGS_SHIFT},	// 58 :
+		{TREE_KEY_SEMICOLON, 0},								// 59 ;
+		{TREE_KEY_COMMA, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 60 <
+		{TREE_KEY_EQUALS, 0},									// 61 =
+		{TREE_KEY_PERIOD, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 62 >
+		{TREE_KEY_SLASH, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 63 ?
+		{TREE_KEY_2, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 64 @
+		{TREE_KEY_A, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 65 A
+		{TREE_KEY_B, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 66 B
+		{TREE_KEY_C, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 67 C
+		{TREE_KEY_D, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 68 D
+		{TREE_KEY_E, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 69 E
+		{TREE_KEY_F, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 70 F
+		{TREE_KEY_G, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 71 G
+		{TREE_KEY_H, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 72 H
+		{TREE_KEY_I, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 73 I
+		{TREE_KEY_J, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 74 J
+		{TREE_KEY_K, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 75 K
+		{TREE_KEY_L, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 76 L
+		{TREE_KEY_M, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 77 M
+		{TREE_KEY_N, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 78 N
+		{TREE_KEY_O, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 79 O
+		{TREE_KEY_P, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 80 P
+		{TREE_KEY_Q, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 81 Q
+		{TREE_KEY_R, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 82 R
+		{TREE_KEY_S, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 83 S
+		{TREE_KEY_T, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 84 T
+		{TREE_KEY_U, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 85 U
+		{TREE_KEY_V, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 86 V
+		{TREE_KEY_W, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 87 W
+		{TREE_KEY_X, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 88 X
+		{TREE_KEY_Y, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 89 Y
+		{TREE_KEY_Z, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 90 Z
+		{TREE_KEY_LEFT_BRACKET, 0},								// 91 [
+		{TREE_KEY_BACKSLASH, 0},								// 92 backslash
+		{TREE_KEY_RIGHT_BRACKET, 0},							// 93 ]
+		{TREE_KEY_6, TREE_KEY_MODIFIER_FLAGS_SHIFT},			// 94 ^
+		{TREE_KEY_MINUS, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 95 _
+		{TREE_KEY_TILDE, 0},									// 96 `
+		{TREE_KEY_A, 0},										// 97 a
+		{TREE_KEY_B, 0},										// 98 b
+		{TREE_KEY_C, 0},										// 99 c
+		{TREE_KEY_D, 0},										// 100 d
+		{TREE_KEY_E, 0},										// 101 e
+		{TREE_KEY_F, 0},										// 102 f
+		{TREE_KEY_G, 0},										// 103 g
+		{TREE_KEY_H, 0},										// 104 h
+		{TREE_KEY_I, 0},										// 105 i
+		{TREE_KEY_J, 0},										// 106 j
+		{TREE_KEY_K, 0},										// 107 k
+		{TREE_KEY_L, 0},										// 108 l
+		{TREE_KEY_M, 0},										// 109 m
+		{TREE_KEY_N, 0},										// 110 n
+		{TREE_KEY_O, 0},										// 111 o
+		{TREE_KEY_P, 0},										// 112 p
+		{TREE_KEY_Q, 0},										// 113 q
+		{TREE_KEY_R, 0},										// 114 r
+		{TREE_KEY_S, 0},										// 115 s
+		{TREE_KEY_T, 0},										// 116 t
+		{TREE_KEY_U, 0},										// 117 u
+		{TREE_KEY_V, 0},										// 118 v
+		{TREE_KEY_W, 0},										// 119 w
+		{TREE_KEY_X, 0},										// 120 x
+		{TREE_KEY_Y, 0},										// 121 y
+		{TREE_KEY_Z, 0},										// 122 z
+		{TREE_KEY_LEFT_BRACKET, TREE_KEY_MODIFIER_FLAGS_SHIFT},// 123 {
+		{TREE_KEY_BACKSLASH, TREE_KEY_MODIFIER_FLAGS_SHIFT},	// 124 |
+		{TREE_KEY_RIGHT_BRACKET, TREE_KEY_MODIFIER_FLAGS_SHIFT},// 125 }
+		{TREE_KEY_TILDE, TREE_KEY_MODIFIER_FLAGS_SHIFT},		// 126 ~
+		{TREE_KEY_BACKSPACE, 0},								// 127 delete
+};
+
+// how the terminal reported a key, numbered like the event types of the kitty keyboard protocol
+#define TERMINAL_KEY_TYPED 0
+#define TERMINAL_KEY_PRESSED 1
+#define TERMINAL_KEY_REPEATED 2
+#define TERMINAL_KEY_RELEASED 3
+
+// the start of a bracketed paste
+#define TERMINAL_KEY_PASTE 4
+
+// the longest escape sequence that can be a key, anything longer is skipped
+#define TERMINAL_SEQUENCE_LENGTH 32
+
+typedef struct _TREE_TerminalKey
+{
+	TREE_Key key;
+	TREE_KeyModifierFlags modifiers;
+	TREE_Int action;
+} _TREE_TerminalKey;
+
+TREE_KeyModifierFlags _TREE_Terminal_GetModifiers(TREE_Int parameter)
+{
+	// 1 plus the held modifiers: shift 1, alt 2, control 4, super 8
+	TREE_KeyModifierFlags modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
+	if (parameter < 2)
+	{
+		return modifiers;
+	}
+	parameter -= 1;
+	if (parameter & 0x1)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_SHIFT;
+	}
+	if (parameter & 0x2)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+	}
+	if (parameter & 0x4)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_CONTROL;
+	}
+	if (parameter & 0x8)
+	{
+		modifiers |= TREE_KEY_MODIFIER_FLAGS_COMMAND;
+	}
+	return modifiers;
+}
+
+TREE_Key _TREE_Terminal_GetLetterKey(TREE_Char letter)
+{
+	// the final letter of CSI 1;modifiers letter and SS3 letter
+	switch (letter)
+	{
+	case 'A':
+		return TREE_KEY_UP_ARROW;
+	case 'B':
+		return TREE_KEY_DOWN_ARROW;
+	case 'C':
+		return TREE_KEY_RIGHT_ARROW;
+	case 'D':
+		return TREE_KEY_LEFT_ARROW;
+	case 'H':
+		return TREE_KEY_HOME;
+	case 'F':
+		return TREE_KEY_END;
+	case 'P':
+		return TREE_KEY_F1;
+	case 'Q':
+		return TREE_KEY_F2;
+	case 'R':
+		return TREE_KEY_F3;
+	case 'S':
+		return TREE_KEY_F4;
+	default:
+		return TREE_KEY_NONE;
+	}
+}
+
+TREE_Key _TREE_Terminal_GetTildeKey(TREE_Int number)
+{
+	// the number of CSI number;modifiers ~
+	switch (number)
+	{
+	case 1:
+	case 7:
+		return TREE_KEY_HOME;
+	case 2:
+		return TREE_KEY_INSERT;
+	case 3:
+		return TREE_KEY_DELETE;
+	case 4:
+	case 8:
+		return TREE_KEY_END;
+	case 5:
+		return TREE_KEY_PAGE_UP;
+	case 6:
+		return TREE_KEY_PAGE_DOWN;
+	case 11:
+	case 12:
+	case 13:
+	case 14:
+	case 15:
+		return (TREE_Key)(TREE_KEY_F1 + (number - 11));
+	case 17:
+	case 18:
+	case 19:
+	case 20:
+	case 21:
+		return (TREE_Key)(TREE_KEY_F6 + (number - 17));
+	case 23:
+		return TREE_KEY_F11;
+	case 24:
+		return TREE_KEY_F12;
+	default:
+		return TREE_KEY_NONE;
+	}
+}
+
+TREE_Key _TREE_Terminal_GetFunctionalKey(TREE_Int code)
+{
+	// the private use area codes of the kitty keyboard protocol, for keys without a character
+	switch (code)
+	{
+	case 57358:
+		return TREE_KEY_CAPS_LOCK;
+	case 57359:
+		return TREE_KEY_SCROLL_LOCK;
+	case 57360:
+		return TREE_KEY_NUM_LOCK;
+	case 57361:
+		return TREE_KEY_PRINT_SCREEN;
+	case 57362:
+		return TREE_KEY_PAUSE;
+	case 57363:
+		return TREE_KEY_APPLICATION;
+	case 57399:
+	case 57400:
+	case 57401:
+	case 57402:
+	case 57403:
+	case 57404:
+	case 57405:
+	case 57406:
+	case 57407:
+	case 57408:
+		return (TREE_Key)(TREE_KEY_NUMPAD_0 + (code - 57399));
+	case 57409:
+		return TREE_KEY_DECIMAL;
+	case 57410:
+		return TREE_KEY_DIVIDE;
+	case 57411:
+		return TREE_KEY_MULTIPLY;
+	case 57412:
+		return TREE_KEY_SUBTRACT;
+	case 57413:
+		return TREE_KEY_ADD;
+	case 57414:
+		return TREE_KEY_ENTER;
+	case 57415:
+		return TREE_KEY_EQUALS;
+	case 57417:
+		return TREE_KEY_LEFT_ARROW;
+	case 57418:
+		return TREE_KEY_RIGHT_ARROW;
+	case 57419:
+		return TREE_KEY_UP_ARROW;
+	case 57420:
+		return TREE_KEY_DOWN_ARROW;
+	case 57421:
+		return TREE_KEY_PAGE_UP;
+	case 57422:
+		return TREE_KEY_PAGE_DOWN;
+	case 57423:
+		return TREE_KEY_HOME;
+	case 57424:
+		return TREE_KEY_END;
+	case 57425:
+		return TREE_KEY_INSERT;
+	case 57426:
+		return TREE_KEY_DELETE;
+	case 57441:
+		return TREE_KEY_LEFT_SHIFT;
+	case 57442:
+		return TREE_KEY_LEFT_CONTROL;
+	case 57443:
+		return TREE_KEY_LEFT_ALT;
+	case 57444:
+		return TREE_KEY_LEFT_COMMAND;
+	case 57447:
+		return TREE_KEY_RIGHT_SHIFT;
+	case 57448:
+		return TREE_KEY_RIGHT_CONTROL;
+	case 57449:
+		return TREE_KEY_RIGHT_ALT;
+	case 57450:
+		return TREE_KEY_RIGHT_COMMAND;
+	default:
+		return TREE_KEY_NONE;
+	}
+}
+
+TREE_Size _TREE_Terminal_DecodeSequence(TREE_Char const *text, TREE_Size size, _TREE_TerminalKey *key)
+{
+	// find the final byte, after the parameters and intermediates
+	TREE_Size end = 2;
+	while (end < size && ((unsigned char)text[end] < 0x40 || (unsigned char)text[end] > 0x7E))
+	{
+		++end;
+		if (end >= TERMINAL_SEQUENCE_LENGTH)
+		{
+			// not a key, skip it
+			return end;
+		}
+	}
+	if (end >= size)
+	{
+		return 0;
+	}
+	TREE_Char final = text[end];
+	TREE_Size length = end + 1;
+
+	// replies and mouse reports start with a private marker
+	TREE_Size index = 2;
+	TREE_Char marker = text[index];
+	if (marker >= '<' && marker <= '?')
+	{
+		++index;
+	}
+	else
+	{
+		marker = '\0';
+	}
+
+	// the parameters, along with the first subparameter of each, such as the event type in modifiers:event
+	TREE_Int parameters[3] = {0, 0, 0};
+	TREE_Int subparameters[3] = {0, 0, 0};
+	TREE_Size count = 0;
+	TREE_Size subcount = 0;
+	for (; index < end && count < 3; ++index)
+	{
+		TREE_Char ch = text[index];
+		if (ch >= '0' && ch <= '9')
+		{
+			if (subcount == 0)
+			{
+				parameters[count] = parameters[count] * 10 + (ch - '0');
+			}
+			else if (subcount == 1)
+			{
+				subparameters[count] = subparameters[count] * 10 + (ch - '0');
+			}
+		}
+		else if (ch == ':')
+		{
+			++subcount;
+		}
+		else if (ch == ';')
+		{
+			++count;
+			subcount = 0;
+		}
+		else
+		{
+			// intermediates
+			break;
+		}
+	}
+
+	// the reply to the kitty keyboard protocol query, with the flags in use
+	if (marker == '?' && final == 'u')
+	{
+		g_terminalKeyEvents = (parameters[0] & 0x2) != 0;
+		return length;
+	}
+	if (marker)
+	{
+		return length;
+	}
+
+	switch (final)
+	{
+	case 'u':
+		// kitty keyboard protocol: CSI code;modifiers:event u
+		if (parameters[0] < 128)
+		{
+			key->key = (TREE_Key)g_terminalCharKeys[parameters[0]].key;
+			key->modifiers = (TREE_KeyModifierFlags)g_terminalCharKeys[parameters[0]].modifiers;
+		}
+		else
+		{
+			key->key = _TREE_Terminal_GetFunctionalKey(parameters[0]);
+		}
+		break;
+	case '~':
+		if (parameters[0] == 200)
+		{
+			key->action = TERMINAL_KEY_PASTE;
+			return length;
+		}
+		key->key = _TREE_Terminal_GetTildeKey(parameters[0]);
+		break;
+	case 'Z':
+		key->key = TREE_KEY_TAB;
+		key->modifiers = TREE_KEY_MODIFIER_FLAGS_SHIFT;
+		break;
+	default:
+		key->key = _TREE_Terminal_GetLetterKey(final);
+		break;
+	}
+	key->modifiers |= _TREE_Terminal_GetModifiers(parameters[1]);
+	if (subparameters[1] >= TERMINAL_KEY_PRESSED && subparameters[1] <= TERMINAL_KEY_RELEASED)
+	{
+		key->action = subparameters[1];
+	}
+
+	return length;
+}
+
+TREE_Size _TREE_Terminal_Decode(TREE_Char const *text, TREE_Size size, _TREE_TerminalKey *key)
+{
+	key->key = TREE_KEY_NONE;
+	key->modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
+	key->action = TERMINAL_KEY_TYPED;
+
+	// a character on its own
+	unsigned char ch = (unsigned char)text[0];
+	if (ch != '\033')
+	{
+		if (ch < 0x80)
+		{
+			key->key = (TREE_Key)g_terminalCharKeys[ch].key;
+			key->modifiers = (TREE_KeyModifierFlags)g_terminalCharKeys[ch].modifiers;
+			return 1;
+		}
+
+		// no key types any other character, so skip all of its UTF-8 bytes
+		TREE_Size length = ch >= 0xF0 ? 4 : (ch >= 0xE0 ? 3 : (ch >= 0xC0 ? 2 : 1));
+		return length <= size ? length : 0;
+	}
+
+	// wait for the rest of the sequence
+	if (size < 2)
+	{
+		return 0;
+	}
+
+	// CSI
+	if (text[1] == '[')
+	{
+		return _TREE_Terminal_DecodeSequence(text, size, key);
+	}
+
+	// SS3 letter, sent for some keys in application mode
+	if (text[1] == 'O')
+	{
+		if (size < 3)
+		{
+			return 0;
+		}
+		key->key = text[2] == 'M' ? TREE_KEY_ENTER : _TREE_Terminal_GetLetterKey(text[2]);
+		if (key->key != TREE_KEY_NONE)
+		{
+			return 3;
+		}
+
+		// not a letter SS3 ends with, so it was 'O' with alt held, and the letter is a key of its own
+		_TREE_Terminal_Decode(&text[1], 1, key);
+		key->modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+		return 2;
+	}
+
+	// escape followed by a key is that key with alt held
+	TREE_Size length = _TREE_Terminal_Decode(&text[1], size - 1, key);
+	if (!length)
+	{
+		return 0;
+	}
+	key->modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+	return length + 1;
+}
+
+void _TREE_Input_TypeTerminalKey(TREE_Input *input, TREE_Key key, TREE_Bool retype, TREE_Time time, TREE_Microseconds sourceTime)
+{
+	// a key typed again is released in between, so every time it is typed is its own press
+	TREE_Size index = 0;
+	while (index < g_terminalTypedCount && g_terminalTyped[index] != key)
+	{
+		++index;
+	}
+	if (index < g_terminalTypedCount)
+	{
+		if (!retype)
+		{
+			return;
+		}
+		_TREE_Input_SetKey(input, key, TREE_FALSE, time, sourceTime);
+	}
+	else if (g_terminalTypedCount < TREE_KEY_COUNT)
+	{
+		g_terminalTyped[g_terminalTypedCount++] = key;
+	}
+	_TREE_Input_SetKey(input, key, TREE_TRUE, time, sourceTime);
+}
+
+void _TREE_Input_ApplyTerminalKey(TREE_Input *input, _TREE_TerminalKey const *key, TREE_Time time, TREE_Microseconds sourceTime)
+{
+	if (key->key == TREE_KEY_NONE)
+	{
+		return;
+	}
+
+	// the kitty keyboard protocol reports presses and releases, and the repeats are timed by the Input
+	if (key->action != TERMINAL_KEY_TYPED || g_terminalKeyEvents)
+	{
+		_TREE_Input_SetKey(input, key->key, key->action != TERMINAL_KEY_RELEASED, time, sourceTime);
+		return;
+	}
+
+	// without release reports, a key counts as pressed until the next refresh,
+	// and the modifier keys are only known along with a key
+	static struct
+	{
+		TREE_KeyModifierFlags flag;
+		TREE_Key key;
+	} const modifierKeys[] =
+		{
+			{TREE_KEY_MODIFIER_FLAGS_SHIFT, TREE_KEY_LEFT_SHIFT},
+			{TREE_KEY_MODIFIER_FLAGS_CONTROL, TREE_KEY_LEFT_CONTROL},
+			{TREE_KEY_MODIFIER_FLAGS_ALT, TREE_KEY_LEFT_ALT},
+			{TREE_KEY_MODIFIER_FLAGS_COMMAND, TREE_KEY_LEFT_COMMAND},
+		};
+	for (TREE_Size i = 0; i < sizeof(modifierKeys) / sizeof(modifierKeys[0]); ++i)
+	{
+		if (key->modifiers & modifierKeys[i].flag)
+		{
+			_TREE_Input_TypeTerminalKey(input, modifierKeys[i].key, TREE_FALSE, time, sourceTime);
+		}
+	}
+	_TREE_Input_TypeTerminalKey(input, key->key, TREE_TRUE, time, sourceTime);
+}
+
+TREE_Result _TREE_Input_FinishPaste(TREE_Input *input, TREE_Time time, TREE_Microseconds sourceTime)
+{
+	g_terminalPasting = TREE_FALSE;
+
+	// terminals send the line endings of a paste as '\r'
+	TREE_Size size = 0;
+	for (TREE_Size i = 0; i < g_terminalPasteSize; ++i)
+	{
+		TREE_Char ch = g_terminalPaste[i];
+		if (ch == '\r')
+		{
+			if (i + 1 < g_terminalPasteSize && g_terminalPaste[i + 1] == '\n')
+			{
+				continue;
+			}
+			ch = '\n';
+		}
+		g_terminalPaste[size++] = ch;
+	}
+	g_terminalPasteSize = 0;
+	if (!size)
+	{
+		return TREE_OK;
+	}
+	g_terminalPaste[size] = '\0';
+
+	// hand the text over, or add it to another paste from the same refresh
+	if (!input->pasteText)
+	{
+		input->pasteText = g_terminalPaste;
+		input->pasteSize = size;
+		g_terminalPaste = NULL;
+		g_terminalPasteCapacity = 0;
+	}
+	else
+	{
+		TREE_Char *pasteText = (TREE_Char *)realloc(input->pasteText, (input->pasteSize + size + 1) * sizeof(TREE_Char));
+		if (!pasteText)
+		{
+			return TREE_ERROR_ALLOC;
+		}
+		memcpy(&pasteText[input->pasteSize], g_terminalPaste, (size + 1) * sizeof(TREE_Char));
+		input->pasteText = pasteText;
+		input->pasteSize += size;
+	}
+	_TREE_Input_PushDelta(input, TREE_KEY_NONE, TREE_INPUT_STATE_PRESSED, time, sourceTime);
+
+	return TREE_OK;
+}
+
+TREE_Result _TREE_Input_AddPaste(TREE_Input *input, TREE_Char const *text, TREE_Size size, TREE_Time time, TREE_Microseconds sourceTime, TREE_Size *taken)
+{
+	static TREE_Char const pasteEnd[] = "\033[201~";
+	TREE_Size const pasteEndLength = sizeof(pasteEnd) - 1;
+
+	// find the end of the paste, stopping early where the rest of the text could be the start of it
+	TREE_Size length = 0;
+	TREE_Bool ended = TREE_FALSE;
+	while (length < size)
+	{
+		TREE_Char const *escape = (TREE_Char const *)memchr(&text[length], '\033', size - length);
+		if (!escape)
+		{
+			length = size;
+			break;
+		}
+		length = (TREE_Size)(escape - text);
+		TREE_Size rest = size - length;
+		if (rest < pasteEndLength && !memcmp(escape, pasteEnd, rest))
+		{
+			break;
+		}
+		if (rest >= pasteEndLength && !memcmp(escape, pasteEnd, pasteEndLength))
+		{
+			ended = TREE_TRUE;
+			break;
+		}
+		++length;
+	}
+
+	// add the text, leaving room for a null terminator
+	// without room, the text is still taken, so that the rest of the paste is not typed out as keys
+	*taken = ended ? length + pasteEndLength : length;
+	if (g_terminalPasteSize + length + 1 > g_terminalPasteCapacity)
+	{
+		TREE_Size capacity = MAX(g_terminalPasteCapacity * 2, g_terminalPasteSize + length + 1);
+		TREE_Char *paste = (TREE_Char *)realloc(g_terminalPaste, capacity * sizeof(TREE_Char));
+		if (!paste)
+		{
+			g_terminalPasting = !ended;
+			g_terminalPasteSize = 0;
+			return TREE_ERROR_ALLOC;
+		}
+		g_terminalPaste = paste;
+		g_terminalPasteCapacity = capacity;
+	}
+	memcpy(&g_terminalPaste[g_terminalPasteSize], text, length * sizeof(TREE_Char));
+	g_terminalPasteSize += length;
+
+	if (!ended)
+	{
+		return TREE_OK;
+	}
+	return _TREE_Input_FinishPaste(input, time, sourceTime);
+}
+
+TREE_Result _TREE_Input_ReadTerminal(TREE_Input *input)
+{
+	// release the keys that were only reported as typed
+	TREE_Time time = TREE_Time_Now();
+	TREE_Microseconds sourceTime = TREE_Time_NowMicroseconds();
+	for (TREE_Size i = 0; i < g_terminalTypedCount; ++i)
+	{
+		_TREE_Input_SetKey(input, g_terminalTyped[i], TREE_FALSE, time, sourceTime);
+	}
+	g_terminalTypedCount = 0;
+
+	// wait for input, without a timeout the read below finds out if there is any
+	if (input->timeout > 0)
+	{
+		struct pollfd pfd;
+		pfd.fd = STDIN_FILENO;
+		pfd.events = POLLIN;
+		int pollResult = poll(&pfd, 1, (int)input->timeout);
+		if (pollResult < 0 && errno != EINTR)
+		{
+			return TREE_ERROR_LINUX_TERMINAL_READ;
+		}
+		if (pollResult <= 0)
+		{
+			return TREE_OK;
+		}
+	}
+
+	TREE_Char buffer[sizeof(g_terminalInput) + 4096];
+	TREE_Bool reading = TREE_TRUE;
+	while (reading)
+	{
+		// read after the part of a sequence left over from the last read
+		TREE_Size size = g_terminalInputSize;
+		memcpy(buffer, g_terminalInput, size);
+		ssize_t count = read(STDIN_FILENO, &buffer[size], sizeof(buffer) - size);
+		if (count < 0)
+		{
+			if (errno != EAGAIN && errno != EINTR)
+			{
+				return TREE_ERROR_LINUX_TERMINAL_READ;
+			}
+			count = 0;
+		}
+		size += (TREE_Size)count;
+		time = TREE_Time_Now();
+		sourceTime = TREE_Time_NowMicroseconds();
+
+		// a read that did not fill the buffer got everything the terminal sent so far
+		TREE_Bool drained = size < sizeof(buffer);
+
+		TREE_Size index = 0;
+		while (index < size)
+		{
+			// the text of a paste is taken as it is
+			if (g_terminalPasting)
+			{
+				TREE_Size length = 0;
+				TREE_Result result = _TREE_Input_AddPaste(input, &buffer[index], size - index, time, sourceTime, &length);
+				if (result)
+				{
+					// the rest of this read is lost
+					g_terminalInputSize = 0;
+					return result;
+				}
+				if (!length)
+				{
+					break;
+				}
+				index += length;
+				continue;
+			}
+
+			_TREE_TerminalKey key;
+			TREE_Size length = _TREE_Terminal_Decode(&buffer[index], size - index, &key);
+			if (!length)
+			{
+				// terminals send a sequence all at once, so an escape with nothing after it is the Escape key,
+				// and an escape with only one character after it, such as '[' or 'O', is that character with alt held
+				TREE_Bool single = index + 2 == size && buffer[index + 1] != '\033';
+				if (!drained || buffer[index] != '\033' || (index + 1 < size && buffer[index + 1] != '\033' && !single))
+				{
+					break;
+				}
+				if (single)
+				{
+					length = _TREE_Terminal_Decode(&buffer[index + 1], 1, &key);
+					if (!length)
+					{
+						break;
+					}
+					key.modifiers |= TREE_KEY_MODIFIER_FLAGS_ALT;
+					length = 2;
+				}
+				else
+				{
+					key.key = TREE_KEY_ESCAPE;
+					key.modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
+					key.action = TERMINAL_KEY_TYPED;
+					length = 1;
+				}
+			}
+			if (key.action == TERMINAL_KEY_PASTE)
+			{
+				g_terminalPasting = TREE_TRUE;
+				g_terminalPasteSize = 0;
+			}
+			else
+			{
+				_TREE_Input_ApplyTerminalKey(input, &key, time, sourceTime);
+			}
+			index += length;
+		}
+
+		// keep the start of a sequence for the next read
+		g_terminalInputSize = size - index;
+		if (g_terminalInputSize > sizeof(g_terminalInput))
+		{
+			g_terminalInputSize = 0;
+		}
+		memmove(g_terminalInput, &buffer[index], g_terminalInputSize);
+
+		// a paste comes all at once, so keep reading until it ends
+		reading = g_terminalPasting && count > 0;
+	}
+
+	return TREE_OK;
+}
+
+// how old a keyboard event can be before its time is not trusted, such as when the device was set to another clock
+#define KEYBOARD_TIME_TOLERANCE 1000
+
+// map KEY_ to TREE_Key
+// 127 is KEY_COMPOSE, which is the highest key value used in TREE
+static TREE_Byte const g_keyboardKeyMap[128] =
+	{
+		TREE_KEY_NONE,			// 0
+		TREE_KEY_ESCAPE,		// 1
+		TREE_KEY_1,				// 2
+		TREE_KEY_2,				// 3
+		TREE_KEY_3,				// 4
+		TREE_KEY_4,				// 5
+		TREE_KEY_5,				// 6
+		TREE_KEY_6,				// 7
+		TREE_KEY_7,				// 8
+		TREE_KEY_8,				// 9
+		TREE_KEY_9,				// 10
+		TREE_KEY_0,				// 11
+		TREE_KEY_MINUS,			// 12
+		TREE_KEY_EQUALS,		// 13
+		TREE_KEY_BACKSPACE,		// 14
+		TREE_KEY_TAB,			// 15
+		TREE_KEY_Q,				// 16
+		TREE_KEY_W,				// 17
+		TREE_KEY_E,				// 18
+		TREE_KEY_R,				// 19
+		TREE_KEY_T,				// 20
+		TREE_KEY_Y,				// 21
+		TREE_KEY_U,				// 22
+		TREE_KEY_I,				// 23
+		TREE_KEY_O,				// 24
+		TREE_KEY_P,				// 25
+		TREE_KEY_LEFT_BRACKET,	// 26
+		TREE_KEY_RIGHT_BRACKET, // 27
+		TREE_KEY_ENTER,			// 28
+		TREE_KEY_LEFT_CONTROL,	// 29
+		TREE_KEY_A,				// 30
+		TREE_KEY_S,				// 31
+		TREE_KEY_D,				// 32
+		TREE_KEY_F,				// 33
+		TREE_KEY_G,				// 34
+		TREE_KEY_H,				// 35
+		TREE_KEY_J,				// 36
+		TREE_KEY_K,				// 37
+		TREE_KEY_L,				// 38
+		TREE_KEY_SEMICOLON,		// 39
+		TREE_KEY_APOSTROPHE,	// 40
+		TREE_KEY_TILDE,			// 41
+		TREE_KEY_LEFT_SHIFT,	// 42
+		TREE_KEY_BACKSLASH,		// 43
+		TREE_KEY_Z,				// 44
+		TREE_KEY_X,				// 45
+		TREE_KEY_C,				// 46
+		TREE_KEY_V,				// 47
+		TREE_KEY_B,				// 48
+		TREE_KEY_N,				// 49
+		TREE_KEY_M,				// 50
+		TREE_KEY_COMMA,			// 51
+		TREE_KEY_PERIOD,		// 52
+		TREE_KEY_SLASH,			// 53
+		TREE_KEY_RIGHT_SHIFT,	// 54
+		TREE_KEY_MULTIPLY,		// 55
+		TREE_KEY_LEFT_ALT,		// 56
+		TREE_KEY_SPACE,			// 57
+		TREE_KEY_CAPS_LOCK,		// 58
+		TREE_KEY_F1,			// 59
+		TREE_KEY_F2,			// 60
+		TREE_KEY_F3,			// 61
+		TREE_KEY_F4,			// 62
+		TREE_KEY_F5,			// 63
+		TREE_KEY_F6,			// 64
+		TREE_KEY_F7,			// 65
+		TREE_KEY_F8,			// 66
+		TREE_KEY_F9,			// 67
+		TREE_KEY_F10,			// 68
+		TREE_KEY_NUM_LOCK,		// 69
+		TREE_KEY_SCROLL_LOCK,	// 70
+		TREE_KEY_NUMPAD_7,		// 71
+		TREE_KEY_NUMPAD_8,		// 72
+		TREE_KEY_NUMPAD_9,		// 73
+		TREE_KEY_SUBTRACT,		// 74
+		TREE_KEY_NUMPAD_4,		// 75
+		TREE_KEY_NUMPAD_5,		// 76
+		TREE_KEY_NUMPAD_6,		// 77
+		TREE_KEY_ADD,			// 78
+		TREE_KEY_NUMPAD_1,		// 79
+		TREE_KEY_NUMPAD_2,		// 80
+		TREE_KEY_NUMPAD_3,		// 81
+		TREE_KEY_NUMPAD_0,		// 82
+		TREE_KEY_DECIMAL,		// 83
+		TREE_KEY_NONE,			// 84
+		TREE_KEY_NONE,			// 85
+		TREE_KEY_NONE,			// 86
+		TREE_KEY_F11,			// 87
+		TREE_KEY_F12,			// 88
+		TREE_KEY_NONE,			// 89
+		TREE_KEY_NONE,			// 90
+		TREE_KEY_NONE,			// 91
+		TREE_KEY_NONE,			// 92
+		TREE_KEY_NONE,			// 93
+		TREE_KEY_NONE,			// 94
+		TREE_KEY_NONE,			// 95
+		TREE_KEY_ENTER,			// 96
+		TREE_KEY_RIGHT_CONTROL, // 97
+		TREE_KEY_DIVIDE,		// 98
+		TREE_KEY_PRINT_SCREEN,	// 99
+		TREE_KEY_RIGHT_ALT,		// 100
+		TREE_KEY_ENTER,			// 101
+		TREE_KEY_HOME,			// 102
+		TREE_KEY_UP_ARROW,		// 103
+		TREE_KEY_PAGE_UP,		// 104
+		TREE_KEY_LEFT_ARROW,	// 105
+		TREE_KEY_RIGHT_ARROW,	// 106
+		TREE_KEY_END,			// 107
+		TREE_KEY_DOWN_ARROW,	// 108
+		TREE_KEY_PAGE_DOWN,		// 109
+		TREE_KEY_INSERT,		// 110
+		TREE_KEY_DELETE,		// 111
+		TREE_KEY_NONE,			// 112
+		TREE_KEY_NONE,			// 113
+		TREE_KEY_NONE,			// 114
+		TREE_KEY_NONE,			// 115
+		TREE_KEY_NONE,			// 116
+		TREE_KEY_EQUALS,		// 117
+		TREE_KEY_NONE,			// 118
+		TREE_KEY_PAUSE,			// 119
+		TREE_KEY_NONE,			// 120
+
+		TREE_KEY_NONE,			// 121
+		TREE_KEY_NONE,			// 122
+		TREE_KEY_NONE,			// 123
+		TREE_KEY_NONE,			// 124
+		TREE_KEY_LEFT_COMMAND,	// 125
+		TREE_KEY_RIGHT_COMMAND, // 126
+		TREE_KEY_APPLICATION,	// 127
+	};
+
+TREE_Result _TREE_Input_ReadKeyboardDevice(TREE_Input *input, int device, TREE_Bool *resync, TREE_Bool *removed)
+{
+	// read the keyboard events in batches, so one read drains a whole burst of keystrokes
+	TREE_Time now = TREE_Time_Now();
+	TREE_Microseconds nowMicroseconds = TREE_Time_NowMicroseconds();
+	struct input_event events[64];
+	TREE_Size const eventsCapacity = sizeof(events) / sizeof(events[0]);
+	TREE_Size const keyMapSize = sizeof(g_keyboardKeyMap) / sizeof(g_keyboardKeyMap[0]);
+	while (TREE_TRUE)
+	{
+		ssize_t bytesRead = read(device, events, sizeof(events));
+		if (bytesRead < 0)
+		{
+			if (errno == EAGAIN || errno == EINTR)
+			{
+				break;
+			}
+
+			// the keyboard was unplugged
+			if (errno == ENODEV)
+			{
+				*removed = TREE_TRUE;
+				break;
+			}
+
+			// if not EAGAIN, an error occurred
+			return TREE_ERROR_LINUX_KEYBOARD_READ;
+		}
+
+		// apply only the keys that changed
+		TREE_Size count = (TREE_Size)bytesRead / sizeof(struct input_event);
+		for (TREE_Size i = 0; i < count; ++i)
+		{
+			struct input_event const *ev = &events[i];
+			if (ev->type == EV_KEY && ev->code < keyMapSize)
+			{
+				// get the key code as TREE_Key
+				TREE_Key key = (TREE_Key)g_keyboardKeyMap[ev->code];
+
+				// save if pressed or released, at the time the kernel saw it, which is on the monotonic clock
+				// the autorepeat of the kernel (2) is ignored, the repeats are timed by the Input
+				TREE_Microseconds age = nowMicroseconds - ((TREE_Microseconds)ev->input_event_sec * 1000000 + (TREE_Microseconds)ev->input_event_usec);
+				if (age < 0 || age > (TREE_Microseconds)KEYBOARD_TIME_TOLERANCE * 1000)
+				{
+					age = 0;
+				}
+				_TREE_Input_SetKey(input, key, ev->value != 0, now - (TREE_Time)(age / 1000), nowMicroseconds - age);
+			}
+			else if (ev->type == EV_SYN && ev->code == SYN_DROPPED)
+			{
+				// the device ran out of room and lost events
+				*resync = TREE_TRUE;
+			}
+		}
+
+		// a partial batch means there is nothing left to read
+		if (count < eventsCapacity)
+		{
+			break;
+		}
+	}
+
+	return TREE_OK;
+}
+
+void _TREE_Input_SyncKeyboards(TREE_Input *input)
+{
+	// ask every keyboard which keys are down, after events were lost or a keyboard was unplugged
+	unsigned char keyBits[KEY_MAX / 8 + 1];
+	memset(keyBits, 0, sizeof(keyBits));
+	for (TREE_Size i = 0; i < g_keyboardCount; ++i)
+	{
+		unsigned char deviceBits[KEY_MAX / 8 + 1];
+		memset(deviceBits, 0, sizeof(deviceBits));
+		if (ioctl(g_keyboards[i].device, EVIOCGKEY(sizeof(deviceBits)), deviceBits) < 0)
+		{
+			continue;
+		}
+		for (TREE_Size j = 0; j < sizeof(keyBits); ++j)
+		{
+			keyBits[j] |= deviceBits[j];
+		}
+	}
+	TREE_Time time = TREE_Time_Now();
+	TREE_Microseconds sourceTime = TREE_Time_NowMicroseconds();
+	for (TREE_Size code = 0; code < sizeof(g_keyboardKeyMap) / sizeof(g_keyboardKeyMap[0]); ++code)
+	{
+		_TREE_Input_SetKey(input, (TREE_Key)g_keyboardKeyMap[code], (keyBits[code / 8] >> (code % 8)) & 1, time, sourceTime);
+	}
+}
+
+void _TREE_Input_WatchKeyboards(TREE_Bool *resync)
+{
+	// the events are aligned like the struct, and each can have a name up to NAME_MAX
+	union
+	{
+		struct inotify_event event;
+		TREE_Char bytes[sizeof(struct inotify_event) + NAME_MAX + 1];
+	} buffer[16];
+	while (TREE_TRUE)
+	{
+		ssize_t bytesRead = read(g_keyboardWatch, buffer, sizeof(buffer));
+		if (bytesRead <= 0)
+		{
+			break;
+		}
+		for (TREE_Char const *next = buffer[0].bytes; next < buffer[0].bytes + bytesRead;)
+		{
+			struct inotify_event const *event = (struct inotify_event const *)next;
+			next += sizeof(struct inotify_event) + event->len;
+			if (!event->len)
+			{
+				continue;
+			}
+
+			if (event->mask & IN_DELETE)
+			{
+				// let go of the keys that were held on it
+				for (TREE_Size i = 0; i < g_keyboardCount; ++i)
+				{
+					if (!strcmp(g_keyboards[i].name, event->name))
+					{
+						_TREE_RemoveKeyboard(i);
+						*resync = TREE_TRUE;
+						break;
+					}
+				}
+			}
+			else
+			{
+				// a new device can only be opened once it has been given its permissions
+				_TREE_AddKeyboard(event->name);
+			}
+		}
+	}
+}
+
+TREE_Result _TREE_Input_ReadKeyboard(TREE_Input *input)
+{
+	// the keyboards are opened by TREE_Init
+	if (g_keyboardEvents < 0)
+	{
+		return TREE_ERROR_LINUX_KEYBOARD_OPEN;
+	}
+
+	// wait for any of the keyboards, without a timeout this only finds out which have events
+	struct epoll_event ready[KEYBOARD_CAPACITY + 1];
+	int readyCount = epoll_wait(g_keyboardEvents, ready, KEYBOARD_CAPACITY + 1, input->timeout > 0 ? (int)input->timeout : 0);
+	if (readyCount < 0)
+	{
+		if (errno != EINTR)
+		{
+			return TREE_ERROR_LINUX_KEYBOARD_POLL;
+		}
+		readyCount = 0;
+	}
+
+	TREE_Bool resync = TREE_FALSE;
+	for (int i = 0; i < readyCount; ++i)
+	{
+		int device = ready[i].data.fd;
+		if (device == g_keyboardWatch)
+		{
+			_TREE_Input_WatchKeyboards(&resync);
+			continue;
+		}
+
+		// skip keyboards removed while handling the ones before
+		TREE_Size index = 0;
+		while (index < g_keyboardCount && g_keyboards[index].device != device)
+		{
+			++index;
+		}
+		if (index == g_keyboardCount)
+		{
+			continue;
+		}
+
+		TREE_Bool removed = TREE_FALSE;
+		TREE_Result result = _TREE_Input_ReadKeyboardDevice(input, device, &resync, &removed);
+		if (result)
+		{
+			return result;
+		}
+		if (removed)
+		{
+			_TREE_RemoveKeyboard(index);
+			resync = TREE_TRUE;
+		}
+	}
+
+	// after losing events, or a keyboard, ask the keyboards which keys are down
+	if (resync)
+	{
+		_TREE_Input_SyncKeyboards(input);
+	}
+
+	return TREE_OK;
+}
+
+#endif
+
+TREE_EXTERN TREE_Result TREE_Input_Refresh(TREE_Input *input)
+{
+	// validate
+	if (!input)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// start a new list of changes, with the repeats of the held keys
+	input->deltaCount = 0;
+	TREE_DELETE(input->pasteText);
+	input->pasteSize = 0;
+	_TREE_Input_Repeat(input, TREE_Time_Now());
+
+// get new key states
+#ifdef TREE_WINDOWS
+	TREE_Time time = TREE_Time_Now();
+	TREE_Microseconds sourceTime = TREE_Time_NowMicroseconds();
+	for (TREE_Size i = 0; i < TREE_KEY_COUNT; i++)
+	{
+		// get key at index
+		TREE_Key key = input->keys[i];
+
+		// set the key state
+		_TREE_Input_SetKey(input, key, (GetAsyncKeyState(key) & 0x8000) != 0, time, sourceTime);
+	}
+#else // TREE_LINUX
+	TREE_Result result = g_inputBackend == TREE_INPUT_BACKEND_TERMINAL ? _TREE_Input_ReadTerminal(input) : _TREE_Input_ReadKeyboard(input);
+	if (result)
+	{
+		return result;
+	}
+#endif
+
+	input->modifiers = _TREE_Input_GetModifiers(input);
+
+	return TREE_OK;
+}
+
+TREE_Direction TREE_Direction_Opposite(TREE_Direction direction)
+{
+	// if none, no opposite
+	if (direction == TREE_DIRECTION_NONE)
+	{
+		return TREE_DIRECTION_NONE;
+	}
+
+	// add 2 to invert it
+	return (TREE_Direction)(((TREE_Size)direction + 1) % 4 + 1);
+}
+
+TREE_Result TREE_Transform_Init(TREE_Transform *transform, TREE_Offset localOffset, TREE_Pivot localPivot, TREE_Extent localExtent, TREE_Alignment localAlignment)
+{
+	// validate
+	if (!transform)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set data
+	transform->localOffset = localOffset;
+	transform->localPivot = localPivot;
+	transform->localExtent = localExtent;
+	transform->localAlignment = localAlignment;
+	transform->parent = NULL;
+	transform->child = NULL;
+	transform->sibling = NULL;
+	transform->dirty = TREE_TRUE;
+	transform->globalRect.offset.x = 0;
+	transform->globalRect.offset.y = 0;
+	transform->globalRect.extent.width = 0;
+	transform->globalRect.extent.height = 0;
+
+	return TREE_OK;
+}
+
+void TREE_Transform_Free(TREE_Transform *transform)
+{
+}
+
+TREE_Result TREE_Transform_Dirty(TREE_Transform *transform)
+{
+	// validate
+	if (!transform)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// mark as dirty
+	transform->dirty = TREE_TRUE;
+
+	// mark children as dirty
+	TREE_Transform *child = transform->child;
+	while (child)
+	{
+		TREE_Transform_Dirty(child);
+		child = child->sibling;
+	}
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Transform_SetParent(TREE_Transform *transform, TREE_Transform *parent)
+{
+	// validate
+	if (!transform)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// ignore if no change
+	if (transform->parent == parent)
+	{
+		return TREE_OK;
+	}
+
+	// unconnect from old family
+	if (transform->parent)
+	{
+		TREE_Transform *firstSibling = transform->parent->child;
+
+		if (firstSibling == transform)
+		{
+			// if this is the first child, set the parent's child to the next sibling
+			transform->parent->child = transform->sibling;
+		}
+		else
+		{
+			// find the previous sibling
+			TREE_Transform *sibling = firstSibling;
+			while (sibling && sibling->sibling != transform)
+			{
+				sibling = sibling->sibling;
+			}
+			// connect to next sibling
+			if (sibling)
+			{
+				sibling->sibling = transform->sibling;
+			}
+		}
+	}
+
+	// set new parent
+	transform->sibling = NULL;
+	transform->parent = parent;
+
+	// connect to new family
+	if (parent)
+	{
+		// if the parent has no children, set this as the first child
+		if (!parent->child)
+		{
+			parent->child = transform;
+		}
+		else
+		{
+			// otherwise, find the last sibling and set this as the next sibling
+			TREE_Transform *lastSibling = parent->child;
+			while (lastSibling->sibling)
+			{
+				lastSibling = lastSibling->sibling;
+			}
+			lastSibling->sibling = transform;
+		}
+	}
+
+	// mark as dirty
+	return TREE_Transform_Dirty(transform);
+}
+
+TREE_Result TREE_Transform_DisconnectChildren(TREE_Transform *transform)
+{
+	// validate
+	if (!transform)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// if no children, nothing to do
+	if (!transform->child)
+	{
+		return TREE_OK;
+	}
+
+	// disconnect all children from this parent, and each sibling
+	TREE_Transform *child = transform->child;
+	while (child)
+	{
+		TREE_Transform *nextSibling = child->sibling;
+		child->parent = NULL;  // disconnect from parent
+		child->sibling = NULL; // disconnect from siblings
+		TREE_Result result = TREE_Transform_Dirty(child);
+		if (result)
+		{
+			return result;
+		}
+		child = nextSibling; // move to next sibling
+	}
+
+	// set child to NULL
+	transform->child = NULL;
+
+	// mark as dirty
+	TREE_Transform_Dirty(transform);
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Transform_Refresh(TREE_Transform *transform, TREE_Extent windowExtent)
+{
+	// validate
+	if (!transform)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// calculate global rectangle
+
+	// is parent offset and extent if there is one
+	// otherwise use origin and window extent
+	TREE_Transform *parent = transform->parent;
+	TREE_Offset offset;
+	TREE_Extent extent;
+	if (parent)
+	{
+		offset = parent->globalRect.offset;
+		extent = parent->globalRect.extent;
+	}
+	else
+	{
+		offset = (TREE_Offset){0, 0};
+		extent = windowExtent;
+	}
+
+	TREE_Alignment alignment = transform->localAlignment;
+	TREE_Rect result;
+
+	// top<-->bottom
+	if ((alignment & TREE_ALIGNMENT_VERTICALSTRETCH) == TREE_ALIGNMENT_VERTICALSTRETCH)
+	{
+		result.offset.y = offset.y + transform->localOffset.y;
+		result.extent.height = extent.height - transform->localExtent.height - transform->localOffset.y;
+	}
+	else if (alignment & TREE_ALIGNMENT_TOP)
+	{
+		result.offset.y = offset.y + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
+		result.extent.height = transform->localExtent.height;
+	}
+	else if (alignment & TREE_ALIGNMENT_BOTTOM)
+	{
+		result.offset.y = offset.y + extent.height + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
+		result.extent.height = transform->localExtent.height;
+	}
+	else
+	{
+		result.offset.y = offset.y + (extent.height + transform->localExtent.height) / 2 + transform->localOffset.y - (TREE_Int)(transform->localPivot.y * transform->localExtent.height);
+		result.extent.height = transform->localExtent.height;
+	}
+
+	// left<-->right
+	if ((alignment & TREE_ALIGNMENT_HORIZONTALSTRETCH) == TREE_ALIGNMENT_HORIZONTALSTRETCH)
+	{
+		result.offset.x = offset.x + transform->localOffset.x;
+		result.extent.width = extent.width - transform->localExtent.width - transform->localOffset.x;
+	}
+	else if (alignment & TREE_ALIGNMENT_LEFT)
+	{
+		result.offset.x = offset.x + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
+		result.extent.width = transform->localExtent.width;
+	}
+	else if (alignment & TREE_ALIGNMENT_RIGHT)
+	{
+		result.offset.x = offset.x + extent.width + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
+		result.extent.width = transform->localExtent.width;
+	}
+	else
+	{
+		result.offset.x = offset.x + (extent.width + transform->localExtent.width) / 2 + transform->localOffset.x - (TREE_Int)(transform->localPivot.x * transform->localExtent.width);
+		result.extent.width = transform->localExtent.width;
+	}
+
+	// set global rectangle
+	transform->globalRect = result;
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_Init(TREE_Control *control, TREE_Transform *parent, TREE_EventHandler eventHandler, TREE_Data data)
+{
+	// validate
+	if (!control || !eventHandler)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	TREE_Result result;
+
+	// allocate data
+	control->transform = TREE_NEW(TREE_Transform);
+	if (!control->transform)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	control->image = TREE_NEW(TREE_Image);
+	if (!control->image)
+	{
+		TREE_DELETE(control->transform);
+		return TREE_ERROR_ALLOC;
+	}
+
+	// set data
+	control->type = TREE_CONTROL_TYPE_NONE;
+	control->flags = TREE_CONTROL_FLAGS_NONE;
+	control->stateFlags = TREE_CONTROL_STATE_FLAGS_DIRTY;
+	result = TREE_Transform_Init(control->transform, (TREE_Offset){0, 0}, (TREE_Pivot){0.0f, 0.0f}, (TREE_Extent){0, 0}, TREE_ALIGNMENT_TOPLEFT);
+	if (result)
+	{
+		TREE_DELETE(control->image);
+		TREE_DELETE(control->transform);
+		return result;
+	}
+	result = TREE_Image_Init(control->image, (TREE_Extent){0, 0});
+	if (result)
+	{
+		TREE_Transform_Free(control->transform);
+		TREE_DELETE(control->image);
+		TREE_DELETE(control->transform);
+		return result;
+	}
+	memset(control->adjacent, 0, 4 * sizeof(TREE_Control *));
+	control->eventHandler = eventHandler;
+	control->data = data;
+	control->layer = TREE_LAYER_BASE;
+	control->drawnLayer = TREE_LAYER_BASE;
+
+	if (parent)
+	{
+		TREE_Result result = TREE_Transform_SetParent(control->transform, parent);
+		if (result)
+		{
+			return result;
+		}
+	}
+
+	return TREE_OK;
+}
+
+void TREE_Control_Free(TREE_Control *control)
+{
+	if (!control)
+	{
+		return;
+	}
+
+	// free data
+	TREE_Transform_Free(control->transform);
+	TREE_DELETE(control->transform);
+	TREE_Image_Free(control->image);
+	TREE_DELETE(control->image);
+}
+
+TREE_Result TREE_Control_SetLayer(TREE_Control *control, TREE_Layer layer)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (layer < TREE_LAYER_BASE || layer >= TREE_LAYER_COUNT)
+	{
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+
+	// the Application moves it to the new Layer when it next refreshes
+	control->layer = layer;
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_Layer TREE_Control_GetLayer(TREE_Control const *control)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_LAYER_BASE;
+	}
+
+	// active Controls, such as open Dropdowns, go over the Controls around them
+	if ((control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE) && control->layer < TREE_LAYER_POPUP)
+	{
+		return TREE_LAYER_POPUP;
+	}
+	return control->layer;
+}
+
+TREE_Result TREE_Control_Link(TREE_Control *control, TREE_Direction direction, TREE_ControlLink link, TREE_Control *other)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (direction == TREE_DIRECTION_NONE)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+	if (link != TREE_CONTROL_LINK_NONE && !other)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (!(other->flags & TREE_CONTROL_FLAGS_FOCUSABLE))
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// calculate indices
+	TREE_Size index = (TREE_Size)direction - 1;
+	TREE_Direction opposite = TREE_Direction_Opposite(direction);
+	TREE_Size oppositeIndex = (TREE_Size)opposite - 1;
+	TREE_Control *old = control->adjacent[index];
+
+	// perform linking
+	switch (link)
+	{
+	case TREE_CONTROL_LINK_NONE:
+		if (old && old->adjacent[oppositeIndex] == control)
+		{
+			old->adjacent[oppositeIndex] = NULL;
+		}
+		control->adjacent[index] = NULL;
+		break;
+	case TREE_CONTROL_LINK_SINGLE:
+		control->adjacent[index] = other;
+		break;
+	case TREE_CONTROL_LINK_DOUBLE:
+		control->adjacent[index] = other;
+		other->adjacent[oppositeIndex] = control;
+		break;
+	default:
+		return TREE_NOT_IMPLEMENTED;
+	}
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_HandleEvent(TREE_Control *control, TREE_Event const *event)
+{
+	// validate
+	if (!control || !event)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// if event handler, call it
+	if (control->eventHandler)
+	{
+		return control->eventHandler(event);
+	}
+
+	// no event handler, so ignore the event
+	return TREE_OK;
+}
+
+TREE_Size _TREE_ClampScroll(TREE_Size scroll, TREE_Size offset, TREE_Size extent)
+{
+	// adjust scroll
+	if (scroll + extent <= offset)
+	{
+		// scroll towards END
+		return offset + 1 - extent;
+	}
+	else if (scroll > offset)
+	{
+		// scroll towards HOME
+		return offset;
+	}
+	return scroll;
+}
+
+TREE_Size _TREE_WordWrapPass(TREE_String text, TREE_Size width, TREE_Char ***result, TREE_Size lineCount)
+{
+	if (!text || !*text || width == 0)
+	{
+		return 0;
+	}
+
+	// allocate lines, if count given
+	TREE_Char **lines = NULL;
+	if (result && lineCount > 0)
+	{
+		lines = TREE_NEW_ARRAY(TREE_Char *, lineCount);
+		if (!lines)
+		{
+			return 0;
+		}
+	}
+
+	// get number of lines
+	TREE_Size count = 0;
+	TREE_Size lastSpace = 0;
+	TREE_Size lastLine = 0;
+	TREE_Size textLength = strlen(text);
+	TREE_Char ch;
+	for (TREE_Size i = 0; i < textLength; i++)
+	{
+		ch = text[i];
+
+		if (ch == '\n')
+		{
 			// normal line end
 
 			// add to lines
@@ -3464,25 +6768,13 @@ TREE_Offset _TREE_CalculateCursorOffset(TREE_Size cursorPosition, TREE_Size *lin
 	return result;
 }
 
-TREE_Result _TREE_Control_Refresh_Text(TREE_Image *target, TREE_Offset controlOffset, TREE_Extent controlExtent, TREE_String text, TREE_Alignment alignment, TREE_Pixel design)
+TREE_Result _TREE_Control_Refresh_Text(TREE_ImageView *target, TREE_Offset controlOffset, TREE_Extent controlExtent, TREE_String text, TREE_Alignment alignment, TREE_Pixel design)
 {
 	TREE_Result result;
 
-	// resize image if needed
-	if (controlExtent.width != target->extent.width ||
-		controlExtent.height != target->extent.height)
-	{
-		TREE_Image_Free(target);
-		result = TREE_Image_Init(target, controlExtent);
-		if (result)
-		{
-			return result;
-		}
-	}
-
-	// draw onto the image
+	// draw onto the view
 	// draw the rect
-	result = TREE_Image_Clear(target, design);
+	result = TREE_ImageView_Clear(target, design);
 	if (result)
 	{
 		return result;
@@ -3518,7 +6810,7 @@ TREE_Result _TREE_Control_Refresh_Text(TREE_Image *target, TREE_Offset controlOf
 		for (TREE_Int i = 0; i < lineCount; i++)
 		{
 			offset.y = top + i;
-			result = TREE_Image_DrawString(
+			result = TREE_ImageView_DrawString(
 				target,
 				offset,
 				lines[i],
@@ -3535,7 +6827,7 @@ TREE_Result _TREE_Control_Refresh_Text(TREE_Image *target, TREE_Offset controlOf
 		{
 			offset.x = (TREE_Int)(controlExtent.width - strlen(lines[i])) / 2;
 			offset.y = top + i;
-			result = TREE_Image_DrawString(
+			result = TREE_ImageView_DrawString(
 				target,
 				offset,
 				lines[i],
@@ -3552,7 +6844,7 @@ TREE_Result _TREE_Control_Refresh_Text(TREE_Image *target, TREE_Offset controlOf
 		{
 			offset.x = (TREE_Int)(controlExtent.width - strlen(lines[i]));
 			offset.y = top + i;
-			result = TREE_Image_DrawString(
+			result = TREE_ImageView_DrawString(
 				target,
 				offset,
 				lines[i],
@@ -3637,6 +6929,7 @@ TREE_Result TREE_Control_Label_Init(TREE_Control *control, TREE_Transform *paren
 	control->transform->localExtent.width = (TREE_UInt)strlen(data->text);
 	control->transform->localExtent.height = 1;
 	control->type = TREE_CONTROL_TYPE_LABEL;
+	control->flags = TREE_CONTROL_FLAGS_DRAW_DIRECT;
 
 	return TREE_OK;
 }
@@ -3779,9 +7072,22 @@ TREE_Result TREE_Control_Label_EventHandler(TREE_Event const *event)
 	{
 	case TREE_EVENT_TYPE_REFRESH:
 	{
+		// drawn straight into the target instead
+		if (control->flags & TREE_CONTROL_FLAGS_DRAW_DIRECT)
+		{
+			break;
+		}
+
+		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (result)
+		{
+			return result;
+		}
+		TREE_ImageView view;
+		TREE_ImageView_Init(&view, control->image);
 		TREE_Offset offset = {0, 0};
 		result = _TREE_Control_Refresh_Text(
-			control->image,
+			&view,
 			offset,
 			control->transform->globalRect.extent,
 			labelData->text,
@@ -3799,6 +7105,24 @@ TREE_Result TREE_Control_Label_EventHandler(TREE_Event const *event)
 		// get the event data
 		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
 		TREE_Image *target = drawData->target;
+
+		// lay out the text within the part of the target that is being drawn
+		if (control->flags & TREE_CONTROL_FLAGS_DRAW_DIRECT)
+		{
+			TREE_Offset offset = {0, 0};
+			result = _TREE_Control_Refresh_Text(
+				&drawData->view,
+				offset,
+				control->transform->globalRect.extent,
+				labelData->text,
+				labelData->alignment,
+				labelData->theme->pixels[TREE_THEME_PID_NORMAL_TEXT]);
+			if (result)
+			{
+				return result;
+			}
+			break;
+		}
 		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
 
 		result = _TREE_Control_Draw(
@@ -3813,7 +7137,9 @@ TREE_Result TREE_Control_Label_EventHandler(TREE_Event const *event)
 
 		break;
 	}
-	}
+	default:
+		break;
+	}
 
 	return TREE_OK;
 }
@@ -3874,7 +7200,7 @@ TREE_Result TREE_Control_Button_Init(TREE_Control *control, TREE_Transform *pare
 	control->transform->localExtent.width = 20;
 	control->transform->localExtent.height = 3;
 	control->type = TREE_CONTROL_TYPE_BUTTON;
-	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
+	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE | TREE_CONTROL_FLAGS_DRAW_DIRECT;
 
 	return TREE_OK;
 }
@@ -3994,6 +7320,20 @@ TREE_ControlEventHandler TREE_Control_Button_GetOnSubmit(TREE_Control *control)
 	return buttonData->onSubmit;
 }
 
+TREE_Pixel const *_TREE_Control_Button_GetPixel(TREE_Control const *control, TREE_Control_ButtonData const *buttonData)
+{
+	// determine pixel from state
+	if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE)
+	{
+		return &buttonData->theme->pixels[TREE_THEME_PID_ACTIVE];
+	}
+	if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+	{
+		return &buttonData->theme->pixels[TREE_THEME_PID_FOCUSED];
+	}
+	return &buttonData->theme->pixels[TREE_THEME_PID_NORMAL];
+}
+
 TREE_Result TREE_Control_Button_EventHandler(TREE_Event const *event)
 {
 	// validate
@@ -4057,25 +7397,27 @@ TREE_Result TREE_Control_Button_EventHandler(TREE_Event const *event)
 	}
 	case TREE_EVENT_TYPE_REFRESH:
 	{
-		// determine pixel from state
-		TREE_Pixel const *pixel = &buttonData->theme->pixels[TREE_THEME_PID_NORMAL];
-		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE)
+		// drawn straight into the target instead
+		if (control->flags & TREE_CONTROL_FLAGS_DRAW_DIRECT)
 		{
-			pixel = &buttonData->theme->pixels[TREE_THEME_PID_ACTIVE];
+			break;
 		}
-		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+
+		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (result)
 		{
-			pixel = &buttonData->theme->pixels[TREE_THEME_PID_FOCUSED];
+			return result;
 		}
-
+		TREE_ImageView view;
+		TREE_ImageView_Init(&view, control->image);
 		TREE_Offset offset = {0, 0};
 		result = _TREE_Control_Refresh_Text(
-			control->image,
+			&view,
 			offset,
 			control->transform->globalRect.extent,
 			buttonData->text,
 			buttonData->alignment,
-			*pixel);
+			*_TREE_Control_Button_GetPixel(control, buttonData));
 		if (result)
 		{
 			return result;
@@ -4088,6 +7430,24 @@ TREE_Result TREE_Control_Button_EventHandler(TREE_Event const *event)
 		// get the event data
 		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
 		TREE_Image *target = drawData->target;
+
+		// lay out the text within the part of the target that is being drawn
+		if (control->flags & TREE_CONTROL_FLAGS_DRAW_DIRECT)
+		{
+			TREE_Offset offset = {0, 0};
+			result = _TREE_Control_Refresh_Text(
+				&drawData->view,
+				offset,
+				control->transform->globalRect.extent,
+				buttonData->text,
+				buttonData->alignment,
+				*_TREE_Control_Button_GetPixel(control, buttonData));
+			if (result)
+			{
+				return result;
+			}
+			break;
+		}
 		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
 
 		result = _TREE_Control_Draw(
@@ -4102,6 +7462,8 @@ TREE_Result TREE_Control_Button_EventHandler(TREE_Event const *event)
 
 		break;
 	}
+	default:
+		break;
 	}
 	return TREE_OK;
 }
@@ -4301,1636 +7663,2371 @@ TREE_Result TREE_Control_TextInput_SetType(TREE_Control *control, TREE_Control_T
 	return TREE_OK;
 }
 
-TREE_Control_TextInputType TREE_Control_TextInput_GetType(TREE_Control *control)
+TREE_Control_TextInputType TREE_Control_TextInput_GetType(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_CONTROL_TEXT_INPUT_TYPE_NONE;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_CONTROL_TEXT_INPUT_TYPE_NONE;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// return type
+	return textInputData->type;
+}
+
+TREE_Result TREE_Control_TextInput_SetText(TREE_Control *control, TREE_String text)
+{
+	// validate
+	if (!control || !text)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// get size, limited by the capacity
+	TREE_Size textLength = strlen(text);
+	TREE_Size capacity = textInputData->capacity;
+	if (textLength > capacity)
+	{
+		textLength = capacity;
+	}
+
+	// copy the text
+	memcpy(textInputData->text, text, textLength * sizeof(TREE_Char));
+	textInputData->text[textLength] = '\0'; // null terminator
+
+	// mark as dirty to get redrawn
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_String TREE_Control_TextInput_GetText(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return NULL;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// return text
+	return textInputData->text;
+}
+
+TREE_Result TREE_Control_TextInput_SetCapacity(TREE_Control *control, TREE_Size capacity)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// set data
+	textInputData->capacity = capacity;
+
+	// reallocate text
+	TREE_Char *copy;
+	TREE_Result result = TREE_String_CreateClampedCopy(&copy, textInputData->text, capacity);
+	if (result)
+	{
+		return result;
+	}
+	TREE_REPLACE(textInputData->text, copy);
+
+	// mark as dirty to get redrawn
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_Size TREE_Control_TextInput_GetCapacity(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return 0;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return 0;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// return capacity
+	return textInputData->capacity;
+}
+
+TREE_Result TREE_Control_TextInput_SetPlaceholder(TREE_Control *control, TREE_String placeholder)
+{
+	// validate
+	if (!control || !placeholder)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// create copy
+	TREE_Char *copy;
+	TREE_Result result = TREE_String_CreateCopy(&copy, placeholder);
+	if (result)
+	{
+		return result;
+	}
+
+	// set data
+	TREE_REPLACE(textInputData->placeholder, copy);
+
+	// mark as dirty to get redrawn
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_String TREE_Control_TextInput_GetPlaceholder(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return NULL;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// return placeholder
+	return textInputData->placeholder;
+}
+
+TREE_Result TREE_Control_TextInput_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// set data
+	textInputData->onChange = onChange;
+	return TREE_OK;
+}
+
+TREE_ControlEventHandler TREE_Control_TextInput_GetOnChange(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return NULL;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// return onChange function
+	return textInputData->onChange;
+}
+
+TREE_Result TREE_Control_TextInput_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// get data
+	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+
+	// set data
+	textInputData->onSubmit = onSubmit;
+	return TREE_OK;
+}
+
+TREE_ControlEventHandler TREE_Control_TextInput_GetOnSubmit(TREE_Control *control)
 {
 	// validate
 	if (!control)
 	{
-		return TREE_CONTROL_TEXT_INPUT_TYPE_NONE;
+		return NULL;
 	}
 	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
 	{
-		return TREE_CONTROL_TEXT_INPUT_TYPE_NONE;
+		return NULL;
 	}
 
 	// get data
 	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
 
-	// return type
-	return textInputData->type;
+	// return onSubmit function
+	return textInputData->onSubmit;
 }
 
-TREE_Result TREE_Control_TextInput_SetText(TREE_Control *control, TREE_String text)
+TREE_Bool _TREE_IsCharSafe(TREE_Char ch)
 {
-	// validate
-	if (!control || !text)
+	return ch >= 32 && ch <= 126;
+}
+
+void _TREE_MakeSafe(TREE_Char *text, TREE_Size size)
+{
+	// make the text safe
+	for (TREE_Size i = 0; i < size; i++)
 	{
-		return TREE_ERROR_ARG_NULL;
+		if (!_TREE_IsCharSafe(text[i]))
+		{
+			text[i] = ' ';
+		}
 	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+}
+
+TREE_Char *_TREE_MakeSafeCopy(TREE_Char *text, TREE_Size size)
+{
+	// allocate new text
+	TREE_Char *newText = TREE_NEW_ARRAY(TREE_Char, size + 1);
+	if (!newText)
 	{
-		return TREE_ERROR_ARG_INVALID;
+		return NULL;
 	}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+	// copy the text
+	memcpy(newText, text, size * sizeof(TREE_Char));
+	newText[size] = '\0'; // null terminator
 
-	// get size, limited by the capacity
-	TREE_Size textLength = strlen(text);
-	TREE_Size capacity = textInputData->capacity;
-	if (textLength > capacity)
+	// make it safe
+	_TREE_MakeSafe(newText, size);
+
+	return newText;
+}
+
+TREE_Size _TREE_SeekDifferentCharType(TREE_Char *text, TREE_Size textLength, TREE_Size index)
+{
+	TREE_CharType type = TREE_Char_GetType(text[index]);
+	for (TREE_Size i = index; i < textLength; i++)
 	{
-		textLength = capacity;
+		if (TREE_Char_GetType(text[i]) != type)
+		{
+			return i + 1;
+		}
+	}
+	return textLength;
+}
+
+TREE_Size _TREE_SeekDifferentCharTypeReverse(TREE_Char *text, TREE_Size textLength, TREE_Size index)
+{
+	TREE_CharType type = TREE_Char_GetType(text[index]);
+	for (TREE_Size i = index; i > 0; i--)
+	{
+		if (TREE_Char_GetType(text[i]) != type)
+		{
+			return i;
+		}
 	}
+	return 0;
+}
 
-	// copy the text
-	memcpy(textInputData->text, text, textLength * sizeof(TREE_Char));
-	textInputData->text[textLength] = '\0'; // null terminator
+TREE_Pixel _TREE_GetCursorPixel(TREE_Pixel design, TREE_Bool insert, TREE_Size index, TREE_String text, TREE_Size textLength)
+{
+	TREE_Pixel cursorPixel = design;
 
-	// mark as dirty to get redrawn
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	// if inserting, and index is over a character, and the character is safe, use it
+	if (insert && index < textLength && _TREE_IsCharSafe(text[index]))
+	{
+		cursorPixel.character = text[index];
+	}
 
-	return TREE_OK;
+	return cursorPixel;
 }
 
-TREE_String TREE_Control_TextInput_GetText(TREE_Control *control)
+TREE_Result _TREE_Control_TextInput_FollowCursor(TREE_Control *control, TREE_Control_TextInputData *data, TREE_Bool updateCursorOffset)
 {
-	// validate
-	if (!control)
+	TREE_Extent const *extent = &control->transform->globalRect.extent;
+	TREE_Bool multiline = extent->height > 1;
+
+	TREE_Size scrollExtent;
+	TREE_Size scrollOffset;
+	if (multiline)
+	{
+		// scroll is up and down on multiline
+
+		// get word wrap offsets
+		TREE_Char **lines;
+		TREE_Size lineCount;
+		TREE_Size *lineOffsets;
+		TREE_Result result = _TREE_WordWrapAndOffsets(
+			data->text,
+			extent->width,
+			&lines,
+			&lineCount,
+			&lineOffsets);
+		if (result)
+		{
+			return result;
+		}
+
+		// get cursor offset
+		TREE_Offset cursorOffset = _TREE_CalculateCursorOffset(
+			data->cursorPosition,
+			lineOffsets,
+			lineCount);
+		TREE_DELETE_ARRAY(lines, lineCount);
+		TREE_DELETE(lineOffsets);
+
+		if (updateCursorOffset)
+		{
+			// update the cursor offset
+			data->cursorOffset.x = cursorOffset.x;
+			data->cursorOffset.y = cursorOffset.y;
+		}
+
+		// calculate the line number
+		scrollOffset = cursorOffset.y;
+		scrollExtent = extent->height;
+	}
+	else
 	{
-		return NULL;
+		scrollOffset = data->cursorPosition;
+		scrollExtent = extent->width;
 	}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+	// adjust scroll
+	data->scroll = _TREE_ClampScroll(data->scroll, scrollOffset, scrollExtent);
 
-	// return text
-	return textInputData->text;
+	return TREE_OK;
 }
 
-TREE_Result TREE_Control_TextInput_SetCapacity(TREE_Control *control, TREE_Size capacity)
+TREE_Result TREE_Control_TextInput_EventHandler(TREE_Event const *event)
 {
 	// validate
-	if (!control)
+	if (!event)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	if (event->control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
 	{
 		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+	// get the data
+	TREE_Control *control = event->control;
+	TREE_Control_TextInputData *data = (TREE_Control_TextInputData *)event->control->data;
+	TREE_Result result;
+
+	// determine if multiline or single line
+	TREE_Extent const *extent = &control->transform->globalRect.extent;
+	TREE_Bool multiline = extent->height > 1;
+
+	// handle the event
+	switch (event->type)
+	{
+	case TREE_EVENT_TYPE_KEY_DOWN:
+	case TREE_EVENT_TYPE_KEY_HELD:
+	{
+		// ignore if not focused
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
+		{
+			break;
+		}
+
+		// get the event data
+		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
+		TREE_Key key = keyData->key;
+
+		// if not active, do nothing
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		{
+			// if not active but a submit key is pressed, become active
+			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
+			{
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		}
+
+		// get text length for calculations
+		TREE_Size textLength = strlen(data->text);
+
+		TREE_Bool cursorMoved = TREE_FALSE;
+		TREE_Bool updateCursorOffset = TREE_FALSE;
+
+		// reset cursor timer, as long as the input is not a modifier key
+		if (key != TREE_KEY_SHIFT && key != TREE_KEY_ALT && key != TREE_KEY_CONTROL)
+		{
+			data->cursorTimer = 0;
+		}
+
+		// handle key inputs
+		switch (key)
+		{
+		case TREE_KEY_ESCAPE: // exit out of active state, call submit function
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onSubmit, control, &data->text);
+			break;
+		case TREE_KEY_BACKSPACE: // remove character before cursor
+			// if control held, "select" until a space found
+			if (data->cursorPosition > 0 && data->selectionStart == data->selectionEnd && keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+			{
+				// find the last space before the cursor
+				data->selectionEnd = data->cursorPosition;
+				data->selectionStart = _TREE_SeekDifferentCharTypeReverse(data->text, textLength, data->cursorPosition - 1);
+			}
+			if (data->selectionStart != data->selectionEnd)
+			{
+				// remove selected text
+				TREE_Result result = TREE_Control_TextInputData_RemoveSelectedText(data);
+				if (result)
+				{
+					return result;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				CALL_ACTION(data->onChange, control, &data->text);
+				updateCursorOffset = TREE_TRUE;
+			}
+			else if (data->cursorPosition > 0)
+			{
+				// shift string over
+				memmove(&data->text[data->cursorPosition - 1], &data->text[data->cursorPosition], (textLength - data->cursorPosition) * sizeof(TREE_Char));
+				data->text[textLength - 1] = '\0'; // null terminator
+				data->cursorPosition--;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				CALL_ACTION(data->onChange, control, &data->text);
+				updateCursorOffset = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_DELETE: // remove character at cursor
+			// if control held, "select" until a space found
+			if (data->cursorPosition < textLength && data->selectionStart == data->selectionEnd && keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+			{
+				// find the next space after the cursor
+				data->selectionStart = data->cursorPosition;
+				data->selectionEnd = _TREE_SeekDifferentCharType(data->text, textLength, data->cursorPosition);
+			}
+			if (data->selectionStart != data->selectionEnd)
+			{
+				// remove selected text
+				TREE_Result result = TREE_Control_TextInputData_RemoveSelectedText(data);
+				if (result)
+				{
+					return result;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				CALL_ACTION(data->onChange, control, &data->text);
+				updateCursorOffset = TREE_TRUE;
+			}
+			else if (data->cursorPosition < textLength)
+			{
+				// shift string over
+				memmove(&data->text[data->cursorPosition], &data->text[data->cursorPosition + 1], (textLength - data->cursorPosition) * sizeof(TREE_Char));
+				data->text[textLength - 1] = '\0'; // null terminator
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				CALL_ACTION(data->onChange, control, &data->text);
+				updateCursorOffset = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_LEFT_ARROW: // move cursor left 1
+			if (data->cursorPosition > 0)
+			{
+				// if control held, move until a space found
+				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+				{
+					data->cursorPosition = _TREE_SeekDifferentCharTypeReverse(data->text, textLength, data->cursorPosition - 1);
+				}
+				else
+				{
+					data->cursorPosition--;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+				updateCursorOffset = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_RIGHT_ARROW: // move cursor right 1
+			if (data->cursorPosition < textLength)
+			{
+				// if control held, move until a space found
+				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+				{
+					data->cursorPosition = _TREE_SeekDifferentCharType(data->text, textLength, data->cursorPosition);
+				}
+				else
+				{
+					data->cursorPosition++;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+				updateCursorOffset = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_UP_ARROW: // move cursor up 1
+			if (data->cursorPosition > 0)
+			{
+				if (multiline)
+				{
+					// if on first line, move to start of line
+					if (data->cursorOffset.y == 0)
+					{
+						data->cursorPosition = 0;
+						data->cursorOffset.x = 0;
+					}
+					else
+					{
+						// move cursor up 1 line
+						data->cursorOffset.y -= 1;
+
+						// get the line offsets
+						TREE_Size lineCount = 0;
+						TREE_Size *lineOffsets = NULL;
+						TREE_Char **lines = NULL;
+						result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+						if (result)
+						{
+							return result;
+						}
 
-	// set data
-	textInputData->capacity = capacity;
+						// set position based on line
+						TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
+						data->cursorPosition = lineOffsets[data->cursorOffset.y] + MIN(lineSize - 1, (TREE_Size)data->cursorOffset.x);
+					}
+				}
+				else
+				{
+					// act like HOME if single line
+					data->cursorPosition = 0;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_DOWN_ARROW: // move cursor down 1
+			if (data->cursorPosition < textLength)
+			{
+				if (multiline)
+				{
+					// get the line offsets
+					TREE_Size lineCount = 0;
+					TREE_Size *lineOffsets = NULL;
+					TREE_Char **lines = NULL;
+					result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+					if (result)
+					{
+						return result;
+					}
 
-	// reallocate text
-	TREE_Char *copy;
-	TREE_Result result = TREE_String_CreateClampedCopy(&copy, textInputData->text, capacity);
-	if (result)
-	{
-		return result;
-	}
-	TREE_REPLACE(textInputData->text, copy);
+					// if on last line, move to end of line
+					if (data->cursorOffset.y == lineCount - 1)
+					{
+						data->cursorPosition = textLength;
+						TREE_Size lastLineLength = strlen(lines[lineCount - 1]);
+						if (lastLineLength)
+						{
+							data->cursorOffset.x = (TREE_Int)lastLineLength;
+						}
+						else
+						{
+							data->cursorOffset.x = 0;
+						}
+					}
+					else
+					{
+						// move to next line
+						data->cursorOffset.y += 1;
 
-	// mark as dirty to get redrawn
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+						// set position based on line
+						TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
+						if (lineSize)
+						{
+							TREE_Size adjustment = data->cursorOffset.y == lineCount - 1 ? 0 : 1;
+							data->cursorPosition = lineOffsets[data->cursorOffset.y] + MIN(lineSize - adjustment, (TREE_Size)data->cursorOffset.x);
+						}
+						else
+						{
+							data->cursorPosition = lineOffsets[data->cursorOffset.y];
+						}
+					}
+				}
+				else
+				{
+					// act like END if single line
+					data->cursorPosition = textLength;
+				}
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_HOME: // move cursor to start
+			if (multiline)
+			{
+				// move to start of line
+				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+				{
+					// set position based on total text
+					data->cursorPosition = 0;
+					data->cursorOffset.x = 0;
+					data->cursorOffset.y = 0;
+				}
+				else
+				{
+					// get the line offsets
+					TREE_Size lineCount = 0;
+					TREE_Size *lineOffsets = NULL;
+					TREE_Char **lines = NULL;
+					result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+					if (result)
+					{
+						return result;
+					}
 
-	return TREE_OK;
-}
+					// set position based on line
+					TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
+					data->cursorPosition = lineOffsets[data->cursorOffset.y];
+					data->cursorOffset.x = 0;
+				}
+			}
+			else
+			{
+				// move to start of text
+				data->cursorPosition = 0;
+				updateCursorOffset = TREE_TRUE;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			cursorMoved = TREE_TRUE;
+			break;
+		case TREE_KEY_END: // move cursor to end
+			if (multiline)
+			{
+				// move to end of line
 
-TREE_Size TREE_Control_TextInput_GetCapacity(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return 0;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return 0;
-	}
+				// get the line offsets
+				TREE_Size lineCount = 0;
+				TREE_Size *lineOffsets = NULL;
+				TREE_Char **lines = NULL;
+				result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+				if (result)
+				{
+					return result;
+				}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL || data->cursorOffset.y == lineCount - 1)
+				{
+					// set position based on total text
+					data->cursorPosition = textLength;
+					data->cursorOffset.x = (TREE_Int)strlen(lines[lineCount - 1]);
+					data->cursorOffset.y = (TREE_Int)lineCount - 1;
+				}
+				else
+				{
+					// set position based on line
+					TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
+					data->cursorPosition = lineOffsets[data->cursorOffset.y] + lineSize - 1;
+					data->cursorOffset.x = (TREE_Int)lineSize - 1;
+				}
+			}
+			else
+			{
+				// move to end of text
+				data->cursorPosition = textLength;
+				updateCursorOffset = TREE_TRUE;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			cursorMoved = TREE_TRUE;
+			break;
+		default:
+		{
+			// if single line, and enter key pressed, submit
+			if (key == TREE_KEY_ENTER && !multiline)
+			{
+				// if singleline, treat enter as a submit
+				control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				CALL_ACTION(data->onSubmit, control, &data->text);
+				break;
+			}
 
-	// return capacity
-	return textInputData->capacity;
-}
+			// if at capacity, ignore new characters
+			if (textLength >= data->capacity)
+			{
+				TREE_Window_Beep();
+				break;
+			}
 
-TREE_Result TREE_Control_TextInput_SetPlaceholder(TREE_Control *control, TREE_String placeholder)
-{
-	// validate
-	if (!control || !placeholder)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+			// get the character to add
+			TREE_Char ch = TREE_Key_ToChar(key, keyData->modifiers);
 
-	// create copy
-	TREE_Char *copy;
-	TREE_Result result = TREE_String_CreateCopy(&copy, placeholder);
-	if (result)
-	{
-		return result;
-	}
+			// if invalid, ignore it, with exceptions
+			if (!_TREE_IsCharSafe(ch) && (!multiline || ch != '\n'))
+			{
+				break;
+			}
 
-	// set data
-	TREE_REPLACE(textInputData->placeholder, copy);
+			updateCursorOffset = TREE_TRUE;
 
-	// mark as dirty to get redrawn
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			data->cursorTimer = 0;
 
-	return TREE_OK;
-}
+			// check for special inputs
+			TREE_Bool ctrl = (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) != 0;
+			if (ctrl && key == TREE_KEY_C)
+			{
+				// get selection text
+				TREE_Char *text = TREE_Control_TextInputData_GetSelectedText(data);
 
-TREE_String TREE_Control_TextInput_GetPlaceholder(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return NULL;
-	}
+				// copy selection to clipboard, if there is something selected
+				if (text)
+				{
+					// set the clipboard text
+					result = TREE_Clipboard_SetText(text);
+					TREE_DELETE(text);
+					if (result)
+					{
+						return result;
+					}
+				}
+				break;
+			}
+			if (ctrl && key == TREE_KEY_V)
+			{
+				// remove selection, if any
+				result = TREE_Control_TextInputData_RemoveSelectedText(data);
+				if (result)
+				{
+					return result;
+				}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+				// paste from clipboard
+				TREE_Char *text = NULL;
+				result = TREE_Clipboard_GetText(&text);
+				if (result)
+				{
+					return result;
+				}
+				TREE_Size textLength = strlen(text);
 
-	// return placeholder
-	return textInputData->placeholder;
-}
+				// insert clipboard text
+				result = TREE_Control_TextInputData_InsertText(data, text);
+				TREE_DELETE(text);
+				if (result)
+				{
+					return result;
+				}
 
-TREE_Result TREE_Control_TextInput_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
-{
-	// validate
-	if (!control)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
+				// mark as dirty
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+				// call onChange
+				CALL_ACTION(data->onChange, control, &data->text);
 
-	// set data
-	textInputData->onChange = onChange;
-	return TREE_OK;
-}
+				break;
+			}
+			if (ctrl && key == TREE_KEY_X)
+			{
+				// copy selection, and remove it
 
-TREE_ControlEventHandler TREE_Control_TextInput_GetOnChange(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return NULL;
-	}
+				// get selection text
+				TREE_Char *text = TREE_Control_TextInputData_GetSelectedText(data);
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+				// copy selection to clipboard, if there is something selected
+				if (text)
+				{
+					// set the clipboard text
+					result = TREE_Clipboard_SetText(text);
+					TREE_DELETE(text);
+					if (result)
+					{
+						return result;
+					}
 
-	// return onChange function
-	return textInputData->onChange;
-}
+					// remove selected text
+					result = TREE_Control_TextInputData_RemoveSelectedText(data);
+					if (result)
+					{
+						return result;
+					}
 
-TREE_Result TREE_Control_TextInput_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
-{
-	// validate
-	if (!control)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
+					// mark as dirty
+					control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+					// call onChange
+					CALL_ACTION(data->onChange, control, &data->text);
+				}
+				break;
+			}
+			if (ctrl && key == TREE_KEY_A)
+			{
+				// select all text
+				data->selectionOrigin = 0;
+				data->selectionStart = 0;
+				data->selectionEnd = textLength;
+				data->cursorPosition = textLength;
 
-	// set data
-	textInputData->onSubmit = onSubmit;
-	return TREE_OK;
-}
+				// mark as dirty
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-TREE_ControlEventHandler TREE_Control_TextInput_GetOnSubmit(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return NULL;
-	}
-	if (control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
-	{
-		return NULL;
-	}
+				break;
+			}
 
-	// get data
-	TREE_Control_TextInputData *textInputData = (TREE_Control_TextInputData *)control->data;
+			// type normal character
 
-	// return onSubmit function
-	return textInputData->onSubmit;
-}
+			// remove selection, if any
+			result = TREE_Control_TextInputData_RemoveSelectedText(data);
+			if (result)
+			{
+				return result;
+			}
 
-TREE_Bool _TREE_IsCharSafe(TREE_Char ch)
-{
-	return ch >= 32 && ch <= 126;
-}
+			// shift string over, if needed
+			if (data->cursorPosition < textLength)
+			{
+				memmove(&data->text[data->cursorPosition + 1], &data->text[data->cursorPosition], (textLength - data->cursorPosition) * sizeof(TREE_Char));
+			}
+			data->text[textLength + 1] = '\0'; // null terminator
 
-void _TREE_MakeSafe(TREE_Char *text, TREE_Size size)
-{
-	// make the text safe
-	for (TREE_Size i = 0; i < size; i++)
-	{
-		if (!_TREE_IsCharSafe(text[i]))
-		{
-			text[i] = ' ';
+			// insert character
+			data->text[data->cursorPosition] = ch;
+			data->cursorPosition++;
+			CALL_ACTION(data->onChange, control, &data->text);
+			break;
+		}
 		}
-	}
-}
 
-TREE_Char *_TREE_MakeSafeCopy(TREE_Char *text, TREE_Size size)
-{
-	// allocate new text
-	TREE_Char *newText = TREE_NEW_ARRAY(TREE_Char, size + 1);
-	if (!newText)
-	{
-		return NULL;
-	}
+		// if cursor moved, update the scroll region
+		if (cursorMoved)
+		{
+			if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_SHIFT)
+			{
+				// if cursor moved, update selection
 
-	// copy the text
-	memcpy(newText, text, size * sizeof(TREE_Char));
-	newText[size] = '\0'; // null terminator
+				// set origin if cursor at origin
+				if (data->selectionStart == data->selectionEnd)
+				{
+					data->selectionOrigin = data->selectionStart;
+				}
 
-	// make it safe
-	_TREE_MakeSafe(newText, size);
+				// update selection
+				if (data->cursorPosition <= data->selectionOrigin)
+				{
+					data->selectionStart = data->cursorPosition;
+					data->selectionEnd = data->selectionOrigin;
+				}
+				if (data->cursorPosition >= data->selectionOrigin)
+				{
+					data->selectionEnd = data->cursorPosition;
+					data->selectionStart = data->selectionOrigin;
+				}
+			}
+			else
+			{
+				// cursor moved, but no shift pressed
+				data->selectionStart = data->cursorPosition;
+				data->selectionEnd = data->cursorPosition;
+			}
+		}
+		else if (data->selectionStart == data->selectionEnd && data->selectionStart != data->cursorPosition)
+		{
+			// cursor moved due to a modification
+			data->selectionStart = data->cursorPosition;
+			data->selectionEnd = data->cursorPosition;
+		}
 
-	return newText;
-}
+		// clamp the scroll to follow the cursor
+		result = _TREE_Control_TextInput_FollowCursor(control, data, updateCursorOffset);
+		if (result)
+		{
+			return result;
+		}
 
-TREE_Size _TREE_SeekDifferentCharType(TREE_Char *text, TREE_Size textLength, TREE_Size index)
-{
-	TREE_CharType type = TREE_Char_GetType(text[index]);
-	for (TREE_Size i = index; i < textLength; i++)
+		break;
+	}
+	case TREE_EVENT_TYPE_PASTE:
 	{
-		if (TREE_Char_GetType(text[i]) != type)
+		// ignore if not focused and active
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED) || !(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
 		{
-			return i + 1;
+			break;
 		}
-	}
-	return textLength;
-}
+		TREE_EventData_Paste *pasteData = (TREE_EventData_Paste *)event->data;
 
-TREE_Size _TREE_SeekDifferentCharTypeReverse(TREE_Char *text, TREE_Size textLength, TREE_Size index)
-{
-	TREE_CharType type = TREE_Char_GetType(text[index]);
-	for (TREE_Size i = index; i > 0; i--)
-	{
-		if (TREE_Char_GetType(text[i]) != type)
+		// keep the characters that can be typed, and the line breaks if multiline
+		TREE_Char *text = TREE_NEW_ARRAY(TREE_Char, pasteData->length + 1);
+		if (!text)
 		{
-			return i;
+			return TREE_ERROR_ALLOC;
 		}
-	}
-	return 0;
-}
+		TREE_Size length = 0;
+		for (TREE_Size i = 0; i < pasteData->length; ++i)
+		{
+			TREE_Char ch = pasteData->text[i];
+			if (_TREE_IsCharSafe(ch) || (multiline && ch == '\n'))
+			{
+				text[length++] = ch;
+			}
+			else if (ch == '\n' || ch == '\t')
+			{
+				text[length++] = ' ';
+			}
+		}
+		text[length] = '\0';
 
-TREE_Pixel _TREE_GetCursorPixel(TREE_Pixel design, TREE_Bool insert, TREE_Size index, TREE_String text, TREE_Size textLength)
-{
-	TREE_Pixel cursorPixel = design;
+		// replace the selection, if any, with the whole paste at once
+		result = TREE_Control_TextInputData_RemoveSelectedText(data);
+		if (!result)
+		{
+			result = TREE_Control_TextInputData_InsertText(data, text);
+		}
+		TREE_DELETE(text);
+		if (result)
+		{
+			return result;
+		}
+		data->selectionStart = data->cursorPosition;
+		data->selectionEnd = data->cursorPosition;
+		data->cursorTimer = 0;
 
-	// if inserting, and index is over a character, and the character is safe, use it
-	if (insert && index < textLength && _TREE_IsCharSafe(text[index]))
-	{
-		cursorPixel.character = text[index];
-	}
+		// mark as dirty
+		control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-	return cursorPixel;
-}
+		// call onChange
+		CALL_ACTION(data->onChange, control, &data->text);
 
-TREE_Result TREE_Control_TextInput_EventHandler(TREE_Event const *event)
-{
-	// validate
-	if (!event)
-	{
-		return TREE_ERROR_ARG_NULL;
+		// clamp the scroll to follow the cursor
+		result = _TREE_Control_TextInput_FollowCursor(control, data, TREE_TRUE);
+		if (result)
+		{
+			return result;
+		}
+
+		break;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_TEXT_INPUT)
+	case TREE_EVENT_TYPE_REFRESH:
 	{
-		return TREE_ERROR_ARG_INVALID;
-	}
+		result = TREE_Image_Resize(control->image, *extent);
+		if (result)
+		{
+			return result;
+		}
 
-	// get the data
-	TREE_Control *control = event->control;
-	TREE_Control_TextInputData *data = (TREE_Control_TextInputData *)event->control->data;
-	TREE_Result result;
+		TREE_Bool active = (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
 
-	// determine if multiline or single line
-	TREE_Extent const *extent = &control->transform->globalRect.extent;
-	TREE_Bool multiline = extent->height > 1;
+		// determine pixel from state
+		TREE_Pixel const *pixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
+		if (active)
+		{
+			pixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
+		}
+		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+		{
+			pixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
+		}
 
-	// handle the event
-	switch (event->type)
-	{
-	case TREE_EVENT_TYPE_KEY_DOWN:
-	case TREE_EVENT_TYPE_KEY_HELD:
-	{
-		// ignore if not focused
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
+		// draw the background
+		result = TREE_Image_Clear(control->image, *pixel);
+		if (result)
 		{
-			break;
+			return result;
 		}
 
-		// get the event data
-		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
-		TREE_Key key = keyData->key;
+		// determine what text to draw
+		TREE_Char *text = data->text;
+		TREE_Bool disposeText = TREE_FALSE;
 
-		// if not active, do nothing
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		// if not active and no text, use placeholder
+		if (!(active) && !text[0])
 		{
-			// if not active but a submit key is pressed, become active
-			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
+			text = data->placeholder;
+		}
+		// if not placeholder and is a password, replace with stars
+		else if (data->type == TREE_CONTROL_TEXT_INPUT_TYPE_PASSWORD)
+		{
+			TREE_Size textLength = strlen(text);
+			TREE_Char *passwordText = TREE_NEW_ARRAY(TREE_Char, textLength + 1);
+			if (!passwordText)
 			{
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
+				return TREE_ERROR_ALLOC;
 			}
-			break;
+			memset(passwordText, '*', textLength);
+			passwordText[textLength] = '\0'; // null terminator
+			text = passwordText;
+			disposeText = TREE_TRUE;
 		}
 
-		// get text length for calculations
-		TREE_Size textLength = strlen(data->text);
-
-		TREE_Bool cursorMoved = TREE_FALSE;
-		TREE_Bool updateCursorOffset = TREE_FALSE;
+		TREE_Size textLength = strlen(text);
 
-		// reset cursor timer, as long as the input is not a modifier key
-		if (key != TREE_KEY_SHIFT && key != TREE_KEY_ALT && key != TREE_KEY_CONTROL)
+		if (multiline)
 		{
-			data->cursorTimer = 0;
-		}
+			// multiline
 
-		// handle key inputs
-		switch (key)
-		{
-		case TREE_KEY_ESCAPE: // exit out of active state, call submit function
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onSubmit, control, &data->text);
-			break;
-		case TREE_KEY_BACKSPACE: // remove character before cursor
-			// if control held, "select" until a space found
-			if (data->cursorPosition > 0 && data->selectionStart == data->selectionEnd && keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
-			{
-				// find the last space before the cursor
-				data->selectionEnd = data->cursorPosition;
-				data->selectionStart = _TREE_SeekDifferentCharTypeReverse(data->text, textLength, data->cursorPosition - 1);
-			}
-			if (data->selectionStart != data->selectionEnd)
-			{
-				// remove selected text
-				TREE_Result result = TREE_Control_TextInputData_RemoveSelectedText(data);
-				if (result)
-				{
-					return result;
-				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				CALL_ACTION(data->onChange, control, &data->text);
-				updateCursorOffset = TREE_TRUE;
-			}
-			else if (data->cursorPosition > 0)
-			{
-				// shift string over
-				memmove(&data->text[data->cursorPosition - 1], &data->text[data->cursorPosition], (textLength - data->cursorPosition) * sizeof(TREE_Char));
-				data->text[textLength - 1] = '\0'; // null terminator
-				data->cursorPosition--;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				CALL_ACTION(data->onChange, control, &data->text);
-				updateCursorOffset = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_DELETE: // remove character at cursor
-			// if control held, "select" until a space found
-			if (data->cursorPosition < textLength && data->selectionStart == data->selectionEnd && keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
-			{
-				// find the next space after the cursor
-				data->selectionStart = data->cursorPosition;
-				data->selectionEnd = _TREE_SeekDifferentCharType(data->text, textLength, data->cursorPosition);
-			}
-			if (data->selectionStart != data->selectionEnd)
-			{
-				// remove selected text
-				TREE_Result result = TREE_Control_TextInputData_RemoveSelectedText(data);
-				if (result)
-				{
-					return result;
-				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				CALL_ACTION(data->onChange, control, &data->text);
-				updateCursorOffset = TREE_TRUE;
-			}
-			else if (data->cursorPosition < textLength)
+			// get word wrap data
+
+			TREE_Char **lines;
+			TREE_Size lineCount;
+			TREE_Size *lineOffsets;
+			result = _TREE_WordWrapAndOffsets(
+				text,
+				extent->width,
+				&lines,
+				&lineCount,
+				&lineOffsets);
+			if (result)
 			{
-				// shift string over
-				memmove(&data->text[data->cursorPosition], &data->text[data->cursorPosition + 1], (textLength - data->cursorPosition) * sizeof(TREE_Char));
-				data->text[textLength - 1] = '\0'; // null terminator
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				CALL_ACTION(data->onChange, control, &data->text);
-				updateCursorOffset = TREE_TRUE;
+				return result;
 			}
-			break;
-		case TREE_KEY_LEFT_ARROW: // move cursor left 1
-			if (data->cursorPosition > 0)
-			{
-				// if control held, move until a space found
-				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
-				{
-					data->cursorPosition = _TREE_SeekDifferentCharTypeReverse(data->text, textLength, data->cursorPosition - 1);
-				}
-				else
-				{
-					data->cursorPosition--;
-				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-				updateCursorOffset = TREE_TRUE;
+
+			// calculate the cursor position
+			TREE_Offset cursorOffset = _TREE_CalculateCursorOffset(
+				data->cursorPosition,
+				lineOffsets,
+				lineCount);
+			// adjust for scrolling
+			cursorOffset.y -= (TREE_Int)data->scroll;
+
+			// draw the lines based on the scroll
+			TREE_Size count = MIN(lineCount, extent->height);
+			TREE_Size scroll = data->scroll;
+
+			if (!active)
+			{
+				// no scroll when inactive
+				scroll = 0;
 			}
-			break;
-		case TREE_KEY_RIGHT_ARROW: // move cursor right 1
-			if (data->cursorPosition < textLength)
+
+			// draw each line
+			TREE_ColorPair lineColor;
+			for (TREE_Size i = 0; i < count && data->scroll + i < lineCount; i++)
 			{
-				// if control held, move until a space found
-				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
+				// replace unsafe characters
+				TREE_Char *line = lines[data->scroll + i];
+				TREE_Size lineLength = strlen(line);
+				_TREE_MakeSafe(line, lineLength);
+
+				// determine if whole line is selected or not
+				TREE_Size lineBeginIndex = lineOffsets[data->scroll + i];
+				TREE_Size lineEndIndex = lineBeginIndex + lineLength;
+				if (lineBeginIndex >= data->selectionStart &&
+					lineEndIndex <= data->selectionEnd)
 				{
-					data->cursorPosition = _TREE_SeekDifferentCharType(data->text, textLength, data->cursorPosition);
+					// all selected
+					lineColor = data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair;
 				}
 				else
 				{
-					data->cursorPosition++;
+					// none/partial selected
+					lineColor = pixel->colorPair;
 				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-				updateCursorOffset = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_UP_ARROW: // move cursor up 1
-			if (data->cursorPosition > 0)
-			{
-				if (multiline)
-				{
-					// if on first line, move to start of line
-					if (data->cursorOffset.y == 0)
-					{
-						data->cursorPosition = 0;
-						data->cursorOffset.x = 0;
-					}
-					else
-					{
-						// move cursor up 1 line
-						data->cursorOffset.y -= 1;
-
-						// get the line offsets
-						TREE_Size lineCount = 0;
-						TREE_Size *lineOffsets = NULL;
-						TREE_Char **lines = NULL;
-						result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
-						if (result)
-						{
-							return result;
-						}
 
-						// set position based on line
-						TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
-						data->cursorPosition = lineOffsets[data->cursorOffset.y] + MIN(lineSize - 1, (TREE_Size)data->cursorOffset.x);
-					}
-				}
-				else
+				// draw the string
+				TREE_Offset offset;
+				offset.x = 0;
+				offset.y = (TREE_Int)i;
+				result = TREE_Image_DrawString(
+					control->image,
+					offset,
+					line,
+					lineColor);
+				if (result)
 				{
-					// act like HOME if single line
-					data->cursorPosition = 0;
+					break;
 				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_DOWN_ARROW: // move cursor down 1
-			if (data->cursorPosition < textLength)
-			{
-				if (multiline)
+
+				if (data->selectionStart != data->selectionEnd &&
+					((data->selectionStart >= lineBeginIndex &&
+					  data->selectionStart <= lineEndIndex) ||
+					 (data->selectionEnd >= lineBeginIndex &&
+					  data->selectionEnd <= lineEndIndex)))
 				{
-					// get the line offsets
-					TREE_Size lineCount = 0;
-					TREE_Size *lineOffsets = NULL;
-					TREE_Char **lines = NULL;
-					result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
-					if (result)
+					// draw just the selected part, over the existing text
+					TREE_Size selectionStart = MAX(data->selectionStart, lineBeginIndex);
+					TREE_Size selectionEnd = MIN(data->selectionEnd, lineEndIndex);
+					TREE_Size selectionLength = selectionEnd - selectionStart;
+					TREE_Size selectionOffset = selectionStart - lineBeginIndex;
+					TREE_Char *selectionText = TREE_NEW_ARRAY(TREE_Char, selectionLength + 1);
+					if (!selectionText)
 					{
-						return result;
+						return TREE_ERROR_ALLOC;
 					}
+					memcpy(selectionText, &text[selectionStart], selectionLength * sizeof(TREE_Char));
+					selectionText[selectionLength] = '\0'; // null terminator
 
-					// if on last line, move to end of line
-					if (data->cursorOffset.y == lineCount - 1)
-					{
-						data->cursorPosition = textLength;
-						TREE_Size lastLineLength = strlen(lines[lineCount - 1]);
-						if (lastLineLength)
-						{
-							data->cursorOffset.x = (TREE_Int)lastLineLength;
-						}
-						else
-						{
-							data->cursorOffset.x = 0;
-						}
-					}
-					else
-					{
-						// move to next line
-						data->cursorOffset.y += 1;
+					// only render safe chars
+					_TREE_MakeSafe(selectionText, selectionLength);
 
-						// set position based on line
-						TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
-						if (lineSize)
-						{
-							TREE_Size adjustment = data->cursorOffset.y == lineCount - 1 ? 0 : 1;
-							data->cursorPosition = lineOffsets[data->cursorOffset.y] + MIN(lineSize - adjustment, (TREE_Size)data->cursorOffset.x);
-						}
-						else
-						{
-							data->cursorPosition = lineOffsets[data->cursorOffset.y];
-						}
-					}
-				}
-				else
-				{
-					// act like END if single line
-					data->cursorPosition = textLength;
-				}
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_HOME: // move cursor to start
-			if (multiline)
-			{
-				// move to start of line
-				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL)
-				{
-					// set position based on total text
-					data->cursorPosition = 0;
-					data->cursorOffset.x = 0;
-					data->cursorOffset.y = 0;
-				}
-				else
-				{
-					// get the line offsets
-					TREE_Size lineCount = 0;
-					TREE_Size *lineOffsets = NULL;
-					TREE_Char **lines = NULL;
-					result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+					// draw the selection
+					TREE_Offset selectionPos;
+					selectionPos.x = (TREE_Int)selectionOffset;
+					selectionPos.y = (TREE_Int)i;
+					result = TREE_Image_DrawString(
+						control->image,
+						selectionPos,
+						selectionText,
+						data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair);
+					TREE_DELETE(selectionText);
 					if (result)
 					{
 						return result;
 					}
-
-					// set position based on line
-					TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
-					data->cursorPosition = lineOffsets[data->cursorOffset.y];
-					data->cursorOffset.x = 0;
 				}
 			}
-			else
-			{
-				// move to start of text
-				data->cursorPosition = 0;
-				updateCursorOffset = TREE_TRUE;
-			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			cursorMoved = TREE_TRUE;
-			break;
-		case TREE_KEY_END: // move cursor to end
-			if (multiline)
+
+			// draw cursor if active
+			if (active)
 			{
-				// move to end of line
+				// get the cursor
+				TREE_Pixel cursorPixel = _TREE_GetCursorPixel(
+					data->theme->pixels[TREE_THEME_PID_CURSOR],
+					data->inserting,
+					data->cursorPosition,
+					text,
+					textLength);
 
-				// get the line offsets
-				TREE_Size lineCount = 0;
-				TREE_Size *lineOffsets = NULL;
-				TREE_Char **lines = NULL;
-				result = _TREE_WordWrapAndOffsets(data->text, extent->width, &lines, &lineCount, &lineOffsets);
+				// draw the cursor
+				result = TREE_Image_Set(
+					control->image,
+					cursorOffset,
+					cursorPixel);
 				if (result)
 				{
 					return result;
 				}
+			}
+		}
+		else
+		{
+			// single line
 
-				if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL || data->cursorOffset.y == lineCount - 1)
-				{
-					// set position based on total text
-					data->cursorPosition = textLength;
-					data->cursorOffset.x = (TREE_Int)strlen(lines[lineCount - 1]);
-					data->cursorOffset.y = (TREE_Int)lineCount - 1;
-				}
-				else
+			// find the offset
+			TREE_Size offset = data->scroll;
+			if (active)
+			{
+				if (data->cursorPosition - offset == extent->width)
 				{
-					// set position based on line
-					TREE_Size lineSize = strlen(lines[data->cursorOffset.y]);
-					data->cursorPosition = lineOffsets[data->cursorOffset.y] + lineSize - 1;
-					data->cursorOffset.x = (TREE_Int)lineSize - 1;
+					offset++;
 				}
 			}
-			else
-			{
-				// move to end of text
-				data->cursorPosition = textLength;
-				updateCursorOffset = TREE_TRUE;
-			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			cursorMoved = TREE_TRUE;
-			break;
-		default:
-		{
-			// if single line, and enter key pressed, submit
-			if (key == TREE_KEY_ENTER && !multiline)
+			else
 			{
-				// if singleline, treat enter as a submit
-				control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				CALL_ACTION(data->onSubmit, control, &data->text);
-				break;
+				// no scroll when inactive
+				offset = 0;
 			}
 
-			// if at capacity, ignore new characters
-			if (textLength >= data->capacity)
+			// get size of text using the offset
+			TREE_Size length = MIN(extent->width, textLength - offset);
+
+			// get a copy of the text to draw
+			TREE_Char *textCopy = TREE_NEW_ARRAY(TREE_Char, length + 1);
+			if (!textCopy)
 			{
-				TREE_Window_Beep();
-				break;
+				return TREE_ERROR_ALLOC;
 			}
+			memcpy(textCopy, &text[offset], length * sizeof(TREE_Char));
+			textCopy[length] = '\0'; // null terminator
 
-			// get the character to add
-			TREE_Char ch = TREE_Key_ToChar(key, keyData->modifiers);
+			// only render safe chars
+			_TREE_MakeSafe(textCopy, length);
 
-			// if invalid, ignore it, with exceptions
-			if (!_TREE_IsCharSafe(ch) && (!multiline || ch != '\n'))
+			// draw the text
+			TREE_Offset imageOffset;
+			imageOffset.x = 0;
+			imageOffset.y = 0;
+			result = TREE_Image_DrawString(
+				control->image,
+				imageOffset,
+				textCopy,
+				pixel->colorPair);
+			TREE_DELETE(textCopy);
+			if (result)
 			{
-				break;
+				return result;
 			}
 
-			updateCursorOffset = TREE_TRUE;
+			// if active
+			if (active)
+			{
+				// draw selection, if any, and if visible
+				if (data->selectionStart != data->selectionEnd &&
+					data->selectionEnd > offset &&
+					data->selectionStart < offset + length)
+				{
+					// get the start and end of the selection
+					TREE_Size selectionStart = MAX(data->selectionStart, offset);
+					TREE_Size selectionEnd = MIN(data->selectionEnd, offset + length);
+					TREE_Size selectionLength = selectionEnd - selectionStart;
 
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			data->cursorTimer = 0;
+					// create a copy of the text to draw
+					TREE_Char *selectionText = TREE_NEW_ARRAY(TREE_Char, selectionLength + 1);
+					if (!selectionText)
+					{
+						return TREE_ERROR_ALLOC;
+					}
+					memcpy(selectionText, &text[selectionStart], selectionLength * sizeof(TREE_Char));
+					selectionText[selectionLength] = '\0'; // null terminator
 
-			// check for special inputs
-			TREE_Bool ctrl = (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) != 0;
-			if (ctrl && key == TREE_KEY_C)
-			{
-				// get selection text
-				TREE_Char *text = TREE_Control_TextInputData_GetSelectedText(data);
+					// only render safe chars
+					_TREE_MakeSafe(selectionText, selectionLength);
 
-				// copy selection to clipboard, if there is something selected
-				if (text)
-				{
-					// set the clipboard text
-					result = TREE_Clipboard_SetText(text);
-					TREE_DELETE(text);
+					// draw the selection
+					TREE_Offset selectionOffset;
+					selectionOffset.x = (TREE_Int)(selectionStart - offset);
+					selectionOffset.y = 0;
+					result = TREE_Image_DrawString(
+						control->image,
+						selectionOffset,
+						selectionText,
+						data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair);
 					if (result)
 					{
 						return result;
 					}
 				}
-				break;
-			}
-			if (ctrl && key == TREE_KEY_V)
-			{
-				// remove selection, if any
-				result = TREE_Control_TextInputData_RemoveSelectedText(data);
-				if (result)
-				{
-					return result;
-				}
 
-				// paste from clipboard
-				TREE_Char *text = NULL;
-				result = TREE_Clipboard_GetText(&text);
+				// get the cursor
+				TREE_Pixel cursorPixel = _TREE_GetCursorPixel(
+					data->theme->pixels[TREE_THEME_PID_CURSOR],
+					data->inserting,
+					data->cursorPosition,
+					text,
+					textLength);
+
+				// draw the cursor
+				TREE_Offset cursorOffset;
+				cursorOffset.x = (TREE_Int)(data->cursorPosition - offset);
+				cursorOffset.y = 0;
+				result = TREE_Image_Set(
+					control->image,
+					cursorOffset,
+					cursorPixel);
 				if (result)
 				{
 					return result;
 				}
-				TREE_Size textLength = strlen(text);
+			}
+		}
+
+		// if needed, dispose of text
+		if (disposeText)
+		{
+			TREE_DELETE(text);
+		}
+
+		break;
+	}
+	case TREE_EVENT_TYPE_DRAW:
+	{
+		// get the event data
+		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
+		TREE_Image *target = drawData->target;
+		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
+
+		result = _TREE_Control_Draw(
+			target,
+			dirtyRect,
+			&control->transform->globalRect,
+			control->image);
+		if (result)
+		{
+			return result;
+		}
+
+		break;
+	}
+	default:
+		break;
+	}
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_ScrollbarData_Init(TREE_Control_ScrollbarData *data, TREE_Control_ScrollbarType type, TREE_Axis axis, TREE_Theme const *theme)
+{
+	// validate
+	if (!data)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (axis != TREE_AXIS_HORIZONTAL && axis != TREE_AXIS_VERTICAL)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// set data
+	data->type = type;
+	data->axis = axis;
+	data->theme = theme;
+
+	return TREE_OK;
+}
+
+TREE_Result _TREE_Control_Scrollbar_Draw(TREE_Image *target, TREE_Offset scrollbarOffset, TREE_Extent scrollbarExtent, TREE_Control_ScrollbarData *data, TREE_Size scroll, TREE_Size maxScroll, TREE_Int mode)
+{
+	TREE_Offset offset = scrollbarOffset;
+	TREE_Extent extent = scrollbarExtent;
+
+	// determine if horizontal or vertical
+	TREE_Bool vertical = data->axis == TREE_AXIS_VERTICAL;
+
+	TREE_ColorPair colorPair, barColorPair;
+	switch (mode)
+	{
+	case 0: // unfocused
+		colorPair = data->theme->pixels[TREE_THEME_PID_NORMAL_SCROLL_AREA].colorPair;
+		barColorPair = data->theme->pixels[TREE_THEME_PID_NORMAL_SCROLL_BAR].colorPair;
+		break;
+	case 1: // focused
+		colorPair = data->theme->pixels[TREE_THEME_PID_FOCUSED_SCROLL_AREA].colorPair;
+		barColorPair = data->theme->pixels[TREE_THEME_PID_FOCUSED_SCROLL_BAR].colorPair;
+		break;
+	case 2: // active
+		colorPair = data->theme->pixels[TREE_THEME_PID_ACTIVE_SCROLL_AREA].colorPair;
+		barColorPair = data->theme->pixels[TREE_THEME_PID_ACTIVE_SCROLL_BAR].colorPair;
+		break;
+	default: // none
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+
+	// draw the scrollbar
+	TREE_Pixel scrollbarPixel;
+	if (vertical)
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_V_AREA];
+	}
+	else
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_H_AREA];
+	}
+	scrollbarPixel.colorPair = colorPair;
+	TREE_Rect rect = {offset, extent};
+	TREE_Result result = TREE_Image_FillRect(
+		target,
+		&rect,
+		scrollbarPixel);
+	if (result)
+	{
+		return result;
+	}
+
+	// draw the top
+	if (vertical)
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_UP];
+	}
+	else
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_LEFT];
+	}
+	result = TREE_Image_Set(
+		target,
+		offset,
+		scrollbarPixel);
+	if (result)
+	{
+		return result;
+	}
+
+	// draw the bottom
+	if (vertical)
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_DOWN];
+		offset.y = scrollbarOffset.y + (TREE_Int)(scrollbarExtent.height - 1);
+	}
+	else
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_RIGHT];
+		offset.x = scrollbarOffset.x + (TREE_Int)(scrollbarExtent.width - 1);
+	}
+	result = TREE_Image_Set(
+		target,
+		offset,
+		scrollbarPixel);
+	if (result)
+	{
+		return result;
+	}
 
-				// insert clipboard text
-				result = TREE_Control_TextInputData_InsertText(data, text);
-				TREE_DELETE(text);
-				if (result)
-				{
-					return result;
-				}
+	// draw the bar, if it is needed
+	if (!maxScroll)
+	{
+		// not enough
+		return TREE_OK;
+	}
 
-				// mark as dirty
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	TREE_Size barSize;
+	TREE_Size barOffset;
+	if (maxScroll < extent.height)
+	{
+		// basic scrollbar
+		barSize = extent.height - maxScroll;
+		barOffset = scroll;
+	}
+	else
+	{
+		// complex/tiny scrollbar
+		barSize = 1;
+		barOffset = scroll * (extent.height - 1) / maxScroll;
+	}
+	if (vertical)
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_V_BAR];
+	}
+	else
+	{
+		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_H_BAR];
+	}
+	scrollbarPixel.colorPair = barColorPair;
+	if (vertical)
+	{
+		offset.y = scrollbarOffset.y + (TREE_Int)barOffset;
+		extent.height = (TREE_UInt)barSize;
+	}
+	else
+	{
+		offset.x = scrollbarOffset.x + (TREE_Int)barOffset;
+		extent.width = (TREE_UInt)barSize;
+	}
+	rect.offset = offset;
+	rect.extent = extent;
+	result = TREE_Image_FillRect(
+		target,
+		&rect,
+		scrollbarPixel);
+	if (result)
+	{
+		return result;
+	}
 
-				// call onChange
-				CALL_ACTION(data->onChange, control, &data->text);
+	return TREE_OK;
+}
 
-				break;
-			}
-			if (ctrl && key == TREE_KEY_X)
-			{
-				// copy selection, and remove it
+void TREE_Control_ScrollbarData_Free(TREE_Control_ScrollbarData *data)
+{
+	if (!data)
+	{
+		return;
+	}
 
-				// get selection text
-				TREE_Char *text = TREE_Control_TextInputData_GetSelectedText(data);
+	// nothing to free
+}
 
-				// copy selection to clipboard, if there is something selected
-				if (text)
-				{
-					// set the clipboard text
-					result = TREE_Clipboard_SetText(text);
-					TREE_DELETE(text);
-					if (result)
-					{
-						return result;
-					}
+TREE_Result TREE_Control_ListData_Init(TREE_Control_ListData *data, TREE_Control_ListFlags flags, TREE_String *options, TREE_Size optionsSize, TREE_ControlEventHandler onChange, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
+{
+	// validate
+	if (!data || !options)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-					// remove selected text
-					result = TREE_Control_TextInputData_RemoveSelectedText(data);
-					if (result)
-					{
-						return result;
-					}
+	data->flags = flags;
+	data->options = NULL;
+	data->optionsSize = 0;
+	data->selectedIndices = NULL;
 
-					// mark as dirty
-					control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	TREE_Result result = TREE_Control_ListData_SetOptions(data, options, optionsSize);
+	if (result)
+	{
+		return result;
+	}
 
-					// call onChange
-					CALL_ACTION(data->onChange, control, &data->text);
-				}
-				break;
-			}
-			if (ctrl && key == TREE_KEY_A)
-			{
-				// select all text
-				data->selectionOrigin = 0;
-				data->selectionStart = 0;
-				data->selectionEnd = textLength;
-				data->cursorPosition = textLength;
+	// set data
+	result = TREE_Control_ScrollbarData_Init(&data->scrollbar, TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC, TREE_AXIS_VERTICAL, theme);
+	if (result)
+	{
+		return result;
+	}
+	data->theme = theme;
+	data->onChange = onChange;
+	data->onSubmit = onSubmit;
 
-				// mark as dirty
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	return TREE_OK;
+}
 
-				break;
-			}
+void TREE_Control_ListData_Free(TREE_Control_ListData *data)
+{
+	if (!data)
+	{
+		return;
+	}
 
-			// type normal character
+	// free the options
+	TREE_DELETE_ARRAY(data->options, data->optionsSize);
+}
 
-			// remove selection, if any
-			result = TREE_Control_TextInputData_RemoveSelectedText(data);
-			if (result)
-			{
-				return result;
-			}
+TREE_Result TREE_Control_ListData_SetOptions(TREE_Control_ListData *data, TREE_String *options, TREE_Size optionsSize)
+{
+	// validate
+	if (!data)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-			// shift string over, if needed
-			if (data->cursorPosition < textLength)
-			{
-				memmove(&data->text[data->cursorPosition + 1], &data->text[data->cursorPosition], (textLength - data->cursorPosition) * sizeof(TREE_Char));
-			}
-			data->text[textLength + 1] = '\0'; // null terminator
+	// if old options, free them
+	if (data->options)
+	{
+		TREE_DELETE_ARRAY(data->options, data->optionsSize);
+	}
+	data->selectedIndex = 0;
+	data->hoverIndex = 0;
+	data->scroll = 0;
+	if (data->selectedIndices)
+	{
+		TREE_DELETE(data->selectedIndices);
+	}
+	data->optionsSize = optionsSize;
 
-			// insert character
-			data->text[data->cursorPosition] = ch;
-			data->cursorPosition++;
-			CALL_ACTION(data->onChange, control, &data->text);
-			break;
-		}
+	// if new data, allocate and copy over
+	if (options && optionsSize)
+	{
+		// allocate data
+		data->options = TREE_NEW_ARRAY(TREE_Char *, optionsSize);
+		if (!data->options)
+		{
+			return TREE_ERROR_ALLOC;
 		}
 
-		// if cursor moved, update the scroll region
-		if (cursorMoved)
+		// copy over options
+		for (TREE_Size i = 0; i < optionsSize; i++)
 		{
-			if (keyData->modifiers & TREE_KEY_MODIFIER_FLAGS_SHIFT)
-			{
-				// if cursor moved, update selection
-
-				// set origin if cursor at origin
-				if (data->selectionStart == data->selectionEnd)
-				{
-					data->selectionOrigin = data->selectionStart;
-				}
-
-				// update selection
-				if (data->cursorPosition <= data->selectionOrigin)
-				{
-					data->selectionStart = data->cursorPosition;
-					data->selectionEnd = data->selectionOrigin;
-				}
-				if (data->cursorPosition >= data->selectionOrigin)
-				{
-					data->selectionEnd = data->cursorPosition;
-					data->selectionStart = data->selectionOrigin;
-				}
-			}
-			else
+			TREE_String oldOption = options[i];
+			TREE_Size oldOptionSize = strlen(oldOption);
+			TREE_Char *option = TREE_NEW_ARRAY(TREE_Char, oldOptionSize + 1);
+			if (!option)
 			{
-				// cursor moved, but no shift pressed
-				data->selectionStart = data->cursorPosition;
-				data->selectionEnd = data->cursorPosition;
+				TREE_DELETE_ARRAY(data->options, i);
+				return TREE_ERROR_ALLOC;
 			}
-		}
-		else if (data->selectionStart == data->selectionEnd && data->selectionStart != data->cursorPosition)
-		{
-			// cursor moved due to a modification
-			data->selectionStart = data->cursorPosition;
-			data->selectionEnd = data->cursorPosition;
+			memcpy(option, oldOption, oldOptionSize * sizeof(TREE_Char));
+			option[oldOptionSize] = '\0'; // null terminator
+			data->options[i] = option;
 		}
 
-		// clamp the scroll to follow the cursor
-		TREE_Size scrollExtent;
-		TREE_Size scrollOffset;
-		if (multiline)
-		{
-			// scroll is up and down on multiline
+		data->optionsSize = optionsSize;
 
-			// get word wrap offsets
-			TREE_Char **lines;
-			TREE_Size lineCount;
-			TREE_Size *lineOffsets;
-			result = _TREE_WordWrapAndOffsets(
-				data->text,
-				extent->width,
-				&lines,
-				&lineCount,
-				&lineOffsets);
-			if (result)
+		// allocate selection data if needed
+		if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+		{
+			data->selectedIndices = TREE_NEW_ARRAY(TREE_Byte, optionsSize);
+			if (!data->selectedIndices)
 			{
-				return result;
+				TREE_DELETE_ARRAY(data->options, optionsSize);
+				return TREE_ERROR_ALLOC;
 			}
 
-			// get cursor offset
-			TREE_Offset cursorOffset = _TREE_CalculateCursorOffset(
-				data->cursorPosition,
-				lineOffsets,
-				lineCount);
-
-			if (updateCursorOffset)
+			for (TREE_Size i = 0; i < optionsSize; i++)
 			{
-				// update the cursor offset
-				data->cursorOffset.x = cursorOffset.x;
-				data->cursorOffset.y = cursorOffset.y;
+				data->selectedIndices[i] = TREE_FALSE;
 			}
-
-			// calculate the line number
-			scrollOffset = cursorOffset.y;
-			scrollExtent = extent->height;
-		}
-		else
-		{
-			scrollOffset = data->cursorPosition;
-			scrollExtent = extent->width;
 		}
+	}
 
-		// adjust scroll
-		data->scroll = _TREE_ClampScroll(data->scroll, scrollOffset, scrollExtent);
+	return TREE_OK;
+}
 
-		break;
+TREE_Result TREE_Control_ListData_SetSelected(TREE_Control_ListData *data, TREE_Size index, TREE_Bool selected)
+{
+	// validate
+	if (!data)
+	{
+		return TREE_ERROR_ARG_NULL;
 	}
-	case TREE_EVENT_TYPE_REFRESH:
+	if (index >= data->optionsSize)
 	{
-		result = TREE_Image_Resize(control->image, *extent);
-		if (result)
-		{
-			return result;
-		}
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
 
-		TREE_Bool active = (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
+	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+	{
+		// multiselect
+		data->selectedIndices[index] = selected;
+	}
+	else
+	{
+		// single select
+		data->selectedIndex = index;
+	}
 
-		// determine pixel from state
-		TREE_Pixel const *pixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
-		if (active)
-		{
-			pixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
-		}
-		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_ListData_GetSelected(TREE_Control_ListData *data, TREE_Size **indices, TREE_Size *indexCount)
+{
+	// validate
+	if (!data || !indices || !indexCount)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	*indices = NULL;
+	*indexCount = 0;
+
+	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+	{
+		// compile indices
+		TREE_Size selectedCount = 0;
+		for (TREE_Size i = 0; i < data->optionsSize; i++)
 		{
-			pixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
+			if (data->selectedIndices[i])
+			{
+				selectedCount++;
+			}
 		}
-
-		// draw the background
-		result = TREE_Image_Clear(control->image, *pixel);
-		if (result)
+		if (selectedCount == 0)
 		{
-			return result;
+			return TREE_OK;
 		}
-
-		// determine what text to draw
-		TREE_Char *text = data->text;
-		TREE_Bool disposeText = TREE_FALSE;
-
-		// if not active and no text, use placeholder
-		if (!(active) && !text[0])
+		TREE_Size *selected = TREE_NEW_ARRAY(TREE_Size, selectedCount);
+		if (!selected)
 		{
-			text = data->placeholder;
+			return TREE_ERROR_ALLOC;
 		}
-		// if not placeholder and is a password, replace with stars
-		else if (data->type == TREE_CONTROL_TEXT_INPUT_TYPE_PASSWORD)
+		TREE_Size j = 0;
+		for (TREE_Size i = 0; i < data->optionsSize; i++)
 		{
-			TREE_Size textLength = strlen(text);
-			TREE_Char *passwordText = TREE_NEW_ARRAY(TREE_Char, textLength + 1);
-			if (!passwordText)
+			if (data->selectedIndices[i])
 			{
-				return TREE_ERROR_ALLOC;
+				selected[j] = i;
+				j++;
 			}
-			memset(passwordText, '*', textLength);
-			passwordText[textLength] = '\0'; // null terminator
-			text = passwordText;
-			disposeText = TREE_TRUE;
 		}
-
-		TREE_Size textLength = strlen(text);
-
-		if (multiline)
+		*indices = selected;
+		*indexCount = selectedCount;
+	}
+	else
+	{
+		// single index
+		*indices = TREE_NEW(TREE_Size);
+		if (!*indices)
 		{
-			// multiline
-
-			// get word wrap data
-
-			TREE_Char **lines;
-			TREE_Size lineCount;
-			TREE_Size *lineOffsets;
-			result = _TREE_WordWrapAndOffsets(
-				text,
-				extent->width,
-				&lines,
-				&lineCount,
-				&lineOffsets);
-			if (result)
-			{
-				return result;
-			}
-
-			// calculate the cursor position
-			TREE_Offset cursorOffset = _TREE_CalculateCursorOffset(
-				data->cursorPosition,
-				lineOffsets,
-				lineCount);
-			// adjust for scrolling
-			cursorOffset.y -= (TREE_Int)data->scroll;
+			return TREE_ERROR_ALLOC;
+		}
+		**indices = data->selectedIndex;
+		*indexCount = 1;
+	}
+	return TREE_OK;
+}
 
-			// draw the lines based on the scroll
-			TREE_Size count = MIN(lineCount, extent->height);
-			TREE_Size scroll = data->scroll;
+TREE_Bool TREE_Control_ListData_IsSelected(TREE_Control_ListData *data, TREE_Size index)
+{
+	// validate
+	if (!data)
+	{
+		return TREE_FALSE;
+	}
 
-			if (!active)
-			{
-				// no scroll when inactive
-				scroll = 0;
-			}
+	if (index >= data->optionsSize)
+	{
+		return TREE_FALSE;
+	}
 
-			// draw each line
-			TREE_ColorPair lineColor;
-			for (TREE_Size i = 0; i < count && data->scroll + i < lineCount; i++)
-			{
-				// replace unsafe characters
-				TREE_Char *line = lines[data->scroll + i];
-				TREE_Size lineLength = strlen(line);
-				_TREE_MakeSafe(line, lineLength);
+	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+	{
+		// multiselect
+		return data->selectedIndices[index];
+	}
+	else
+	{
+		// single select
+		return data->selectedIndex == index;
+	}
+}
 
-				// determine if whole line is selected or not
-				TREE_Size lineBeginIndex = lineOffsets[data->scroll + i];
-				TREE_Size lineEndIndex = lineBeginIndex + lineLength;
-				if (lineBeginIndex >= data->selectionStart &&
-					lineEndIndex <= data->selectionEnd)
-				{
-					// all selected
-					lineColor = data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair;
-				}
-				else
-				{
-					// none/partial selected
-					lineColor = pixel->colorPair;
-				}
+TREE_Result TREE_Control_List_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_ListData *data)
+{
+	// validate
+	if (!control || !data)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-				// draw the string
-				TREE_Offset offset;
-				offset.x = 0;
-				offset.y = (TREE_Int)i;
-				result = TREE_Image_DrawString(
-					control->image,
-					offset,
-					line,
-					lineColor);
-				if (result)
-				{
-					break;
-				}
+	// init control
+	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_List_EventHandler, data);
+	if (result)
+	{
+		return result;
+	}
 
-				if (data->selectionStart != data->selectionEnd &&
-					((data->selectionStart >= lineBeginIndex &&
-					  data->selectionStart <= lineEndIndex) ||
-					 (data->selectionEnd >= lineBeginIndex &&
-					  data->selectionEnd <= lineEndIndex)))
-				{
-					// draw just the selected part, over the existing text
-					TREE_Size selectionStart = MAX(data->selectionStart, lineBeginIndex);
-					TREE_Size selectionEnd = MIN(data->selectionEnd, lineEndIndex);
-					TREE_Size selectionLength = selectionEnd - selectionStart;
-					TREE_Size selectionOffset = selectionStart - lineBeginIndex;
-					TREE_Char *selectionText = TREE_NEW_ARRAY(TREE_Char, selectionLength + 1);
-					if (!selectionText)
-					{
-						return TREE_ERROR_ALLOC;
-					}
-					memcpy(selectionText, &text[selectionStart], selectionLength * sizeof(TREE_Char));
-					selectionText[selectionLength] = '\0'; // null terminator
+	// set data
+	control->type = TREE_CONTROL_TYPE_LIST;
+	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
+	control->transform->localExtent.width = 16;
+	control->transform->localExtent.height = 10;
 
-					// only render safe chars
-					_TREE_MakeSafe(selectionText, selectionLength);
+	return TREE_OK;
+}
 
-					// draw the selection
-					TREE_Offset selectionPos;
-					selectionPos.x = (TREE_Int)selectionOffset;
-					selectionPos.y = (TREE_Int)i;
-					result = TREE_Image_DrawString(
-						control->image,
-						selectionPos,
-						selectionText,
-						data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair);
-					TREE_DELETE(selectionText);
-					if (result)
-					{
-						return result;
-					}
-				}
-			}
+TREE_Result TREE_Control_List_SetFlags(TREE_Control *control, TREE_Control_ListFlags flags)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-			// draw cursor if active
-			if (active)
-			{
-				// get the cursor
-				TREE_Pixel cursorPixel = _TREE_GetCursorPixel(
-					data->theme->pixels[TREE_THEME_PID_CURSOR],
-					data->inserting,
-					data->cursorPosition,
-					text,
-					textLength);
+	// set flags
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	data->flags = flags;
 
-				// draw the cursor
-				result = TREE_Image_Set(
-					control->image,
-					cursorOffset,
-					cursorPixel);
-				if (result)
-				{
-					return result;
-				}
-			}
-		}
-		else
-		{
-			// single line
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-			// find the offset
-			TREE_Size offset = data->scroll;
-			if (active)
-			{
-				if (data->cursorPosition - offset == extent->width)
-				{
-					offset++;
-				}
-			}
-			else
-			{
-				// no scroll when inactive
-				offset = 0;
-			}
+	return TREE_OK;
+}
 
-			// get size of text using the offset
-			TREE_Size length = MIN(extent->width, textLength - offset);
+TREE_Control_ListFlags TREE_Control_List_GetFlags(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_CONTROL_LIST_FLAGS_NONE;
+	}
 
-			// get a copy of the text to draw
-			TREE_Char *textCopy = TREE_NEW_ARRAY(TREE_Char, length + 1);
-			if (!textCopy)
-			{
-				return TREE_ERROR_ALLOC;
-			}
-			memcpy(textCopy, &text[offset], length * sizeof(TREE_Char));
-			textCopy[length] = '\0'; // null terminator
+	// get flags
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return data->flags;
+}
 
-			// only render safe chars
-			_TREE_MakeSafe(textCopy, length);
+TREE_Result TREE_Control_List_SetOptions(TREE_Control *control, TREE_String *options, TREE_Size optionsSize)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-			// draw the text
-			TREE_Offset imageOffset;
-			imageOffset.x = 0;
-			imageOffset.y = 0;
-			result = TREE_Image_DrawString(
-				control->image,
-				imageOffset,
-				textCopy,
-				pixel->colorPair);
-			TREE_DELETE(textCopy);
-			if (result)
-			{
-				return result;
-			}
+	// set options
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	TREE_Result result = TREE_Control_ListData_SetOptions(data, options, optionsSize);
+	if (result)
+	{
+		return result;
+	}
 
-			// if active
-			if (active)
-			{
-				// draw selection, if any, and if visible
-				if (data->selectionStart != data->selectionEnd &&
-					data->selectionEnd > offset &&
-					data->selectionStart < offset + length)
-				{
-					// get the start and end of the selection
-					TREE_Size selectionStart = MAX(data->selectionStart, offset);
-					TREE_Size selectionEnd = MIN(data->selectionEnd, offset + length);
-					TREE_Size selectionLength = selectionEnd - selectionStart;
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
-					// create a copy of the text to draw
-					TREE_Char *selectionText = TREE_NEW_ARRAY(TREE_Char, selectionLength + 1);
-					if (!selectionText)
-					{
-						return TREE_ERROR_ALLOC;
-					}
-					memcpy(selectionText, &text[selectionStart], selectionLength * sizeof(TREE_Char));
-					selectionText[selectionLength] = '\0'; // null terminator
+	return TREE_OK;
+}
 
-					// only render safe chars
-					_TREE_MakeSafe(selectionText, selectionLength);
+TREE_String *TREE_Control_List_GetOptions(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return NULL;
+	}
 
-					// draw the selection
-					TREE_Offset selectionOffset;
-					selectionOffset.x = (TREE_Int)(selectionStart - offset);
-					selectionOffset.y = 0;
-					result = TREE_Image_DrawString(
-						control->image,
-						selectionOffset,
-						selectionText,
-						data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED].colorPair);
-					if (result)
-					{
-						return result;
-					}
-				}
+	// get options
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return (TREE_String *)data->options;
+}
 
-				// get the cursor
-				TREE_Pixel cursorPixel = _TREE_GetCursorPixel(
-					data->theme->pixels[TREE_THEME_PID_CURSOR],
-					data->inserting,
-					data->cursorPosition,
-					text,
-					textLength);
+TREE_Size TREE_Control_List_GetOptionsSize(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return 0;
+	}
 
-				// draw the cursor
-				TREE_Offset cursorOffset;
-				cursorOffset.x = (TREE_Int)(data->cursorPosition - offset);
-				cursorOffset.y = 0;
-				result = TREE_Image_Set(
-					control->image,
-					cursorOffset,
-					cursorPixel);
-				if (result)
-				{
-					return result;
-				}
-			}
-		}
+	// get options size
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return data->optionsSize;
+}
 
-		// if needed, dispose of text
-		if (disposeText)
-		{
-			TREE_DELETE(text);
-		}
+TREE_Result TREE_Control_List_SetSelected(TREE_Control *control, TREE_Size index, TREE_Bool selected)
+{
+	// validate
+	if (!control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
 
-		break;
+	// set selected
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	TREE_Result result = TREE_Control_ListData_SetSelected(data, index, selected);
+	if (result)
+	{
+		return result;
 	}
-	case TREE_EVENT_TYPE_DRAW:
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_Bool TREE_Control_List_IsSelected(TREE_Control *control, TREE_Size index)
+{
+	// validate
+	if (!control)
 	{
-		// get the event data
-		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
-		TREE_Image *target = drawData->target;
-		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
+		return TREE_FALSE;
+	}
 
-		result = _TREE_Control_Draw(
-			target,
-			dirtyRect,
-			&control->transform->globalRect,
-			control->image);
-		if (result)
-		{
-			return result;
-		}
+	// get selected
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return TREE_Control_ListData_IsSelected(data, index);
+}
 
-		break;
+TREE_Size TREE_Control_List_GetSelected(TREE_Control *control)
+{
+	// validate
+	if (!control)
+	{
+		return 0;
 	}
+
+	// get selected
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+	{
+		return 0;
 	}
-	return TREE_OK;
+	return data->selectedIndex;
 }
 
-TREE_Result TREE_Control_ScrollbarData_Init(TREE_Control_ScrollbarData *data, TREE_Control_ScrollbarType type, TREE_Axis axis, TREE_Theme const *theme)
+TREE_Result TREE_Control_List_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
 {
 	// validate
-	if (!data)
+	if (!control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (axis != TREE_AXIS_HORIZONTAL && axis != TREE_AXIS_VERTICAL)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
 
-	// set data
-	data->type = type;
-	data->axis = axis;
-	data->theme = theme;
+	// set onChange
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	data->onChange = onChange;
 
 	return TREE_OK;
 }
 
-TREE_Result _TREE_Control_Scrollbar_Draw(TREE_Image *target, TREE_Offset scrollbarOffset, TREE_Extent scrollbarExtent, TREE_Control_ScrollbarData *data, TREE_Size scroll, TREE_Size maxScroll, TREE_Int mode)
+TREE_ControlEventHandler TREE_Control_List_GetOnChange(TREE_Control *control)
 {
-	TREE_Offset offset = scrollbarOffset;
-	TREE_Extent extent = scrollbarExtent;
-
-	// determine if horizontal or vertical
-	TREE_Bool vertical = data->axis == TREE_AXIS_VERTICAL;
-
-	TREE_ColorPair colorPair, barColorPair;
-	switch (mode)
+	// validate
+	if (!control)
 	{
-	case 0: // unfocused
-		colorPair = data->theme->pixels[TREE_THEME_PID_NORMAL_SCROLL_AREA].colorPair;
-		barColorPair = data->theme->pixels[TREE_THEME_PID_NORMAL_SCROLL_BAR].colorPair;
-		break;
-	case 1: // focused
-		colorPair = data->theme->pixels[TREE_THEME_PID_FOCUSED_SCROLL_AREA].colorPair;
-		barColorPair = data->theme->pixels[TREE_THEME_PID_FOCUSED_SCROLL_BAR].colorPair;
-		break;
-	case 2: // active
-		colorPair = data->theme->pixels[TREE_THEME_PID_ACTIVE_SCROLL_AREA].colorPair;
-		barColorPair = data->theme->pixels[TREE_THEME_PID_ACTIVE_SCROLL_BAR].colorPair;
-		break;
-	default: // none
-		return TREE_ERROR_ARG_OUT_OF_RANGE;
+		return NULL;
 	}
 
-	// draw the scrollbar
-	TREE_Pixel scrollbarPixel;
-	if (vertical)
-	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_V_AREA];
-	}
-	else
-	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_H_AREA];
-	}
-	scrollbarPixel.colorPair = colorPair;
-	TREE_Rect rect = {offset, extent};
-	TREE_Result result = TREE_Image_FillRect(
-		target,
-		&rect,
-		scrollbarPixel);
-	if (result)
-	{
-		return result;
-	}
+	// get onChange
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return data->onChange;
+}
 
-	// draw the top
-	if (vertical)
+TREE_Result TREE_Control_List_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
+{
+	// validate
+	if (!control)
 	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_UP];
+		return TREE_ERROR_ARG_NULL;
 	}
-	else
+
+	// set onSubmit
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	data->onSubmit = onSubmit;
+
+	return TREE_OK;
+}
+
+TREE_ControlEventHandler TREE_Control_List_GetOnSubmit(TREE_Control *control)
+{
+	// validate
+	if (!control)
 	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_LEFT];
+		return NULL;
 	}
-	result = TREE_Image_Set(
-		target,
-		offset,
-		scrollbarPixel);
-	if (result)
+
+	// get onSubmit
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	return data->onSubmit;
+}
+
+TREE_Result _TREE_Control_List_Draw(TREE_Image *target, TREE_Offset controlOffset, TREE_Extent controlExtent, TREE_ControlStateFlags stateFlags, TREE_Control_ListData *data)
+{
+	TREE_Result result;
+	TREE_Bool active = (stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
+	TREE_Bool focused = (stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED);
+
+	// determine pixels from state
+	TREE_Pixel const *unselectedPixel;
+	TREE_Pixel const *selectedPixel;
+
+	if (active)
 	{
-		return result;
+		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
+		selectedPixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED];
 	}
-
-	// draw the bottom
-	if (vertical)
+	else if (focused)
 	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_DOWN];
-		offset.y = scrollbarOffset.y + (TREE_Int)(scrollbarExtent.height - 1);
+		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
+		selectedPixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED_SELECTED];
 	}
 	else
 	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_RIGHT];
-		offset.x = scrollbarOffset.x + (TREE_Int)(scrollbarExtent.width - 1);
+		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
+		selectedPixel = &data->theme->pixels[TREE_THEME_PID_NORMAL_SELECTED];
 	}
-	result = TREE_Image_Set(
-		target,
-		offset,
-		scrollbarPixel);
-	if (result)
+
+	// determine if there is a scrollbar
+	TREE_Size scrollbar = 0;
+	switch (data->scrollbar.type)
 	{
-		return result;
+	case TREE_CONTROL_SCROLLBAR_TYPE_NONE:
+		scrollbar = 0;
+		break;
+	case TREE_CONTROL_SCROLLBAR_TYPE_STATIC:
+		scrollbar = 1;
+		break;
+	case TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC:
+		scrollbar = (controlExtent.height < data->optionsSize) ? 1 : 0;
+		break;
 	}
 
-	// draw the bar, if it is needed
-	if (!maxScroll)
+	// get width of options
+	TREE_Size optionsWidth = controlExtent.width - scrollbar;
+
+	// draw the options
+	TREE_Size count = controlExtent.height;
+	TREE_Size scroll = data->scroll;
+	TREE_Size index;
+	for (TREE_Size i = 0; i < count; i++)
 	{
-		// not enough
-		return TREE_OK;
+		index = scroll + i;
+
+		TREE_Size fillerOffset;
+		TREE_Size fillerLength;
+		TREE_Pixel const *pixel;
+
+		if (index < data->optionsSize)
+		{
+			// draw option
+			// get option and info about it
+			TREE_Char *option = data->options[scroll + i];
+			TREE_Size optionLength = strlen(option);
+			TREE_Size optionWidth = MIN(optionsWidth, optionLength);
+			fillerOffset = optionWidth;
+			fillerLength = optionsWidth - optionWidth;
+			TREE_Bool selected = TREE_Control_ListData_IsSelected(data, scroll + i);
+
+			// copy the option
+			TREE_Char *optionCopy = _TREE_MakeSafeCopy(option, optionWidth);
+
+			// get pixel to use for drawing
+			if (active && data->hoverIndex == scroll + i)
+			{
+				if (selected)
+				{
+					pixel = &data->theme->pixels[TREE_THEME_PID_HOVERED_SELECTED];
+				}
+				else
+				{
+					pixel = &data->theme->pixels[TREE_THEME_PID_HOVERED];
+				}
+			}
+			else
+			{
+				if (selected)
+				{
+					pixel = selectedPixel;
+				}
+				else
+				{
+					pixel = unselectedPixel;
+				}
+			}
+
+			// draw option text
+			TREE_Offset offset;
+			offset.x = controlOffset.x;
+			offset.y = controlOffset.y + (TREE_Int)i;
+			result = TREE_Image_DrawString(
+				target,
+				offset,
+				optionCopy,
+				pixel->colorPair);
+			if (result)
+			{
+				return result;
+			}
+
+			free(optionCopy);
+		}
+		else
+		{
+			// no option to draw
+			fillerOffset = 0;
+			fillerLength = optionsWidth;
+			pixel = unselectedPixel;
+		}
+
+		// draw filler
+		if (fillerLength)
+		{
+			TREE_Offset offset;
+			offset.x = controlOffset.x + (TREE_Int)fillerOffset;
+			offset.y = controlOffset.y + (TREE_Int)i;
+			TREE_Extent extent;
+			extent.width = (TREE_UInt)fillerLength;
+			extent.height = 1;
+			TREE_Rect rect = {offset, extent};
+			result = TREE_Image_FillRect(
+				target,
+				&rect,
+				*pixel);
+			if (result)
+			{
+				return result;
+			}
+		}
 	}
 
-	TREE_Size barSize;
-	TREE_Size barOffset;
-	if (maxScroll < extent.height)
-	{
-		// basic scrollbar
-		barSize = extent.height - maxScroll;
-		barOffset = scroll;
-	}
-	else
-	{
-		// complex/tiny scrollbar
-		barSize = 1;
-		barOffset = scroll * (extent.height - 1) / maxScroll;
-	}
-	if (vertical)
-	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_V_BAR];
-	}
-	else
-	{
-		scrollbarPixel.character = data->theme->characters[TREE_THEME_CID_SCROLL_H_BAR];
-	}
-	scrollbarPixel.colorPair = barColorPair;
-	if (vertical)
-	{
-		offset.y = scrollbarOffset.y + (TREE_Int)barOffset;
-		extent.height = (TREE_UInt)barSize;
-	}
-	else
-	{
-		offset.x = scrollbarOffset.x + (TREE_Int)barOffset;
-		extent.width = (TREE_UInt)barSize;
-	}
-	rect.offset = offset;
-	rect.extent = extent;
-	result = TREE_Image_FillRect(
-		target,
-		&rect,
-		scrollbarPixel);
-	if (result)
+	// draw the scrollbar
+	if (scrollbar)
 	{
-		return result;
-	}
 
-	return TREE_OK;
-}
+		// get the scrollbar extent
+		TREE_Extent scrollbarExtent;
+		scrollbarExtent.width = 1;
+		scrollbarExtent.height = controlExtent.height;
 
-void TREE_Control_ScrollbarData_Free(TREE_Control_ScrollbarData *data)
-{
-	if (!data)
-	{
-		return;
+		// get the scrollbar offset
+		TREE_Offset scrollbarOffset;
+		scrollbarOffset.x = controlOffset.x + (TREE_Int)optionsWidth;
+		scrollbarOffset.y = controlOffset.y;
+
+		// draw the scrollbar
+		result = _TREE_Control_Scrollbar_Draw(
+			target,
+			scrollbarOffset,
+			scrollbarExtent,
+			&data->scrollbar,
+			data->scroll,
+			data->optionsSize - controlExtent.height,
+			active ? 2 : (focused ? 1 : 0));
+		if (result)
+		{
+			return result;
+		}
 	}
 
-	// nothing to free
+	return TREE_OK;
 }
 
-TREE_Result TREE_Control_ListData_Init(TREE_Control_ListData *data, TREE_Control_ListFlags flags, TREE_String *options, TREE_Size optionsSize, TREE_ControlEventHandler onChange, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
+TREE_Result TREE_Control_List_EventHandler(TREE_Event const *event)
 {
 	// validate
-	if (!data || !options)
+	if (!event || !event->control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-
-	data->flags = flags;
-	data->options = NULL;
-	data->optionsSize = 0;
-	data->selectedIndices = NULL;
-
-	TREE_Result result = TREE_Control_ListData_SetOptions(data, options, optionsSize);
-	if (result)
+	if (event->control->type != TREE_CONTROL_TYPE_LIST)
 	{
-		return result;
+		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// set data
-	result = TREE_Control_ScrollbarData_Init(&data->scrollbar, TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC, TREE_AXIS_VERTICAL, theme);
-	if (result)
-	{
-		return result;
-	}
-	data->theme = theme;
-	data->onChange = onChange;
-	data->onSubmit = onSubmit;
+	TREE_Result result;
 
-	return TREE_OK;
-}
+	TREE_Control *control = event->control;
+	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	TREE_Extent extent = control->transform->globalRect.extent;
 
-void TREE_Control_ListData_Free(TREE_Control_ListData *data)
-{
-	if (!data)
+	switch (event->type)
 	{
-		return;
-	}
+	case TREE_EVENT_TYPE_KEY_DOWN:
+	case TREE_EVENT_TYPE_KEY_HELD:
+	{
+		// ignore if not focused
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
+		{
+			break;
+		}
 
-	// free the options
-	TREE_DELETE_ARRAY(data->options, data->optionsSize);
-}
+		// get the event data
+		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
+		TREE_Key key = keyData->key;
 
-TREE_Result TREE_Control_ListData_SetOptions(TREE_Control_ListData *data, TREE_String *options, TREE_Size optionsSize)
-{
-	// validate
-	if (!data)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
+		// activate if not active
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		{
+			// if not active but a submit key is pressed, become active
+			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
+			{
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		}
 
-	// if old options, free them
-	if (data->options)
-	{
-		TREE_DELETE_ARRAY(data->options, data->optionsSize);
-	}
-	data->selectedIndex = 0;
-	data->hoverIndex = 0;
-	data->scroll = 0;
-	if (data->selectedIndices)
-	{
-		TREE_DELETE(data->selectedIndices);
-	}
-	data->optionsSize = optionsSize;
+		// handle key events
+		switch (key)
+		{
+		case TREE_KEY_DOWN_ARROW: // move to next option
+		case TREE_KEY_S:
+			if (data->hoverIndex < data->optionsSize - 1)
+			{
+				data->hoverIndex++;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		case TREE_KEY_UP_ARROW: // move to previous option
+		case TREE_KEY_W:
+			if (data->hoverIndex > 0)
+			{
+				data->hoverIndex--;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		case TREE_KEY_HOME: // move to first option
+			if (data->hoverIndex != 0)
+			{
+				data->hoverIndex = 0;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		case TREE_KEY_END: // move to last option
+			if (data->hoverIndex != data->optionsSize - 1)
+			{
+				data->hoverIndex = data->optionsSize - 1;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			}
+			break;
+		case TREE_KEY_PAGE_UP: // move up a page
+			if (data->hoverIndex > extent.height)
+			{
+				data->hoverIndex -= extent.height;
+			}
+			else
+			{
+				data->hoverIndex = 0;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			break;
+		case TREE_KEY_PAGE_DOWN: // move down a page
+			if (data->hoverIndex < data->optionsSize - extent.height)
+			{
+				data->hoverIndex += extent.height;
+			}
+			else
+			{
+				data->hoverIndex = data->optionsSize - 1;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			break;
+		case TREE_KEY_SPACE: // select option
+		case TREE_KEY_ENTER:
+		{
+			if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+			{
+				// multiselect
+				data->selectedIndices[data->hoverIndex] = !data->selectedIndices[data->hoverIndex];
+				CALL_ACTION(data->onChange, control, &data->selectedIndices);
+			}
+			else
+			{
+				// single select
+				data->selectedIndex = data->hoverIndex;
+				CALL_ACTION(data->onChange, control, &data->selectedIndex);
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			break;
+		}
+		case TREE_KEY_ESCAPE: // exit
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+			{
+				// multiselect
+				CALL_ACTION(data->onChange, control, &data->selectedIndices);
+			}
+			else
+			{
+				// single select
+				CALL_ACTION(data->onChange, control, &data->selectedIndex);
+			}
+			break;
+		}
 
-	// if new data, allocate and copy over
-	if (options && optionsSize)
-	{
-		// allocate data
-		data->options = TREE_NEW_ARRAY(TREE_Char *, optionsSize);
-		if (!data->options)
+		// if needed, update the scroll
+		data->scroll = _TREE_ClampScroll(data->scroll, data->hoverIndex, extent.height);
+
+		break;
+	}
+	case TREE_EVENT_TYPE_REFRESH:
+	{
+		// resize the image if needed
+		TREE_Result result = TREE_Image_Resize(control->image, extent);
+		if (result)
 		{
-			return TREE_ERROR_ALLOC;
+			return result;
 		}
 
-		// copy over options
-		for (TREE_Size i = 0; i < optionsSize; i++)
+		// draw the list
+		TREE_Offset offset = {0, 0};
+		result = _TREE_Control_List_Draw(
+			control->image,
+			offset,
+			extent,
+			control->stateFlags,
+			data);
+		if (result)
 		{
-			TREE_String oldOption = options[i];
-			TREE_Size oldOptionSize = strlen(oldOption);
-			TREE_Char *option = TREE_NEW_ARRAY(TREE_Char, oldOptionSize + 1);
-			if (!option)
-			{
-				TREE_DELETE_ARRAY(data->options, i);
-				return TREE_ERROR_ALLOC;
-			}
-			memcpy(option, oldOption, oldOptionSize * sizeof(TREE_Char));
-			option[oldOptionSize] = '\0'; // null terminator
-			data->options[i] = option;
+			return result;
 		}
 
-		data->optionsSize = optionsSize;
+		break;
+	}
+	case TREE_EVENT_TYPE_DRAW:
+	{
+		// get the event data
+		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
+		TREE_Image *target = drawData->target;
+		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
 
-		// allocate selection data if needed
-		if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+		// draw the control
+		result = _TREE_Control_Draw(
+			target,
+			dirtyRect,
+			&control->transform->globalRect,
+			control->image);
+		if (result)
 		{
-			data->selectedIndices = TREE_NEW_ARRAY(TREE_Byte, optionsSize);
-			if (!data->selectedIndices)
-			{
-				TREE_DELETE_ARRAY(data->options, optionsSize);
-				return TREE_ERROR_ALLOC;
-			}
-
-			for (TREE_Size i = 0; i < optionsSize; i++)
-			{
-				data->selectedIndices[i] = TREE_FALSE;
-			}
+			return result;
 		}
+		break;
+	}
+	default:
+		break;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_ListData_SetSelected(TREE_Control_ListData *data, TREE_Size index, TREE_Bool selected)
+TREE_Result TREE_Control_DropdownData_Init(TREE_Control_DropdownData *data, TREE_String *options, TREE_Size optionsSize, TREE_Size selectedIndex, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
 {
 	// validate
-	if (!data)
+	if (!data || !options)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (index >= data->optionsSize)
+	if (!optionsSize)
 	{
-		return TREE_ERROR_ARG_OUT_OF_RANGE;
+		return TREE_ERROR_ARG_INVALID;
 	}
 
-	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
-	{
-		// multiselect
-		data->selectedIndices[index] = selected;
-	}
-	else
+	data->options = NULL;
+	data->optionsSize = 0;
+	TREE_Result result = TREE_Control_DropdownData_SetOptions(data, options, optionsSize);
+	if (result)
 	{
-		// single select
-		data->selectedIndex = index;
+		return result;
 	}
 
+	// set data
+	data->selectedIndex = selectedIndex;
+	data->hoverIndex = selectedIndex;
+	data->scroll = 0;
+	data->origin.x = 0;
+	data->origin.y = 0;
+	data->drop = 0;
+	data->theme = theme;
+	data->onSubmit = onSubmit;
+
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_ListData_GetSelected(TREE_Control_ListData *data, TREE_Size **indices, TREE_Size *indexCount)
+void TREE_Control_DropdownData_Free(TREE_Control_DropdownData *data)
 {
-	// validate
-	if (!data || !indices || !indexCount)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	*indices = NULL;
-	*indexCount = 0;
-
-	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
-	{
-		// compile indices
-		TREE_Size selectedCount = 0;
-		for (TREE_Size i = 0; i < data->optionsSize; i++)
-		{
-			if (data->selectedIndices[i])
-			{
-				selectedCount++;
-			}
-		}
-		if (selectedCount == 0)
-		{
-			return TREE_OK;
-		}
-		TREE_Size *selected = TREE_NEW_ARRAY(TREE_Size, selectedCount);
-		if (!selected)
-		{
-			return TREE_ERROR_ALLOC;
-		}
-		TREE_Size j = 0;
-		for (TREE_Size i = 0; i < data->optionsSize; i++)
-		{
-			if (data->selectedIndices[i])
-			{
-				selected[j] = i;
-				j++;
-			}
-		}
-		*indices = selected;
-		*indexCount = selectedCount;
-	}
-	else
+	if (!data)
 	{
-		// single index
-		*indices = TREE_NEW(TREE_Size);
-		if (!*indices)
-		{
-			return TREE_ERROR_ALLOC;
-		}
-		**indices = data->selectedIndex;
-		*indexCount = 1;
+		return;
 	}
-	return TREE_OK;
+	// free the options
+	TREE_DELETE_ARRAY(data->options, data->optionsSize);
 }
 
-TREE_Bool TREE_Control_ListData_IsSelected(TREE_Control_ListData *data, TREE_Size index)
+TREE_Result TREE_Control_DropdownData_SetOptions(TREE_Control_DropdownData *data, TREE_String *options, TREE_Size optionsSize)
 {
 	// validate
-	if (!data)
+	if (!data || !options)
 	{
-		return TREE_FALSE;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	if (index >= data->optionsSize)
+	// if old options, free them
+	if (data->options)
 	{
-		return TREE_FALSE;
+		TREE_DELETE_ARRAY(data->options, data->optionsSize);
 	}
 
-	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
+	// allocate and copy over options
+	data->options = TREE_NEW_ARRAY(TREE_Char *, optionsSize);
+	if (!data->options)
 	{
-		// multiselect
-		return data->selectedIndices[index];
+		return TREE_ERROR_ALLOC;
 	}
-	else
+	for (TREE_Size i = 0; i < optionsSize; i++)
 	{
-		// single select
-		return data->selectedIndex == index;
+		TREE_String oldOption = options[i];
+		TREE_Size oldOptionSize = strlen(oldOption);
+		TREE_Char *option = TREE_NEW_ARRAY(TREE_Char, oldOptionSize + 1);
+		if (!option)
+		{
+			TREE_DELETE_ARRAY(data->options, i);
+			return TREE_ERROR_ALLOC;
+		}
+		memcpy(option, oldOption, oldOptionSize * sizeof(TREE_Char));
+		option[oldOptionSize] = '\0'; // null terminator
+		data->options[i] = option;
 	}
+	data->optionsSize = optionsSize;
+
+	// reset selection
+	data->selectedIndex = 0;
+	data->hoverIndex = 0;
+	data->scroll = 0;
+
+	return TREE_OK;
 }
 
-TREE_Result TREE_Control_List_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_ListData *data)
+TREE_Result TREE_Control_Dropdown_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_DropdownData *data)
 {
 	// validate
 	if (!control || !data)
@@ -5938,54 +10035,23 @@ TREE_Result TREE_Control_List_Init(TREE_Control *control, TREE_Transform *parent
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// init control
-	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_List_EventHandler, data);
+	// control init
+	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_Dropdown_EventHandler, data);
 	if (result)
 	{
 		return result;
 	}
 
 	// set data
-	control->type = TREE_CONTROL_TYPE_LIST;
+	control->type = TREE_CONTROL_TYPE_DROPDOWN;
 	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
-	control->transform->localExtent.width = 16;
-	control->transform->localExtent.height = 10;
-
-	return TREE_OK;
-}
-
-TREE_Result TREE_Control_List_SetFlags(TREE_Control *control, TREE_Control_ListFlags flags)
-{
-	// validate
-	if (!control)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-
-	// set flags
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	data->flags = flags;
-
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	control->transform->localExtent.width = 22;
+	control->transform->localExtent.height = 1;
 
 	return TREE_OK;
 }
 
-TREE_Control_ListFlags TREE_Control_List_GetFlags(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return TREE_CONTROL_LIST_FLAGS_NONE;
-	}
-
-	// get flags
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	return data->flags;
-}
-
-TREE_Result TREE_Control_List_SetOptions(TREE_Control *control, TREE_String *options, TREE_Size optionsSize)
+TREE_Result TREE_Control_Dropdown_SetOptions(TREE_Control *control, TREE_String *options, TREE_Size optionsSize)
 {
 	// validate
 	if (!control)
@@ -5994,8 +10060,8 @@ TREE_Result TREE_Control_List_SetOptions(TREE_Control *control, TREE_String *opt
 	}
 
 	// set options
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	TREE_Result result = TREE_Control_ListData_SetOptions(data, options, optionsSize);
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	TREE_Result result = TREE_Control_DropdownData_SetOptions(data, options, optionsSize);
 	if (result)
 	{
 		return result;
@@ -6007,7 +10073,7 @@ TREE_Result TREE_Control_List_SetOptions(TREE_Control *control, TREE_String *opt
 	return TREE_OK;
 }
 
-TREE_String *TREE_Control_List_GetOptions(TREE_Control *control)
+TREE_String *TREE_Control_Dropdown_GetOptions(TREE_Control *control)
 {
 	// validate
 	if (!control)
@@ -6016,11 +10082,11 @@ TREE_String *TREE_Control_List_GetOptions(TREE_Control *control)
 	}
 
 	// get options
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
 	return (TREE_String *)data->options;
 }
 
-TREE_Size TREE_Control_List_GetOptionsSize(TREE_Control *control)
+TREE_Size TREE_Control_Dropdown_GetOptionsSize(TREE_Control *control)
 {
 	// validate
 	if (!control)
@@ -6029,11 +10095,11 @@ TREE_Size TREE_Control_List_GetOptionsSize(TREE_Control *control)
 	}
 
 	// get options size
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
 	return data->optionsSize;
 }
 
-TREE_Result TREE_Control_List_SetSelected(TREE_Control *control, TREE_Size index, TREE_Bool selected)
+TREE_Result TREE_Control_Dropdown_SetSelected(TREE_Control *control, TREE_Size index)
 {
 	// validate
 	if (!control)
@@ -6042,12 +10108,13 @@ TREE_Result TREE_Control_List_SetSelected(TREE_Control *control, TREE_Size index
 	}
 
 	// set selected
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	TREE_Result result = TREE_Control_ListData_SetSelected(data, index, selected);
-	if (result)
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	if (index >= data->optionsSize)
 	{
-		return result;
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
+	data->selectedIndex = index;
+	data->hoverIndex = index;
 
 	// redraw
 	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
@@ -6055,7 +10122,7 @@ TREE_Result TREE_Control_List_SetSelected(TREE_Control *control, TREE_Size index
 	return TREE_OK;
 }
 
-TREE_Bool TREE_Control_List_IsSelected(TREE_Control *control, TREE_Size index)
+TREE_Bool TREE_Control_Dropdown_IsSelected(TREE_Control *control, TREE_Size index)
 {
 	// validate
 	if (!control)
@@ -6064,11 +10131,16 @@ TREE_Bool TREE_Control_List_IsSelected(TREE_Control *control, TREE_Size index)
 	}
 
 	// get selected
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	return TREE_Control_ListData_IsSelected(data, index);
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	if (index >= data->optionsSize)
+	{
+		return TREE_FALSE;
+	}
+
+	return data->selectedIndex == index;
 }
 
-TREE_Size TREE_Control_List_GetSelected(TREE_Control *control)
+TREE_Size TREE_Control_Dropdown_GetSelected(TREE_Control *control)
 {
 	// validate
 	if (!control)
@@ -6077,15 +10149,12 @@ TREE_Size TREE_Control_List_GetSelected(TREE_Control *control)
 	}
 
 	// get selected
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
-	{
-		return 0;
-	}
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+
 	return data->selectedIndex;
 }
 
-TREE_Result TREE_Control_List_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
+TREE_Result TREE_Control_Dropdown_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
 {
 	// validate
 	if (!control)
@@ -6093,14 +10162,14 @@ TREE_Result TREE_Control_List_SetOnChange(TREE_Control *control, TREE_ControlEve
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set onChange
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	data->onChange = onChange;
+	// set onSubmit
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	data->onSubmit = onSubmit;
 
 	return TREE_OK;
 }
 
-TREE_ControlEventHandler TREE_Control_List_GetOnChange(TREE_Control *control)
+TREE_ControlEventHandler TREE_Control_Dropdown_GetOnSubmit(TREE_Control *control)
 {
 	// validate
 	if (!control)
@@ -6108,228 +10177,504 @@ TREE_ControlEventHandler TREE_Control_List_GetOnChange(TREE_Control *control)
 		return NULL;
 	}
 
-	// get onChange
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	return data->onChange;
+	// get onSubmit
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+
+	return data->onSubmit;
 }
 
-TREE_Result TREE_Control_List_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
+TREE_Result TREE_Control_Dropdown_EventHandler(TREE_Event const *event)
 {
 	// validate
-	if (!control)
+	if (!event || !event->control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-
-	// set onSubmit
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	data->onSubmit = onSubmit;
-
-	return TREE_OK;
-}
-
-TREE_ControlEventHandler TREE_Control_List_GetOnSubmit(TREE_Control *control)
-{
-	// validate
-	if (!control)
+	if (event->control->type != TREE_CONTROL_TYPE_DROPDOWN)
 	{
-		return NULL;
+		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// get onSubmit
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	return data->onSubmit;
-}
-
-TREE_Result _TREE_Control_List_Draw(TREE_Image *target, TREE_Offset controlOffset, TREE_Extent controlExtent, TREE_ControlStateFlags stateFlags, TREE_Control_ListData *data)
-{
 	TREE_Result result;
-	TREE_Bool active = (stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
-	TREE_Bool focused = (stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED);
-
-	// determine pixels from state
-	TREE_Pixel const *unselectedPixel;
-	TREE_Pixel const *selectedPixel;
+	TREE_Control *control = event->control;
+	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
 
-	if (active)
-	{
-		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
-		selectedPixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE_SELECTED];
-	}
-	else if (focused)
+	switch (event->type)
 	{
-		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
-		selectedPixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED_SELECTED];
-	}
-	else
+	case TREE_EVENT_TYPE_KEY_DOWN:
+	case TREE_EVENT_TYPE_KEY_HELD:
 	{
-		unselectedPixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
-		selectedPixel = &data->theme->pixels[TREE_THEME_PID_NORMAL_SELECTED];
-	}
+		// ignore if not focused
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
+		{
+			break;
+		}
+
+		// get the event data
+		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
+		TREE_Key key = keyData->key;
+
+		// if not active, do nothing
+		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		{
+			// if not active but a submit key is pressed, become active
+			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
+			{
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+				// set origin
+				data->origin = control->transform->localOffset;
+
+				// calulate drop size if needed
+				// get window size, or the size of the Surface if the Application has no window
+				TREE_Offset dropdownOffset = control->transform->globalRect.offset;
+				TREE_Application const *application = event->application;
+				TREE_Extent windowExtent = application && application->headless ? application->surface->image.extent : TREE_Window_GetExtent();
+
+				// get space above and below the dropdown
+				TREE_Int optionsCount = (TREE_Int)data->optionsSize;
+				TREE_Int belowSpace = (TREE_Int)windowExtent.height - dropdownOffset.y;
+				TREE_Int aboveSpace = (TREE_Int)dropdownOffset.y + 1;
+
+				// if can fit down, go down
+				// if not, go up
+				// if cannot fit in either, pick larger one
+				if (optionsCount < belowSpace)
+				{
+					// go down
+					data->drop = optionsCount;
+				}
+				else if (optionsCount < aboveSpace)
+				{
+					// go up
+					data->drop = -optionsCount;
+				}
+				else
+				{
+					// go bigger direction, cap at space size
+					if (aboveSpace > belowSpace)
+					{
+						data->drop = -aboveSpace;
+					}
+					else
+					{
+						data->drop = belowSpace - 1;
+					}
+				}
+
+				// move transform (if needed) to account for dropdown
+				if (data->drop < 0)
+				{
+					control->transform->localOffset.y += data->drop;
+				}
+
+				// resize transform as well
+				TREE_UInt dropSize = (TREE_UInt)(data->drop > 0 ? data->drop : -data->drop);
+				control->transform->localExtent.height = dropSize + 1;
+				control->transform->dirty = TREE_TRUE;
+			}
+			break;
+		}
+
+		TREE_Bool cursorMoved = TREE_FALSE;
+
+		// handle key events
+		switch (key)
+		{
+		case TREE_KEY_UP_ARROW: // move to previous option
+		case TREE_KEY_W:
+			if (data->hoverIndex > 0)
+			{
+				data->hoverIndex--;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_DOWN_ARROW: // move to next option
+		case TREE_KEY_S:
+			if (data->hoverIndex < data->optionsSize - 1)
+			{
+				data->hoverIndex++;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_HOME: // move to first option
+			if (data->hoverIndex != 0)
+			{
+				data->hoverIndex = 0;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_END: // move to last option
+			if (data->hoverIndex != data->optionsSize - 1)
+			{
+				data->hoverIndex = data->optionsSize - 1;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+				cursorMoved = TREE_TRUE;
+			}
+			break;
+		case TREE_KEY_PAGE_UP: // move up a page
+			if (data->hoverIndex > control->transform->localExtent.height)
+			{
+				data->hoverIndex -= control->transform->localExtent.height;
+			}
+			else
+			{
+				data->hoverIndex = 0;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			cursorMoved = TREE_TRUE;
+			break;
+		case TREE_KEY_PAGE_DOWN: // move down a page
+			if (data->hoverIndex < data->optionsSize - control->transform->localExtent.height)
+			{
+				data->hoverIndex += control->transform->localExtent.height;
+			}
+			else
+			{
+				data->hoverIndex = data->optionsSize - 1;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			cursorMoved = TREE_TRUE;
+			break;
+		case TREE_KEY_ENTER: // submit
+		case TREE_KEY_SPACE:
+		{
+			// move back to origin
+			control->transform->localOffset = data->origin;
+
+			// shrink transform
+			control->transform->localExtent.height = 1;
+			control->transform->dirty = TREE_TRUE;
+
+			data->selectedIndex = data->hoverIndex;
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onSubmit, control, &data->selectedIndex);
+			break;
+		}
+		case TREE_KEY_ESCAPE: // cancel
+		{
+			// move back to origin
+			control->transform->localOffset = data->origin;
+
+			// shrink transform
+			control->transform->localExtent.height = 1;
+			control->transform->dirty = TREE_TRUE;
+
+			data->hoverIndex = data->selectedIndex;
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			break;
+		}
+		}
+
+		// update scroll
+		if (cursorMoved)
+		{
+			data->scroll = _TREE_ClampScroll(data->scroll, data->hoverIndex, control->transform->localExtent.height - 1);
+		}
 
-	// determine if there is a scrollbar
-	TREE_Size scrollbar = 0;
-	switch (data->scrollbar.type)
-	{
-	case TREE_CONTROL_SCROLLBAR_TYPE_NONE:
-		scrollbar = 0;
-		break;
-	case TREE_CONTROL_SCROLLBAR_TYPE_STATIC:
-		scrollbar = 1;
-		break;
-	case TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC:
-		scrollbar = (controlExtent.height < data->optionsSize) ? 1 : 0;
 		break;
 	}
-
-	// get width of options
-	TREE_Size optionsWidth = controlExtent.width - scrollbar;
-
-	// draw the options
-	TREE_Size count = controlExtent.height;
-	TREE_Size scroll = data->scroll;
-	TREE_Size index;
-	for (TREE_Size i = 0; i < count; i++)
+	case TREE_EVENT_TYPE_REFRESH:
 	{
-		index = scroll + i;
+		TREE_Bool active = (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
 
-		TREE_Size fillerOffset;
-		TREE_Size fillerLength;
+		// resize if needed
+		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (result)
+		{
+			return result;
+		}
+
+		// get pixel from state
 		TREE_Pixel const *pixel;
+		if (active)
+		{
+			pixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
+		}
+		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+		{
+			pixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
+		}
+		else
+		{
+			pixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
+		}
 
-		if (index < data->optionsSize)
+		// get the selected option
+		TREE_Extent extent = control->transform->globalRect.extent;
+		TREE_Size optionsWidth = extent.width - 2;
+		TREE_Size fillerOffset;
+		TREE_Size fillerWidth;
+		TREE_Offset offset;
+		TREE_Int mainOffset = data->drop < 0 ? extent.height - 1 : 0;
+		if (data->optionsSize)
 		{
-			// draw option
-			// get option and info about it
-			TREE_Char *option = data->options[scroll + i];
+			TREE_Char *option = data->options[data->selectedIndex];
 			TREE_Size optionLength = strlen(option);
 			TREE_Size optionWidth = MIN(optionsWidth, optionLength);
-			fillerOffset = optionWidth;
-			fillerLength = optionsWidth - optionWidth;
-			TREE_Bool selected = TREE_Control_ListData_IsSelected(data, scroll + i);
-
-			// copy the option
 			TREE_Char *optionCopy = _TREE_MakeSafeCopy(option, optionWidth);
-
-			// get pixel to use for drawing
-			if (active && data->hoverIndex == scroll + i)
-			{
-				if (selected)
-				{
-					pixel = &data->theme->pixels[TREE_THEME_PID_HOVERED_SELECTED];
-				}
-				else
-				{
-					pixel = &data->theme->pixels[TREE_THEME_PID_HOVERED];
-				}
-			}
-			else
+			if (!optionCopy)
 			{
-				if (selected)
-				{
-					pixel = selectedPixel;
-				}
-				else
-				{
-					pixel = unselectedPixel;
-				}
+				return TREE_ERROR_ALLOC;
 			}
 
-			// draw option text
-			TREE_Offset offset;
-			offset.x = controlOffset.x;
-			offset.y = controlOffset.y + (TREE_Int)i;
+			// draw the option
+			offset.x = 0;
+			offset.y = mainOffset;
 			result = TREE_Image_DrawString(
-				target,
+				control->image,
 				offset,
 				optionCopy,
 				pixel->colorPair);
+			free(optionCopy);
 			if (result)
 			{
 				return result;
 			}
 
-			free(optionCopy);
+			fillerOffset = optionWidth;
+			fillerWidth = optionsWidth - optionWidth;
 		}
 		else
 		{
-			// no option to draw
 			fillerOffset = 0;
-			fillerLength = optionsWidth;
-			pixel = unselectedPixel;
+			fillerWidth = optionsWidth;
+		}
+
+		// draw the filler, if any
+		if (fillerWidth)
+		{
+			offset.x = (TREE_Int)fillerOffset;
+			offset.y = mainOffset;
+			TREE_Extent extent;
+			extent.width = (TREE_UInt)fillerWidth;
+			extent.height = 1;
+			TREE_Rect rect = {offset, extent};
+			result = TREE_Image_FillRect(
+				control->image,
+				&rect,
+				*pixel);
+			if (result)
+			{
+				return result;
+			}
+		}
+
+		// draw the dropdown separator
+		TREE_Pixel arrowPixel;
+		arrowPixel.character = '|';
+		arrowPixel.colorPair = pixel->colorPair;
+		offset.x = (TREE_Int)optionsWidth;
+		offset.y = mainOffset;
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			arrowPixel);
+		if (result)
+		{
+			return result;
+		}
+
+		// draw the dropdown arrow
+		arrowPixel.character = active ? '^' : 'v';
+		offset.x = (TREE_Int)optionsWidth + 1;
+		offset.y = mainOffset;
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			arrowPixel);
+		if (result)
+		{
+			return result;
+		}
+
+		// if active, draw the dropdown
+		if (active)
+		{
+			// populate a list data structure using the dropdown's data
+			TREE_Control_ListData listData;
+			listData.flags = TREE_CONTROL_LIST_FLAGS_NONE;
+			listData.options = data->options;
+			listData.optionsSize = data->optionsSize;
+			listData.selectedIndex = data->selectedIndex;
+			listData.selectedIndices = NULL;
+			listData.hoverIndex = data->hoverIndex;
+			listData.scroll = data->scroll;
+			result = TREE_Control_ScrollbarData_Init(
+				&listData.scrollbar,
+				TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC,
+				TREE_AXIS_VERTICAL,
+				data->theme);
+			listData.theme = data->theme;
+			listData.onChange = NULL;
+			listData.onSubmit = NULL;
+
+			// draw the list where the dropdown is
+			TREE_Int adjustment = data->drop < 0 ? 0 : 1;
+			TREE_Offset listOffset;
+			listOffset.x = 0;
+			listOffset.y = adjustment;
+			TREE_Extent listExtent = extent;
+			listExtent.height -= 1;
+			result = _TREE_Control_List_Draw(
+				control->image,
+				listOffset,
+				listExtent,
+				control->stateFlags,
+				&listData);
+			if (result)
+			{
+				TREE_Control_ListData_Free(&listData);
+				return result;
+			}
+		}
+
+		break;
+	}
+	case TREE_EVENT_TYPE_DRAW:
+	{
+		// get the event data
+		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
+		TREE_Image *target = drawData->target;
+		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
+
+		// draw the control
+		TREE_Result result = _TREE_Control_Draw(
+			target,
+			dirtyRect,
+			&control->transform->globalRect,
+			control->image);
+		if (result)
+		{
+			return result;
 		}
 
-		// draw filler
-		if (fillerLength)
-		{
-			TREE_Offset offset;
-			offset.x = controlOffset.x + (TREE_Int)fillerOffset;
-			offset.y = controlOffset.y + (TREE_Int)i;
-			TREE_Extent extent;
-			extent.width = (TREE_UInt)fillerLength;
-			extent.height = 1;
-			TREE_Rect rect = {offset, extent};
-			result = TREE_Image_FillRect(
-				target,
-				&rect,
-				*pixel);
-			if (result)
-			{
-				return result;
-			}
-		}
+		break;
+	}
+	default:
+		break;
+	}
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_CheckboxData_Init(TREE_Control_CheckboxData *data, TREE_String text, TREE_Control_CheckboxFlags flags, TREE_ControlEventHandler onCheck, TREE_Theme const *theme)
+{
+	// validate
+	if (!data || !text)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set data
+	TREE_Result result = TREE_String_CreateCopy(&data->text, text);
+	if (result)
+	{
+		return result;
+	}
+	data->flags = flags;
+	data->theme = theme;
+	data->onCheck = onCheck;
+
+	return TREE_OK;
+}
+
+void TREE_Control_CheckboxData_Free(TREE_Control_CheckboxData *data)
+{
+	// validate
+	if (!data)
+	{
+		return;
+	}
+	// free the text
+	TREE_DELETE(data->text);
+}
+
+TREE_Result TREE_Control_Checkbox_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_CheckboxData *data)
+{
+	// validate
+	if (!control || !data)
+	{
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	// draw the scrollbar
-	if (scrollbar)
+	// control init
+	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_Checkbox_EventHandler, data);
+	if (result)
 	{
+		return result;
+	}
 
-		// get the scrollbar extent
-		TREE_Extent scrollbarExtent;
-		scrollbarExtent.width = 1;
-		scrollbarExtent.height = controlExtent.height;
+	// set data
+	control->type = TREE_CONTROL_TYPE_CHECKBOX;
+	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
+	control->transform->localExtent.width = 16;
+	control->transform->localExtent.height = 1;
 
-		// get the scrollbar offset
-		TREE_Offset scrollbarOffset;
-		scrollbarOffset.x = controlOffset.x + (TREE_Int)optionsWidth;
-		scrollbarOffset.y = controlOffset.y;
+	return TREE_OK;
+}
 
-		// draw the scrollbar
-		result = _TREE_Control_Scrollbar_Draw(
-			target,
-			scrollbarOffset,
-			scrollbarExtent,
-			&data->scrollbar,
-			data->scroll,
-			data->optionsSize - controlExtent.height,
-			active ? 2 : (focused ? 1 : 0));
-		if (result)
-		{
-			return result;
-		}
+TREE_Result TREE_Control_Checkbox_SetChecked(TREE_Control *control, TREE_Byte checked)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_CHECKBOX)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set the checked state
+	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
+	if (checked)
+	{
+		data->flags |= TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
+	}
+	else
+	{
+		data->flags &= ~TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
 	}
 
+	// dirty the component to be redrawn
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_List_EventHandler(TREE_Event const *event)
+TREE_Bool TREE_Control_Checkbox_GetChecked(TREE_Control *control)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_CHECKBOX)
+	{
+		return TREE_FALSE;
+	}
+
+	// get the checked state
+	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
+	return (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0 ? TREE_TRUE : TREE_FALSE;
+}
+
+TREE_Result TREE_Control_Checkbox_EventHandler(TREE_Event const *event)
 {
 	// validate
 	if (!event || !event->control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_LIST)
+	if (event->control->type != TREE_CONTROL_TYPE_CHECKBOX)
 	{
 		return TREE_ERROR_ARG_INVALID;
 	}
 
+	// get data
 	TREE_Result result;
-
 	TREE_Control *control = event->control;
-	TREE_Control_ListData *data = (TREE_Control_ListData *)control->data;
-	TREE_Extent extent = control->transform->globalRect.extent;
+	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
 
+	// handle events
 	switch (event->type)
 	{
 	case TREE_EVENT_TYPE_KEY_DOWN:
@@ -6345,133 +10690,197 @@ TREE_Result TREE_Control_List_EventHandler(TREE_Event const *event)
 		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
 		TREE_Key key = keyData->key;
 
-		// activate if not active
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		// check boxes are like buttons, they do not need to be active to be used
+		// when submit button is pressed, toggle the checkbox
+		if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
 		{
-			// if not active but a submit key is pressed, become active
-			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
+			// toggle the checked state
+			TREE_Bool checked = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0;
+			if (checked)
 			{
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
+				data->flags &= ~TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
 			}
-			break;
+			else
+			{
+				data->flags |= TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
+			}
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onCheck, control, &checked);
+		}
+		break;
+	}
+	case TREE_EVENT_TYPE_REFRESH:
+	{
+		// resize if needed
+		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (result)
+		{
+			return result;
 		}
 
-		// handle key events
-		switch (key)
+		// get color from state
+		TREE_ColorPair color;
+		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
 		{
-		case TREE_KEY_DOWN_ARROW: // move to next option
-		case TREE_KEY_S:
-			if (data->hoverIndex < data->optionsSize - 1)
-			{
-				data->hoverIndex++;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			}
-			break;
-		case TREE_KEY_UP_ARROW: // move to previous option
-		case TREE_KEY_W:
-			if (data->hoverIndex > 0)
-			{
-				data->hoverIndex--;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			}
-			break;
-		case TREE_KEY_HOME: // move to first option
-			if (data->hoverIndex != 0)
-			{
-				data->hoverIndex = 0;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			}
-			break;
-		case TREE_KEY_END: // move to last option
-			if (data->hoverIndex != data->optionsSize - 1)
-			{
-				data->hoverIndex = data->optionsSize - 1;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			}
-			break;
-		case TREE_KEY_PAGE_UP: // move up a page
-			if (data->hoverIndex > extent.height)
+			color = data->theme->pixels[TREE_THEME_PID_FOCUSED].colorPair;
+		}
+		else
+		{
+			color = data->theme->pixels[TREE_THEME_PID_NORMAL].colorPair;
+		}
+
+		// get checked character
+		TREE_Bool radio = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_RADIO) != 0;
+		TREE_Bool checked = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0;
+		TREE_Char checkedChar;
+		if (checked)
+		{
+			if (radio)
 			{
-				data->hoverIndex -= extent.height;
+				checkedChar = data->theme->characters[TREE_THEME_CID_RADIOBOX_CHECKED];
 			}
 			else
 			{
-				data->hoverIndex = 0;
+				checkedChar = data->theme->characters[TREE_THEME_CID_CHECKBOX_CHECKED];
 			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			break;
-		case TREE_KEY_PAGE_DOWN: // move down a page
-			if (data->hoverIndex < data->optionsSize - extent.height)
+		}
+		else
+		{
+			if (radio)
 			{
-				data->hoverIndex += extent.height;
+				checkedChar = data->theme->characters[TREE_THEME_CID_RADIOBOX_UNCHECKED];
 			}
 			else
 			{
-				data->hoverIndex = data->optionsSize - 1;
+				checkedChar = data->theme->characters[TREE_THEME_CID_CHECKBOX_UNCHECKED];
 			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			break;
-		case TREE_KEY_SPACE: // select option
-		case TREE_KEY_ENTER:
+		}
+
+		// draw the checkbox
+		TREE_Offset offset;
+		offset.y = 0;
+
+		// if reverse, place the checkbox on the right
+		TREE_Int checkboxLength = 3;
+		TREE_Int checkOffset, textOffset;
+		if (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_REVERSE)
+		{
+			checkOffset = control->transform->globalRect.extent.width - checkboxLength;
+			textOffset = 0;
+		}
+		else
+		{
+			checkOffset = 0;
+			textOffset = checkboxLength;
+		}
+		offset.x = checkOffset;
+
+		// draw the checkbox
+		TREE_Pixel pixel;
+		if (radio)
+		{
+			pixel.character = data->theme->characters[TREE_THEME_CID_RADIOBOX_LEFT];
+		}
+		else
+		{
+			pixel.character = data->theme->characters[TREE_THEME_CID_CHECKBOX_LEFT];
+		}
+		pixel.colorPair = color;
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			pixel);
+		if (result)
+		{
+			return result;
+		}
+		offset.x++;
+		pixel.character = checkedChar;
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			pixel);
+		if (result)
+		{
+			return result;
+		}
+		offset.x++;
+		if (radio)
 		{
-			if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
-			{
-				// multiselect
-				data->selectedIndices[data->hoverIndex] = !data->selectedIndices[data->hoverIndex];
-				CALL_ACTION(data->onChange, control, &data->selectedIndices);
-			}
-			else
-			{
-				// single select
-				data->selectedIndex = data->hoverIndex;
-				CALL_ACTION(data->onChange, control, &data->selectedIndex);
-			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			break;
+			pixel.character = data->theme->characters[TREE_THEME_CID_RADIOBOX_RIGHT];
 		}
-		case TREE_KEY_ESCAPE: // exit
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			if (data->flags & TREE_CONTROL_LIST_FLAGS_MULTISELECT)
-			{
-				// multiselect
-				CALL_ACTION(data->onChange, control, &data->selectedIndices);
-			}
-			else
-			{
-				// single select
-				CALL_ACTION(data->onChange, control, &data->selectedIndex);
-			}
-			break;
+		else
+		{
+			pixel.character = data->theme->characters[TREE_THEME_CID_CHECKBOX_RIGHT];
+		}
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			pixel);
+		if (result)
+		{
+			return result;
 		}
 
-		// if needed, update the scroll
-		data->scroll = _TREE_ClampScroll(data->scroll, data->hoverIndex, extent.height);
+		// draw the string
+		offset.x = textOffset;
+		offset.y = 0;
+		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
+		{
+			color = data->theme->pixels[TREE_THEME_PID_FOCUSED].colorPair;
+		}
+		else
+		{
+			color = data->theme->pixels[TREE_THEME_PID_NORMAL].colorPair;
+		}
 
-		break;
-	}
-	case TREE_EVENT_TYPE_REFRESH:
-	{
-		// resize the image if needed
-		TREE_Result result = TREE_Image_Resize(control->image, extent);
+		// if the string is too long, cap it
+		TREE_Char *text;
+		result = TREE_String_CreateClampedCopy(&text, data->text, control->transform->globalRect.extent.width - (TREE_Size)checkboxLength);
 		if (result)
 		{
 			return result;
 		}
 
-		// draw the list
-		TREE_Offset offset = {0, 0};
-		result = _TREE_Control_List_Draw(
+		TREE_Size textSize = strlen(text);
+
+		// draw the string
+		result = TREE_Image_DrawString(
 			control->image,
 			offset,
-			extent,
-			control->stateFlags,
-			data);
+			text,
+			color);
+		free(text);
 		if (result)
 		{
 			return result;
 		}
 
+		// if there is extra space, fill it
+		TREE_Size fillerSize = control->transform->globalRect.extent.width - (TREE_Size)checkboxLength - textSize;
+		if (fillerSize)
+		{
+			TREE_Offset fillerOffset;
+			fillerOffset.x = (TREE_Int)(textOffset + textSize);
+			fillerOffset.y = 0;
+
+			TREE_Extent fillerExtent;
+			fillerExtent.width = (TREE_UInt)fillerSize;
+			fillerExtent.height = 1;
+
+			pixel.character = ' ';
+			pixel.colorPair = color;
+			TREE_Rect fillerRect = {fillerOffset, fillerExtent};
+			result = TREE_Image_FillRect(
+				control->image,
+				&fillerRect,
+				pixel);
+			if (result)
+			{
+				return result;
+			}
+		}
+
 		break;
 	}
 	case TREE_EVENT_TYPE_DRAW:
@@ -6482,7 +10891,7 @@ TREE_Result TREE_Control_List_EventHandler(TREE_Event const *event)
 		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
 
 		// draw the control
-		result = _TREE_Control_Draw(
+		TREE_Result result = _TREE_Control_Draw(
 			target,
 			dirtyRect,
 			&control->transform->globalRect,
@@ -6491,139 +10900,187 @@ TREE_Result TREE_Control_List_EventHandler(TREE_Event const *event)
 		{
 			return result;
 		}
+
 		break;
 	}
+	default:
+		break;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_DropdownData_Init(TREE_Control_DropdownData *data, TREE_String *options, TREE_Size optionsSize, TREE_Size selectedIndex, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
+TREE_Result TREE_Control_NumberInputData_Init(TREE_Control_NumberInputData *data, TREE_Float value, TREE_Float min, TREE_Float max, TREE_Float increment, TREE_Int decimalPlaces, TREE_ControlEventHandler onChange, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
 {
 	// validate
-	if (!data || !options)
+	if (!data)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (!optionsSize)
-	{
-		return TREE_ERROR_ARG_INVALID;
-	}
-
-	data->options = NULL;
-	data->optionsSize = 0;
-	TREE_Result result = TREE_Control_DropdownData_SetOptions(data, options, optionsSize);
-	if (result)
+	if (min > max)
 	{
-		return result;
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
 
 	// set data
-	data->selectedIndex = selectedIndex;
-	data->hoverIndex = selectedIndex;
-	data->scroll = 0;
-	data->origin.x = 0;
-	data->origin.y = 0;
-	data->drop = 0;
+	data->minValue = min;
+	data->maxValue = max;
+	data->value = CLAMP(value, min, max);
+	data->increment = increment;
+	data->decimalPlaces = decimalPlaces;
 	data->theme = theme;
+	data->onChange = onChange;
 	data->onSubmit = onSubmit;
 
 	return TREE_OK;
 }
 
-void TREE_Control_DropdownData_Free(TREE_Control_DropdownData *data)
+void TREE_Control_NumberInputData_Free(TREE_Control_NumberInputData *data)
 {
 	if (!data)
 	{
 		return;
 	}
-	// free the options
-	TREE_DELETE_ARRAY(data->options, data->optionsSize);
+
+	// nothing to free
 }
 
-TREE_Result TREE_Control_DropdownData_SetOptions(TREE_Control_DropdownData *data, TREE_String *options, TREE_Size optionsSize)
+TREE_Result TREE_Control_NumberInput_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_NumberInputData *data)
 {
 	// validate
-	if (!data || !options)
+	if (!control || !data)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// if old options, free them
-	if (data->options)
+	// control init
+	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_NumberInput_EventHandler, data);
+	if (result)
 	{
-		TREE_DELETE_ARRAY(data->options, data->optionsSize);
+		return result;
 	}
 
-	// allocate and copy over options
-	data->options = TREE_NEW_ARRAY(TREE_Char *, optionsSize);
-	if (!data->options)
+	// set data
+	control->type = TREE_CONTROL_TYPE_NUMBER_INPUT;
+	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
+	control->transform->localExtent.width = 7;
+	control->transform->localExtent.height = 1;
+
+	return TREE_OK;
+}
+
+TREE_Result TREE_Control_NumberInput_SetValue(TREE_Control *control, TREE_Float value)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		return TREE_ERROR_ALLOC;
+		return TREE_ERROR_ARG_NULL;
 	}
-	for (TREE_Size i = 0; i < optionsSize; i++)
+
+	// set the value
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->value = CLAMP(value, data->minValue, data->maxValue);
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	// call the onChange event
+	CALL_ACTION(data->onChange, control, &data->value);
+
+	return TREE_OK;
+}
+
+TREE_Float TREE_Control_NumberInput_GetValue(TREE_Control *control)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		TREE_String oldOption = options[i];
-		TREE_Size oldOptionSize = strlen(oldOption);
-		TREE_Char *option = TREE_NEW_ARRAY(TREE_Char, oldOptionSize + 1);
-		if (!option)
-		{
-			TREE_DELETE_ARRAY(data->options, i);
-			return TREE_ERROR_ALLOC;
-		}
-		memcpy(option, oldOption, oldOptionSize * sizeof(TREE_Char));
-		option[oldOptionSize] = '\0'; // null terminator
-		data->options[i] = option;
+		return 0;
 	}
-	data->optionsSize = optionsSize;
 
-	// reset selection
-	data->selectedIndex = 0;
-	data->hoverIndex = 0;
-	data->scroll = 0;
+	// get the value
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+
+	return data->value;
+}
+
+TREE_Result TREE_Control_NumberInput_SetMin(TREE_Control *control, TREE_Float minValue)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set the min
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->minValue = minValue;
+	data->value = CLAMP(data->value, minValue, data->maxValue);
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_Float TREE_Control_NumberInput_GetMin(TREE_Control *control)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	{
+		return 0;
+	}
+
+	// get the min
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+
+	return data->minValue;
+}
+
+TREE_Result TREE_Control_NumberInput_SetMax(TREE_Control *control, TREE_Float maxValue)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// set the max
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->maxValue = maxValue;
+	data->value = CLAMP(data->value, data->minValue, maxValue);
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_Dropdown_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_DropdownData *data)
+TREE_Float TREE_Control_NumberInput_GetMax(TREE_Control *control)
 {
 	// validate
-	if (!control || !data)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-
-	// control init
-	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_Dropdown_EventHandler, data);
-	if (result)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		return result;
+		return 0;
 	}
 
-	// set data
-	control->type = TREE_CONTROL_TYPE_DROPDOWN;
-	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
-	control->transform->localExtent.width = 22;
-	control->transform->localExtent.height = 1;
+	// get the max
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
 
-	return TREE_OK;
+	return data->maxValue;
 }
 
-TREE_Result TREE_Control_Dropdown_SetOptions(TREE_Control *control, TREE_String *options, TREE_Size optionsSize)
+TREE_Result TREE_Control_NumberInput_SetIncrement(TREE_Control *control, TREE_Float increment)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set options
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-	TREE_Result result = TREE_Control_DropdownData_SetOptions(data, options, optionsSize);
-	if (result)
-	{
-		return result;
-	}
+	// set the increment
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->increment = increment;
 
 	// redraw
 	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
@@ -6631,48 +11088,30 @@ TREE_Result TREE_Control_Dropdown_SetOptions(TREE_Control *control, TREE_String
 	return TREE_OK;
 }
 
-TREE_String *TREE_Control_Dropdown_GetOptions(TREE_Control *control)
-{
-	// validate
-	if (!control)
-	{
-		return NULL;
-	}
-
-	// get options
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-	return (TREE_String *)data->options;
-}
-
-TREE_Size TREE_Control_Dropdown_GetOptionsSize(TREE_Control *control)
+TREE_Float TREE_Control_NumberInput_GetIncrement(TREE_Control *control)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return 0;
 	}
 
-	// get options size
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-	return data->optionsSize;
+	// get the increment
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	return data->increment;
 }
 
-TREE_Result TREE_Control_Dropdown_SetSelected(TREE_Control *control, TREE_Size index)
+TREE_Result TREE_Control_NumberInput_SetDecimalPlaces(TREE_Control *control, TREE_Int decimalPlaces)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set selected
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-	if (index >= data->optionsSize)
-	{
-		return TREE_ERROR_ARG_OUT_OF_RANGE;
-	}
-	data->selectedIndex = index;
-	data->hoverIndex = index;
+	// set the decimal places
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->decimalPlaces = decimalPlaces;
 
 	// redraw
 	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
@@ -6680,83 +11119,91 @@ TREE_Result TREE_Control_Dropdown_SetSelected(TREE_Control *control, TREE_Size i
 	return TREE_OK;
 }
 
-TREE_Bool TREE_Control_Dropdown_IsSelected(TREE_Control *control, TREE_Size index)
+TREE_Int TREE_Control_NumberInput_GetDecimalPlaces(TREE_Control *control)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		return TREE_FALSE;
+		return 0;
 	}
 
-	// get selected
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-	if (index >= data->optionsSize)
+	// get the decimal places
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	return data->decimalPlaces;
+}
+
+TREE_Result TREE_Control_NumberInput_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		return TREE_FALSE;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	return data->selectedIndex == index;
+	// set the onChange event
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	data->onChange = onChange;
+	return TREE_OK;
 }
 
-TREE_Size TREE_Control_Dropdown_GetSelected(TREE_Control *control)
+TREE_ControlEventHandler TREE_Control_NumberInput_GetOnChange(TREE_Control *control)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
-		return 0;
+		return NULL;
 	}
 
-	// get selected
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-
-	return data->selectedIndex;
+	// get the onChange event
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	return data->onChange;
 }
 
-TREE_Result TREE_Control_Dropdown_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
+TREE_Result TREE_Control_NumberInput_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set onSubmit
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	// set the onSubmit event
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
 	data->onSubmit = onSubmit;
-
 	return TREE_OK;
 }
 
-TREE_ControlEventHandler TREE_Control_Dropdown_GetOnSubmit(TREE_Control *control)
+TREE_ControlEventHandler TREE_Control_NumberInput_GetOnSubmit(TREE_Control *control)
 {
 	// validate
-	if (!control)
+	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return NULL;
 	}
 
-	// get onSubmit
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
-
+	// get the onSubmit event
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
 	return data->onSubmit;
 }
 
-TREE_Result TREE_Control_Dropdown_EventHandler(TREE_Event const *event)
+TREE_Result TREE_Control_NumberInput_EventHandler(TREE_Event const *event)
 {
 	// validate
 	if (!event || !event->control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_DROPDOWN)
+	if (event->control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
 	{
 		return TREE_ERROR_ARG_INVALID;
 	}
 
+	// get data
 	TREE_Result result;
 	TREE_Control *control = event->control;
-	TREE_Control_DropdownData *data = (TREE_Control_DropdownData *)control->data;
+	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
 
+	// handle events
 	switch (event->type)
 	{
 	case TREE_EVENT_TYPE_KEY_DOWN:
@@ -6771,175 +11218,76 @@ TREE_Result TREE_Control_Dropdown_EventHandler(TREE_Event const *event)
 		// get the event data
 		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
 		TREE_Key key = keyData->key;
+		TREE_KeyModifierFlags modifiers = keyData->modifiers;
 
-		// if not active, do nothing
+		// if not active, make it active if submit key pressed
 		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
 		{
-			// if not active but a submit key is pressed, become active
-			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
-			{
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE | TREE_CONTROL_STATE_FLAGS_DIRTY;
-
-				// set origin
-				data->origin = control->transform->localOffset;
-
-				// calulate drop size if needed
-				// get window size
-				TREE_Offset dropdownOffset = control->transform->globalRect.offset;
-				TREE_Extent windowExtent = TREE_Window_GetExtent();
-
-				// get space above and below the dropdown
-				TREE_Int optionsCount = (TREE_Int)data->optionsSize;
-				TREE_Int belowSpace = (TREE_Int)windowExtent.height - dropdownOffset.y;
-				TREE_Int aboveSpace = (TREE_Int)dropdownOffset.y + 1;
-
-				// if can fit down, go down
-				// if not, go up
-				// if cannot fit in either, pick larger one
-				if (optionsCount < belowSpace)
-				{
-					// go down
-					data->drop = optionsCount;
-				}
-				else if (optionsCount < aboveSpace)
-				{
-					// go up
-					data->drop = -optionsCount;
-				}
-				else
-				{
-					// go bigger direction, cap at space size
-					if (aboveSpace > belowSpace)
-					{
-						data->drop = -aboveSpace;
-					}
-					else
-					{
-						data->drop = belowSpace - 1;
-					}
-				}
-
-				// move transform (if needed) to account for dropdown
-				if (data->drop < 0)
-				{
-					control->transform->localOffset.y += data->drop;
-				}
-
-				// resize transform as well
-				TREE_UInt dropSize = (TREE_UInt)(data->drop > 0 ? data->drop : -data->drop);
-				control->transform->localExtent.height = dropSize + 1;
-				control->transform->dirty = TREE_TRUE;
-			}
-			break;
-		}
-
-		TREE_Bool cursorMoved = TREE_FALSE;
-
-		// handle key events
-		switch (key)
-		{
-		case TREE_KEY_UP_ARROW: // move to previous option
-		case TREE_KEY_W:
-			if (data->hoverIndex > 0)
-			{
-				data->hoverIndex--;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_DOWN_ARROW: // move to next option
-		case TREE_KEY_S:
-			if (data->hoverIndex < data->optionsSize - 1)
-			{
-				data->hoverIndex++;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_HOME: // move to first option
-			if (data->hoverIndex != 0)
-			{
-				data->hoverIndex = 0;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_END: // move to last option
-			if (data->hoverIndex != data->optionsSize - 1)
-			{
-				data->hoverIndex = data->optionsSize - 1;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-				cursorMoved = TREE_TRUE;
-			}
-			break;
-		case TREE_KEY_PAGE_UP: // move up a page
-			if (data->hoverIndex > control->transform->localExtent.height)
-			{
-				data->hoverIndex -= control->transform->localExtent.height;
-			}
-			else
-			{
-				data->hoverIndex = 0;
-			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			cursorMoved = TREE_TRUE;
-			break;
-		case TREE_KEY_PAGE_DOWN: // move down a page
-			if (data->hoverIndex < data->optionsSize - control->transform->localExtent.height)
-			{
-				data->hoverIndex += control->transform->localExtent.height;
-			}
-			else
+			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
 			{
-				data->hoverIndex = data->optionsSize - 1;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE;
+				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 			}
+			break;
+		}
+
+		// if active, handle the key
+		switch (key)
+		{
+		case TREE_KEY_UP_ARROW: // increment
+		case TREE_KEY_LEFT_ARROW:
+		case TREE_KEY_W:
+		case TREE_KEY_A:
+		case TREE_KEY_EQUALS:
+		{
+			TREE_Float inc = (modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) ? data->increment * 10 : data->increment;
+			data->value += inc;
+			data->value = CLAMP(data->value, data->minValue, data->maxValue);
 			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			cursorMoved = TREE_TRUE;
+			CALL_ACTION(data->onChange, control, &data->value);
 			break;
-		case TREE_KEY_ENTER: // submit
-		case TREE_KEY_SPACE:
+		}
+		case TREE_KEY_DOWN_ARROW: // decrement
+		case TREE_KEY_RIGHT_ARROW:
+		case TREE_KEY_S:
+		case TREE_KEY_D:
+		case TREE_KEY_MINUS:
 		{
-			// move back to origin
-			control->transform->localOffset = data->origin;
-
-			// shrink transform
-			control->transform->localExtent.height = 1;
-			control->transform->dirty = TREE_TRUE;
-
-			data->selectedIndex = data->hoverIndex;
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			TREE_Float inc = (modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) ? data->increment * 10 : data->increment;
+			data->value -= inc;
+			data->value = CLAMP(data->value, data->minValue, data->maxValue);
 			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onSubmit, control, &data->selectedIndex);
+			CALL_ACTION(data->onChange, control, &data->value);
 			break;
 		}
-		case TREE_KEY_ESCAPE: // cancel
+		case TREE_KEY_HOME: // set to min
 		{
-			// move back to origin
-			control->transform->localOffset = data->origin;
-
-			// shrink transform
-			control->transform->localExtent.height = 1;
-			control->transform->dirty = TREE_TRUE;
-
-			data->hoverIndex = data->selectedIndex;
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			data->value = data->minValue;
 			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onChange, control, &data->value);
 			break;
 		}
+		case TREE_KEY_END: // set to max
+		{
+			data->value = data->maxValue;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onChange, control, &data->value);
+			break;
 		}
-
-		// update scroll
-		if (cursorMoved)
+		case TREE_KEY_ENTER: // submit
+		case TREE_KEY_SPACE:
+		case TREE_KEY_ESCAPE:
 		{
-			data->scroll = _TREE_ClampScroll(data->scroll, data->hoverIndex, control->transform->localExtent.height - 1);
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+			CALL_ACTION(data->onSubmit, control, &data->value);
+			break;
 		}
-
 		break;
+		}
 	}
 	case TREE_EVENT_TYPE_REFRESH:
 	{
-		TREE_Bool active = (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE);
-
 		// resize if needed
 		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
 		if (result)
@@ -6947,146 +11295,149 @@ TREE_Result TREE_Control_Dropdown_EventHandler(TREE_Event const *event)
 			return result;
 		}
 
-		// get pixel from state
-		TREE_Pixel const *pixel;
-		if (active)
+		// get color from state
+		TREE_Pixel pixel;
+		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE)
 		{
-			pixel = &data->theme->pixels[TREE_THEME_PID_ACTIVE];
+			pixel = data->theme->pixels[TREE_THEME_PID_ACTIVE];
 		}
 		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
 		{
-			pixel = &data->theme->pixels[TREE_THEME_PID_FOCUSED];
+			pixel = data->theme->pixels[TREE_THEME_PID_FOCUSED];
 		}
 		else
 		{
-			pixel = &data->theme->pixels[TREE_THEME_PID_NORMAL];
+			pixel = data->theme->pixels[TREE_THEME_PID_NORMAL];
 		}
 
-		// get the selected option
-		TREE_Extent extent = control->transform->globalRect.extent;
-		TREE_Size optionsWidth = extent.width - 2;
-		TREE_Size fillerOffset;
-		TREE_Size fillerWidth;
+		// draw the down arrow input, if not at max value
+		TREE_Int width = (TREE_Int)control->transform->globalRect.extent.width;
 		TREE_Offset offset;
-		TREE_Int mainOffset = data->drop < 0 ? extent.height - 1 : 0;
-		if (data->optionsSize)
+		offset.x = 0;
+		offset.y = 0;
+		if (data->value > data->minValue)
 		{
-			TREE_Char *option = data->options[data->selectedIndex];
-			TREE_Size optionLength = strlen(option);
-			TREE_Size optionWidth = MIN(optionsWidth, optionLength);
-			TREE_Char *optionCopy = _TREE_MakeSafeCopy(option, optionWidth);
-			if (!optionCopy)
-			{
-				return TREE_ERROR_ALLOC;
-			}
-
-			// draw the option
-			offset.x = 0;
-			offset.y = mainOffset;
-			result = TREE_Image_DrawString(
-				control->image,
-				offset,
-				optionCopy,
-				pixel->colorPair);
-			free(optionCopy);
-			if (result)
-			{
-				return result;
-			}
-
-			fillerOffset = optionWidth;
-			fillerWidth = optionsWidth - optionWidth;
+			pixel.character = data->theme->characters[TREE_THEME_CID_DOWN];
 		}
 		else
 		{
-			fillerOffset = 0;
-			fillerWidth = optionsWidth;
+			// draw a space
+			pixel.character = ' ';
 		}
-
-		// draw the filler, if any
-		if (fillerWidth)
+		TREE_Result result = TREE_Image_Set(
+			control->image,
+			offset,
+			pixel);
+		if (result)
 		{
-			offset.x = (TREE_Int)fillerOffset;
-			offset.y = mainOffset;
-			TREE_Extent extent;
-			extent.width = (TREE_UInt)fillerWidth;
-			extent.height = 1;
-			TREE_Rect rect = {offset, extent};
-			result = TREE_Image_FillRect(
-				control->image,
-				&rect,
-				*pixel);
-			if (result)
-			{
-				return result;
-			}
+			return result;
 		}
 
-		// draw the dropdown separator
-		TREE_Pixel arrowPixel;
-		arrowPixel.character = '|';
-		arrowPixel.colorPair = pixel->colorPair;
-		offset.x = (TREE_Int)optionsWidth;
-		offset.y = mainOffset;
+		// draw the up arrow input, if not at min value
+		offset.x = width - 1;
+		offset.y = 0;
+		if (data->value < data->maxValue)
+		{
+			pixel.character = data->theme->characters[TREE_THEME_CID_UP];
+		}
+		else
+		{
+			// draw a space
+			pixel.character = ' ';
+		}
 		result = TREE_Image_Set(
 			control->image,
 			offset,
-			arrowPixel);
+			pixel);
 		if (result)
 		{
 			return result;
 		}
 
-		// draw the dropdown arrow
-		arrowPixel.character = active ? '^' : 'v';
-		offset.x = (TREE_Int)optionsWidth + 1;
-		offset.y = mainOffset;
+		// draw the bar separators
+		pixel.character = '|';
+		offset.x = 1;
+		offset.y = 0;
 		result = TREE_Image_Set(
 			control->image,
 			offset,
-			arrowPixel);
+			pixel);
+		if (result)
+		{
+			return result;
+		}
+		offset.x = width - 2;
+		offset.y = 0;
+		result = TREE_Image_Set(
+			control->image,
+			offset,
+			pixel);
 		if (result)
 		{
 			return result;
 		}
 
-		// if active, draw the dropdown
-		if (active)
+		// get the value, using the decimal places
+		TREE_Char valueString[32];
+		TREE_Int valueStringSize = snprintf(
+			valueString,
+			sizeof(valueString),
+			"%.*f",
+			data->decimalPlaces,
+			data->value);
+		if (valueStringSize < 0)
 		{
-			// populate a list data structure using the dropdown's data
-			TREE_Control_ListData listData;
-			listData.flags = TREE_CONTROL_LIST_FLAGS_NONE;
-			listData.options = data->options;
-			listData.optionsSize = data->optionsSize;
-			listData.selectedIndex = data->selectedIndex;
-			listData.selectedIndices = NULL;
-			listData.hoverIndex = data->hoverIndex;
-			listData.scroll = data->scroll;
-			result = TREE_Control_ScrollbarData_Init(
-				&listData.scrollbar,
-				TREE_CONTROL_SCROLLBAR_TYPE_DYNAMIC,
-				TREE_AXIS_VERTICAL,
-				data->theme);
-			listData.theme = data->theme;
-			listData.onChange = NULL;
-			listData.onSubmit = NULL;
+			return TREE_ERROR_INVALID_STATE;
+		}
 
-			// draw the list where the dropdown is
-			TREE_Int adjustment = data->drop < 0 ? 0 : 1;
-			TREE_Offset listOffset;
-			listOffset.x = 0;
-			listOffset.y = adjustment;
-			TREE_Extent listExtent = extent;
-			listExtent.height -= 1;
-			result = _TREE_Control_List_Draw(
+		// get max width of text string
+		TREE_Int textWidth = width - 4;
+		if (textWidth <= 0)
+		{
+			// cannot render any text
+			break;
+		}
+
+		// if the string is too long, replace with hashes
+		if (valueStringSize > textWidth)
+		{
+			valueStringSize = textWidth;
+			memset(valueString, '#', valueStringSize);
+			valueString[valueStringSize] = '\0';
+		}
+
+		// draw the value string
+		offset.x = width - 2 - valueStringSize;
+		offset.y = 0;
+		result = TREE_Image_DrawString(
+			control->image,
+			offset,
+			valueString,
+			pixel.colorPair);
+		if (result)
+		{
+			return result;
+		}
+
+		// if space left over, fill it
+		TREE_Size fillerSize = textWidth - valueStringSize;
+		if (fillerSize > 0)
+		{
+			TREE_Offset fillerOffset;
+			fillerOffset.x = 2;
+			fillerOffset.y = 0;
+			TREE_Extent fillerExtent;
+			fillerExtent.width = (TREE_UInt)fillerSize;
+			fillerExtent.height = 1;
+			pixel.character = ' ';
+			pixel.colorPair = pixel.colorPair;
+			TREE_Rect fillerRect = {fillerOffset, fillerExtent};
+			result = TREE_Image_FillRect(
 				control->image,
-				listOffset,
-				listExtent,
-				control->stateFlags,
-				&listData);
+				&fillerRect,
+				pixel);
 			if (result)
 			{
-				TREE_Control_ListData_Free(&listData);
 				return result;
 			}
 		}
@@ -7113,44 +11464,41 @@ TREE_Result TREE_Control_Dropdown_EventHandler(TREE_Event const *event)
 
 		break;
 	}
+	default:
+		break;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_CheckboxData_Init(TREE_Control_CheckboxData *data, TREE_String text, TREE_Control_CheckboxFlags flags, TREE_ControlEventHandler onCheck, TREE_Theme const *theme)
+TREE_EXTERN TREE_Result TREE_Control_ProgressBarData_Init(TREE_Control_ProgressBarData *data, TREE_Theme const *theme)
 {
 	// validate
-	if (!data || !text)
+	if (!data || !theme)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
 	// set data
-	TREE_Result result = TREE_String_CreateCopy(&data->text, text);
-	if (result)
-	{
-		return result;
-	}
-	data->flags = flags;
+	data->value = 0;
+	data->direction = TREE_DIRECTION_EAST;
 	data->theme = theme;
-	data->onCheck = onCheck;
 
 	return TREE_OK;
 }
 
-void TREE_Control_CheckboxData_Free(TREE_Control_CheckboxData *data)
+TREE_EXTERN void TREE_Control_ProgressBarData_Free(TREE_Control_ProgressBarData *data)
 {
 	// validate
 	if (!data)
 	{
 		return;
 	}
-	// free the text
-	TREE_DELETE(data->text);
+
+	// nothing to free
 }
 
-TREE_Result TREE_Control_Checkbox_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_CheckboxData *data)
+TREE_EXTERN TREE_Result TREE_Control_ProgressBar_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_ProgressBarData *data)
 {
 	// validate
 	if (!control || !data)
@@ -7159,1750 +11507,2398 @@ TREE_Result TREE_Control_Checkbox_Init(TREE_Control *control, TREE_Transform *pa
 	}
 
 	// control init
-	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_Checkbox_EventHandler, data);
+	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_ProgressBar_EventHandler, data);
 	if (result)
 	{
 		return result;
 	}
 
 	// set data
-	control->type = TREE_CONTROL_TYPE_CHECKBOX;
-	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
-	control->transform->localExtent.width = 16;
+	control->type = TREE_CONTROL_TYPE_PROGRESS_BAR;
+	control->flags = TREE_CONTROL_FLAGS_NONE;
+	control->transform->localExtent.width = 20;
 	control->transform->localExtent.height = 1;
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_Checkbox_SetChecked(TREE_Control *control, TREE_Byte checked)
+TREE_EXTERN TREE_Result TREE_Control_ProgressBar_SetValue(TREE_Control *control, TREE_Float value)
 {
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_CHECKBOX)
+	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set the checked state
-	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
-	if (checked)
+	// set the value
+	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+	data->value = CLAMP(value, 0.0f, 1.0f);
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_EXTERN TREE_Float TREE_Control_ProgressBar_GetValue(TREE_Control *control)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
 	{
-		data->flags |= TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
+		return 0.0f;
 	}
-	else
+
+	// get the value
+	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+	return data->value;
+}
+
+TREE_EXTERN TREE_Result TREE_Control_ProgressBar_SetDirection(TREE_Control *control, TREE_Direction direction)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
 	{
-		data->flags &= ~TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (direction < TREE_DIRECTION_NORTH || direction > TREE_DIRECTION_WEST)
+	{
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+
+	// set the direction
+	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+	data->direction = direction;
+
+	// redraw
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	return TREE_OK;
+}
+
+TREE_EXTERN TREE_Direction TREE_Control_ProgressBar_GetDirection(TREE_Control *control)
+{
+	// validate
+	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	{
+		return TREE_DIRECTION_NONE;
+	}
+
+	// get the direction
+	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+
+	return data->direction;
+}
+
+TREE_EXTERN TREE_Result TREE_Control_ProgressBar_EventHandler(TREE_Event const *event)
+{
+	// validate
+	if (!event || !event->control)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (event->control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	// get data
+	TREE_Result result;
+	TREE_Control *control = event->control;
+	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+	TREE_Extent controlExtent = control->transform->globalRect.extent;
+
+	// handle events
+	switch (event->type)
+	{
+	case TREE_EVENT_TYPE_REFRESH:
+	{
+		// resize if needed
+		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (result)
+		{
+			return result;
+		}
+
+		// determine bounds
+		TREE_Rect barRect, bgRect;
+
+		TREE_Int size;
+		switch (data->direction)
+		{
+		case TREE_DIRECTION_EAST:
+			size = (TREE_Int)(controlExtent.width * data->value);
+			barRect.offset.x = 0;
+			barRect.offset.y = 0;
+			barRect.extent.width = size;
+			barRect.extent.height = controlExtent.height;
+			bgRect.offset.x = barRect.extent.width;
+			bgRect.offset.y = 0;
+			bgRect.extent.width = controlExtent.width - size;
+			bgRect.extent.height = controlExtent.height;
+			break;
+		case TREE_DIRECTION_WEST:
+			size = (TREE_Int)(controlExtent.width * data->value);
+			barRect.offset.x = controlExtent.width - size;
+			barRect.offset.y = 0;
+			barRect.extent.width = size;
+			barRect.extent.height = controlExtent.height;
+			bgRect.offset.x = 0;
+			bgRect.offset.y = 0;
+			bgRect.extent.width = controlExtent.width - size;
+			bgRect.extent.height = controlExtent.height;
+			break;
+		case TREE_DIRECTION_NORTH:
+			size = (TREE_Int)(controlExtent.height * data->value);
+			barRect.offset.x = 0;
+			barRect.offset.y = controlExtent.height - size;
+			barRect.extent.width = controlExtent.width;
+			barRect.extent.height = size;
+			bgRect.offset.x = 0;
+			bgRect.offset.y = 0;
+			bgRect.extent.width = controlExtent.width;
+			bgRect.extent.height = controlExtent.height - size;
+			break;
+		case TREE_DIRECTION_SOUTH:
+			size = (TREE_Int)(controlExtent.height * data->value);
+			barRect.offset.x = 0;
+			barRect.offset.y = 0;
+			barRect.extent.width = controlExtent.width;
+			barRect.extent.height = size;
+			bgRect.offset.x = 0;
+			bgRect.offset.y = barRect.extent.height;
+			bgRect.extent.width = controlExtent.width;
+			bgRect.extent.height = controlExtent.height - size;
+			break;
+		default:
+			return TREE_NOT_IMPLEMENTED;
+		}
+
+		// draw the background
+		if (bgRect.extent.width > 0 && bgRect.extent.height > 0)
+		{
+			result = TREE_Image_FillRect(
+				control->image,
+				&bgRect,
+				data->theme->pixels[TREE_THEME_PID_BACKGROUND]);
+			if (result)
+			{
+				return result;
+			}
+		}
+
+		// draw the bar
+		if (barRect.extent.width > 0 && barRect.extent.height > 0)
+		{
+			result = TREE_Image_FillRect(
+				control->image,
+				&barRect,
+				data->theme->pixels[TREE_THEME_PID_PROGRESS_BAR]);
+			if (result)
+			{
+				return result;
+			}
+		}
+
+		break;
+	}
+	case TREE_EVENT_TYPE_DRAW:
+	{
+		// get the event data
+		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
+		TREE_Image *target = drawData->target;
+		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
+
+		// draw the control
+		TREE_Result result = _TREE_Control_Draw(
+			target,
+			dirtyRect,
+			&control->transform->globalRect,
+			control->image);
+		if (result)
+		{
+			return result;
+		}
+
+		break;
+	}
+	default:
+		break;
 	}
 
-	// dirty the component to be redrawn
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-
 	return TREE_OK;
 }
 
-TREE_Bool TREE_Control_Checkbox_GetChecked(TREE_Control *control)
+void _TREE_Application_ClearInput(TREE_Application *application)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_CHECKBOX)
+	for (TREE_Size i = 0; i < application->inputEventsSize; ++i)
 	{
-		return TREE_FALSE;
+		TREE_Size index = (application->inputEventsStart + i) % TREE_APPLICATION_INPUT_CAPACITY;
+		TREE_DELETE(application->inputEventTexts[index]);
+		application->inputEventTextSizes[index] = 0;
 	}
-
-	// get the checked state
-	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
-	return (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0 ? TREE_TRUE : TREE_FALSE;
+	application->inputEventsSize = 0;
 }
 
-TREE_Result TREE_Control_Checkbox_EventHandler(TREE_Event const *event)
+TREE_Result _TREE_Application_Init(TREE_Application *application, TREE_Size capacity, TREE_EventHandler eventHandler, TREE_Extent extent, TREE_Bool headless)
 {
 	// validate
-	if (!event || !event->control)
+	if (!application)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_CHECKBOX)
+	if (capacity == 0)
 	{
-		return TREE_ERROR_ARG_INVALID;
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
 
-	// get data
-	TREE_Result result;
-	TREE_Control *control = event->control;
-	TREE_Control_CheckboxData *data = (TREE_Control_CheckboxData *)control->data;
-
-	// handle events
-	switch (event->type)
+	// allocate data
+	application->controls = TREE_NEW_ARRAY(TREE_Control *, capacity);
+	if (!application->controls)
 	{
-	case TREE_EVENT_TYPE_KEY_DOWN:
-	case TREE_EVENT_TYPE_KEY_HELD:
+		return TREE_ERROR_ALLOC;
+	}
+	application->surface = TREE_NEW(TREE_Surface);
+	if (!application->surface)
 	{
-		// ignore if not focused
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
-		{
-			break;
-		}
-
-		// get the event data
-		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
-		TREE_Key key = keyData->key;
-
-		// check boxes are like buttons, they do not need to be active to be used
-		// when submit button is pressed, toggle the checkbox
-		if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
-		{
-			// toggle the checked state
-			TREE_Bool checked = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0;
-			if (checked)
-			{
-				data->flags &= ~TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
-			}
-			else
-			{
-				data->flags |= TREE_CONTROL_CHECKBOX_FLAGS_CHECKED;
-			}
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onCheck, control, &checked);
-		}
-		break;
+		TREE_DELETE(application->controls);
+		return TREE_ERROR_ALLOC;
 	}
-	case TREE_EVENT_TYPE_REFRESH:
+	// each Control can dirty its old and new area, plus the whole Surface
+	application->dirtyRectsCapacity = capacity * 2 + 1;
+	application->dirtyRectsSize = 0;
+	application->dirtyRects = TREE_NEW_ARRAY(TREE_Rect, application->dirtyRectsCapacity);
+	application->dirtyLayers = TREE_NEW_ARRAY(TREE_Layer, application->dirtyRectsCapacity);
+	if (!application->dirtyRects || !application->dirtyLayers)
 	{
-		// resize if needed
-		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
-		if (result)
-		{
-			return result;
-		}
-
-		// get color from state
-		TREE_ColorPair color;
-		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
-		{
-			color = data->theme->pixels[TREE_THEME_PID_FOCUSED].colorPair;
-		}
-		else
-		{
-			color = data->theme->pixels[TREE_THEME_PID_NORMAL].colorPair;
-		}
-
-		// get checked character
-		TREE_Bool radio = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_RADIO) != 0;
-		TREE_Bool checked = (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_CHECKED) != 0;
-		TREE_Char checkedChar;
-		if (checked)
-		{
-			if (radio)
-			{
-				checkedChar = data->theme->characters[TREE_THEME_CID_RADIOBOX_CHECKED];
-			}
-			else
-			{
-				checkedChar = data->theme->characters[TREE_THEME_CID_CHECKBOX_CHECKED];
-			}
-		}
-		else
-		{
-			if (radio)
-			{
-				checkedChar = data->theme->characters[TREE_THEME_CID_RADIOBOX_UNCHECKED];
-			}
-			else
-			{
-				checkedChar = data->theme->characters[TREE_THEME_CID_CHECKBOX_UNCHECKED];
-			}
-		}
-
-		// draw the checkbox
-		TREE_Offset offset;
-		offset.y = 0;
-
-		// if reverse, place the checkbox on the right
-		TREE_Int checkboxLength = 3;
-		TREE_Int checkOffset, textOffset;
-		if (data->flags & TREE_CONTROL_CHECKBOX_FLAGS_REVERSE)
-		{
-			checkOffset = control->transform->globalRect.extent.width - checkboxLength;
-			textOffset = 0;
-		}
-		else
-		{
-			checkOffset = 0;
-			textOffset = checkboxLength;
-		}
-		offset.x = checkOffset;
-
-		// draw the checkbox
-		TREE_Pixel pixel;
-		if (radio)
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_RADIOBOX_LEFT];
-		}
-		else
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_CHECKBOX_LEFT];
-		}
-		pixel.colorPair = color;
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
-		if (result)
-		{
-			return result;
-		}
-		offset.x++;
-		pixel.character = checkedChar;
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
-		if (result)
-		{
-			return result;
-		}
-		offset.x++;
-		if (radio)
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_RADIOBOX_RIGHT];
-		}
-		else
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_CHECKBOX_RIGHT];
-		}
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
-		if (result)
-		{
-			return result;
-		}
-
-		// draw the string
-		offset.x = textOffset;
-		offset.y = 0;
-		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
-		{
-			color = data->theme->pixels[TREE_THEME_PID_FOCUSED].colorPair;
-		}
-		else
-		{
-			color = data->theme->pixels[TREE_THEME_PID_NORMAL].colorPair;
-		}
-
-		// if the string is too long, cap it
-		TREE_Char *text;
-		result = TREE_String_CreateClampedCopy(&text, data->text, control->transform->globalRect.extent.width - (TREE_Size)checkboxLength);
-		if (result)
-		{
-			return result;
-		}
-
-		TREE_Size textSize = strlen(text);
-
-		// draw the string
-		result = TREE_Image_DrawString(
-			control->image,
-			offset,
-			text,
-			color);
-		free(text);
-		if (result)
-		{
-			return result;
-		}
-
-		// if there is extra space, fill it
-		TREE_Size fillerSize = control->transform->globalRect.extent.width - (TREE_Size)checkboxLength - textSize;
-		if (fillerSize)
-		{
-			TREE_Offset fillerOffset;
-			fillerOffset.x = (TREE_Int)(textOffset + textSize);
-			fillerOffset.y = 0;
+		TREE_DELETE(application->dirtyLayers);
+		TREE_DELETE(application->dirtyRects);
+		TREE_DELETE(application->surface);
+		TREE_DELETE(application->controls);
+		return TREE_ERROR_ALLOC;
+	}
 
-			TREE_Extent fillerExtent;
-			fillerExtent.width = (TREE_UInt)fillerSize;
-			fillerExtent.height = 1;
+	TREE_Result result;
 
-			pixel.character = ' ';
-			pixel.colorPair = color;
-			TREE_Rect fillerRect = {fillerOffset, fillerExtent};
-			result = TREE_Image_FillRect(
-				control->image,
-				&fillerRect,
-				pixel);
-			if (result)
-			{
-				return result;
-			}
-		}
+	// enough for the Images of a full page of Controls
+	result = TREE_ImagePool_Init(&application->imagePool, capacity);
+	if (result)
+	{
+		TREE_DELETE(application->dirtyLayers);
+		TREE_DELETE(application->dirtyRects);
+		TREE_DELETE(application->surface);
+		TREE_DELETE(application->controls);
+		return result;
+	}
 
-		break;
+	// set data
+	application->controlsCapacity = capacity;
+	application->controlsSize = 0;
+	application->focusedControl = NULL;
+	application->forceRedraw = TREE_TRUE;
+	application->occupiedLayers = 1 << TREE_LAYER_BASE;
+	application->running = TREE_FALSE;
+	application->frameInterval = 1000 / TREE_APPLICATION_FRAME_RATE;
+	application->lastFrameTime = 0;
+	application->resizeExtent = (TREE_Extent){0, 0};
+	application->resizeTime = 0;
+	application->inputEventsStart = 0;
+	application->inputEventsSize = 0;
+	memset(application->inputEventTexts, 0, sizeof(application->inputEventTexts));
+	memset(application->inputEventTextSizes, 0, sizeof(application->inputEventTextSizes));
+	application->frameInputTime = 0;
+	application->presentInputTime = 0;
+	application->inputLatencyCount = 0;
+	application->backgroundPresent = TREE_FALSE;
+	application->presenter = NULL;
+	application->eventLoop = NULL;
+	application->recording = NULL;
+	application->replay = NULL;
+	application->headless = headless;
+	result = TREE_Input_Init(&application->input);
+	if (result)
+	{
+		TREE_ImagePool_Free(&application->imagePool);
+		TREE_DELETE(application->dirtyLayers);
+		TREE_DELETE(application->dirtyRects);
+		TREE_DELETE(application->surface);
+		TREE_DELETE(application->controls);
+		return result;
+	}
+	application->eventHandler = eventHandler;
+	result = TREE_Surface_Init(application->surface, extent);
+	if (result)
+	{
+		TREE_ImagePool_Free(&application->imagePool);
+		TREE_DELETE(application->dirtyLayers);
+		TREE_DELETE(application->dirtyRects);
+		TREE_DELETE(application->surface);
+		TREE_DELETE(application->controls);
+		TREE_Input_Free(&application->input);
+		return result;
 	}
-	case TREE_EVENT_TYPE_DRAW:
+	for (TREE_Size i = 0; i < TREE_LAYER_COUNT - 1; ++i)
 	{
-		// get the event data
-		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
-		TREE_Image *target = drawData->target;
-		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
-
-		// draw the control
-		TREE_Result result = _TREE_Control_Draw(
-			target,
-			dirtyRect,
-			&control->transform->globalRect,
-			control->image);
+		result = TREE_Image_Init(&application->layers[i], extent);
 		if (result)
 		{
+			while (i > 0)
+			{
+				TREE_Image_Free(&application->layers[--i]);
+			}
+			TREE_Surface_Free(application->surface);
+			TREE_ImagePool_Free(&application->imagePool);
+			TREE_DELETE(application->dirtyLayers);
+			TREE_DELETE(application->dirtyRects);
+			TREE_DELETE(application->surface);
+			TREE_DELETE(application->controls);
+			TREE_Input_Free(&application->input);
 			return result;
 		}
-
-		break;
 	}
+	if (!headless && TREE_Window_SupportsSynchronizedOutput())
+	{
+		application->surface->features |= TREE_SURFACE_FEATURE_FLAGS_SYNCHRONIZE;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_NumberInputData_Init(TREE_Control_NumberInputData *data, TREE_Float value, TREE_Float min, TREE_Float max, TREE_Float increment, TREE_Int decimalPlaces, TREE_ControlEventHandler onChange, TREE_ControlEventHandler onSubmit, TREE_Theme const *theme)
+TREE_Result TREE_Application_Init(TREE_Application *application, TREE_Size capacity, TREE_EventHandler eventHandler)
 {
-	// validate
-	if (!data)
+	TREE_Extent extent = TREE_Window_GetExtent();
+	if (extent.width == 0 || extent.height == 0)
 	{
-		return TREE_ERROR_ARG_NULL;
+		// Some hosts (like output panes) do not expose a real terminal size.
+		extent.width = 120;
+		extent.height = 30;
 	}
-	if (min > max)
+	return _TREE_Application_Init(application, capacity, eventHandler, extent, TREE_FALSE);
+}
+
+TREE_Result TREE_Application_InitHeadless(TREE_Application *application, TREE_Size capacity, TREE_EventHandler eventHandler, TREE_Extent extent)
+{
+	// validate
+	if (extent.width <= 0 || extent.height <= 0)
 	{
 		return TREE_ERROR_ARG_OUT_OF_RANGE;
 	}
 
-	// set data
-	data->minValue = min;
-	data->maxValue = max;
-	data->value = CLAMP(value, min, max);
-	data->increment = increment;
-	data->decimalPlaces = decimalPlaces;
-	data->theme = theme;
-	data->onChange = onChange;
-	data->onSubmit = onSubmit;
-
-	return TREE_OK;
+	return _TREE_Application_Init(application, capacity, eventHandler, extent, TREE_TRUE);
 }
 
-void TREE_Control_NumberInputData_Free(TREE_Control_NumberInputData *data)
+void TREE_Application_Free(TREE_Application *application)
 {
-	if (!data)
+	if (!application)
 	{
 		return;
 	}
 
-	// nothing to free
+	TREE_DELETE(application->controls);
+	TREE_DELETE(application->dirtyRects);
+	TREE_DELETE(application->dirtyLayers);
+	_TREE_Application_ClearInput(application);
+	TREE_Application_StopRecording(application);
+	TREE_Application_StopReplay(application);
+	TREE_Input_Free(&application->input);
+	TREE_Surface_Free(application->surface);
+	TREE_DELETE(application->surface);
+	TREE_ImagePool_Free(&application->imagePool);
+	for (TREE_Size i = 0; i < TREE_LAYER_COUNT - 1; ++i)
+	{
+		TREE_Image_Free(&application->layers[i]);
+	}
 }
 
-TREE_Result TREE_Control_NumberInput_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_NumberInputData *data)
+TREE_Result TREE_Application_AddControl(TREE_Application *application, TREE_Control *control)
 {
 	// validate
-	if (!control || !data)
+	if (!application || !control)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-
-	// control init
-	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_NumberInput_EventHandler, data);
-	if (result)
+	if (application->controlsSize == application->controlsCapacity)
 	{
-		return result;
+		return TREE_ERROR_FULL;
 	}
 
-	// set data
-	control->type = TREE_CONTROL_TYPE_NUMBER_INPUT;
-	control->flags = TREE_CONTROL_FLAGS_FOCUSABLE;
-	control->transform->localExtent.width = 7;
-	control->transform->localExtent.height = 1;
+	// add to the application
+	application->controls[application->controlsSize] = control;
+	application->controlsSize++;
+	control->transform->dirty = TREE_TRUE;
+	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+	// ensure stale focus/active flags do not carry across pages.
+	control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_FOCUSED & ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+	control->drawnLayer = TREE_Control_GetLayer(control);
+
+	// if no focused control, and this one can be focused, set it as the focused control
+	if (!application->focusedControl && (control->flags & TREE_CONTROL_FLAGS_FOCUSABLE))
+	{
+		TREE_Result result = TREE_Application_SetFocus(application, control);
+		if (result)
+		{
+			return result;
+		}
+	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Control_NumberInput_SetValue(TREE_Control *control, TREE_Float value)
+TREE_Result TREE_Application_ClearControls(TREE_Application *application)
 {
+	TREE_Size i;
+
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (!application)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
 
-	// set the value
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->value = CLAMP(value, data->minValue, data->maxValue);
-
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	for (i = 0; i < application->controlsSize; ++i)
+	{
+		// the Image is not drawn while the Control is not in the Application, so its memory can go to the next page
+		TREE_ImagePool_Release(&application->imagePool, application->controls[i]->image);
+		application->controls[i] = NULL;
+	}
 
-	// call the onChange event
-	CALL_ACTION(data->onChange, control, &data->value);
+	application->controlsSize = 0;
+	application->focusedControl = NULL;
+	application->forceRedraw = TREE_TRUE;
 
 	return TREE_OK;
 }
 
-TREE_Float TREE_Control_NumberInput_GetValue(TREE_Control *control)
+TREE_Result TREE_Application_SetFocus(TREE_Application *application, TREE_Control *control)
 {
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (!application)
 	{
-		return 0;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	// get the value
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-
-	return data->value;
-}
-
-TREE_Result TREE_Control_NumberInput_SetMin(TREE_Control *control, TREE_Float minValue)
-{
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	// if control already focused, take its focus away
+	if (application->focusedControl)
 	{
-		return TREE_ERROR_ARG_NULL;
+		application->focusedControl->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_FOCUSED & ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+		application->focusedControl->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 	}
 
-	// set the min
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->minValue = minValue;
-	data->value = CLAMP(data->value, minValue, data->maxValue);
+	// set to new control
+	application->focusedControl = control;
 
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	// if new control, give it focus
+	if (control)
+	{
+		control->stateFlags |= TREE_CONTROL_STATE_FLAGS_FOCUSED | TREE_CONTROL_STATE_FLAGS_DIRTY;
+	}
 
 	return TREE_OK;
 }
 
-TREE_Float TREE_Control_NumberInput_GetMin(TREE_Control *control)
+TREE_Result TREE_Application_DispatchEvent(TREE_Application *application, TREE_Event const *event)
 {
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (!application || !event)
 	{
-		return 0;
+		return TREE_ERROR_ARG_NULL;
 	}
 
-	// get the min
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
+	TREE_Event e = *event;		 // local copy to edit
+	e.application = application; // set the application for the event
 
-	return data->minValue;
-}
+	// handle event on the application level
+	switch (e.type)
+	{
+	case TREE_EVENT_TYPE_KEY_DOWN:
+	case TREE_EVENT_TYPE_KEY_HELD:
+	{
+		// move focus if arrow keys used, if current control is not active
+		if (!application->focusedControl || (application->focusedControl->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		{
+			break;
+		}
 
-TREE_Result TREE_Control_NumberInput_SetMax(TREE_Control *control, TREE_Float maxValue)
-{
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+		// movement allowed
+		TREE_EventData_Key *keyData = (TREE_EventData_Key *)e.data;
+		TREE_Key key = keyData->key;
+
+		// move if move key pressed, and there is a control to move to
+		TREE_Direction direction = TREE_DIRECTION_NONE;
+		switch (key)
+		{
+		case TREE_KEY_UP_ARROW:
+		case TREE_KEY_W:
+			direction = TREE_DIRECTION_NORTH;
+			break;
+		case TREE_KEY_DOWN_ARROW:
+		case TREE_KEY_S:
+			direction = TREE_DIRECTION_SOUTH;
+			break;
+		case TREE_KEY_LEFT_ARROW:
+		case TREE_KEY_A:
+			direction = TREE_DIRECTION_WEST;
+			break;
+		case TREE_KEY_RIGHT_ARROW:
+		case TREE_KEY_D:
+			direction = TREE_DIRECTION_EAST;
+			break;
+		}
+
+		// if no direction, stop
+		if (direction == TREE_DIRECTION_NONE)
+		{
+			break;
+		}
+
+		// get next control
+		TREE_Control *nextControl = application->focusedControl->adjacent[(TREE_Size)direction - 1];
+
+		// if no control, stop
+		if (!nextControl)
+		{
+			break;
+		}
+
+		// focus on that control
+		TREE_Result result = TREE_Application_SetFocus(application, nextControl);
+		if (result)
+		{
+			return result;
+		}
+
+		break;
+	}
+	default:
+		break;
+	}
+
+	// dispatch the event to the application's event handler, if any
+	if (application->eventHandler)
 	{
-		return TREE_ERROR_ARG_NULL;
+		TREE_Result result = application->eventHandler(&e);
+		if (result)
+		{
+			return result;
+		}
+	}
+
+	// dispatch the event to all controls
+	TREE_Control *control;
+	TREE_Result result;
+	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+	{
+		control = application->controls[i];
+		if (control && control->eventHandler)
+		{
+			// set the control for the event
+			e.control = control;
+			// call the event handler
+			result = TREE_Control_HandleEvent(control, &e);
+			// if the event handler returns an error, return it
+			if (result)
+			{
+				return result;
+			}
+		}
 	}
 
-	// set the max
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->maxValue = maxValue;
-	data->value = CLAMP(data->value, data->minValue, maxValue);
-
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-
 	return TREE_OK;
 }
 
-TREE_Float TREE_Control_NumberInput_GetMax(TREE_Control *control)
+void _TREE_Application_QueueInput(TREE_Application *application, TREE_InputDelta const *delta)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	// a paste needs its text, which is kept with it so it goes out between the keys around it
+	TREE_Input *input = &application->input;
+	if (delta->key == TREE_KEY_NONE && !input->pasteText)
 	{
-		return 0;
+		return;
 	}
 
-	// get the max
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-
-	return data->maxValue;
-}
-
-TREE_Result TREE_Control_NumberInput_SetIncrement(TREE_Control *control, TREE_Float increment)
-{
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	// under load, a repeat is dropped if the key has one waiting already, and nothing happened to the key since
+	if (delta->state == TREE_INPUT_STATE_HELD)
 	{
-		return TREE_ERROR_ARG_NULL;
+		for (TREE_Size i = application->inputEventsSize; i > 0; --i)
+		{
+			TREE_InputDelta const *waiting = &application->inputEvents[(application->inputEventsStart + i - 1) % TREE_APPLICATION_INPUT_CAPACITY];
+			if (waiting->key == delta->key)
+			{
+				if (waiting->state == TREE_INPUT_STATE_HELD)
+				{
+					return;
+				}
+				break;
+			}
+		}
 	}
 
-	// set the increment
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->increment = increment;
+	// when full, the newest changes are lost, along with their text, so it is not added to a later paste
+	if (application->inputEventsSize >= TREE_APPLICATION_INPUT_CAPACITY)
+	{
+		if (delta->key == TREE_KEY_NONE)
+		{
+			TREE_DELETE(input->pasteText);
+			input->pasteSize = 0;
+		}
+		return;
+	}
+	TREE_Size index = (application->inputEventsStart + application->inputEventsSize) % TREE_APPLICATION_INPUT_CAPACITY;
+	application->inputEvents[index] = *delta;
+	application->inputEventTimes[index] = delta->sourceTime ? delta->sourceTime : TREE_Time_NowMicroseconds();
+	if (delta->key == TREE_KEY_NONE)
+	{
+		application->inputEventTexts[index] = input->pasteText;
+		application->inputEventTextSizes[index] = input->pasteSize;
+		input->pasteText = NULL;
+		input->pasteSize = 0;
+	}
+	++application->inputEventsSize;
+}
 
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+// the file starts with these bytes, the last one being the version
+static TREE_Byte const g_inputRecordingHeader[8] = {'T', 'R', 'E', 'E', 'I', 'N', 'P', 1};
 
-	return TREE_OK;
-}
+// each key change takes 16 bytes, little endian: the time (8), the key (2), the state (1), the modifiers (1), and the length of the pasted text that follows it (4)
+#define INPUT_RECORD_SIZE 16
 
-TREE_Float TREE_Control_NumberInput_GetIncrement(TREE_Control *control)
+struct _TREE_InputRecording
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
-	{
-		return 0;
-	}
+	FILE *file;
+	TREE_ReplayFlags flags;
 
-	// get the increment
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	return data->increment;
-}
+	// when replaying, the next key change is read ahead, to know when it is due
+	TREE_InputDelta next;
+	TREE_Char *nextText;
+	TREE_Size nextSize;
+	TREE_Bool hasNext;
 
-TREE_Result TREE_Control_NumberInput_SetDecimalPlaces(TREE_Control *control, TREE_Int decimalPlaces)
+	// how far the recorded times are behind the current time, once started
+	TREE_Time offset;
+	TREE_Bool started;
+};
+
+TREE_Result _TREE_InputRecording_Write(TREE_InputRecording *recording, TREE_InputDelta const *delta, TREE_Char const *text, TREE_Size size)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	TREE_Byte record[INPUT_RECORD_SIZE];
+	unsigned long long time = (unsigned long long)delta->time;
+	for (TREE_Size i = 0; i < 8; ++i)
 	{
-		return TREE_ERROR_ARG_NULL;
+		record[i] = (TREE_Byte)(time >> (i * 8));
+	}
+	record[8] = (TREE_Byte)(delta->key & 0xFF);
+	record[9] = (TREE_Byte)(delta->key >> 8);
+	record[10] = (TREE_Byte)delta->state;
+	record[11] = (TREE_Byte)delta->modifiers;
+	for (TREE_Size i = 0; i < 4; ++i)
+	{
+		record[12 + i] = (TREE_Byte)(size >> (i * 8));
+	}
+	if (fwrite(record, 1, INPUT_RECORD_SIZE, recording->file) != INPUT_RECORD_SIZE ||
+		(size && fwrite(text, sizeof(TREE_Char), size, recording->file) != size))
+	{
+		return TREE_ERROR_FILE_WRITE;
 	}
-
-	// set the decimal places
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->decimalPlaces = decimalPlaces;
-
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-
 	return TREE_OK;
 }
 
-TREE_Int TREE_Control_NumberInput_GetDecimalPlaces(TREE_Control *control)
+TREE_Result _TREE_InputRecording_ReadNext(TREE_InputRecording *recording)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	TREE_DELETE(recording->nextText);
+	recording->nextSize = 0;
+	recording->hasNext = TREE_FALSE;
+
+	// the end of the recording, or a key change cut short
+	TREE_Byte record[INPUT_RECORD_SIZE];
+	if (fread(record, 1, INPUT_RECORD_SIZE, recording->file) != INPUT_RECORD_SIZE)
 	{
-		return 0;
+		return TREE_OK;
+	}
+	unsigned long long time = 0;
+	for (TREE_Size i = 0; i < 8; ++i)
+	{
+		time |= (unsigned long long)record[i] << (i * 8);
+	}
+	TREE_Size size = 0;
+	for (TREE_Size i = 0; i < 4; ++i)
+	{
+		size |= (TREE_Size)record[12 + i] << (i * 8);
+	}
+	TREE_InputDelta *next = &recording->next;
+	next->time = (TREE_Time)time;
+	next->sourceTime = 0;
+	next->key = (TREE_Key)(record[8] | (record[9] << 8));
+	next->state = (TREE_InputState)record[10];
+	next->modifiers = (TREE_KeyModifierFlags)record[11];
+	if (next->key > TREE_KEY_MAX)
+	{
+		return TREE_ERROR_FILE_READ;
 	}
 
-	// get the decimal places
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	return data->decimalPlaces;
-}
-
-TREE_Result TREE_Control_NumberInput_SetOnChange(TREE_Control *control, TREE_ControlEventHandler onChange)
-{
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	// the pasted text
+	if (size)
 	{
-		return TREE_ERROR_ARG_NULL;
+		recording->nextText = TREE_NEW_ARRAY(TREE_Char, size + 1);
+		if (!recording->nextText)
+		{
+			return TREE_ERROR_ALLOC;
+		}
+		if (fread(recording->nextText, sizeof(TREE_Char), size, recording->file) != size)
+		{
+			TREE_DELETE(recording->nextText);
+			return TREE_OK;
+		}
+		recording->nextText[size] = '\0';
+		recording->nextSize = size;
 	}
+	recording->hasNext = TREE_TRUE;
 
-	// set the onChange event
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->onChange = onChange;
 	return TREE_OK;
 }
 
-TREE_ControlEventHandler TREE_Control_NumberInput_GetOnChange(TREE_Control *control)
+void _TREE_InputRecording_Free(TREE_InputRecording *recording)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
-	{
-		return NULL;
-	}
-
-	// get the onChange event
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	return data->onChange;
+	fclose(recording->file);
+	TREE_DELETE(recording->nextText);
 }
 
-TREE_Result TREE_Control_NumberInput_SetOnSubmit(TREE_Control *control, TREE_ControlEventHandler onSubmit)
+TREE_Result TREE_Application_StartRecording(TREE_Application *application, TREE_String path)
 {
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (!application || !path)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
+	if (application->recording)
+	{
+		return TREE_ERROR_INVALID_STATE;
+	}
+
+	// open the file
+	TREE_InputRecording *recording = TREE_NEW(TREE_InputRecording);
+	if (!recording)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	memset(recording, 0, sizeof(TREE_InputRecording));
+	recording->file = fopen(path, "wb");
+	if (!recording->file)
+	{
+		TREE_DELETE(recording);
+		return TREE_ERROR_FILE_OPEN;
+	}
+	if (fwrite(g_inputRecordingHeader, 1, sizeof(g_inputRecordingHeader), recording->file) != sizeof(g_inputRecordingHeader))
+	{
+		_TREE_InputRecording_Free(recording);
+		TREE_DELETE(recording);
+		return TREE_ERROR_FILE_WRITE;
+	}
+	application->recording = recording;
 
-	// set the onSubmit event
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	data->onSubmit = onSubmit;
 	return TREE_OK;
 }
 
-TREE_ControlEventHandler TREE_Control_NumberInput_GetOnSubmit(TREE_Control *control)
+TREE_Result TREE_Application_StopRecording(TREE_Application *application)
 {
 	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (!application)
 	{
-		return NULL;
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (!application->recording)
+	{
+		return TREE_OK;
 	}
 
-	// get the onSubmit event
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-	return data->onSubmit;
+	// anything still buffered is written when the file is closed
+	TREE_Result result = fflush(application->recording->file) ? TREE_ERROR_FILE_WRITE : TREE_OK;
+	_TREE_InputRecording_Free(application->recording);
+	TREE_DELETE(application->recording);
+
+	return result;
 }
 
-TREE_Result TREE_Control_NumberInput_EventHandler(TREE_Event const *event)
+TREE_Result TREE_Application_StartReplay(TREE_Application *application, TREE_String path, TREE_ReplayFlags flags)
 {
 	// validate
-	if (!event || !event->control)
+	if (!application || !path)
 	{
 		return TREE_ERROR_ARG_NULL;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_NUMBER_INPUT)
+	if (application->replay)
 	{
-		return TREE_ERROR_ARG_INVALID;
+		return TREE_ERROR_INVALID_STATE;
 	}
 
-	// get data
-	TREE_Result result;
-	TREE_Control *control = event->control;
-	TREE_Control_NumberInputData *data = (TREE_Control_NumberInputData *)control->data;
-
-	// handle events
-	switch (event->type)
+	// open the file
+	TREE_InputRecording *replay = TREE_NEW(TREE_InputRecording);
+	if (!replay)
 	{
-	case TREE_EVENT_TYPE_KEY_DOWN:
-	case TREE_EVENT_TYPE_KEY_HELD:
+		return TREE_ERROR_ALLOC;
+	}
+	memset(replay, 0, sizeof(TREE_InputRecording));
+	replay->flags = flags;
+	replay->file = fopen(path, "rb");
+	if (!replay->file)
 	{
-		// ignore if not focused
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED))
-		{
-			break;
-		}
+		TREE_DELETE(replay);
+		return TREE_ERROR_FILE_OPEN;
+	}
 
-		// get the event data
-		TREE_EventData_Key *keyData = (TREE_EventData_Key *)event->data;
-		TREE_Key key = keyData->key;
-		TREE_KeyModifierFlags modifiers = keyData->modifiers;
+	// check that it is a recording this version can read, and read ahead the first key change
+	TREE_Byte header[sizeof(g_inputRecordingHeader)];
+	TREE_Result result = TREE_OK;
+	if (fread(header, 1, sizeof(header), replay->file) != sizeof(header) || memcmp(header, g_inputRecordingHeader, sizeof(header)) != 0)
+	{
+		result = TREE_ERROR_FILE_READ;
+	}
+	else
+	{
+		result = _TREE_InputRecording_ReadNext(replay);
+	}
+	if (result)
+	{
+		_TREE_InputRecording_Free(replay);
+		TREE_DELETE(replay);
+		return result;
+	}
+	application->replay = replay;
 
-		// if not active, make it active if submit key pressed
-		if (!(control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
-		{
-			if (key == TREE_KEY_ENTER || key == TREE_KEY_SPACE)
-			{
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_ACTIVE;
-				control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			}
-			break;
-		}
+	return TREE_OK;
+}
 
-		// if active, handle the key
-		switch (key)
-		{
-		case TREE_KEY_UP_ARROW: // increment
-		case TREE_KEY_LEFT_ARROW:
-		case TREE_KEY_W:
-		case TREE_KEY_A:
-		case TREE_KEY_EQUALS:
-		{
-			TREE_Float inc = (modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) ? data->increment * 10 : data->increment;
-			data->value += inc;
-			data->value = CLAMP(data->value, data->minValue, data->maxValue);
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onChange, control, &data->value);
-			break;
-		}
-		case TREE_KEY_DOWN_ARROW: // decrement
-		case TREE_KEY_RIGHT_ARROW:
-		case TREE_KEY_S:
-		case TREE_KEY_D:
-		case TREE_KEY_MINUS:
-		{
-			TREE_Float inc = (modifiers & TREE_KEY_MODIFIER_FLAGS_CONTROL) ? data->increment * 10 : data->increment;
-			data->value -= inc;
-			data->value = CLAMP(data->value, data->minValue, data->maxValue);
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onChange, control, &data->value);
-			break;
-		}
-		case TREE_KEY_HOME: // set to min
-		{
-			data->value = data->minValue;
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onChange, control, &data->value);
-			break;
-		}
-		case TREE_KEY_END: // set to max
-		{
-			data->value = data->maxValue;
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onChange, control, &data->value);
-			break;
-		}
-		case TREE_KEY_ENTER: // submit
-		case TREE_KEY_SPACE:
-		case TREE_KEY_ESCAPE:
-		{
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
-			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-			CALL_ACTION(data->onSubmit, control, &data->value);
-			break;
-		}
-		break;
-		}
+TREE_Result TREE_Application_StopReplay(TREE_Application *application)
+{
+	// validate
+	if (!application)
+	{
+		return TREE_ERROR_ARG_NULL;
 	}
-	case TREE_EVENT_TYPE_REFRESH:
+	if (!application->replay)
+	{
+		return TREE_OK;
+	}
+
+	_TREE_InputRecording_Free(application->replay);
+	TREE_DELETE(application->replay);
+
+	return TREE_OK;
+}
+
+TREE_Result _TREE_Application_TakeInput(TREE_Application *application, TREE_InputDelta const *delta)
+{
+	// write it down before the paste is taken
+	if (application->recording)
 	{
-		// resize if needed
-		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		TREE_Input const *input = &application->input;
+		TREE_Bool paste = delta->key == TREE_KEY_NONE && input->pasteText;
+		TREE_Result result = _TREE_InputRecording_Write(application->recording, delta, paste ? input->pasteText : NULL, paste ? input->pasteSize : 0);
 		if (result)
 		{
 			return result;
 		}
+	}
 
-		// get color from state
-		TREE_Pixel pixel;
-		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE)
-		{
-			pixel = data->theme->pixels[TREE_THEME_PID_ACTIVE];
-		}
-		else if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_FOCUSED)
-		{
-			pixel = data->theme->pixels[TREE_THEME_PID_FOCUSED];
-		}
-		else
-		{
-			pixel = data->theme->pixels[TREE_THEME_PID_NORMAL];
-		}
+	_TREE_Application_QueueInput(application, delta);
+	return TREE_OK;
+}
 
-		// draw the down arrow input, if not at max value
-		TREE_Int width = (TREE_Int)control->transform->globalRect.extent.width;
-		TREE_Offset offset;
-		offset.x = 0;
-		offset.y = 0;
-		if (data->value > data->minValue)
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_DOWN];
-		}
-		else
-		{
-			// draw a space
-			pixel.character = ' ';
-		}
-		TREE_Result result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
-		if (result)
-		{
-			return result;
-		}
+TREE_Result _TREE_Application_TakeReplay(TREE_Application *application, TREE_Time currentTime)
+{
+	TREE_InputRecording *replay = application->replay;
+	TREE_Input *input = &application->input;
+	if (!replay->hasNext)
+	{
+		return TREE_OK;
+	}
 
-		// draw the up arrow input, if not at min value
-		offset.x = width - 1;
-		offset.y = 0;
-		if (data->value < data->maxValue)
-		{
-			pixel.character = data->theme->characters[TREE_THEME_CID_UP];
-		}
-		else
+	// the recording is played back from the first time it is read
+	if (!replay->started)
+	{
+		replay->offset = currentTime - replay->next.time;
+		replay->started = TREE_TRUE;
+	}
+
+	// all due key changes, or as fast as possible, all within one frame of the oldest one
+	TREE_Bool fast = (replay->flags & TREE_REPLAY_FLAGS_MAXIMUM_SPEED) != 0;
+	TREE_Time until = fast ? replay->next.time + application->frameInterval : currentTime - replay->offset;
+	while (replay->hasNext && replay->next.time <= until)
+	{
+		// the changes happen now, as far as the Application knows
+		TREE_InputDelta delta = replay->next;
+		delta.time = fast ? currentTime : delta.time + replay->offset;
+
+		// hand over the pasted text the way the Input would
+		if (delta.key == TREE_KEY_NONE)
 		{
-			// draw a space
-			pixel.character = ' ';
+			TREE_DELETE(input->pasteText);
+			input->pasteText = replay->nextText;
+			input->pasteSize = replay->nextSize;
+			replay->nextText = NULL;
 		}
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
+		TREE_Result result = _TREE_Application_TakeInput(application, &delta);
 		if (result)
 		{
 			return result;
 		}
 
-		// draw the bar separators
-		pixel.character = '|';
-		offset.x = 1;
-		offset.y = 0;
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
+		result = _TREE_InputRecording_ReadNext(replay);
 		if (result)
 		{
 			return result;
 		}
-		offset.x = width - 2;
-		offset.y = 0;
-		result = TREE_Image_Set(
-			control->image,
-			offset,
-			pixel);
+	}
+
+	return TREE_OK;
+}
+
+TREE_Time _TREE_Application_GetReplayTimeout(TREE_Application const *application, TREE_Time currentTime)
+{
+	TREE_InputRecording const *replay = application->replay;
+	if (!replay)
+	{
+		return -1;
+	}
+
+	// the end of the recording is handled with the next frame
+	if (!replay->hasNext || !replay->started || (replay->flags & TREE_REPLAY_FLAGS_MAXIMUM_SPEED))
+	{
+		return 0;
+	}
+	return MAX(replay->next.time + replay->offset - currentTime, 0);
+}
+
+TREE_Result TREE_Application_PushInput(TREE_Application *application, TREE_InputDelta const *delta)
+{
+	// validate
+	if (!application || !delta)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (delta->key > TREE_KEY_MAX)
+	{
+		return TREE_ERROR_ARG_OUT_OF_RANGE;
+	}
+
+	// there is no pasted text to go with it
+	if (delta->key == TREE_KEY_NONE)
+	{
+		return TREE_ERROR_ARG_INVALID;
+	}
+
+	TREE_InputDelta pushed = *delta;
+	if (!pushed.time)
+	{
+		pushed.time = TREE_Time_Now();
+	}
+	return _TREE_Application_TakeInput(application, &pushed);
+}
+
+TREE_Result TREE_Application_PushPaste(TREE_Application *application, TREE_String text)
+{
+	// validate
+	if (!application || !text)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (!*text)
+	{
+		return TREE_OK;
+	}
+
+	// hand the text over the way the Input would
+	TREE_Input *input = &application->input;
+	TREE_DELETE(input->pasteText);
+	TREE_Result result = TREE_String_CreateCopy(&input->pasteText, text);
+	if (result)
+	{
+		return result;
+	}
+	input->pasteSize = strlen(text);
+
+	TREE_InputDelta pushed;
+	pushed.key = TREE_KEY_NONE;
+	pushed.state = TREE_INPUT_STATE_PRESSED;
+	pushed.modifiers = TREE_KEY_MODIFIER_FLAGS_NONE;
+	pushed.time = TREE_Time_Now();
+	pushed.sourceTime = 0;
+	return _TREE_Application_TakeInput(application, &pushed);
+}
+
+TREE_Result _TREE_Application_RefreshInput(TREE_Application *application)
+{
+	// validate
+	if (!application)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// without a terminal, the keys are only pushed or replayed
+	TREE_Input *input = &application->input;
+	TREE_Result result;
+	if (application->headless)
+	{
+		return application->replay ? _TREE_Application_TakeReplay(application, TREE_Time_Now()) : TREE_OK;
+	}
+
+	// update key states
+	result = TREE_Input_Refresh(input);
+	if (result)
+	{
+		return result;
+	}
+
+	// while replaying, the keyboard is still read, so it does not back up, but its changes are not used
+	if (application->replay)
+	{
+		return _TREE_Application_TakeReplay(application, TREE_Time_Now());
+	}
+
+	// keep the changes until the next frame
+	for (TREE_Size i = 0; i < input->deltaCount; i++)
+	{
+		result = _TREE_Application_TakeInput(application, &input->deltas[i]);
 		if (result)
 		{
 			return result;
 		}
+	}
 
-		// get the value, using the decimal places
-		TREE_Char valueString[32];
-		TREE_Int valueStringSize = snprintf(
-			valueString,
-			sizeof(valueString),
-			"%.*f",
-			data->decimalPlaces,
-			data->value);
-		if (valueStringSize < 0)
-		{
-			return TREE_ERROR_INVALID_STATE;
-		}
+	return TREE_OK;
+}
 
-		// get max width of text string
-		TREE_Int textWidth = width - 4;
-		if (textWidth <= 0)
-		{
-			// cannot render any text
-			break;
-		}
+void _TREE_Application_RefreshReplay(TREE_Application *application)
+{
+	// once the last key change of the recording has been drawn
+	if (!application->replay || application->replay->hasNext || application->inputEventsSize)
+	{
+		return;
+	}
+	if (application->replay->flags & TREE_REPLAY_FLAGS_QUIT)
+	{
+		application->running = TREE_FALSE;
+	}
+	TREE_Application_StopReplay(application);
+}
 
-		// if the string is too long, replace with hashes
-		if (valueStringSize > textWidth)
-		{
-			valueStringSize = textWidth;
-			memset(valueString, '#', valueStringSize);
-			valueString[valueStringSize] = '\0';
-		}
+TREE_Result _TREE_Application_DispatchInput(TREE_Application *application)
+{
+	// create event data
+	TREE_EventData_Key eventData;
 
-		// draw the value string
-		offset.x = width - 2 - valueStringSize;
-		offset.y = 0;
-		result = TREE_Image_DrawString(
-			control->image,
-			offset,
-			valueString,
-			pixel.colorPair);
-		if (result)
+	// create event
+	TREE_Event event;
+	event.type = TREE_EVENT_TYPE_NONE;
+	event.data = &eventData;
+	event.control = NULL;
+	event.application = application;
+
+	// trigger an event for each change, in the order they happened
+	TREE_Result result;
+	while (application->inputEventsSize)
+	{
+		TREE_InputDelta delta = application->inputEvents[application->inputEventsStart];
+		TREE_Microseconds takenTime = application->inputEventTimes[application->inputEventsStart];
+		TREE_Char *pasteText = application->inputEventTexts[application->inputEventsStart];
+		TREE_Size pasteSize = application->inputEventTextSizes[application->inputEventsStart];
+		application->inputEventTexts[application->inputEventsStart] = NULL;
+		application->inputEventTextSizes[application->inputEventsStart] = 0;
+		application->inputEventsStart = (application->inputEventsStart + 1) % TREE_APPLICATION_INPUT_CAPACITY;
+		--application->inputEventsSize;
+
+		// the frame shows everything since its oldest change
+		if (!application->frameInputTime || takenTime < application->frameInputTime)
 		{
-			return result;
+			application->frameInputTime = takenTime;
 		}
 
-		// if space left over, fill it
-		TREE_Size fillerSize = textWidth - valueStringSize;
-		if (fillerSize > 0)
+		// each paste goes out in one event, in the order it came in
+		if (delta.key == TREE_KEY_NONE)
 		{
-			TREE_Offset fillerOffset;
-			fillerOffset.x = 2;
-			fillerOffset.y = 0;
-			TREE_Extent fillerExtent;
-			fillerExtent.width = (TREE_UInt)fillerSize;
-			fillerExtent.height = 1;
-			pixel.character = ' ';
-			pixel.colorPair = pixel.colorPair;
-			TREE_Rect fillerRect = {fillerOffset, fillerExtent};
-			result = TREE_Image_FillRect(
-				control->image,
-				&fillerRect,
-				pixel);
+			if (!pasteText)
+			{
+				continue;
+			}
+			TREE_EventData_Paste pasteData;
+			pasteData.text = pasteText;
+			pasteData.length = pasteSize;
+			TREE_Event pasteEvent = event;
+			pasteEvent.type = TREE_EVENT_TYPE_PASTE;
+			pasteEvent.data = &pasteData;
+			result = TREE_Application_DispatchEvent(application, &pasteEvent);
+			TREE_DELETE(pasteText);
 			if (result)
 			{
+				application->running = TREE_FALSE;
 				return result;
 			}
+			continue;
 		}
 
-		break;
-	}
-	case TREE_EVENT_TYPE_DRAW:
-	{
-		// get the event data
-		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
-		TREE_Image *target = drawData->target;
-		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
-
-		// draw the control
-		TREE_Result result = _TREE_Control_Draw(
-			target,
-			dirtyRect,
-			&control->transform->globalRect,
-			control->image);
+		switch (delta.state)
+		{
+		case TREE_INPUT_STATE_PRESSED:
+			event.type = TREE_EVENT_TYPE_KEY_DOWN;
+			break;
+		case TREE_INPUT_STATE_HELD:
+			event.type = TREE_EVENT_TYPE_KEY_HELD;
+			break;
+		default:
+			event.type = TREE_EVENT_TYPE_KEY_UP;
+			break;
+		}
+		eventData.key = delta.key;
+		eventData.modifiers = delta.modifiers;
+		eventData.time = delta.time;
+		result = TREE_Application_DispatchEvent(application, &event);
 		if (result)
 		{
+			application->running = TREE_FALSE;
 			return result;
 		}
-
-		break;
-	}
 	}
 
 	return TREE_OK;
 }
 
-TREE_EXTERN TREE_Result TREE_Control_ProgressBarData_Init(TREE_Control_ProgressBarData *data, TREE_Theme const *theme)
+void _TREE_Application_AddInputLatency(TREE_Application *application, TREE_Microseconds latency)
 {
-	// validate
-	if (!data || !theme)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-
-	// set data
-	data->value = 0;
-	data->direction = TREE_DIRECTION_EAST;
-	data->theme = theme;
+	application->inputLatencies[application->inputLatencyCount % TREE_APPLICATION_LATENCY_CAPACITY] = MAX(latency, 0);
+	++application->inputLatencyCount;
+}
 
-	return TREE_OK;
+int _TREE_Microseconds_Compare(void const *a, void const *b)
+{
+	TREE_Microseconds timeA = *(TREE_Microseconds const *)a;
+	TREE_Microseconds timeB = *(TREE_Microseconds const *)b;
+	return (timeA > timeB) - (timeA < timeB);
 }
 
-TREE_EXTERN void TREE_Control_ProgressBarData_Free(TREE_Control_ProgressBarData *data)
+TREE_Microseconds TREE_Application_GetInputLatency(TREE_Application const *application, TREE_Float percentile)
 {
 	// validate
-	if (!data)
+	if (!application || !application->inputLatencyCount)
 	{
-		return;
+		return -1;
 	}
 
-	// nothing to free
+	// sort a copy of the latest latencies, and take the nearest rank
+	TREE_Microseconds latencies[TREE_APPLICATION_LATENCY_CAPACITY];
+	TREE_Size count = MIN(application->inputLatencyCount, TREE_APPLICATION_LATENCY_CAPACITY);
+	memcpy(latencies, application->inputLatencies, count * sizeof(TREE_Microseconds));
+	qsort(latencies, count, sizeof(TREE_Microseconds), _TREE_Microseconds_Compare);
+	percentile = MAX(0.0, MIN(percentile, 100.0));
+	return latencies[(TREE_Size)(percentile / 100.0 * (TREE_Float)(count - 1) + 0.5)];
 }
 
-TREE_EXTERN TREE_Result TREE_Control_ProgressBar_Init(TREE_Control *control, TREE_Transform *parent, TREE_Control_ProgressBarData *data)
+void _TREE_Application_AddDirtyRect(TREE_Application *application, TREE_Rect const *rect, TREE_Layer layer)
 {
-	// validate
-	if (!control || !data)
+	// ignore empty areas
+	if (rect->extent.width <= 0 || rect->extent.height <= 0)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return;
 	}
 
-	// control init
-	TREE_Result result = TREE_Control_Init(control, parent, TREE_Control_ProgressBar_EventHandler, data);
-	if (result)
+	for (TREE_Size i = 0; i < application->dirtyRectsSize; ++i)
 	{
-		return result;
+		// already drawn from this Layer or lower
+		if (application->dirtyLayers[i] <= layer && _TREE_Rect_IsWithin(&application->dirtyRects[i], rect))
+		{
+			return;
+		}
+
+		// grow an area of the same Layer it overlaps, so that the same cells are not drawn twice
+		// areas of different Layers stay apart, so that a popup closing does not draw the Controls below it again
+		if (application->dirtyLayers[i] == layer && TREE_Rect_IsOverlapping(&application->dirtyRects[i], rect))
+		{
+			application->dirtyRects[i] = TREE_Rect_Combine(&application->dirtyRects[i], rect);
+			return;
+		}
 	}
 
-	// set data
-	control->type = TREE_CONTROL_TYPE_PROGRESS_BAR;
-	control->flags = TREE_CONTROL_FLAGS_NONE;
-	control->transform->localExtent.width = 20;
-	control->transform->localExtent.height = 1;
+	// out of room, so combine with the last area
+	if (application->dirtyRectsSize == application->dirtyRectsCapacity)
+	{
+		TREE_Size last = application->dirtyRectsSize - 1;
+		application->dirtyRects[last] = TREE_Rect_Combine(&application->dirtyRects[last], rect);
+		application->dirtyLayers[last] = MIN(application->dirtyLayers[last], layer);
+		return;
+	}
 
-	return TREE_OK;
+	application->dirtyRects[application->dirtyRectsSize] = *rect;
+	application->dirtyLayers[application->dirtyRectsSize] = layer;
+	application->dirtyRectsSize++;
 }
 
-TREE_EXTERN TREE_Result TREE_Control_ProgressBar_SetValue(TREE_Control *control, TREE_Float value)
+TREE_Bool _TREE_Transform_DependsOnWindow(TREE_Transform const *transform)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	// only the top Transforms are placed within the window
+	if (transform->parent)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return TREE_FALSE;
 	}
 
-	// set the value
-	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
-	data->value = CLAMP(value, 0.0f, 1.0f);
-
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
-
-	return TREE_OK;
+	// anything but a fixed distance from the top left moves with the window
+	TREE_Alignment alignment = transform->localAlignment;
+	return (alignment & TREE_ALIGNMENT_VERTICALSTRETCH) != TREE_ALIGNMENT_TOP ||
+		   (alignment & TREE_ALIGNMENT_HORIZONTALSTRETCH) != TREE_ALIGNMENT_LEFT;
 }
 
-TREE_EXTERN TREE_Float TREE_Control_ProgressBar_GetValue(TREE_Control *control)
+TREE_Result _TREE_Application_Refresh_Surface(TREE_Application *application, TREE_Time currentTime)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	// without a window, the size stays the same
+	if (application->headless)
 	{
-		return 0.0f;
+		return TREE_OK;
 	}
 
-	// get the value
-	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
-	return data->value;
-}
+	// resize the surface if needed
+	TREE_Extent newExtent = TREE_Window_GetExtent();
+	TREE_Extent oldExtent = application->surface->image.extent;
+	if (newExtent.width == 0 || newExtent.height == 0)
+	{
+		// Keep a valid render size when host output has no real terminal extent.
+		if (oldExtent.width > 0 && oldExtent.height > 0)
+		{
+			newExtent = oldExtent;
+		}
+		else
+		{
+			newExtent.width = 120;
+			newExtent.height = 30;
+		}
+	}
+	if (newExtent.width == oldExtent.width && newExtent.height == oldExtent.height)
+	{
+		// resized back before it settled
+		application->resizeTime = 0;
+		return TREE_OK;
+	}
 
-TREE_EXTERN TREE_Result TREE_Control_ProgressBar_SetDirection(TREE_Control *control, TREE_Direction direction)
-{
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	// wait for the window to stop changing size, so that dragging it does not lay everything out again many times over
+	if (!application->resizeTime || newExtent.width != application->resizeExtent.width || newExtent.height != application->resizeExtent.height)
 	{
-		return TREE_ERROR_ARG_NULL;
+		application->resizeExtent = newExtent;
+		application->resizeTime = currentTime;
 	}
-	if (direction < TREE_DIRECTION_NORTH || direction > TREE_DIRECTION_WEST)
+	TREE_Time resizeTime = currentTime - application->resizeTime;
+	if (resizeTime < TREE_APPLICATION_RESIZE_DELAY && resizeTime >= 0)
 	{
-		return TREE_ERROR_ARG_OUT_OF_RANGE;
+		return TREE_OK;
 	}
+	application->resizeTime = 0;
 
-	// set the direction
-	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
-	data->direction = direction;
+	// resize the surface and its Layers, what was drawn where both sizes overlap stays
+	TREE_Result result = TREE_Image_Resize(&application->surface->image, newExtent);
+	if (result)
+	{
+		return result;
+	}
+	for (TREE_Size i = 0; i < TREE_LAYER_COUNT - 1; ++i)
+	{
+		result = TREE_Image_Resize(&application->layers[i], newExtent);
+		if (result)
+		{
+			return result;
+		}
+	}
 
-	// redraw
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+	// draw into the new area
+	TREE_Rect rect;
+	if (newExtent.width > oldExtent.width)
+	{
+		rect.offset = (TREE_Offset){oldExtent.width, 0};
+		rect.extent = (TREE_Extent){newExtent.width - oldExtent.width, newExtent.height};
+		_TREE_Application_AddDirtyRect(application, &rect, TREE_LAYER_BASE);
+	}
+	if (newExtent.height > oldExtent.height)
+	{
+		rect.offset = (TREE_Offset){0, oldExtent.height};
+		rect.extent = (TREE_Extent){newExtent.width, newExtent.height - oldExtent.height};
+		_TREE_Application_AddDirtyRect(application, &rect, TREE_LAYER_BASE);
+	}
+
+	// trigger event
+	TREE_EventData_WindowResize eventData;
+	eventData.extent = newExtent;
+	TREE_Event event;
+	event.type = TREE_EVENT_TYPE_WINDOW_RESIZE;
+	event.data = &eventData;
+	event.control = NULL;
+	event.application = application;
+	result = TREE_Application_DispatchEvent(application, &event);
+	if (result)
+	{
+		return result;
+	}
+
+	// lay out again only what is placed relative to the window, along with everything within it
+	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+	{
+		TREE_Transform *transform = application->controls[i]->transform;
+		if (_TREE_Transform_DependsOnWindow(transform))
+		{
+			TREE_Transform_Dirty(transform);
+		}
+	}
 
 	return TREE_OK;
 }
 
-TREE_EXTERN TREE_Direction TREE_Control_ProgressBar_GetDirection(TREE_Control *control)
+TREE_Layer _TREE_Application_GetTopLayer(TREE_Byte layers)
 {
-	// validate
-	if (!control || control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	TREE_Layer top = TREE_LAYER_COUNT - 1;
+	while (top > TREE_LAYER_BASE && !(layers & (1 << top)))
 	{
-		return TREE_DIRECTION_NONE;
+		--top;
 	}
+	return top;
+}
 
-	// get the direction
-	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
+TREE_Result _TREE_Application_OccupyLayers(TREE_Application *application, TREE_Byte layers)
+{
+	// a Layer newly below the top needs its cache, which is what the Surface or the cache below it shows so far
+	TREE_Byte occupied = application->occupiedLayers;
+	TREE_Layer oldTop = _TREE_Application_GetTopLayer(occupied);
+	TREE_Layer newTop = _TREE_Application_GetTopLayer(layers);
+	TREE_Extent extent = application->surface->image.extent;
+	TREE_Layer source = TREE_LAYER_BASE;
+	for (TREE_Layer current = TREE_LAYER_BASE; current < newTop; ++current)
+	{
+		if (current < oldTop && (occupied & (1 << current)))
+		{
+			source = current;
+			continue;
+		}
+		if (!(layers & (1 << current)))
+		{
+			continue;
+		}
+		TREE_Image const *image = current >= oldTop ? &application->surface->image : &application->layers[source];
+		TREE_Result result = TREE_Image_DrawImage(&application->layers[current], (TREE_Offset){0, 0}, image, (TREE_Offset){0, 0}, extent);
+		if (result)
+		{
+			return result;
+		}
+	}
+	application->occupiedLayers = layers;
 
-	return data->direction;
+	return TREE_OK;
 }
 
-TREE_EXTERN TREE_Result TREE_Control_ProgressBar_EventHandler(TREE_Event const *event)
+TREE_Result _TREE_Application_Draw_Controls(TREE_Application *application, TREE_Rect const *dirtyRect, TREE_Layer layer)
 {
-	// validate
-	if (!event || !event->control)
+	TREE_Result result;
+
+	// create event data
+	TREE_EventData_Draw eventData;
+	eventData.dirtyRect = *dirtyRect;
+
+	// create event
+	TREE_Event event;
+	event.type = TREE_EVENT_TYPE_DRAW;
+	event.data = &eventData;
+	event.control = NULL;
+	event.application = application;
+
+	// start from the lowest occupied Layer that changed, or the top one if none above it are left
+	TREE_Byte occupied = application->occupiedLayers;
+	TREE_Layer top = _TREE_Application_GetTopLayer(occupied);
+	TREE_Layer start = layer;
+	while (start < top && !(occupied & (1 << start)))
 	{
-		return TREE_ERROR_ARG_NULL;
+		++start;
 	}
-	if (event->control->type != TREE_CONTROL_TYPE_PROGRESS_BAR)
+	if (start > top)
 	{
-		return TREE_ERROR_ARG_INVALID;
+		start = top;
 	}
-
-	// get data
-	TREE_Result result;
-	TREE_Control *control = event->control;
-	TREE_Control_ProgressBarData *data = (TREE_Control_ProgressBarData *)control->data;
-	TREE_Extent controlExtent = control->transform->globalRect.extent;
-
-	// handle events
-	switch (event->type)
+	TREE_Layer below = TREE_LAYER_BASE;
+	for (TREE_Layer current = TREE_LAYER_BASE; current < start; ++current)
 	{
-	case TREE_EVENT_TYPE_REFRESH:
+		if (occupied & (1 << current))
+		{
+			below = current;
+		}
+	}
+
+	// draw each occupied Layer from there up, over the one below it, skipping the Layers without Controls
+	for (TREE_Layer current = start; current <= top; ++current)
 	{
-		// resize if needed
-		result = TREE_Image_Resize(control->image, control->transform->globalRect.extent);
+		if (!(occupied & (1 << current)))
+		{
+			continue;
+		}
+
+		// the top Layer is drawn straight onto the Surface
+		TREE_Image *target = current == top ? &application->surface->image : &application->layers[current];
+		if (current == TREE_LAYER_BASE)
+		{
+			result = TREE_Image_FillRect(target, dirtyRect, TREE_Pixel_CreateDefault());
+		}
+		else
+		{
+			result = TREE_Image_DrawImage(target, dirtyRect->offset, &application->layers[below], dirtyRect->offset, dirtyRect->extent);
+		}
+		below = current;
 		if (result)
 		{
 			return result;
 		}
 
-		// determine bounds
-		TREE_Rect barRect, bgRect;
+		// each Control gets its own area of the dirty part of the Layer
+		TREE_ImageView dirtyView;
+		TREE_ImageView_Init(&dirtyView, target);
+		TREE_ImageView_Clip(&dirtyView, dirtyRect);
+		eventData.target = target;
 
-		TREE_Int size;
-		switch (data->direction)
+		// draw the Controls on this Layer within the dirty rect, in the order they were added
+		TREE_Control *control;
+		for (TREE_Size i = 0; i < application->controlsSize; ++i)
 		{
-		case TREE_DIRECTION_EAST:
-			size = (TREE_Int)(controlExtent.width * data->value);
-			barRect.offset.x = 0;
-			barRect.offset.y = 0;
-			barRect.extent.width = size;
-			barRect.extent.height = controlExtent.height;
-			bgRect.offset.x = barRect.extent.width;
-			bgRect.offset.y = 0;
-			bgRect.extent.width = controlExtent.width - size;
-			bgRect.extent.height = controlExtent.height;
-			break;
-		case TREE_DIRECTION_WEST:
-			size = (TREE_Int)(controlExtent.width * data->value);
-			barRect.offset.x = controlExtent.width - size;
-			barRect.offset.y = 0;
-			barRect.extent.width = size;
-			barRect.extent.height = controlExtent.height;
-			bgRect.offset.x = 0;
-			bgRect.offset.y = 0;
-			bgRect.extent.width = controlExtent.width - size;
-			bgRect.extent.height = controlExtent.height;
-			break;
-		case TREE_DIRECTION_NORTH:
-			size = (TREE_Int)(controlExtent.height * data->value);
-			barRect.offset.x = 0;
-			barRect.offset.y = controlExtent.height - size;
-			barRect.extent.width = controlExtent.width;
-			barRect.extent.height = size;
-			bgRect.offset.x = 0;
-			bgRect.offset.y = 0;
-			bgRect.extent.width = controlExtent.width;
-			bgRect.extent.height = controlExtent.height - size;
-			break;
-		case TREE_DIRECTION_SOUTH:
-			size = (TREE_Int)(controlExtent.height * data->value);
-			barRect.offset.x = 0;
-			barRect.offset.y = 0;
-			barRect.extent.width = controlExtent.width;
-			barRect.extent.height = size;
-			bgRect.offset.x = 0;
-			bgRect.offset.y = barRect.extent.height;
-			bgRect.extent.width = controlExtent.width;
-			bgRect.extent.height = controlExtent.height - size;
-			break;
-		default:
-			return TREE_NOT_IMPLEMENTED;
+			control = application->controls[i];
+			if (control->drawnLayer != current || !TREE_Rect_IsOverlapping(dirtyRect, &control->transform->globalRect))
+			{
+				continue;
+			}
+
+			// set the control for the event
+			event.control = control;
+			TREE_ImageView_InitSub(&eventData.view, &dirtyView, &control->transform->globalRect);
+
+			// call the event handler
+			result = TREE_Control_HandleEvent(control, &event);
+			if (result)
+			{
+				return result;
+			}
 		}
+	}
 
-		// draw the background
-		if (bgRect.extent.width > 0 && bgRect.extent.height > 0)
+	// only this area has to be checked when presenting
+	return TREE_Surface_Damage(application->surface, dirtyRect);
+}
+
+TREE_Result _TREE_Application_Refresh_Controls(TREE_Application *application, TREE_Bool* shouldPresent)
+{
+	TREE_Result result;
+
+	// for refreshes
+	TREE_Event event;
+	event.type = TREE_EVENT_TYPE_REFRESH;
+	event.data = NULL;
+	event.control = NULL;
+	event.application = application;
+
+	TREE_Extent extent = application->surface->image.extent;
+	if (application->forceRedraw)
+	{
+		TREE_Rect surfaceRect;
+		surfaceRect.offset.x = 0;
+		surfaceRect.offset.y = 0;
+		surfaceRect.extent = extent;
+		_TREE_Application_AddDirtyRect(application, &surfaceRect, TREE_LAYER_BASE);
+		application->forceRedraw = TREE_FALSE;
+	}
+
+	// the Layers the Controls were on, which are still drawn this time, so that what was above them can be drawn over
+	TREE_Byte layers = 1 << TREE_LAYER_BASE;
+	TREE_Control *control;
+	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+	{
+		layers |= 1 << application->controls[i]->drawnLayer;
+	}
+
+	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+	{
+		control = application->controls[i];
+		TREE_Layer layer = TREE_Control_GetLayer(control);
+		TREE_Bool moved = TREE_FALSE;
+
+		// refresh the transform
+		if (control->transform->dirty)
 		{
-			result = TREE_Image_FillRect(
-				control->image,
-				&bgRect,
-				data->theme->pixels[TREE_THEME_PID_BACKGROUND]);
+			// keep a copy of the old global rect
+			TREE_Rect oldGlobalRect = control->transform->globalRect;
+
+			// refresh the transform
+			result = TREE_Transform_Refresh(control->transform, extent);
 			if (result)
 			{
 				return result;
 			}
+
+			// clear flag
+			control->transform->dirty = TREE_FALSE;
+
+			// the old area needs to be redrawn too, if it moved
+			if (oldGlobalRect.offset.x != control->transform->globalRect.offset.x ||
+				oldGlobalRect.offset.y != control->transform->globalRect.offset.y ||
+				oldGlobalRect.extent.width != control->transform->globalRect.extent.width ||
+				oldGlobalRect.extent.height != control->transform->globalRect.extent.height)
+			{
+				// only from the Layer it was on, what is below it there is cached
+				_TREE_Application_AddDirtyRect(application, &oldGlobalRect, control->drawnLayer);
+				moved = TREE_TRUE;
+			}
+
+			// refresh the control at its new area
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
 		}
 
-		// draw the bar
-		if (barRect.extent.width > 0 && barRect.extent.height > 0)
+		// leaving a Layer uncovers what was below it there
+		if (!moved && layer != control->drawnLayer)
 		{
-			result = TREE_Image_FillRect(
-				control->image,
-				&barRect,
-				data->theme->pixels[TREE_THEME_PID_PROGRESS_BAR]);
+			_TREE_Application_AddDirtyRect(application, &control->transform->globalRect, control->drawnLayer);
+			control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+		}
+
+		// refresh the control
+		if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_DIRTY)
+		{
+			// make room for the Image from the pool, so resizing it does not allocate
+			if (!(control->flags & TREE_CONTROL_FLAGS_DRAW_DIRECT))
+			{
+				result = TREE_ImagePool_Reserve(&application->imagePool, control->image, control->transform->globalRect.extent);
+				if (result)
+				{
+					return result;
+				}
+			}
+
+			// refresh the control
+			event.control = control;
+			result = TREE_Control_HandleEvent(control, &event);
 			if (result)
 			{
 				return result;
 			}
-		}
 
-		break;
+			// clear flag
+			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_DIRTY;
+
+			// update the dirty rects
+			_TREE_Application_AddDirtyRect(application, &control->transform->globalRect, layer);
+			control->drawnLayer = layer;
+		}
+		layers |= 1 << layer;
 	}
-	case TREE_EVENT_TYPE_DRAW:
-	{
-		// get the event data
-		TREE_EventData_Draw *drawData = (TREE_EventData_Draw *)event->data;
-		TREE_Image *target = drawData->target;
-		TREE_Rect const *dirtyRect = &drawData->dirtyRect;
 
-		// draw the control
-		TREE_Result result = _TREE_Control_Draw(
-			target,
-			dirtyRect,
-			&control->transform->globalRect,
-			control->image);
+	// only draw the Layers with Controls, straight onto the Surface if that is only the base Layer
+	if (layers != application->occupiedLayers)
+	{
+		result = _TREE_Application_OccupyLayers(application, layers);
 		if (result)
 		{
 			return result;
 		}
-
-		break;
 	}
+
+	// draw the controls within each dirty rect
+	for (TREE_Size i = 0; i < application->dirtyRectsSize; ++i)
+	{
+		result = _TREE_Application_Draw_Controls(application, &application->dirtyRects[i], application->dirtyLayers[i]);
+		if (result)
+		{
+			return result;
+		}
+		*shouldPresent = TREE_TRUE;
 	}
 
+	// clear the dirty rects
+	application->dirtyRectsSize = 0;
+
 	return TREE_OK;
 }
 
-TREE_Result TREE_Application_Init(TREE_Application *application, TREE_Size capacity, TREE_EventHandler eventHandler)
+// the most input latencies the presenter thread holds until the main loop collects them
+#define PRESENTER_LATENCY_CAPACITY 16
+
+struct _TREE_Presenter
 {
-	// validate
-	if (!application)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (capacity == 0)
-	{
-		return TREE_ERROR_ARG_OUT_OF_RANGE;
-	}
+	// the Surface that is encoded and written, only used by the presenter thread
+	TREE_Surface surface;
 
-	// allocate data
-	application->controls = TREE_NEW_ARRAY(TREE_Control *, capacity);
-	if (!application->controls)
-	{
-		return TREE_ERROR_ALLOC;
-	}
-	application->surface = TREE_NEW(TREE_Surface);
-	if (!application->surface)
-	{
-		TREE_DELETE(application->controls);
-		return TREE_ERROR_ALLOC;
-	}
+	// the newest frame from the main loop, and what changed in it since the presenter thread last took it
+	TREE_Image mailbox;
+	TREE_Int *damageStart;
+	TREE_Int *damageEnd;
+	TREE_Bool invalid;
+	TREE_SurfaceFeatureFlags features;
 
+	// true when there is a frame the presenter thread has not taken yet
+	TREE_Bool pending;
+
+	// true when the frame in the mailbox replaced frames the presenter thread never took
+	TREE_Bool framesDropped;
+
+	// the coalesced frames written since the main loop last collected them
+	TREE_Size coalescedFrames;
+
+	// false when the presenter thread should stop, after writing any pending frame
+	TREE_Bool running;
+
+	// the first error from the presenter thread
 	TREE_Result result;
 
-	// set data
-	application->controlsCapacity = capacity;
-	application->controlsSize = 0;
-	application->focusedControl = NULL;
-	application->forceRedraw = TREE_TRUE;
-	application->running = TREE_FALSE;
-	result = TREE_Input_Init(&application->input);
-	if (result)
-	{
-		TREE_DELETE(application->controls);
-		return result;
-	}
-	application->eventHandler = eventHandler;
-	TREE_Extent extent = TREE_Window_GetExtent();
-	if (extent.width == 0 || extent.height == 0)
+	// the time, in microseconds, of the oldest key change shown by the frame in the mailbox, or 0 if there is none
+	TREE_Microseconds inputTime;
+
+	// the input latencies of the frames written since the main loop last collected them
+	TREE_Microseconds latencies[PRESENTER_LATENCY_CAPACITY];
+	TREE_Size latenciesSize;
+
+#ifdef TREE_WINDOWS
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE signal;
+	HANDLE thread;
+#elif defined(TREE_LINUX)
+	pthread_mutex_t lock;
+	pthread_cond_t signal;
+	pthread_t thread;
+#endif
+};
+
+void _TREE_Presenter_Lock(TREE_Presenter *presenter)
+{
+#ifdef TREE_WINDOWS
+	EnterCriticalSection(&presenter->lock);
+#elif defined(TREE_LINUX)
+	pthread_mutex_lock(&presenter->lock);
+#endif
+}
+
+void _TREE_Presenter_Unlock(TREE_Presenter *presenter)
+{
+#ifdef TREE_WINDOWS
+	LeaveCriticalSection(&presenter->lock);
+#elif defined(TREE_LINUX)
+	pthread_mutex_unlock(&presenter->lock);
+#endif
+}
+
+void _TREE_Presenter_Wait(TREE_Presenter *presenter)
+{
+#ifdef TREE_WINDOWS
+	SleepConditionVariableCS(&presenter->signal, &presenter->lock, INFINITE);
+#elif defined(TREE_LINUX)
+	pthread_cond_wait(&presenter->signal, &presenter->lock);
+#endif
+}
+
+void _TREE_Presenter_Signal(TREE_Presenter *presenter)
+{
+#ifdef TREE_WINDOWS
+	WakeConditionVariable(&presenter->signal);
+#elif defined(TREE_LINUX)
+	pthread_cond_signal(&presenter->signal);
+#endif
+}
+
+TREE_Result _TREE_Presenter_Take(TREE_Presenter *presenter)
+{
+	TREE_Surface *surface = &presenter->surface;
+	TREE_Image *mailbox = &presenter->mailbox;
+	TREE_Extent extent = mailbox->extent;
+
+	// follow the size of the newest frame
+	TREE_Result result;
+	if (surface->image.extent.width != extent.width || surface->image.extent.height != extent.height)
 	{
-		// Some hosts (like output panes) do not expose a real terminal size.
-		extent.width = 120;
-		extent.height = 30;
+		result = TREE_Image_Resize(&surface->image, extent);
+		if (result)
+		{
+			return result;
+		}
 	}
-	result = TREE_Surface_Init(application->surface, extent);
+	result = _TREE_Surface_Match(surface);
 	if (result)
 	{
-		TREE_DELETE(application->controls);
-		TREE_Input_Free(&application->input);
 		return result;
 	}
+	surface->features = presenter->features;
 
-	return TREE_OK;
-}
-
-void TREE_Application_Free(TREE_Application *application)
-{
-	if (!application)
+	// copy what changed, and carry the damage over
+	for (TREE_Int y = 0; y < extent.height; ++y)
 	{
-		return;
+		TREE_Int start = presenter->damageStart[y];
+		TREE_Int end = presenter->damageEnd[y];
+		if (start >= end)
+		{
+			continue;
+		}
+		TREE_Size index = (TREE_Size)y * (TREE_Size)extent.width + (TREE_Size)start;
+		TREE_Size length = (TREE_Size)(end - start);
+		memcpy(&surface->image.text[index], &mailbox->text[index], length * sizeof(TREE_Char));
+		memcpy(&surface->image.colors[index], &mailbox->colors[index], length * sizeof(TREE_ColorPair));
+		surface->damageStart[y] = MIN(surface->damageStart[y], start);
+		surface->damageEnd[y] = MAX(surface->damageEnd[y], end);
+		presenter->damageStart[y] = extent.width;
+		presenter->damageEnd[y] = 0;
 	}
+	if (presenter->invalid)
+	{
+		surface->invalid = TREE_TRUE;
+		presenter->invalid = TREE_FALSE;
+	}
+	presenter->pending = TREE_FALSE;
 
-	TREE_DELETE(application->controls);
-	TREE_Input_Free(&application->input);
-	TREE_Surface_Free(application->surface);
+	// let the Surface count the frame as coalesced, the same as when it drops frames itself
+	surface->framesDropped = surface->framesDropped || presenter->framesDropped;
+	presenter->framesDropped = TREE_FALSE;
+
+	return TREE_OK;
 }
 
-TREE_Result TREE_Application_AddControl(TREE_Application *application, TREE_Control *control)
+void _TREE_Presenter_Loop(TREE_Presenter *presenter)
 {
-	// validate
-	if (!application || !control)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-	if (application->controlsSize == application->controlsCapacity)
+	_TREE_Presenter_Lock(presenter);
+	while (TREE_TRUE)
 	{
-		return TREE_ERROR_FULL;
-	}
+		while (!presenter->pending && presenter->running)
+		{
+			_TREE_Presenter_Wait(presenter);
+		}
+		if (!presenter->pending)
+		{
+			break;
+		}
 
-	// add to the application
-	application->controls[application->controlsSize] = control;
-	application->controlsSize++;
-	control->transform->dirty = TREE_TRUE;
-	control->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+		// take the newest frame, skipping any that were replaced while the last one was written
+		TREE_Result result = _TREE_Presenter_Take(presenter);
+		TREE_Microseconds inputTime = presenter->inputTime;
+		presenter->inputTime = 0;
+		_TREE_Presenter_Unlock(presenter);
 
-	// ensure stale focus/active flags do not carry across pages.
-	control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_FOCUSED & ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
+		// encode and write without holding the lock, so the main loop can hand off the next frame
+		if (!result)
+		{
+			result = TREE_Surface_Refresh(&presenter->surface);
+		}
+		if (!result)
+		{
+			result = TREE_Window_Flush(&presenter->surface, -1);
+		}
 
-	// if no focused control, and this one can be focused, set it as the focused control
-	if (!application->focusedControl && (control->flags & TREE_CONTROL_FLAGS_FOCUSABLE))
-	{
-		TREE_Result result = TREE_Application_SetFocus(application, control);
+		_TREE_Presenter_Lock(presenter);
 		if (result)
 		{
-			return result;
+			presenter->result = result;
+			break;
 		}
-	}
 
-	return TREE_OK;
+		// the frame reached the terminal
+		presenter->coalescedFrames += presenter->surface.coalescedFrames;
+		presenter->surface.coalescedFrames = 0;
+		if (inputTime && presenter->latenciesSize < PRESENTER_LATENCY_CAPACITY)
+		{
+			presenter->latencies[presenter->latenciesSize++] = TREE_Time_NowMicroseconds() - inputTime;
+		}
+	}
+	presenter->running = TREE_FALSE;
+	_TREE_Presenter_Unlock(presenter);
 }
 
-TREE_Result TREE_Application_ClearControls(TREE_Application *application)
+#ifdef TREE_WINDOWS
+DWORD WINAPI _TREE_Presenter_Run(LPVOID parameter)
 {
-	TREE_Size i;
+	_TREE_Presenter_Loop((TREE_Presenter *)parameter);
+	return 0;
+}
+#elif defined(TREE_LINUX)
+void *_TREE_Presenter_Run(void *parameter)
+{
+	_TREE_Presenter_Loop((TREE_Presenter *)parameter);
+	return NULL;
+}
+#endif
 
-	// validate
-	if (!application)
+TREE_Result _TREE_Presenter_Match(TREE_Presenter *presenter, TREE_Extent extent)
+{
+	// nothing to do if the size did not change
+	if (presenter->mailbox.extent.width == extent.width &&
+		presenter->mailbox.extent.height == extent.height &&
+		presenter->damageStart && presenter->damageEnd)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return TREE_OK;
 	}
 
-	for (i = 0; i < application->controlsSize; ++i)
+	TREE_Result result = TREE_Image_Resize(&presenter->mailbox, extent);
+	if (result)
 	{
-		application->controls[i] = NULL;
+		return result;
+	}
+	TREE_Int *damageStart = (TREE_Int *)realloc(presenter->damageStart, (TREE_Size)MAX(extent.height, 1) * sizeof(TREE_Int));
+	if (!damageStart)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	presenter->damageStart = damageStart;
+	TREE_Int *damageEnd = (TREE_Int *)realloc(presenter->damageEnd, (TREE_Size)MAX(extent.height, 1) * sizeof(TREE_Int));
+	if (!damageEnd)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	presenter->damageEnd = damageEnd;
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		presenter->damageStart[y] = extent.width;
+		presenter->damageEnd[y] = 0;
 	}
 
-	application->controlsSize = 0;
-	application->focusedControl = NULL;
-	application->forceRedraw = TREE_TRUE;
+	// a resized frame is printed entirely
+	presenter->invalid = TREE_TRUE;
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Application_SetFocus(TREE_Application *application, TREE_Control *control)
+TREE_Result _TREE_Presenter_Init(TREE_Presenter *presenter, TREE_Extent extent)
 {
-	// validate
-	if (!application)
+	TREE_Result result = TREE_Surface_Init(&presenter->surface, extent);
+	if (result)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return result;
 	}
-
-	// if control already focused, take its focus away
-	if (application->focusedControl)
+	result = TREE_Image_Init(&presenter->mailbox, extent);
+	if (result)
 	{
-		application->focusedControl->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_FOCUSED & ~TREE_CONTROL_STATE_FLAGS_ACTIVE;
-		application->focusedControl->stateFlags |= TREE_CONTROL_STATE_FLAGS_DIRTY;
+		TREE_Surface_Free(&presenter->surface);
+		return result;
 	}
-
-	// set to new control
-	application->focusedControl = control;
-
-	// if new control, give it focus
-	if (control)
+	presenter->damageStart = NULL;
+	presenter->damageEnd = NULL;
+	result = _TREE_Presenter_Match(presenter, extent);
+	if (result)
 	{
-		control->stateFlags |= TREE_CONTROL_STATE_FLAGS_FOCUSED | TREE_CONTROL_STATE_FLAGS_DIRTY;
+		TREE_DELETE(presenter->damageStart);
+		TREE_DELETE(presenter->damageEnd);
+		TREE_Image_Free(&presenter->mailbox);
+		TREE_Surface_Free(&presenter->surface);
+		return result;
+	}
+	presenter->features = presenter->surface.features;
+	presenter->pending = TREE_FALSE;
+	presenter->framesDropped = TREE_FALSE;
+	presenter->coalescedFrames = 0;
+	presenter->running = TREE_TRUE;
+	presenter->result = TREE_OK;
+	presenter->inputTime = 0;
+	presenter->latenciesSize = 0;
+
+	// start the presenter thread, after everything it shares is set up
+	_TREE_FindDifference_Resolve();
+#ifdef TREE_WINDOWS
+	InitializeCriticalSection(&presenter->lock);
+	InitializeConditionVariable(&presenter->signal);
+	presenter->thread = CreateThread(NULL, 0, _TREE_Presenter_Run, presenter, 0, NULL);
+	if (!presenter->thread)
+	{
+		DeleteCriticalSection(&presenter->lock);
+#elif defined(TREE_LINUX)
+	pthread_mutex_init(&presenter->lock, NULL);
+	pthread_cond_init(&presenter->signal, NULL);
+	if (pthread_create(&presenter->thread, NULL, _TREE_Presenter_Run, presenter))
+	{
+		pthread_cond_destroy(&presenter->signal);
+		pthread_mutex_destroy(&presenter->lock);
+#endif
+		TREE_DELETE(presenter->damageStart);
+		TREE_DELETE(presenter->damageEnd);
+		TREE_Image_Free(&presenter->mailbox);
+		TREE_Surface_Free(&presenter->surface);
+		return TREE_ERROR_PRESENTATION_THREAD;
 	}
 
 	return TREE_OK;
 }
 
-TREE_Result TREE_Application_DispatchEvent(TREE_Application *application, TREE_Event const *event)
+TREE_Result _TREE_Presenter_Free(TREE_Presenter *presenter)
 {
-	// validate
-	if (!application || !event)
+	// let the presenter thread write the last frame, then stop
+	_TREE_Presenter_Lock(presenter);
+	presenter->running = TREE_FALSE;
+	_TREE_Presenter_Signal(presenter);
+	_TREE_Presenter_Unlock(presenter);
+#ifdef TREE_WINDOWS
+	WaitForSingleObject(presenter->thread, INFINITE);
+	CloseHandle(presenter->thread);
+	DeleteCriticalSection(&presenter->lock);
+#elif defined(TREE_LINUX)
+	pthread_join(presenter->thread, NULL);
+	pthread_cond_destroy(&presenter->signal);
+	pthread_mutex_destroy(&presenter->lock);
+#endif
+
+	TREE_Result result = presenter->result;
+	TREE_DELETE(presenter->damageStart);
+	TREE_DELETE(presenter->damageEnd);
+	TREE_Image_Free(&presenter->mailbox);
+	TREE_Surface_Free(&presenter->surface);
+	return result;
+}
+
+TREE_Result _TREE_Presenter_Submit(TREE_Presenter *presenter, TREE_Surface *surface, TREE_Microseconds inputTime)
+{
+	// make sure the damage of the Surface matches its Image
+	TREE_Result result = _TREE_Surface_Match(surface);
+	if (result)
 	{
-		return TREE_ERROR_ARG_NULL;
+		return result;
 	}
 
-	TREE_Event e = *event;		 // local copy to edit
-	e.application = application; // set the application for the event
+	_TREE_Presenter_Lock(presenter);
 
-	// handle event on the application level
-	switch (e.type)
+	// stop if the presenter thread failed
+	result = presenter->result;
+	if (!result)
 	{
-	case TREE_EVENT_TYPE_KEY_DOWN:
-	case TREE_EVENT_TYPE_KEY_HELD:
+		result = _TREE_Presenter_Match(presenter, surface->image.extent);
+	}
+	if (result)
 	{
-		// move focus if arrow keys used, if current control is not active
-		if (!application->focusedControl || (application->focusedControl->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE))
+		_TREE_Presenter_Unlock(presenter);
+		return result;
+	}
+
+	// copy what changed into the mailbox, on top of any frame the presenter thread has not taken yet
+	TREE_Extent extent = surface->image.extent;
+	TREE_Bool changed = surface->invalid;
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		TREE_Int start = surface->invalid ? 0 : surface->damageStart[y];
+		TREE_Int end = surface->invalid ? extent.width : surface->damageEnd[y];
+		surface->damageStart[y] = extent.width;
+		surface->damageEnd[y] = 0;
+		if (start >= end)
 		{
-			break;
+			continue;
 		}
+		TREE_Size index = (TREE_Size)y * (TREE_Size)extent.width + (TREE_Size)start;
+		TREE_Size length = (TREE_Size)(end - start);
+		memcpy(&presenter->mailbox.text[index], &surface->image.text[index], length * sizeof(TREE_Char));
+		memcpy(&presenter->mailbox.colors[index], &surface->image.colors[index], length * sizeof(TREE_ColorPair));
+		presenter->damageStart[y] = MIN(presenter->damageStart[y], start);
+		presenter->damageEnd[y] = MAX(presenter->damageEnd[y], end);
+		changed = TREE_TRUE;
+	}
+	if (surface->invalid)
+	{
+		presenter->invalid = TREE_TRUE;
+		surface->invalid = TREE_FALSE;
+	}
+	presenter->features = surface->features;
 
-		// movement allowed
-		TREE_EventData_Key *keyData = (TREE_EventData_Key *)e.data;
-		TREE_Key key = keyData->key;
+	// collect the coalesced frames the presenter thread has written
+	surface->coalescedFrames += presenter->coalescedFrames;
+	presenter->coalescedFrames = 0;
 
-		// move if move key pressed, and there is a control to move to
-		TREE_Direction direction = TREE_DIRECTION_NONE;
-		switch (key)
+	// wake up the presenter thread
+	if (changed)
+	{
+		// the frame it has not taken yet is replaced by this one
+		if (presenter->pending)
 		{
-		case TREE_KEY_UP_ARROW:
-		case TREE_KEY_W:
-			direction = TREE_DIRECTION_NORTH;
-			break;
-		case TREE_KEY_DOWN_ARROW:
-		case TREE_KEY_S:
-			direction = TREE_DIRECTION_SOUTH;
-			break;
-		case TREE_KEY_LEFT_ARROW:
-		case TREE_KEY_A:
-			direction = TREE_DIRECTION_WEST;
-			break;
-		case TREE_KEY_RIGHT_ARROW:
-		case TREE_KEY_D:
-			direction = TREE_DIRECTION_EAST;
-			break;
+			++surface->droppedFrames;
+			presenter->framesDropped = TREE_TRUE;
 		}
+		presenter->pending = TREE_TRUE;
 
-		// if no direction, stop
-		if (direction == TREE_DIRECTION_NONE)
+		// a replaced frame passes its oldest key change on
+		if (inputTime && (!presenter->inputTime || inputTime < presenter->inputTime))
 		{
-			break;
+			presenter->inputTime = inputTime;
 		}
+		_TREE_Presenter_Signal(presenter);
+	}
 
-		// get next control
-		TREE_Control *nextControl = application->focusedControl->adjacent[(TREE_Size)direction - 1];
+	surface->framesDropped = presenter->framesDropped;
 
-		// if no control, stop
-		if (!nextControl)
-		{
-			break;
-		}
+	_TREE_Presenter_Unlock(presenter);
+	return TREE_OK;
+}
 
-		// focus on that control
-		TREE_Result result = TREE_Application_SetFocus(application, nextControl);
-		if (result)
-		{
-			return result;
-		}
+struct _TREE_EventLoop
+{
+#ifdef TREE_WINDOWS
+	// the console input, signaled when there are input records
+	HANDLE input;
 
-		break;
-	}
-	}
+	// signaled by TREE_Application_Wake
+	HANDLE wake;
+#elif defined(TREE_LINUX)
+	// waits on all of the below, and the keyboard
+	int epoll;
 
-	// dispatch the event to the application's event handler, if any
-	if (application->eventHandler)
+	// receives the signals the main loop handles, instead of a signal handler
+	int signals;
+
+	// fires when the next scheduled work is due
+	int timer;
+
+	// written to by TREE_Application_Wake
+	int wake;
+
+	// the signal mask from before the main loop blocked its signals
+	sigset_t oldMask;
+#endif
+};
+
+void _TREE_EventLoop_Free(TREE_EventLoop *eventLoop)
+{
+#ifdef TREE_WINDOWS
+	if (eventLoop->wake)
 	{
-		TREE_Result result = application->eventHandler(&e);
-		if (result)
-		{
-			return result;
-		}
+		CloseHandle(eventLoop->wake);
+		eventLoop->wake = NULL;
 	}
-
-	// dispatch the event to all controls
-	TREE_Control *control;
-	TREE_Result result;
-	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+#elif defined(TREE_LINUX)
+	g_eventLoopWake = -1;
+	int *fds[] = {&eventLoop->epoll, &eventLoop->signals, &eventLoop->timer, &eventLoop->wake};
+	for (TREE_Size i = 0; i < sizeof(fds) / sizeof(fds[0]); ++i)
 	{
-		control = application->controls[i];
-		if (control && control->eventHandler)
+		if (*fds[i] >= 0)
 		{
-			// set the control for the event
-			e.control = control;
-			// call the event handler
-			result = TREE_Control_HandleEvent(control, &e);
-			// if the event handler returns an error, return it
-			if (result)
-			{
-				return result;
-			}
+			close(*fds[i]);
+			*fds[i] = -1;
 		}
 	}
 
-	return TREE_OK;
+	// signals that arrived since were read from the signal file, the rest go to their handlers again
+	pthread_sigmask(SIG_SETMASK, &eventLoop->oldMask, NULL);
+#endif
 }
 
-TREE_Result _TREE_Application_RefreshInput(TREE_Application *application, TREE_Time currentTime)
+TREE_Result _TREE_EventLoop_Init(TREE_EventLoop *eventLoop, TREE_Bool watchInput)
 {
-	// validate
-	if (!application)
-	{
-		return TREE_ERROR_ARG_NULL;
-	}
-
-	static TREE_Time const keyInterval = 1000 / 20; // tick every 1/10 second
-	// key tick interval data
-	static TREE_Time keyTick = 0;
-	if (keyTick == 0)
+#ifdef TREE_WINDOWS
+	eventLoop->input = watchInput ? GetStdHandle(STD_INPUT_HANDLE) : NULL;
+	eventLoop->wake = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (!eventLoop->wake)
 	{
-		keyTick = currentTime; // initialize key tick
+		return TREE_ERROR_WINDOWS_EVENT_INIT;
 	}
+#elif defined(TREE_LINUX)
+	eventLoop->epoll = -1;
+	eventLoop->signals = -1;
+	eventLoop->timer = -1;
+	eventLoop->wake = -1;
 
-#ifdef TREE_LINUX
-#endif // TREE_LINUX
-
-	// update key states
-	TREE_Input oldInput = application->input;
-	TREE_Input *newInput = &application->input;
-	TREE_Result result = TREE_Input_Refresh(newInput);
-	if (result)
+	// block the signals, so that they are only read from the signal file
+	// this is done before any other thread starts, so every thread inherits it
+	sigset_t mask;
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGWINCH);
+	sigaddset(&mask, SIGTERM);
+	sigaddset(&mask, SIGINT);
+	sigaddset(&mask, SIGHUP);
+	if (pthread_sigmask(SIG_BLOCK, &mask, &eventLoop->oldMask))
 	{
-		return result;
+		return TREE_ERROR_LINUX_EVENT_INIT;
 	}
 
-	// create event data
-	TREE_EventData_Key eventData;
-	eventData.key = TREE_KEY_NONE;
-	eventData.modifiers = newInput->modifiers;
-
-	// create event
-	TREE_Event event;
-	event.type = TREE_EVENT_TYPE_NONE;
-	event.data = &eventData;
-	event.control = NULL;
-	event.application = application;
-
-	// check if key tick is active
-	TREE_Bool keyTickActive = (currentTime - keyTick) >= keyInterval;
-	if (keyTickActive)
+	eventLoop->epoll = epoll_create1(EPOLL_CLOEXEC);
+	eventLoop->signals = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+	eventLoop->timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	eventLoop->wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (eventLoop->epoll < 0 || eventLoop->signals < 0 || eventLoop->timer < 0 || eventLoop->wake < 0)
 	{
-		// if active, reset timer
-		keyTick = currentTime;
+		_TREE_EventLoop_Free(eventLoop);
+		return TREE_ERROR_LINUX_EVENT_INIT;
 	}
 
-	// compare new key states with previous states
-	for (TREE_Size i = 0; i < TREE_KEY_COUNT; i++)
+	// watch everything for input, the keys come from the keyboard device or the terminal
+	int input = !watchInput ? -1 : g_inputBackend == TREE_INPUT_BACKEND_TERMINAL ? STDIN_FILENO : g_keyboardEvents;
+	int fds[] = {eventLoop->signals, eventLoop->timer, eventLoop->wake, input};
+	for (TREE_Size i = 0; i < sizeof(fds) / sizeof(fds[0]); ++i)
 	{
-		// get key at index
-		TREE_Key key = newInput->keys[i];
-
-		// check if being pressed right now
-		TREE_Bool pressed = newInput->states[key] != TREE_FALSE;
-
-		// get the old key state
-		TREE_InputState state = oldInput.states[key];
-
-		// copy the old state to the new state
-		newInput->states[key] = state;
-
-		// check for changes
-		if (pressed)
+		if (fds[i] < 0)
 		{
-			if (state == TREE_INPUT_STATE_RELEASED)
-			{
-				// key down
-				newInput->states[key] = TREE_INPUT_STATE_COOLDOWN;
-
-				// trigger key down event
-				event.type = TREE_EVENT_TYPE_KEY_DOWN;
-				eventData.key = key;
-				result = TREE_Application_DispatchEvent(application, &event);
-				if (result)
-				{
-					application->running = TREE_FALSE;
-					return result;
-				}
-			}
-			else if (keyTickActive)
-			{
-				// keep cooling down, if able
-				if (state > TREE_INPUT_STATE_HELD)
-				{
-					state--;
-					newInput->states[key] = state;
-				}
-
-				// held state
-				if (state == TREE_INPUT_STATE_HELD)
-				{
-					// trigger key held event
-					event.type = TREE_EVENT_TYPE_KEY_HELD;
-					eventData.key = key;
-					result = TREE_Application_DispatchEvent(application, &event);
-					if (result)
-					{
-						application->running = TREE_FALSE;
-						return result;
-					}
-				}
-			}
+			continue;
 		}
-		else
+		struct epoll_event event;
+		event.events = EPOLLIN;
+		event.data.fd = fds[i];
+		if (epoll_ctl(eventLoop->epoll, EPOLL_CTL_ADD, fds[i], &event) < 0)
 		{
-			if (state)
+			// a regular file is always ready, so it cannot be waited on
+			if (fds[i] == input && errno == EPERM)
 			{
-				// key up
-				newInput->states[key] = TREE_INPUT_STATE_RELEASED;
-
-				// trigger key up event
-				event.type = TREE_EVENT_TYPE_KEY_UP;
-				eventData.key = key;
-				result = TREE_Application_DispatchEvent(application, &event);
-				if (result)
-				{
-					application->running = TREE_FALSE;
-					return result;
-				}
+				continue;
 			}
+			_TREE_EventLoop_Free(eventLoop);
+			return TREE_ERROR_LINUX_EVENT_INIT;
 		}
 	}
+	g_eventLoopWake = eventLoop->wake;
+#endif
 
 	return TREE_OK;
 }
 
-TREE_Result _TREE_Application_Refresh_Surface(TREE_Application *application)
+void _TREE_EventLoop_Wake(TREE_EventLoop *eventLoop)
 {
-	// resize the surface if needed
-	TREE_Extent newExtent = TREE_Window_GetExtent();
-	TREE_Extent oldExtent = application->surface->image.extent;
-	if (newExtent.width == 0 || newExtent.height == 0)
+#ifdef TREE_WINDOWS
+	SetEvent(eventLoop->wake);
+#elif defined(TREE_LINUX)
+	uint64_t value = 1;
+	ssize_t count = write(eventLoop->wake, &value, sizeof(value));
+	(void)count; // a full counter is already awake
+#endif
+}
+
+TREE_Result _TREE_EventLoop_Wait(TREE_EventLoop *eventLoop, TREE_Application *application, TREE_Time timeout)
+{
+#ifdef TREE_WINDOWS
+	HANDLE handles[2] = {eventLoop->wake, eventLoop->input};
+	DWORD wait = WaitForMultipleObjects(eventLoop->input ? 2 : 1, handles, FALSE, timeout < 0 ? INFINITE : (DWORD)timeout);
+	if (wait == WAIT_FAILED)
 	{
-		// Keep a valid render size when host output has no real terminal extent.
-		if (oldExtent.width > 0 && oldExtent.height > 0)
+		return TREE_ERROR_WINDOWS_EVENT_WAIT;
+	}
+	if (wait == WAIT_OBJECT_0 + 1)
+	{
+		// the key states are read with GetAsyncKeyState, the records only signal that something happened
+		FlushConsoleInputBuffer(eventLoop->input);
+	}
+#elif defined(TREE_LINUX)
+	// schedule the timer, a timeout of 0 does not wait at all
+	int waitTimeout = -1;
+	if (timeout == 0)
+	{
+		waitTimeout = 0;
+	}
+	else if (timeout > 0)
+	{
+		struct itimerspec spec;
+		memset(&spec, 0, sizeof(spec));
+		spec.it_value.tv_sec = (time_t)(timeout / 1000);
+		spec.it_value.tv_nsec = (long)(timeout % 1000) * 1000000L;
+		if (timerfd_settime(eventLoop->timer, 0, &spec, NULL) < 0)
 		{
-			newExtent = oldExtent;
+			return TREE_ERROR_LINUX_EVENT_WAIT;
 		}
-		else
+	}
+
+	struct epoll_event events[4];
+	int count = epoll_wait(eventLoop->epoll, events, sizeof(events) / sizeof(events[0]), waitTimeout);
+	if (count < 0)
+	{
+		if (errno == EINTR)
 		{
-			newExtent.width = 120;
-			newExtent.height = 30;
+			return TREE_OK;
 		}
+		return TREE_ERROR_LINUX_EVENT_WAIT;
 	}
-	if (newExtent.width != oldExtent.width || newExtent.height != oldExtent.height)
+
+	for (int i = 0; i < count; ++i)
 	{
-		// resize the surface
-		TREE_Result result = TREE_Image_Resize(&application->surface->image, newExtent);
-		if (result)
+		int fd = events[i].data.fd;
+		if (fd == eventLoop->signals)
 		{
-			return result;
+			struct signalfd_siginfo info;
+			while (read(fd, &info, sizeof(info)) == (ssize_t)sizeof(info))
+			{
+				// a resize is picked up when the Surface is refreshed, anything else stops the Application
+				if (info.ssi_signo == SIGWINCH)
+				{
+					g_windowExtentStale = 1;
+				}
+				else
+				{
+					application->running = TREE_FALSE;
+				}
+			}
 		}
-
-		// trigger event
-		TREE_EventData_WindowResize eventData;
-		eventData.extent = newExtent;
-		TREE_Event event;
-		event.type = TREE_EVENT_TYPE_WINDOW_RESIZE;
-		event.data = &eventData;
-		event.control = NULL;
-		event.application = application;
-		result = TREE_Application_DispatchEvent(application, &event);
-		if (result)
+		else if (fd == eventLoop->timer || fd == eventLoop->wake)
 		{
-			return result;
+			// clear the expirations/wakeups
+			uint64_t value;
+			ssize_t readCount = read(fd, &value, sizeof(value));
+			(void)readCount;
 		}
 
-		// dirty every transform
-		for (TREE_Size i = 0; i < application->controlsSize; ++i)
-		{
-			application->controls[i]->transform->dirty = TREE_TRUE;
-		}
+		// keyboard events are read by TREE_Input_Refresh
+	}
+
+	// nothing is scheduled until the next wait
+	if (timeout > 0)
+	{
+		struct itimerspec spec;
+		memset(&spec, 0, sizeof(spec));
+		timerfd_settime(eventLoop->timer, 0, &spec, NULL);
 	}
+#endif
 
 	return TREE_OK;
 }
 
-TREE_Result _TREE_Application_Refresh_Controls(TREE_Application *application, TREE_Bool* shouldPresent)
+TREE_Time _TREE_Time_MinTimeout(TREE_Time timeout, TREE_Time other)
 {
-	TREE_Result result;
+	// negative waits forever
+	if (timeout < 0)
+	{
+		return other;
+	}
+	if (other < 0)
+	{
+		return timeout;
+	}
+	return MIN(timeout, other);
+}
 
-	// for refreshes
-	TREE_Event event;
-	event.type = TREE_EVENT_TYPE_REFRESH;
-	event.data = NULL;
-	event.control = NULL;
-	event.application = application;
+TREE_Time _TREE_Input_GetTimeout(TREE_Input const *input, TREE_Time currentTime)
+{
+	// wake up for the next repeat of a held key
+	TREE_Time timeout = -1;
+	for (TREE_Size i = 0; i < input->heldCount; ++i)
+	{
+		timeout = _TREE_Time_MinTimeout(timeout, MAX(input->repeatTimes[input->heldKeys[i]] - currentTime, 0));
+	}
+
+#ifdef TREE_LINUX
+	// and to release the keys that the terminal only reported as typed
+	if (g_terminalTypedCount)
+	{
+		timeout = _TREE_Time_MinTimeout(timeout, input->repeatInterval);
+	}
+#endif
 
-	// clear the dirty rect
-	TREE_Rect dirtyRect;
-	dirtyRect.offset.x = (TREE_Int)application->surface->image.extent.width;
-	dirtyRect.offset.y = (TREE_Int)application->surface->image.extent.height;
-	dirtyRect.extent.width = 0;
-	dirtyRect.extent.height = 0;
+	return timeout;
+}
 
-	TREE_Extent extent = application->surface->image.extent;
-	if (application->forceRedraw)
+TREE_Result _TREE_Application_Present(TREE_Application *application)
+{
+	// hand the frame off to the presenter thread, if there is one
+	if (application->presenter)
 	{
-		dirtyRect.offset.x = 0;
-		dirtyRect.offset.y = 0;
-		dirtyRect.extent.width = extent.width;
-		dirtyRect.extent.height = extent.height;
-		application->forceRedraw = TREE_FALSE;
+		return _TREE_Presenter_Submit(application->presenter, application->surface, application->frameInputTime);
 	}
 
-	TREE_Control *control;
-	TREE_Bool dirty;
-	TREE_Rect rect;
-	for (TREE_Size i = 0; i < application->controlsSize; ++i)
+	TREE_Result result = TREE_Surface_Refresh(application->surface);
+	if (result)
 	{
-		control = application->controls[i];
-		dirty = TREE_FALSE;
+		return result;
+	}
 
-		// refresh the transform
-		if (control->transform->dirty)
+	// without a terminal, the encoded frame counts as written
+	if (application->headless)
+	{
+		application->surface->textWritten = application->surface->textSize;
+	}
+	else
+	{
+		result = TREE_Window_Present(application->surface);
+		if (result)
 		{
-			// keep a copy of the old global rect
-			TREE_Rect oldGlobalRect = control->transform->globalRect;
-
-			// refresh the transform
-			result = TREE_Transform_Refresh(control->transform, extent);
-			if (result)
-			{
-				return result;
-			}
+			return result;
+		}
+	}
 
-			// get the dirty rect (combination of old and new rects)
-			rect = TREE_Rect_Combine(
-				&oldGlobalRect,
-				&control->transform->globalRect);
+	// a frame that replaced one still being written passes its oldest key change on
+	if (application->frameInputTime && (!application->presentInputTime || application->frameInputTime < application->presentInputTime))
+	{
+		application->presentInputTime = application->frameInputTime;
+	}
 
-			// clear flag
-			control->transform->dirty = TREE_FALSE;
+	return TREE_OK;
+}
 
-			// update the dirty rect
-			dirty = TREE_TRUE;
-		}
-		else
+void _TREE_Application_CollectInputLatency(TREE_Application *application)
+{
+	// from the presenter thread
+	if (application->presenter)
+	{
+		TREE_Presenter *presenter = application->presenter;
+		_TREE_Presenter_Lock(presenter);
+		for (TREE_Size i = 0; i < presenter->latenciesSize; ++i)
 		{
-			// transform did not change, so just use the global rect
-			rect = control->transform->globalRect;
+			_TREE_Application_AddInputLatency(application, presenter->latencies[i]);
 		}
+		presenter->latenciesSize = 0;
+		_TREE_Presenter_Unlock(presenter);
+		return;
+	}
 
-		// refresh the control
-		if (dirty || (control->stateFlags & TREE_CONTROL_STATE_FLAGS_DIRTY))
-		{
-			// refresh the control
-			event.control = control;
-			result = TREE_Control_HandleEvent(control, &event);
-			if (result)
-			{
-				return result;
-			}
-
-			// clear flag
-			control->stateFlags &= ~TREE_CONTROL_STATE_FLAGS_DIRTY;
+	// once the frame is written all the way
+	if (application->presentInputTime && !TREE_Window_IsPresenting(application->surface))
+	{
+		_TREE_Application_AddInputLatency(application, TREE_Time_NowMicroseconds() - application->presentInputTime);
+		application->presentInputTime = 0;
+	}
+}
 
-			// update the dirty rect
-			dirty = TREE_TRUE;
-		}
+TREE_Result _TREE_Application_Frame(TREE_Application *application, TREE_Time currentTime)
+{
+	// handle key events
+	TREE_Result result = _TREE_Application_DispatchInput(application);
+	if (result || !application->running)
+	{
+		return result;
+	}
 
-		// update the dirty rect
-		if (dirty)
-		{
-			dirtyRect = TREE_Rect_Combine(
-				&dirtyRect,
-				&rect);
-		}
+	// update the dirty controls/transforms
+	TREE_Bool shouldPresent = TREE_FALSE;
+	result = _TREE_Application_Refresh_Controls(application, &shouldPresent);
+	if (result)
+	{
+		return result;
 	}
 
-	// draw the controls using the dirty rect, if there is a dirty rect
-	if (dirtyRect.extent.width != 0 && dirtyRect.extent.height != 0)
+	// present the surface, if there is an update to show
+	if (shouldPresent)
 	{
-		// clear the surface where the dirty rect is
-		result = TREE_Image_FillRect(
-			&application->surface->image,
-			&dirtyRect,
-			TREE_Pixel_CreateDefault());
+		result = _TREE_Application_Present(application);
 		if (result)
 		{
 			return result;
 		}
-		*shouldPresent = TREE_TRUE;
-
-		// create event data
-		TREE_EventData_Draw eventData;
-		eventData.target = &application->surface->image;
-		eventData.dirtyRect = dirtyRect;
-
-		// create event
-		TREE_Event event;
-		event.type = TREE_EVENT_TYPE_DRAW;
-		event.data = &eventData;
-		event.control = NULL;
-		event.application = application;
-
-		// delay the drawing of the active control until the end
-		TREE_Control *active = NULL;
-		TREE_Control *control;
-
-		// check each control: if it is within the dirty rect, redraw it if so
-		for (TREE_Size i = 0; i < application->controlsSize; ++i)
-		{
-			control = application->controls[i];
-			if (TREE_Rect_IsOverlapping(&dirtyRect, &control->transform->globalRect))
-			{
-				// if this is the active control, skip
-				if (control->stateFlags & TREE_CONTROL_STATE_FLAGS_ACTIVE)
-				{
-					// if already one active, whoops
-					if (active)
-					{
-						return TREE_ERROR_APPLICATION_MULTIPLE_ACTIVE_CONTROLS;
-					}
-					active = control;
-					continue;
-				}
-
-				// set the control for the event
-				event.control = control;
+		application->lastFrameTime = currentTime;
+	}
 
-				// call the event handler
-				result = TREE_Control_HandleEvent(control, &event);
-				if (result)
-				{
-					return result;
-				}
+	// key changes that did not change the frame are not measured
+	application->frameInputTime = 0;
 
-				// there was a drawing update
-				*shouldPresent = TREE_TRUE;
-			}
-		}
+	// finish a replay that has been drawn
+	_TREE_Application_RefreshReplay(application);
 
-		// draw active
-		if (active)
-		{
-			event.control = active;
-			result = TREE_Control_HandleEvent(active, &event);
-			if (result)
-			{
-				return result;
-			}
-			*shouldPresent = TREE_TRUE;
-		}
-	}
-	
 	return TREE_OK;
 }
 
-TREE_Result _TREE_Application_Present(TREE_Application *application)
+TREE_Result TREE_Application_Step(TREE_Application *application)
 {
-	TREE_Result result = TREE_Surface_Refresh(application->surface);
-	if (result)
+	// validate
+	if (!application)
 	{
-		return result;
+		return TREE_ERROR_ARG_NULL;
 	}
-	result = TREE_Window_Present(application->surface);
-	if (result)
+	if (!application->surface)
 	{
-		return result;
+		return TREE_ERROR_ARG_NULL;
+	}
+	if (application->running)
+	{
+		return TREE_ERROR_ARG_INVALID;
 	}
 
-	return TREE_OK;
+	// running only for this frame, so that quitting from an event handler stops the rest of it
+	application->running = TREE_TRUE;
+	TREE_Time currentTime = TREE_Time_Now();
+	application->input.timeout = 0;
+	TREE_Result result = _TREE_Application_RefreshInput(application);
+	if (!result)
+	{
+		result = _TREE_Application_Refresh_Surface(application, currentTime);
+	}
+	if (!result)
+	{
+		result = _TREE_Application_Frame(application, currentTime);
+	}
+	if (!result && TREE_Window_IsPresenting(application->surface))
+	{
+		result = TREE_Window_Present(application->surface);
+	}
+	_TREE_Application_CollectInputLatency(application);
+	application->running = TREE_FALSE;
+
+	return result;
 }
 
 TREE_Result TREE_Application_Run(TREE_Application *application)
@@ -8920,62 +13916,161 @@ TREE_Result TREE_Application_Run(TREE_Application *application)
 		return TREE_ERROR_ARG_INVALID;
 	}
 
-	// hide cursor
-	TREE_Cursor_SetVisible(TREE_FALSE);
-
 	TREE_Result result;
-	TREE_Time startTime = TREE_Time_Now();
 	TREE_Time currentTime;
 
-	// get initial key input state, do not dispatch events yet
-	result = TREE_Input_Refresh(&application->input);
+	// without a terminal, the pushed keys are kept
+	if (!application->headless)
+	{
+		// hide cursor
+		TREE_Cursor_SetVisible(TREE_FALSE);
+
+		// get initial key input state, do not dispatch events yet
+		application->input.timeout = 0;
+		result = TREE_Input_Refresh(&application->input);
+		if (result)
+		{
+			return result;
+		}
+		_TREE_Application_ClearInput(application);
+	}
+	application->frameInputTime = 0;
+	application->presentInputTime = 0;
+
+	// sleep on input, signals and timers, instead of polling for them
+	application->eventLoop = TREE_NEW(TREE_EventLoop);
+	if (!application->eventLoop)
+	{
+		return TREE_ERROR_ALLOC;
+	}
+	result = _TREE_EventLoop_Init(application->eventLoop, !application->headless);
 	if (result)
 	{
+		TREE_DELETE(application->eventLoop);
 		return result;
 	}
 
+	// start presenting in the background, if requested
+	if (application->backgroundPresent && !application->headless)
+	{
+		application->presenter = TREE_NEW(TREE_Presenter);
+		if (!application->presenter)
+		{
+			result = TREE_ERROR_ALLOC;
+		}
+		else
+		{
+			result = _TREE_Presenter_Init(application->presenter, application->surface->image.extent);
+			if (result)
+			{
+				TREE_DELETE(application->presenter);
+			}
+		}
+		if (result)
+		{
+			_TREE_EventLoop_Free(application->eventLoop);
+			TREE_DELETE(application->eventLoop);
+			return result;
+		}
+	}
+
 	application->running = TREE_TRUE;
+	TREE_Time timeout = 0;
 	while (application->running)
 	{
+		// sleep until there is something to do
+		result = _TREE_EventLoop_Wait(application->eventLoop, application, timeout);
+		if (result || !application->running)
+		{
+			break;
+		}
+
 		// get current time
 		currentTime = TREE_Time_Now();
 
-		// check for resize
-		result = _TREE_Application_Refresh_Surface(application);
+		// read input, its key events are dispatched with the next frame
+		result = _TREE_Application_RefreshInput(application);
 		if (result)
 		{
-			application->running = TREE_FALSE;
-			return result;
+			break;
 		}
 
-		// update the dirty controls/transforms
-		TREE_Bool shouldPresent = TREE_FALSE;
-		result = _TREE_Application_Refresh_Controls(application, &shouldPresent);
+		// check for resize
+		result = _TREE_Application_Refresh_Surface(application, currentTime);
 		if (result)
 		{
-			application->running = TREE_FALSE;
-			return result;
+			break;
+		}
+
+		// wait for the next frame, so that all updates until then are drawn together
+		timeout = -1;
+		TREE_Time frameTime = currentTime - application->lastFrameTime;
+		TREE_Bool replayingFast = application->replay && (application->replay->flags & TREE_REPLAY_FLAGS_MAXIMUM_SPEED);
+		if (frameTime >= application->frameInterval || frameTime < 0 || replayingFast)
+		{
+			result = _TREE_Application_Frame(application, currentTime);
+			if (result || !application->running)
+			{
+				break;
+			}
+		}
+		else
+		{
+			// come back when the frame is due
+			timeout = application->frameInterval - frameTime;
 		}
 
-		// present the surface, if there is an update to show
-		if (shouldPresent)
+		// keep writing a frame the terminal could not take all at once, checking back soon
+		if (TREE_Window_IsPresenting(application->surface))
 		{
-			result = _TREE_Application_Present(application);
+			result = TREE_Window_Present(application->surface);
 			if (result)
 			{
-				application->running = TREE_FALSE;
-				return result;
+				break;
+			}
+			if (TREE_Window_IsPresenting(application->surface))
+			{
+				timeout = _TREE_Time_MinTimeout(timeout, MAX(application->frameInterval, 1));
 			}
 		}
 
-		// handle input and key events
-		result = _TREE_Application_RefreshInput(application, currentTime);
-		if (result)
+		// measure the frames that reached the terminal
+		_TREE_Application_CollectInputLatency(application);
+
+		// held keys keep repeating
+		timeout = _TREE_Time_MinTimeout(timeout, _TREE_Input_GetTimeout(&application->input, currentTime));
+
+		// replayed key changes are fed when they are due
+		timeout = _TREE_Time_MinTimeout(timeout, _TREE_Application_GetReplayTimeout(application, currentTime));
+
+		// come back when the window has settled on its new size
+		if (application->resizeTime)
 		{
-			application->running = TREE_FALSE;
-			return result;
+			timeout = _TREE_Time_MinTimeout(timeout, MAX(application->resizeTime + TREE_APPLICATION_RESIZE_DELAY - currentTime, 0));
+		}
+	}
+
+	application->running = TREE_FALSE;
+
+	// wait for the last frame to be written
+	if (application->presenter)
+	{
+		TREE_Result presenterResult = _TREE_Presenter_Free(application->presenter);
+		TREE_DELETE(application->presenter);
+
+		// the front Image of the Surface was not kept up to date
+		TREE_Surface_Invalidate(application->surface);
+		if (!result)
+		{
+			result = presenterResult;
 		}
 	}
+	_TREE_EventLoop_Free(application->eventLoop);
+	TREE_DELETE(application->eventLoop);
+	if (result || application->headless)
+	{
+		return result;
+	}
 
 	// Clear pending key presses before returning to the shell.
 #ifdef TREE_WINDOWS
@@ -8990,6 +14085,20 @@ TREE_Result TREE_Application_Run(TREE_Application *application)
 	return TREE_OK;
 }
 
+TREE_Result TREE_Application_SetFrameRate(TREE_Application *application, TREE_UInt framesPerSecond)
+{
+	// validate
+	if (!application)
+	{
+		return TREE_ERROR_ARG_NULL;
+	}
+
+	// 0 presents every update as soon as possible
+	application->frameInterval = framesPerSecond ? 1000 / (TREE_Time)framesPerSecond : 0;
+
+	return TREE_OK;
+}
+
 void TREE_Application_Quit(TREE_Application *application)
 {
 	// validate
@@ -9000,4 +14109,20 @@ void TREE_Application_Quit(TREE_Application *application)
 
 	// set running to false
 	application->running = TREE_FALSE;
+	TREE_Application_Wake(application);
+}
+
+void TREE_Application_Wake(TREE_Application *application)
+{
+	// validate
+	if (!application)
+	{
+		return;
+	}
+
+	// only a running Application sleeps
+	if (application->eventLoop)
+	{
+		_TREE_EventLoop_Wake(application->eventLoop);
+	}
 }
\ No newline at end of file
@@ -16,6 +16,7 @@ typedef unsigned long long TREE_Size;
 typedef void* TREE_Data;
 typedef long TREE_Long;
 typedef long long TREE_Time;
+typedef long long TREE_Microseconds;
 
 #define TREE_FALSE 0
 #define TREE_TRUE 1
@@ -61,10 +62,13 @@ typedef enum _TREE_Result
 
 	// Presentation errors
 	TREE_ERROR_PRESENTATION = 400,
+	TREE_ERROR_PRESENTATION_THREAD = 401,
 
 	// File errors
 	TREE_ERROR_FILE_OPEN = 500,
 	TREE_ERROR_FILE_DELETE = 501,
+	TREE_ERROR_FILE_READ = 502,
+	TREE_ERROR_FILE_WRITE = 503,
 
 	// Directory errors
 	TREE_ERROR_DIRECTORY_CREATE = 600,
@@ -105,6 +109,10 @@ typedef enum _TREE_Result
 	TREE_ERROR_WINDOWS_CONSOLE_SET_CURSOR_INFO = 10301,
 	TREE_ERROR_WINDOWS_CONSOLE_INIT = 10302,
 
+	// Events
+	TREE_ERROR_WINDOWS_EVENT_INIT = 10400,
+	TREE_ERROR_WINDOWS_EVENT_WAIT = 10401,
+
 	//		Linux
 
 	// Clipboard
@@ -123,6 +131,13 @@ typedef enum _TREE_Result
 	TREE_ERROR_LINUX_KEYBOARD_READ = 20302,
 	TREE_ERROR_LINUX_KEYBOARD_POLL = 20303,
 
+	// Events
+	TREE_ERROR_LINUX_EVENT_INIT = 20400,
+	TREE_ERROR_LINUX_EVENT_WAIT = 20401,
+
+	// Terminal
+	TREE_ERROR_LINUX_TERMINAL_READ = 20500,
+
 } TREE_Result;
 
 TREE_EXTERN TREE_String TREE_Result_ToString(TREE_Result code);
@@ -137,6 +152,12 @@ TREE_EXTERN TREE_String TREE_Result_ToString(TREE_Result code);
 /// <returns></returns>
 TREE_Time TREE_Time_Now();
 
+/// <summary>
+/// Gets the time in microseconds on a monotonic clock, for measuring short durations. Only differences between two of these times are meaningful.
+/// </summary>
+/// <returns>The time in microseconds.</returns>
+TREE_EXTERN TREE_Microseconds TREE_Time_NowMicroseconds();
+
 ///////////////////////////////////////
 // TREE                              //
 ///////////////////////////////////////
@@ -715,6 +736,11 @@ typedef struct _TREE_Image
 	/// The ColorPairs in the image.
 	/// </summary>
 	TREE_ColorPair* colors;
+
+	/// <summary>
+	/// The number of pixels the text and colors can hold. Resizing within it does not reallocate.
+	/// </summary>
+	TREE_Size capacity;
 } TREE_Image;
 
 /// <summary>
@@ -750,6 +776,7 @@ TREE_EXTERN TREE_Pixel TREE_Image_Get(TREE_Image* image, TREE_Offset offset);
 
 /// <summary>
 /// Resizes the given image to the given size.
+/// The overlapping pixels are kept and any new pixels are blank. Memory is only reallocated when growing past the capacity.
 /// </summary>
 /// <param name="image">The Image.</param>
 /// <param name="extent">The new Size.</param>
@@ -757,7 +784,7 @@ TREE_EXTERN TREE_Pixel TREE_Image_Get(TREE_Image* image, TREE_Offset offset);
 TREE_EXTERN TREE_Result TREE_Image_Resize(TREE_Image* image, TREE_Extent extent);
 
 /// <summary>
-/// Draws the given other Image onto the given Image.
+/// Draws the given other Image onto the given Image. Only the parts within both Images are drawn.
 /// </summary>
 /// <param name="image">The destination Image.</param>
 /// <param name="offset">The offset within the destination Image.</param>
@@ -813,10 +840,306 @@ TREE_EXTERN TREE_Result TREE_Image_FillRect(TREE_Image* image, TREE_Rect const*
 /// <returns></returns>
 TREE_EXTERN TREE_Result TREE_Image_Clear(TREE_Image* image, TREE_Pixel pixel);
 
+/// <summary>
+/// Finds the first cell in the given range where the two Images differ, in either the text or the colors.
+/// </summary>
+/// <param name="image">The first Image.</param>
+/// <param name="other">The second Image. Must have the same extent as the first Image.</param>
+/// <param name="start">The index of the first cell to compare.</param>
+/// <param name="end">The index after the last cell to compare.</param>
+/// <returns>The index of the first differing cell, or end if every cell in the range matches.</returns>
+TREE_EXTERN TREE_Size TREE_Image_FindDifference(TREE_Image const* image, TREE_Image const* other, TREE_Size start, TREE_Size end);
+
+///////////////////////////////////////
+// Image View                        //
+///////////////////////////////////////
+
+/// <summary>
+/// A rectangular area of an Image, drawn to without a copy. Coordinates are relative to the top left of the view,
+/// and anything outside of its clip Rect is not drawn.
+/// </summary>
+typedef struct _TREE_ImageView
+{
+	/// <summary>
+	/// The text characters of the Image the view is within.
+	/// </summary>
+	TREE_Char* text;
+
+	/// <summary>
+	/// The ColorPairs of the Image the view is within.
+	/// </summary>
+	TREE_ColorPair* colors;
+
+	/// <summary>
+	/// The number of pixels in each row of the Image the view is within.
+	/// </summary>
+	TREE_Size stride;
+
+	/// <summary>
+	/// The top left of the view within the Image. Can be outside of the Image.
+	/// </summary>
+	TREE_Offset offset;
+
+	/// <summary>
+	/// The size of the view.
+	/// </summary>
+	TREE_Extent extent;
+
+	/// <summary>
+	/// The area that can be drawn to, relative to the view. Always within both the view and the Image.
+	/// </summary>
+	TREE_Rect clip;
+} TREE_ImageView;
+
+/// <summary>
+/// Initializes a view of the whole of the given Image.
+/// The view is no longer valid once the Image is resized or freed.
+/// </summary>
+/// <param name="view">The ImageView.</param>
+/// <param name="image">The Image.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_Init(TREE_ImageView* view, TREE_Image* image);
+
+/// <summary>
+/// Initializes a view of an area of the given other view. It can only draw where the other view can.
+/// </summary>
+/// <param name="view">The ImageView.</param>
+/// <param name="other">The ImageView it is within.</param>
+/// <param name="rect">The area, relative to the other view.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_InitSub(TREE_ImageView* view, TREE_ImageView const* other, TREE_Rect const* rect);
+
+/// <summary>
+/// Limits the area the given view can draw to.
+/// </summary>
+/// <param name="view">The ImageView.</param>
+/// <param name="rect">The area to keep, relative to the view.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_Clip(TREE_ImageView* view, TREE_Rect const* rect);
+
+/// <summary>
+/// Sets the pixel at the given offset in the view.
+/// </summary>
+/// <param name="view">The ImageView.</param>
+/// <param name="offset">The X and Y coordinate within the view. (0, 0) is the top left.</param>
+/// <param name="pixel">The Pixel value to set.</param>
+/// <returns>A TREE_Result code. TREE_ERROR_ARG_OUT_OF_RANGE if the offset is outside of the clip Rect.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_Set(TREE_ImageView* view, TREE_Offset offset, TREE_Pixel pixel);
+
+/// <summary>
+/// Draws the given Image onto the given view.
+/// </summary>
+/// <param name="view">The destination ImageView.</param>
+/// <param name="offset">The offset within the view.</param>
+/// <param name="other">The source Image.</param>
+/// <param name="otherOffset">The offset within the source Image.</param>
+/// <param name="extent">The size to draw.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_DrawImage(TREE_ImageView* view, TREE_Offset offset, TREE_Image const* other, TREE_Offset otherOffset, TREE_Extent extent);
+
+/// <summary>
+/// Draws the given string onto the given view.
+/// </summary>
+/// <param name="view">The destination ImageView.</param>
+/// <param name="offset">The offset within the view.</param>
+/// <param name="string">The source String.</param>
+/// <param name="colorPair">The ColorPair of the String.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_DrawString(TREE_ImageView* view, TREE_Offset offset, TREE_String string, TREE_ColorPair colorPair);
+
+/// <summary>
+/// Draws a line from the start to the end offset in the given view.
+/// </summary>
+/// <param name="view">The destination ImageView.</param>
+/// <param name="start">The starting coordinates of the line.</param>
+/// <param name="end">The ending coordinates of the line.</param>
+/// <param name="pattern">The Pattern to draw the line with.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_DrawLine(TREE_ImageView* view, TREE_Offset start, TREE_Offset end, TREE_Pattern const* pattern);
+
+/// <summary>
+/// Draws the given Rect in the given view.
+/// </summary>
+/// <param name="view">The destination ImageView.</param>
+/// <param name="rect">The Rect to draw.</param>
+/// <param name="pattern">The Pattern to draw the lines with.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_DrawRect(TREE_ImageView* view, TREE_Rect const* rect, TREE_Pattern const* pattern);
+
+/// <summary>
+/// Fills the given Rect in the given view with the given Pixel.
+/// </summary>
+/// <param name="view">The destination ImageView.</param>
+/// <param name="rect">The Rect to fill.</param>
+/// <param name="pixel">The Pixel to fill the Rect with.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_FillRect(TREE_ImageView* view, TREE_Rect const* rect, TREE_Pixel pixel);
+
+/// <summary>
+/// Clears the given view with the given Pixel.
+/// </summary>
+/// <param name="view">The ImageView.</param>
+/// <param name="pixel">The Pixel to use.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImageView_Clear(TREE_ImageView* view, TREE_Pixel pixel);
+
+///////////////////////////////////////
+// Image Pool                        //
+///////////////////////////////////////
+
+/// <summary>
+/// Keeps the memory of Images that are no longer used, to hand to Images that need more.
+/// </summary>
+typedef struct _TREE_ImagePool
+{
+	/// <summary>
+	/// The unused Images, from the smallest to the largest capacity.
+	/// </summary>
+	TREE_Image* images;
+
+	/// <summary>
+	/// The number of unused Images.
+	/// </summary>
+	TREE_Size imagesSize;
+
+	/// <summary>
+	/// The most unused Images that are kept. Past that, the smallest are freed.
+	/// </summary>
+	TREE_Size imagesCapacity;
+} TREE_ImagePool;
+
+/// <summary>
+/// Initializes the given ImagePool.
+/// </summary>
+/// <param name="pool">The ImagePool.</param>
+/// <param name="capacity">The most unused Images to keep.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImagePool_Init(TREE_ImagePool* pool, TREE_Size capacity);
+
+/// <summary>
+/// Frees the given ImagePool, and the memory of every Image within it.
+/// </summary>
+/// <param name="pool">The ImagePool.</param>
+TREE_EXTERN void TREE_ImagePool_Free(TREE_ImagePool* pool);
+
+/// <summary>
+/// Ensures the given Image can be resized to the given extent without allocating.
+/// Takes the smallest unused Image that fits and gives back the old memory, or grows the Image with some room to spare.
+/// The pixels of the Image are kept.
+/// </summary>
+/// <param name="pool">The ImagePool.</param>
+/// <param name="image">The Image.</param>
+/// <param name="extent">The size the Image will be resized to.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_ImagePool_Reserve(TREE_ImagePool* pool, TREE_Image* image, TREE_Extent extent);
+
+/// <summary>
+/// Moves the memory of the given Image into the given ImagePool, leaving the Image empty.
+/// </summary>
+/// <param name="pool">The ImagePool.</param>
+/// <param name="image">The Image.</param>
+TREE_EXTERN void TREE_ImagePool_Release(TREE_ImagePool* pool, TREE_Image* image);
+
+///////////////////////////////////////
+// Image File                        //
+///////////////////////////////////////
+
+/// <summary>
+/// The version of the .treeimg files that are saved and can be loaded.
+/// </summary>
+#define TREE_IMAGE_FILE_VERSION 1
+
+/// <summary>
+/// An Image loaded from a .treeimg file, by mapping the file into memory instead of copying it.
+/// </summary>
+typedef struct _TREE_ImageFile
+{
+	/// <summary>
+	/// The Image, with its text and ColorPairs within the mapped file.
+	/// It can be drawn to, but the changes are never written back to the file. It must not be resized or freed.
+	/// </summary>
+	TREE_Image image;
+
+	/// <summary>
+	/// The start of the mapped file.
+	/// </summary>
+	TREE_Data data;
+
+	/// <summary>
+	/// The size of the mapped file in bytes.
+	/// </summary>
+	TREE_Size size;
+} TREE_ImageFile;
+
+/// <summary>
+/// Saves the given Image to a .treeimg file at the given path.
+/// The file starts with a 16 byte header: "TREEIMG", the version byte, and the width and height as 4 byte little endian integers.
+/// The text follows, with its null terminator, then the ColorPairs, both laid out exactly as in the Image.
+/// </summary>
+/// <param name="image">The Image.</param>
+/// <param name="path">The path to the file.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Image_Save(TREE_Image const* image, TREE_String path);
+
+/// <summary>
+/// Loads the .treeimg file at the given path, without copying its pixels.
+/// </summary>
+/// <param name="file">The ImageFile.</param>
+/// <param name="path">The path to the file.</param>
+/// <returns>A TREE_Result code. TREE_ERROR_FILE_READ if the file is not a .treeimg file of this version.</returns>
+TREE_EXTERN TREE_Result TREE_ImageFile_Load(TREE_ImageFile* file, TREE_String path);
+
+/// <summary>
+/// Frees the given ImageFile. Its Image can no longer be used.
+/// </summary>
+/// <param name="file">The ImageFile.</param>
+TREE_EXTERN void TREE_ImageFile_Free(TREE_ImageFile* file);
+
 ///////////////////////////////////////
 // Surface                           //
 ///////////////////////////////////////
 
+/// <summary>
+/// Optional escape sequences that a Surface may use to print less text.
+/// </summary>
+typedef enum _TREE_SurfaceFeatureFlags
+{
+	/// <summary>
+	/// Only cursor movements, colors and characters are printed.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_NONE = 0x0,
+
+	/// <summary>
+	/// Runs of spaces are erased with the background color (ECH and EL). Requires a terminal that erases with the current background color.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_ERASE = 0x1,
+
+	/// <summary>
+	/// Runs of the same character are printed once and repeated (REP).
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_REPEAT = 0x2,
+
+	/// <summary>
+	/// Rows that moved up or down are scrolled inside a scroll region (DECSTBM with SU and SD), instead of being printed again.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_SCROLL = 0x4,
+
+	/// <summary>
+	/// Scroll regions narrower than the terminal use left and right margins (DECLRMM and DECSLRM). Without this, only scrolling that spans whole rows is used.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_MARGINS = 0x8,
+
+	/// <summary>
+	/// Each frame is wrapped in synchronized output mode (DEC private mode 2026), so that the terminal shows it all at once.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_SYNCHRONIZE = 0x10,
+
+	/// <summary>
+	/// The features used by default.
+	/// </summary>
+	TREE_SURFACE_FEATURE_FLAGS_DEFAULT = 0x7,
+} TREE_SurfaceFeatureFlags;
+
 /// <summary>
 /// The final Image that can be printed to the terminal.
 /// </summary>
@@ -827,10 +1150,77 @@ typedef struct _TREE_Surface
 	/// </summary>
 	TREE_Image image;
 
+	/// <summary>
+	/// The Image that is currently shown in the terminal. Only the cells that differ from it are printed.
+	/// </summary>
+	TREE_Image front;
+
+	/// <summary>
+	/// The optional escape sequences the terminal supports.
+	/// </summary>
+	TREE_SurfaceFeatureFlags features;
+
+	/// <summary>
+	/// If true, the front Image does not match the terminal, and the whole Surface is printed on the next refresh.
+	/// </summary>
+	TREE_Bool invalid;
+
+	/// <summary>
+	/// The first damaged column of each row. The row is not damaged if this is not less than the damage end.
+	/// </summary>
+	TREE_Int* damageStart;
+
+	/// <summary>
+	/// The column after the last damaged column of each row.
+	/// </summary>
+	TREE_Int* damageEnd;
+
+	/// <summary>
+	/// Scratch space for comparing rows when looking for scrolled content. The hashes of the Image rows, followed by the hashes of the front Image rows.
+	/// </summary>
+	TREE_Size* rowHashes;
+
 	/// <summary>
 	/// The final printable String.
 	/// </summary>
 	TREE_Char* text;
+
+	/// <summary>
+	/// The length of the text, not including the null terminator.
+	/// </summary>
+	TREE_Size textSize;
+
+	/// <summary>
+	/// The allocated size of the text. Large enough for any frame of the current size, so it is reused between frames.
+	/// </summary>
+	TREE_Size textCapacity;
+
+	/// <summary>
+	/// How much of the text has been written to the terminal.
+	/// </summary>
+	TREE_Size textWritten;
+
+	/// <summary>
+	/// True while TREE_Window_Present has only written part of the text, because the terminal was busy.
+	/// </summary>
+	TREE_Bool writing;
+
+	/// <summary>
+	/// The number of frames that were not written, because the terminal was still busy with an earlier frame.
+	/// </summary>
+	TREE_Size droppedFrames;
+
+	/// <summary>
+	/// The number of written frames that also carried the changes of dropped frames.
+	/// A frame is counted once, when it is encoded, no matter how many dropped frames it carries.
+	/// Frames handed to the presenter thread of an Application are counted the same way, once that thread wrote them.
+	/// </summary>
+	TREE_Size coalescedFrames;
+
+	/// <summary>
+	/// True when frames were dropped since the last written frame.
+	/// </summary>
+	TREE_Bool framesDropped;
 } TREE_Surface;
 
 /// <summary>
@@ -850,11 +1240,30 @@ TREE_EXTERN void TREE_Surface_Free(TREE_Surface* surface);
 
 /// <summary>
 /// Refreshes the given Surface. After this operation, the text field will be updated.
+/// The text only contains the cursor movements and cells needed to turn the front Image into the Image,
+/// within the areas marked with TREE_Surface_Damage. The damage is cleared afterwards.
+/// If the previous text is still being written, the frame is dropped instead, and its damage is kept for the next refresh.
 /// </summary>
 /// <param name="surface">The Surface.</param>
 /// <returns></returns>
 TREE_EXTERN TREE_Result TREE_Surface_Refresh(TREE_Surface* surface);
 
+/// <summary>
+/// Marks the given area of the Surface as changed, so that it is checked on the next refresh.
+/// </summary>
+/// <param name="surface">The Surface.</param>
+/// <param name="rect">The changed area.</param>
+/// <returns></returns>
+TREE_EXTERN TREE_Result TREE_Surface_Damage(TREE_Surface* surface, TREE_Rect const* rect);
+
+/// <summary>
+/// Marks the front Image of the given Surface as out of sync with the terminal, so that the whole Surface is printed on the next refresh.
+/// Use this after something else has written to the terminal.
+/// </summary>
+/// <param name="surface">The Surface.</param>
+/// <returns></returns>
+TREE_EXTERN TREE_Result TREE_Surface_Invalidate(TREE_Surface* surface);
+
 ///////////////////////////////////////
 // Window                            //
 ///////////////////////////////////////
@@ -868,17 +1277,49 @@ TREE_EXTERN TREE_Result TREE_Window_SetTitle(TREE_String title);
 
 /// <summary>
 /// Presents the given Surface to the terminal.
+/// With non-blocking output, only what the terminal accepts right away is written, and the next call continues where this one stopped.
+/// Once that frame is written, the changes of any frames dropped meanwhile are refreshed and written too.
 /// </summary>
 /// <param name="surface">The Surface.</param>
 /// <returns></returns>
 TREE_EXTERN TREE_Result TREE_Window_Present(TREE_Surface* surface);
 
+/// <summary>
+/// Checks if part of the text of the given Surface is still waiting to be written to the terminal.
+/// </summary>
+/// <param name="surface">The Surface.</param>
+/// <returns>True if the last frame was only partially written.</returns>
+TREE_EXTERN TREE_Bool TREE_Window_IsPresenting(TREE_Surface const* surface);
+
+/// <summary>
+/// Writes the rest of a partially written frame of the given Surface, waiting for the terminal to accept it.
+/// </summary>
+/// <param name="surface">The Surface.</param>
+/// <param name="timeout">The longest time to wait in milliseconds, or a negative number to wait until the frame is written.</param>
+/// <returns></returns>
+TREE_EXTERN TREE_Result TREE_Window_Flush(TREE_Surface* surface, TREE_Time timeout);
+
+/// <summary>
+/// Sets whether writing to the terminal may block. With non-blocking output, a slow terminal gets the newest frame once it catches up,
+/// instead of every frame in between. Only supported on Linux. Blocking output is restored by TREE_Free.
+/// </summary>
+/// <param name="nonBlocking">True to stop writes from blocking.</param>
+/// <returns></returns>
+TREE_EXTERN TREE_Result TREE_Window_SetNonBlocking(TREE_Bool nonBlocking);
+
 /// <summary>
 /// Gets the current Extent of the Window.
+/// On Linux, once TREE is initialized, the Extent is cached and only queried again after the terminal is resized.
 /// </summary>
-/// <returns>The Extent of the terminal.</returns>
+/// <returns>The Extent of the terminal, or an empty Extent if the output is not a terminal.</returns>
 TREE_EXTERN TREE_Extent TREE_Window_GetExtent();
 
+/// <summary>
+/// Checks if the terminal supports synchronized output (DEC private mode 2026). Determined in TREE_Init.
+/// </summary>
+/// <returns>True if frames can be wrapped in synchronized output mode.</returns>
+TREE_EXTERN TREE_Bool TREE_Window_SupportsSynchronizedOutput();
+
 /// <summary>
 /// Produces a beep sound in the terminal.
 /// </summary>
@@ -1133,45 +1574,145 @@ TREE_EXTERN TREE_Char TREE_Key_ToChar(TREE_Key key, TREE_KeyModifierFlags modifi
 typedef enum _TREE_InputState
 {
 	/// <summary>
-	/// The input is not pressed.
+	/// The input is not pressed.
+	/// </summary>
+	TREE_INPUT_STATE_RELEASED = 0,
+
+	/// <summary>
+	/// The input is being held down.
+	/// </summary>
+	TREE_INPUT_STATE_HELD = 1,
+
+	/// <summary>
+	/// The input is first pressed.
+	/// </summary>
+	TREE_INPUT_STATE_PRESSED = 2,
+
+	/// <summary>
+	/// Number of ticks before the key is in "held" state.
+	/// No longer used, the repeat is timed with the repeatDelay of the Input.
+	/// </summary>
+	TREE_INPUT_STATE_COOLDOWN = 10,
+} TREE_InputState;
+
+/// <summary>
+/// The most changes that TREE_Input_Refresh keeps in one refresh.
+/// </summary>
+#define TREE_INPUT_DELTA_CAPACITY 128
+
+/// <summary>
+/// The default time, in milliseconds, that a key is held before it repeats.
+/// </summary>
+#define TREE_INPUT_REPEAT_DELAY 500
+
+/// <summary>
+/// The default time, in milliseconds, between the repeats of a held key.
+/// </summary>
+#define TREE_INPUT_REPEAT_INTERVAL 50
+
+/// <summary>
+/// A change to the state of a key.
+/// </summary>
+typedef struct _TREE_InputDelta
+{
+	/// <summary>
+	/// The key that changed.
+	/// </summary>
+	TREE_Key key;
+
+	/// <summary>
+	/// The new state: TREE_INPUT_STATE_PRESSED when pressed, TREE_INPUT_STATE_HELD when repeated,
+	/// and TREE_INPUT_STATE_RELEASED when released.
+	/// </summary>
+	TREE_InputState state;
+
+	/// <summary>
+	/// The active modifier keys, at the time of the change.
+	/// </summary>
+	TREE_KeyModifierFlags modifiers;
+
+	/// <summary>
+	/// The time of the change, in milliseconds, as reported by the input device when it can.
+	/// </summary>
+	TREE_Time time;
+
+	/// <summary>
+	/// The time of the change, from TREE_Time_NowMicroseconds, as reported by the input device when it can.
+	/// 0 if it is not known, such as for replayed changes.
+	/// </summary>
+	TREE_Microseconds sourceTime;
+} TREE_InputDelta;
+
+/// <summary>
+/// The Input state data.
+/// </summary>
+typedef struct _TREE_Input
+{
+	/// <summary>
+	/// The keys being monitored.
+	/// </summary>
+	TREE_Key keys[TREE_KEY_COUNT];
+
+	/// <summary>
+	/// The states of the keys.
+	/// </summary>
+	TREE_Byte states[TREE_KEY_MAX+1];
+
+	/// <summary>
+	/// The active modifier keys.
+	/// </summary>
+	TREE_KeyModifierFlags modifiers;
+
+	/// <summary>
+	/// The longest time, in milliseconds, that TREE_Input_Refresh waits for new input.
+	/// </summary>
+	TREE_Time timeout;
+
+	/// <summary>
+	/// The time, in milliseconds, that a key is held before it repeats.
+	/// </summary>
+	TREE_Time repeatDelay;
+
+	/// <summary>
+	/// The time, in milliseconds, between the repeats of a held key.
 	/// </summary>
-	TREE_INPUT_STATE_RELEASED = 0,
+	TREE_Time repeatInterval;
 
 	/// <summary>
-	/// The input is being held down.
+	/// The time of the next repeat of each held key.
 	/// </summary>
-	TREE_INPUT_STATE_HELD = 1,
+	TREE_Time repeatTimes[TREE_KEY_MAX+1];
 
 	/// <summary>
-	/// The input is first pressed.
+	/// The keys being held down.
 	/// </summary>
-	TREE_INPUT_STATE_PRESSED = 2,
+	TREE_Key heldKeys[TREE_KEY_COUNT];
 
 	/// <summary>
-	/// Number of ticks before the key is in "held" state.
+	/// The number of keys being held down.
 	/// </summary>
-	TREE_INPUT_STATE_COOLDOWN = 10,
-} TREE_InputState;
+	TREE_Size heldCount;
 
-/// <summary>
-/// The Input state data.
-/// </summary>
-typedef struct _TREE_Input
-{
 	/// <summary>
-	/// The keys being monitored.
+	/// The key changes found by the last TREE_Input_Refresh, in order.
 	/// </summary>
-	TREE_Key keys[TREE_KEY_COUNT];
+	TREE_InputDelta deltas[TREE_INPUT_DELTA_CAPACITY];
 
 	/// <summary>
-	/// The states of the keys.
+	/// The number of key changes found by the last TREE_Input_Refresh.
 	/// </summary>
-	TREE_Byte states[TREE_KEY_MAX+1];
+	TREE_Size deltaCount;
 
 	/// <summary>
-	/// The active modifier keys.
+	/// The text pasted since the last TREE_Input_Refresh, or NULL if there is none.
+	/// Where it was pasted is listed in the deltas as a change of TREE_KEY_NONE.
 	/// </summary>
-	TREE_KeyModifierFlags modifiers;
+	TREE_Char* pasteText;
+
+	/// <summary>
+	/// The length of the pasted text.
+	/// </summary>
+	TREE_Size pasteSize;
 } TREE_Input;
 
 /// <summary>
@@ -1189,11 +1730,48 @@ TREE_EXTERN void TREE_Input_Free(TREE_Input* input);
 
 /// <summary>
 /// Updates the given Input with the current state of the keyboard.
+/// The changes since the last refresh, including the repeats of held keys, are listed in the deltas of the Input.
 /// </summary>
 /// <param name="input">The Input.</param>
 /// <returns>A TREE_Result code.</returns>
 TREE_EXTERN TREE_Result TREE_Input_Refresh(TREE_Input* input);
 
+/// <summary>
+/// Where TREE_Input_Refresh reads the keys from.
+/// </summary>
+typedef enum _TREE_InputBackend
+{
+	/// <summary>
+	/// Use the keyboard if one can be opened, and the session is not remote. Otherwise, use the terminal.
+	/// </summary>
+	TREE_INPUT_BACKEND_AUTOMATIC = 0,
+
+	/// <summary>
+	/// Read the state of the keyboard itself. On Linux, this needs access to the keyboard device.
+	/// </summary>
+	TREE_INPUT_BACKEND_KEYBOARD = 1,
+
+	/// <summary>
+	/// Read the keys the terminal sends through the standard input. Works over SSH.
+	/// Terminals that support the kitty keyboard protocol report presses and releases,
+	/// others only report typed keys, which count as pressed until the next refresh.
+	/// </summary>
+	TREE_INPUT_BACKEND_TERMINAL = 2,
+} TREE_InputBackend;
+
+/// <summary>
+/// Sets where the keys are read from. Must be called before TREE_Init. TREE_Free sets it back to TREE_INPUT_BACKEND_AUTOMATIC.
+/// </summary>
+/// <param name="backend">The input backend.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Input_SetBackend(TREE_InputBackend backend);
+
+/// <summary>
+/// Gets where the keys are read from. After TREE_Init, this is the backend in use.
+/// </summary>
+/// <returns>The input backend.</returns>
+TREE_EXTERN TREE_InputBackend TREE_Input_GetBackend();
+
 ///////////////////////////////////////
 // Direction                         //
 ///////////////////////////////////////
@@ -1333,6 +1911,11 @@ typedef enum _TREE_EventType
 	/// Window resize Event.
 	/// </summary>
 	TREE_EVENT_TYPE_WINDOW_RESIZE,
+
+	/// <summary>
+	/// Paste Event, for text pasted into the terminal all at once.
+	/// </summary>
+	TREE_EVENT_TYPE_PASTE,
 } TREE_EventType;
 
 typedef struct _TREE_Application TREE_Application;
@@ -1375,7 +1958,7 @@ typedef TREE_Result(*TREE_EventHandler)(TREE_Event const* event);
 typedef struct _TREE_EventData_Draw
 {
 	/// <summary>
-	/// The target Image to draw to.
+	/// The target Image to draw to. It holds the Layer of the Control, drawn over the Layers below it.
 	/// </summary>
 	TREE_Image* target;
 
@@ -1383,6 +1966,11 @@ typedef struct _TREE_EventData_Draw
 	/// The target Rect to draw within.
 	/// </summary>
 	TREE_Rect dirtyRect;
+
+	/// <summary>
+	/// The area of the target the Control covers, clipped to the dirty Rect. Drawing to it draws straight into the target.
+	/// </summary>
+	TREE_ImageView view;
 } TREE_EventData_Draw;
 
 /// <summary>
@@ -1399,8 +1987,29 @@ typedef struct _TREE_EventData_Key
 	/// The active modifier flags.
 	/// </summary>
 	TREE_KeyModifierFlags modifiers;
+
+	/// <summary>
+	/// The time that the key changed states, in milliseconds.
+	/// </summary>
+	TREE_Time time;
 } TREE_EventData_Key;
 
+/// <summary>
+/// Paste Event data.
+/// </summary>
+typedef struct _TREE_EventData_Paste
+{
+	/// <summary>
+	/// The pasted text, with its line endings as '\n'.
+	/// </summary>
+	TREE_String text;
+
+	/// <summary>
+	/// The length of the pasted text.
+	/// </summary>
+	TREE_Size length;
+} TREE_EventData_Paste;
+
 /// <summary>
 /// Window resize Event data.
 /// </summary>
@@ -1518,6 +2127,38 @@ TREE_EXTERN TREE_Result TREE_Transform_DisconnectChildren(TREE_Transform* transf
 /// <returns></returns>
 TREE_EXTERN TREE_Result TREE_Transform_Refresh(TREE_Transform* transform, TREE_Extent windowExtent);
 
+///////////////////////////////////////
+// Layer                             //
+///////////////////////////////////////
+
+/// <summary>
+/// The layers that Controls are drawn on. Higher layers are drawn over lower ones.
+/// </summary>
+typedef enum _TREE_Layer
+{
+	/// <summary>
+	/// Regular Controls.
+	/// </summary>
+	TREE_LAYER_BASE = 0,
+
+	/// <summary>
+	/// Popups, such as open Dropdowns. Active Controls are drawn on at least this layer.
+	/// </summary>
+	TREE_LAYER_POPUP,
+
+	/// <summary>
+	/// Overlays, such as dialogs, drawn over popups.
+	/// </summary>
+	TREE_LAYER_OVERLAY,
+
+	/// <summary>
+	/// Short notifications, drawn over everything else.
+	/// </summary>
+	TREE_LAYER_TOAST,
+
+	TREE_LAYER_COUNT
+} TREE_Layer;
+
 ///////////////////////////////////////
 // Control                           //
 ///////////////////////////////////////
@@ -1587,6 +2228,11 @@ typedef enum _TREE_ControlFlags
 	/// The Control is able to be focused.
 	/// </summary>
 	TREE_CONTROL_FLAGS_FOCUSABLE = 0x1,
+
+	/// <summary>
+	/// The Control draws straight into the target of the draw Event, through its view, instead of into its own Image first.
+	/// </summary>
+	TREE_CONTROL_FLAGS_DRAW_DIRECT = 0x2,
 } TREE_ControlFlag;
 
 /// <summary>
@@ -1680,6 +2326,16 @@ typedef struct _TREE_Control
 	/// The data for this Control.
 	/// </summary>
 	TREE_Data data;
+
+	/// <summary>
+	/// The Layer this Control is drawn on.
+	/// </summary>
+	TREE_Layer layer;
+
+	/// <summary>
+	/// The Layer this Control was last drawn on by the Application.
+	/// </summary>
+	TREE_Layer drawnLayer;
 } TREE_Control;
 
 /// <summary>
@@ -1703,6 +2359,21 @@ TREE_EXTERN TREE_Result TREE_Control_Init(TREE_Control* control, TREE_Transform*
 /// <param name="control">The Control.</param>
 TREE_EXTERN void TREE_Control_Free(TREE_Control* control);
 
+/// <summary>
+/// Sets the Layer the given Control is drawn on.
+/// </summary>
+/// <param name="control">The Control.</param>
+/// <param name="layer">The Layer.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Control_SetLayer(TREE_Control* control, TREE_Layer layer);
+
+/// <summary>
+/// Gets the Layer the given Control is drawn on. An active Control is drawn on at least the popup Layer.
+/// </summary>
+/// <param name="control">The Control.</param>
+/// <returns>The Layer.</returns>
+TREE_EXTERN TREE_Layer TREE_Control_GetLayer(TREE_Control const* control);
+
 /// <summary>
 /// Links two Controls together for navigation. Required in order to navigate from one Control to another with the keyboard.
 /// </summary>
@@ -3016,6 +3687,52 @@ TREE_EXTERN TREE_Result TREE_Control_ProgressBar_EventHandler(TREE_Event const*
 // Application                       //
 ///////////////////////////////////////
 
+/// <summary>
+/// Encodes and writes frames on a separate thread.
+/// </summary>
+typedef struct _TREE_Presenter TREE_Presenter;
+
+/// <summary>
+/// Waits for input, signals, timers and wakeups all at once.
+/// </summary>
+typedef struct _TREE_EventLoop TREE_EventLoop;
+
+/// <summary>
+/// A file of key changes, being written while recording or read while replaying.
+/// </summary>
+typedef struct _TREE_InputRecording TREE_InputRecording;
+
+/// <summary>
+/// Determines how an Application replays a recording.
+/// </summary>
+typedef enum _TREE_ReplayFlags
+{
+	/// <summary>
+	/// Replay the key changes as far apart as they were recorded, then go back to reading the keyboard.
+	/// </summary>
+	TREE_REPLAY_FLAGS_NONE = 0x0,
+
+	/// <summary>
+	/// Replay the key changes as fast as the Application can draw them. Each frame gets the key changes of one frame interval of the recording.
+	/// </summary>
+	TREE_REPLAY_FLAGS_MAXIMUM_SPEED = 0x1,
+
+	/// <summary>
+	/// Quit the Application once the last key change of the recording has been drawn.
+	/// </summary>
+	TREE_REPLAY_FLAGS_QUIT = 0x2,
+} TREE_ReplayFlags;
+
+/// <summary>
+/// The most key changes an Application holds between two frames.
+/// </summary>
+#define TREE_APPLICATION_INPUT_CAPACITY 256
+
+/// <summary>
+/// The number of frames an Application keeps the input latency of.
+/// </summary>
+#define TREE_APPLICATION_LATENCY_CAPACITY 128
+
 /// <summary>
 /// Maintains and manages the state of an application.
 /// </summary>
@@ -3061,12 +3778,162 @@ typedef struct _TREE_Application
 	/// </summary>
 	TREE_Surface* surface;
 
+	/// <summary>
+	/// The memory of Control Images that are not in use, such as those of Controls that were cleared.
+	/// </summary>
+	TREE_ImagePool imagePool;
+
 	/// <summary>
 	/// True when the entire surface should be redrawn on next refresh.
 	/// </summary>
 	TREE_Bool forceRedraw;
+
+	/// <summary>
+	/// The areas of the Surface to redraw on the next refresh. Kept separate, so that far apart changes do not redraw everything in between.
+	/// </summary>
+	TREE_Rect* dirtyRects;
+
+	/// <summary>
+	/// The number of dirty areas.
+	/// </summary>
+	TREE_Size dirtyRectsSize;
+
+	/// <summary>
+	/// The maximum number of dirty areas. Any more are combined with the last one.
+	/// </summary>
+	TREE_Size dirtyRectsCapacity;
+
+	/// <summary>
+	/// The lowest Layer that changed within each dirty area. Only it and the Layers above it are drawn again there.
+	/// </summary>
+	TREE_Layer* dirtyLayers;
+
+	/// <summary>
+	/// The Surface as drawn up to and including each Layer, except for the top Layer, which is the Surface Image itself.
+	/// </summary>
+	TREE_Image layers[TREE_LAYER_COUNT - 1];
+
+	/// <summary>
+	/// The Layers that were last drawn, one bit per TREE_Layer. Only these have Controls on them, and only the Images of these are kept in layers.
+	/// </summary>
+	TREE_Byte occupiedLayers;
+
+	/// <summary>
+	/// The shortest time between two frames, in milliseconds. All updates within this time are drawn and presented together.
+	/// </summary>
+	TREE_Time frameInterval;
+
+	/// <summary>
+	/// The time the last frame was presented.
+	/// </summary>
+	TREE_Time lastFrameTime;
+
+	/// <summary>
+	/// The Extent the window was last resized to, while waiting for it to settle.
+	/// </summary>
+	TREE_Extent resizeExtent;
+
+	/// <summary>
+	/// The time the window was last resized, or 0 if no resize is waiting.
+	/// </summary>
+	TREE_Time resizeTime;
+
+	/// <summary>
+	/// The key changes waiting to be dispatched with the next frame, in a ring, oldest first.
+	/// A repeat is dropped if its key already has one waiting.
+	/// </summary>
+	TREE_InputDelta inputEvents[TREE_APPLICATION_INPUT_CAPACITY];
+
+	/// <summary>
+	/// The index of the oldest waiting key change.
+	/// </summary>
+	TREE_Size inputEventsStart;
+
+	/// <summary>
+	/// The number of waiting key changes.
+	/// </summary>
+	TREE_Size inputEventsSize;
+
+	/// <summary>
+	/// The time, from TREE_Time_NowMicroseconds, each key change in inputEvents happened, or was taken by the Application if that is not known.
+	/// </summary>
+	TREE_Microseconds inputEventTimes[TREE_APPLICATION_INPUT_CAPACITY];
+
+	/// <summary>
+	/// The text pasted by each key change in inputEvents, or NULL if it is not a paste.
+	/// </summary>
+	TREE_Char* inputEventTexts[TREE_APPLICATION_INPUT_CAPACITY];
+
+	/// <summary>
+	/// The length of each text in inputEventTexts.
+	/// </summary>
+	TREE_Size inputEventTextSizes[TREE_APPLICATION_INPUT_CAPACITY];
+
+	/// <summary>
+	/// The time, from TREE_Time_NowMicroseconds, the oldest key change dispatched for the frame being drawn happened, or 0 if there is none.
+	/// </summary>
+	TREE_Microseconds frameInputTime;
+
+	/// <summary>
+	/// The time, from TREE_Time_NowMicroseconds, the oldest key change shown by the frame being written was taken, or 0 if there is none.
+	/// </summary>
+	TREE_Microseconds presentInputTime;
+
+	/// <summary>
+	/// The time, in microseconds, from the oldest key change shown by a frame until that frame was written, for the latest frames, in a ring.
+	/// </summary>
+	TREE_Microseconds inputLatencies[TREE_APPLICATION_LATENCY_CAPACITY];
+
+	/// <summary>
+	/// The number of input latencies measured.
+	/// </summary>
+	TREE_Size inputLatencyCount;
+
+	/// <summary>
+	/// If true, frames are encoded and written to the terminal on a separate thread, so a slow terminal does not hold up input and events.
+	/// When that thread falls behind, it skips to the newest frame. Set before calling TREE_Application_Run.
+	/// Nothing else should write to the terminal while the Application is running.
+	/// </summary>
+	TREE_Bool backgroundPresent;
+
+	/// <summary>
+	/// The presenter thread, while running with backgroundPresent.
+	/// </summary>
+	TREE_Presenter* presenter;
+
+	/// <summary>
+	/// What the main loop sleeps on between frames, while running.
+	/// </summary>
+	TREE_EventLoop* eventLoop;
+
+	/// <summary>
+	/// The recording the key changes are written to, or NULL if not recording.
+	/// </summary>
+	TREE_InputRecording* recording;
+
+	/// <summary>
+	/// The recording the key changes are read from instead of the keyboard, or NULL if not replaying.
+	/// </summary>
+	TREE_InputRecording* replay;
+
+	/// <summary>
+	/// If true, the Application does not use the terminal. It draws and encodes frames into its Surface without writing them anywhere,
+	/// the Surface keeps the size it was created with, and the keys come only from TREE_Application_PushInput or a replay.
+	/// Set by TREE_Application_InitHeadless.
+	/// </summary>
+	TREE_Bool headless;
 } TREE_Application;
 
+/// <summary>
+/// The default number of frames an Application presents per second.
+/// </summary>
+#define TREE_APPLICATION_FRAME_RATE 60
+
+/// <summary>
+/// How long, in milliseconds, the window has to keep the same size before an Application resizes to it.
+/// </summary>
+#define TREE_APPLICATION_RESIZE_DELAY 50
+
 /// <summary>
 /// Initializes the given Application with the specified capacity and event handler.
 /// </summary>
@@ -3076,6 +3943,17 @@ typedef struct _TREE_Application
 /// <returns>A TREE_Result code.</returns>
 TREE_EXTERN TREE_Result TREE_Application_Init(TREE_Application* application, TREE_Size capacity, TREE_EventHandler eventHandler);
 
+/// <summary>
+/// Initializes the given Application without a terminal, drawing into a Surface of the given size.
+/// Does not need TREE_Init, a terminal, or access to the keyboard. The background presenter is not used.
+/// </summary>
+/// <param name="application">The Application to initialize.</param>
+/// <param name="capacity">The maximum number of Controls the Application can hold.</param>
+/// <param name="eventHandler">The EventHandler for the Application.</param>
+/// <param name="extent">The size of the Surface.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_InitHeadless(TREE_Application* application, TREE_Size capacity, TREE_EventHandler eventHandler, TREE_Extent extent);
+
 /// <summary>
 /// Disposes of the given Application and its resources.
 /// </summary>
@@ -3093,6 +3971,7 @@ TREE_EXTERN TREE_Result TREE_Application_AddControl(TREE_Application* applicatio
 /// <summary>
 /// Removes all controls from the given Application without freeing the controls themselves.
 /// Useful for implementing page/screen switching at runtime.
+/// The memory of their Images is kept by the Application for the Controls that are added next, and they are refreshed again if re-added.
 /// </summary>
 /// <param name="application">The Application to clear controls from.</param>
 /// <returns>A TREE_Result code.</returns>
@@ -3121,10 +4000,93 @@ TREE_EXTERN TREE_Result TREE_Application_DispatchEvent(TREE_Application* applica
 /// <returns>A TREE_Result code.</returns>
 TREE_EXTERN TREE_Result TREE_Application_Run(TREE_Application* application);
 
+/// <summary>
+/// Runs one frame of the given Application, without waiting: reads the input, dispatches the key events,
+/// then draws and presents the Controls that changed. Ignores the frame rate.
+/// Cannot be called while the Application is running.
+/// </summary>
+/// <param name="application">The Application to step.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_Step(TREE_Application* application);
+
+/// <summary>
+/// Gives the given Application a key change, as if it was read from the Input. It is dispatched with the next frame.
+/// </summary>
+/// <param name="application">The Application.</param>
+/// <param name="delta">The key change. A time or source time of 0 uses the current time.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_PushInput(TREE_Application* application, TREE_InputDelta const* delta);
+
+/// <summary>
+/// Gives the given Application pasted text, as if it was read from the Input. It is dispatched with the next frame, after the key changes pushed before it.
+/// </summary>
+/// <param name="application">The Application.</param>
+/// <param name="text">The pasted text, with its line endings as '\n'.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_PushPaste(TREE_Application* application, TREE_String text);
+
+/// <summary>
+/// Limits how often the given Application draws and presents a frame. Updates between frames are combined.
+/// </summary>
+/// <param name="application">The Application.</param>
+/// <param name="framesPerSecond">The most frames per second, or 0 to present every update as soon as possible.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_SetFrameRate(TREE_Application* application, TREE_UInt framesPerSecond);
+
 /// <summary>
 /// Quits the given Application, stopping its main loop.
 /// </summary>
 /// <param name="application">The Application to quit.</param>
 TREE_EXTERN void TREE_Application_Quit(TREE_Application* application);
 
+/// <summary>
+/// Wakes up the main loop of the given Application, so that it checks for updates right away.
+/// Can be called from any thread while the Application is running.
+/// </summary>
+/// <param name="application">The Application to wake up.</param>
+TREE_EXTERN void TREE_Application_Wake(TREE_Application* application);
+
+/// <summary>
+/// Gets a percentile of the input latency of the given Application, over its latest frames.
+/// The input latency is the time from the oldest key change a frame shows until the frame is written to the terminal.
+/// Keys read from the keyboard are timed when the kernel saw them, other key changes when they were read or pushed.
+/// </summary>
+/// <param name="application">The Application.</param>
+/// <param name="percentile">The percentile, from 0 to 100.</param>
+/// <returns>The input latency in microseconds, or -1 if no frame has shown a key change yet.</returns>
+TREE_EXTERN TREE_Microseconds TREE_Application_GetInputLatency(TREE_Application const* application, TREE_Float percentile);
+
+/// <summary>
+/// Starts writing the key changes of the given Application to a file, as they are read: the key, its state, the modifiers, the time and any pasted text.
+/// The file can be replayed with TREE_Application_StartReplay.
+/// </summary>
+/// <param name="application">The Application to record.</param>
+/// <param name="path">The path of the file to write. An existing file is overwritten.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_StartRecording(TREE_Application* application, TREE_String path);
+
+/// <summary>
+/// Stops recording the given Application, and closes the file.
+/// </summary>
+/// <param name="application">The Application to stop recording.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_StopRecording(TREE_Application* application);
+
+/// <summary>
+/// Starts feeding the given Application the key changes from a recording, instead of the keyboard.
+/// The replay starts with the next input the Application reads.
+/// </summary>
+/// <param name="application">The Application to replay to.</param>
+/// <param name="path">The path of the recording.</param>
+/// <param name="flags">How to replay the recording.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_StartReplay(TREE_Application* application, TREE_String path, TREE_ReplayFlags flags);
+
+/// <summary>
+/// Stops replaying to the given Application, and goes back to reading the keyboard.
+/// </summary>
+/// <param name="application">The Application to stop replaying to.</param>
+/// <returns>A TREE_Result code.</returns>
+TREE_EXTERN TREE_Result TREE_Application_StopReplay(TREE_Application* application);
+
 #endif // __TREE_H__
\ No newline at end of file
@@ -1,9 +1,1284 @@
 ﻿#include "TREE.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// finds the first differing cell one cell at a time, to compare against
+TREE_Size FindDifference_Naive(TREE_Image const* image, TREE_Image const* other, TREE_Size start, TREE_Size end)
+{
+	for (TREE_Size i = start; i < end; ++i)
+	{
+		if (image->text[i] != other->text[i] || image->colors[i] != other->colors[i])
+		{
+			return i;
+		}
+	}
+	return end;
+}
+
+int Benchmark_FindDifference()
+{
+	TREE_Extent extent = { 400, 120 };
+	TREE_Size pixelCount = (TREE_Size)(extent.width * extent.height);
+	int iterations = 2000;
+
+	TREE_Image image, other;
+	if (TREE_Image_Init(&image, extent) || TREE_Image_Init(&other, extent))
+	{
+		printf("Failed to create benchmark images.\n");
+		return 1;
+	}
+
+	// a mostly unchanged frame, with a few changes near the end of some rows
+	TREE_Pixel pixel = { ' ', TREE_ColorPair_Create(TREE_COLOR_WHITE, TREE_COLOR_BLACK) };
+	TREE_Image_Clear(&image, pixel);
+	TREE_Image_Clear(&other, pixel);
+	for (TREE_Int y = 0; y < extent.height; y += 7)
+	{
+		other.text[y * extent.width + extent.width - 3] = '#';
+	}
+	for (TREE_Int y = 3; y < extent.height; y += 11)
+	{
+		other.colors[y * extent.width + y] = TREE_ColorPair_Create(TREE_COLOR_RED, TREE_COLOR_BLACK);
+	}
+
+	// both versions must find the same cells
+	for (TREE_Size start = 0; start < pixelCount; start += 37)
+	{
+		TREE_Size end = start + 5 + start % 700;
+		end = end > pixelCount ? pixelCount : end;
+		if (TREE_Image_FindDifference(&image, &other, start, end) != FindDifference_Naive(&image, &other, start, end))
+		{
+			printf("TREE_Image_FindDifference failed at %llu.\n", start);
+			return 1;
+		}
+	}
+
+	// scan every row of the frame, as the Surface does
+	TREE_Size found = 0;
+	clock_t begin = clock();
+	for (int i = 0; i < iterations; ++i)
+	{
+		for (TREE_Int y = 0; y < extent.height; ++y)
+		{
+			TREE_Size rowIndex = (TREE_Size)(y * extent.width);
+			found += TREE_Image_FindDifference(&image, &other, rowIndex, rowIndex + extent.width);
+		}
+	}
+	double fastSeconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	begin = clock();
+	for (int i = 0; i < iterations; ++i)
+	{
+		for (TREE_Int y = 0; y < extent.height; ++y)
+		{
+			TREE_Size rowIndex = (TREE_Size)(y * extent.width);
+			found -= FindDifference_Naive(&image, &other, rowIndex, rowIndex + extent.width);
+		}
+	}
+	double naiveSeconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	double cells = (double)pixelCount * iterations;
+	printf("FindDifference %dx%d: %.1f Mcells/s (naive: %.1f Mcells/s)\n",
+		extent.width, extent.height,
+		cells / (fastSeconds > 0.0 ? fastSeconds : 1e-9) / 1e6,
+		cells / (naiveSeconds > 0.0 ? naiveSeconds : 1e-9) / 1e6);
+
+	TREE_Image_Free(&image);
+	TREE_Image_Free(&other);
+
+	return found != 0;
+}
+
+// fills one cell at a time, to compare against
+void FillRect_Naive(TREE_Image* image, TREE_Rect const* rect, TREE_Pixel pixel)
+{
+	for (TREE_Int y = rect->offset.y; y < rect->offset.y + (TREE_Int)rect->extent.height; ++y)
+	{
+		for (TREE_Int x = rect->offset.x; x < rect->offset.x + (TREE_Int)rect->extent.width; ++x)
+		{
+			TREE_Offset offset = { x, y };
+			TREE_Image_Set(image, offset, pixel);
+		}
+	}
+}
+
+// draws one point at a time, to compare against
+void DrawLine_Naive(TREE_Image* image, TREE_Offset start, TREE_Offset end, TREE_Pattern const* pattern)
+{
+	TREE_Int dx = abs(end.x - start.x);
+	TREE_Int dy = abs(end.y - start.y);
+	TREE_Int sx = start.x < end.x ? 1 : -1;
+	TREE_Int sy = start.y < end.y ? 1 : -1;
+	TREE_Int err = dx - dy;
+	for (TREE_UInt patternIndex = 0;; patternIndex = (patternIndex + 1) % pattern->size)
+	{
+		TREE_Image_Set(image, start, TREE_Pattern_Get(pattern, patternIndex));
+		if (start.x == end.x && start.y == end.y)
+		{
+			break;
+		}
+		TREE_Int e2 = 2 * err;
+		if (e2 > -dy)
+		{
+			err -= dy;
+			start.x += sx;
+		}
+		if (e2 < dx)
+		{
+			err += dx;
+			start.y += sy;
+		}
+	}
+}
+
+int Image_Equals(TREE_Image const* image, TREE_Image const* other)
+{
+	TREE_Size pixelCount = (TREE_Size)(image->extent.width * image->extent.height);
+	return !memcmp(image->text, other->text, pixelCount) && !memcmp(image->colors, other->colors, pixelCount);
+}
+
+int Benchmark_Fill()
+{
+	TREE_Extent extent = { 400, 120 };
+	int iterations = 2000;
+
+	TREE_Image image, other;
+	TREE_Pattern pattern;
+	if (TREE_Image_Init(&image, extent) || TREE_Image_Init(&other, extent) ||
+		TREE_Pattern_InitFromString(&pattern, "-=~", TREE_ColorPair_Create(TREE_COLOR_WHITE, TREE_COLOR_BLACK)))
+	{
+		printf("Failed to create benchmark images.\n");
+		return 1;
+	}
+	pattern.pixels[1].colorPair = TREE_ColorPair_Create(TREE_COLOR_RED, TREE_COLOR_BLACK);
+	TREE_Pixel pixel = { ' ', TREE_ColorPair_Create(TREE_COLOR_WHITE, TREE_COLOR_BLACK) };
+	TREE_Pixel fill = { '#', TREE_ColorPair_Create(TREE_COLOR_BLUE, TREE_COLOR_BLACK) };
+
+	// both versions must draw the same cells, including lines and rects that leave the Image
+	srand(1);
+	for (int i = 0; i < 2000; ++i)
+	{
+		TREE_Image_Clear(&image, pixel);
+		TREE_Image_Clear(&other, pixel);
+		TREE_Offset start = { rand() % (extent.width + 40) - 20, rand() % (extent.height + 40) - 20 };
+		TREE_Offset end = { rand() % (extent.width + 40) - 20, rand() % (extent.height + 40) - 20 };
+		if (i % 3 == 0)
+		{
+			end.y = start.y;
+		}
+		else if (i % 3 == 1)
+		{
+			end.x = start.x;
+		}
+		TREE_Rect rect = { start, { abs(end.x - start.x) + 1, abs(end.y - start.y) + 1 } };
+		TREE_Image_DrawLine(&image, start, end, &pattern);
+		DrawLine_Naive(&other, start, end, &pattern);
+		TREE_Image_FillRect(&image, &rect, fill);
+		FillRect_Naive(&other, &rect, fill);
+		TREE_Image_DrawRect(&image, &rect, &pattern);
+		DrawLine_Naive(&other, rect.offset, (TREE_Offset){ rect.offset.x + rect.extent.width - 1, rect.offset.y }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ rect.offset.x + rect.extent.width - 1, rect.offset.y }, (TREE_Offset){ rect.offset.x + rect.extent.width - 1, rect.offset.y + rect.extent.height - 1 }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ rect.offset.x + rect.extent.width - 1, rect.offset.y + rect.extent.height - 1 }, (TREE_Offset){ rect.offset.x, rect.offset.y + rect.extent.height - 1 }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ rect.offset.x, rect.offset.y + rect.extent.height - 1 }, rect.offset, &pattern);
+		if (!Image_Equals(&image, &other))
+		{
+			printf("TREE_Image fill or line failed at (%d, %d) to (%d, %d).\n", start.x, start.y, end.x, end.y);
+			return 1;
+		}
+	}
+
+	// a panel within the frame, then the outline of the frame
+	TREE_Rect panel = { { 20, 10 }, { 360, 100 } };
+	TREE_Rect frame = { { 0, 0 }, extent };
+	clock_t begin = clock();
+	for (int i = 0; i < iterations; ++i)
+	{
+		TREE_Image_FillRect(&image, &panel, i % 2 ? fill : pixel);
+		TREE_Image_DrawRect(&image, &frame, &pattern);
+	}
+	double fastSeconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	begin = clock();
+	for (int i = 0; i < iterations; ++i)
+	{
+		FillRect_Naive(&other, &panel, i % 2 ? fill : pixel);
+		DrawLine_Naive(&other, (TREE_Offset){ 0, 0 }, (TREE_Offset){ extent.width - 1, 0 }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ extent.width - 1, 0 }, (TREE_Offset){ extent.width - 1, extent.height - 1 }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ extent.width - 1, extent.height - 1 }, (TREE_Offset){ 0, extent.height - 1 }, &pattern);
+		DrawLine_Naive(&other, (TREE_Offset){ 0, extent.height - 1 }, (TREE_Offset){ 0, 0 }, &pattern);
+	}
+	double naiveSeconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	double cells = (double)(panel.extent.width * panel.extent.height + 2 * (extent.width + extent.height)) * iterations;
+	printf("FillRect and DrawRect %dx%d: %.1f Mcells/s (naive: %.1f Mcells/s)\n",
+		extent.width, extent.height,
+		cells / (fastSeconds > 0.0 ? fastSeconds : 1e-9) / 1e6,
+		cells / (naiveSeconds > 0.0 ? naiveSeconds : 1e-9) / 1e6);
+
+	int failed = !Image_Equals(&image, &other);
+	if (failed)
+	{
+		printf("TREE_Image_FillRect or TREE_Image_DrawRect drew a different frame.\n");
+	}
+
+	TREE_Pattern_Free(&pattern);
+	TREE_Image_Free(&image);
+	TREE_Image_Free(&other);
+
+	return failed;
+}
+
+// copies one cell at a time, to compare against
+void DrawImage_Naive(TREE_Image* image, TREE_Offset offset, TREE_Image const* other, TREE_Offset otherOffset, TREE_Extent extent)
+{
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		for (TREE_Int x = 0; x < extent.width; ++x)
+		{
+			TREE_Offset from = { otherOffset.x + x, otherOffset.y + y };
+			TREE_Offset to = { offset.x + x, offset.y + y };
+			if (from.x >= 0 && from.y >= 0 && from.x < other->extent.width && from.y < other->extent.height)
+			{
+				TREE_Image_Set(image, to, TREE_Image_Get((TREE_Image*)other, from));
+			}
+		}
+	}
+}
+
+int Test_ImageView()
+{
+	TREE_Extent extent = { 40, 12 };
+	TREE_Extent otherExtent = { 23, 9 };
+
+	TREE_Image image, other, expected;
+	if (TREE_Image_Init(&image, extent) || TREE_Image_Init(&expected, extent) || TREE_Image_Init(&other, otherExtent))
+	{
+		printf("Failed to create test images.\n");
+		return 1;
+	}
+	for (TREE_Size i = 0; i < (TREE_Size)(otherExtent.width * otherExtent.height); ++i)
+	{
+		other.text[i] = (TREE_Char)('!' + i % 90);
+		other.colors[i] = (TREE_ColorPair)(i % 256);
+	}
+	TREE_Pixel pixel = { '.', TREE_ColorPair_Create(TREE_COLOR_WHITE, TREE_COLOR_BLACK) };
+
+	// parts of a wider source Image, including parts outside of either Image
+	srand(2);
+	for (int i = 0; i < 2000; ++i)
+	{
+		TREE_Offset offset = { rand() % 60 - 10, rand() % 24 - 6 };
+		TREE_Offset otherOffset = { rand() % 33 - 5, rand() % 19 - 5 };
+		TREE_Extent size = { rand() % 30, rand() % 14 };
+		TREE_Image_Clear(&image, pixel);
+		TREE_Image_Clear(&expected, pixel);
+		TREE_Image_DrawImage(&image, offset, &other, otherOffset, size);
+		DrawImage_Naive(&expected, offset, &other, otherOffset, size);
+		if (!Image_Equals(&image, &expected))
+		{
+			printf("TREE_Image_DrawImage failed drawing (%d, %d) %dx%d at (%d, %d).\n", otherOffset.x, otherOffset.y, size.width, size.height, offset.x, offset.y);
+			return 1;
+		}
+	}
+
+	// drawing through a view only changes the cells within it
+	TREE_ImageView view, sub;
+	TREE_Rect area = { { 30, -2 }, { 15, 8 } };
+	TREE_Rect fill = { { -3, 1 }, { 40, 3 } };
+	TREE_Image_Clear(&image, pixel);
+	TREE_ImageView_Init(&view, &image);
+	TREE_ImageView_InitSub(&sub, &view, &area);
+	TREE_ImageView_FillRect(&sub, &fill, (TREE_Pixel){ '#', pixel.colorPair });
+	TREE_ImageView_DrawString(&sub, (TREE_Offset){ -2, 4 }, "a string through a view", pixel.colorPair);
+	TREE_ImageView_DrawImage(&sub, (TREE_Offset){ 1, 5 }, &other, (TREE_Offset){ 0, 0 }, otherExtent);
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		for (TREE_Int x = 0; x < extent.width; ++x)
+		{
+			TREE_Offset offset = { x, y };
+			TREE_Int viewX = x - area.offset.x;
+			TREE_Int viewY = y - area.offset.y;
+			TREE_Char character = '.';
+			if (viewX >= 0 && viewY >= 0 && viewX < area.extent.width && viewY < area.extent.height)
+			{
+				if (viewY == 4 && viewX + 2 < 23)
+				{
+					character = "a string through a view"[viewX + 2];
+				}
+				else if (viewY >= 5 && viewX >= 1)
+				{
+					character = other.text[(viewY - 5) * otherExtent.width + viewX - 1];
+				}
+				else if (viewY >= 1 && viewY < 4)
+				{
+					character = '#';
+				}
+			}
+			if (TREE_Image_Get(&image, offset).character != character)
+			{
+				printf("TREE_ImageView drew '%c' instead of '%c' at (%d, %d).\n", TREE_Image_Get(&image, offset).character, character, x, y);
+				return 1;
+			}
+		}
+	}
+
+	TREE_Image_Free(&image);
+	TREE_Image_Free(&expected);
+	TREE_Image_Free(&other);
+
+	return 0;
+}
+
+int Test_ImagePool()
+{
+	TREE_ImagePool pool;
+	TREE_Image image, other;
+	if (TREE_ImagePool_Init(&pool, 2) || TREE_Image_Init(&image, (TREE_Extent){ 4, 2 }) || TREE_Image_Init(&other, (TREE_Extent){ 20, 10 }))
+	{
+		printf("Failed to create test images.\n");
+		return 1;
+	}
+	TREE_Image_DrawString(&image, (TREE_Offset){ 0, 0 }, "kept", TREE_ColorPair_CreateDefault());
+
+	// a released Image goes to the next one that needs to grow, which keeps its pixels
+	TREE_Char* memory = other.text;
+	TREE_ImagePool_Release(&pool, &other);
+	if (other.text || other.capacity || pool.imagesSize != 1)
+	{
+		printf("TREE_ImagePool_Release did not take the memory of the Image.\n");
+		return 1;
+	}
+	if (TREE_ImagePool_Reserve(&pool, &image, (TREE_Extent){ 10, 10 }) || image.text != memory || memcmp(image.text, "kept", 4) != 0)
+	{
+		printf("TREE_ImagePool_Reserve did not reuse the released memory.\n");
+		return 1;
+	}
+	TREE_Image_Resize(&image, (TREE_Extent){ 10, 10 });
+	if (image.text != memory || pool.imagesSize != 1)
+	{
+		printf("TREE_Image_Resize allocated within the reserved capacity.\n");
+		return 1;
+	}
+
+	TREE_Image_Free(&image);
+	TREE_ImagePool_Free(&pool);
+
+	return 0;
+}
+
+static int g_labelDraws = 0;
+
+TREE_Result CountingLabel_EventHandler(TREE_Event const* event)
+{
+	if (event->type == TREE_EVENT_TYPE_DRAW)
+	{
+		g_labelDraws++;
+	}
+	return TREE_Control_Label_EventHandler(event);
+}
+
+// checks that the Dropdown is over at least one of the given Labels
+int Dropdown_CoversLabel(TREE_Control const* dropdown, TREE_Control const* labels, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		if (TREE_Rect_IsOverlapping(&dropdown->transform->globalRect, &labels[i].transform->globalRect))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// checks that the Surface is the same as when everything is drawn again
+int Surface_IsComposited(TREE_Application* application)
+{
+	TREE_Image expected;
+	if (TREE_Image_Init(&expected, application->surface->image.extent))
+	{
+		return 0;
+	}
+	TREE_Size size = (TREE_Size)(expected.extent.width * expected.extent.height);
+	memcpy(expected.text, application->surface->image.text, size * sizeof(TREE_Char));
+	memcpy(expected.colors, application->surface->image.colors, size * sizeof(TREE_ColorPair));
+	application->forceRedraw = TREE_TRUE;
+	TREE_Application_Step(application);
+	int equals = Image_Equals(&application->surface->image, &expected);
+	TREE_Image_Free(&expected);
+	return equals;
+}
+
+int Test_Layers()
+{
+	TREE_Theme theme;
+	TREE_Application application;
+	if (TREE_Theme_Init(&theme) || TREE_Application_InitHeadless(&application, 32, NULL, (TREE_Extent){ 80, 24 }))
+	{
+		printf("Failed to create layered application.\n");
+		return 1;
+	}
+
+	// a Dropdown that opens over a grid of Labels, which are above and below it
+	TREE_String options[] = { "Option 1", "Option 2", "Option 3", "Option 4", "Option 5", "Option 6", "Option 7", "Option 8" };
+	TREE_Control_DropdownData dropdownData;
+	TREE_Control dropdown;
+	if (TREE_Control_DropdownData_Init(&dropdownData, options, sizeof(options) / sizeof(options[0]), 0, NULL, &theme) ||
+		TREE_Control_Dropdown_Init(&dropdown, NULL, &dropdownData) ||
+		TREE_Application_AddControl(&application, &dropdown))
+	{
+		printf("Failed to create layered application controls.\n");
+		return 1;
+	}
+	dropdown.transform->localOffset = (TREE_Offset){ 2, 12 };
+	dropdown.transform->localExtent = (TREE_Extent){ 20, 1 };
+	TREE_Control_LabelData labelData;
+	TREE_Control labels[24];
+	TREE_Control_LabelData_Init(&labelData, "Label", &theme);
+	for (int i = 0; i < 24; ++i)
+	{
+		TREE_Control_Label_Init(&labels[i], NULL, &labelData);
+		labels[i].eventHandler = CountingLabel_EventHandler;
+		labels[i].transform->localOffset = (TREE_Offset){ (i % 4) * 20, (i < 12 ? 2 : 11) + i / 4 };
+		labels[i].transform->localExtent = (TREE_Extent){ 18, 1 };
+		TREE_Application_AddControl(&application, &labels[i]);
+	}
+	TREE_Application_Step(&application);
+	if (application.occupiedLayers != 1 << TREE_LAYER_BASE)
+	{
+		printf("Only the base Layer should be drawn.\n");
+		return 1;
+	}
+
+	// opening and closing it only draws the Dropdown, the Labels come from the cached base Layer
+	TREE_Key keys[] = { TREE_KEY_ENTER, TREE_KEY_DOWN_ARROW, TREE_KEY_ENTER };
+	for (int i = 0; i < 3; ++i)
+	{
+		g_labelDraws = 0;
+		TREE_InputDelta delta = { keys[i], TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0 };
+		TREE_Application_PushInput(&application, &delta);
+		delta.state = TREE_INPUT_STATE_RELEASED;
+		TREE_Application_PushInput(&application, &delta);
+		TREE_Application_Step(&application);
+		if (i == 0 && !Dropdown_CoversLabel(&dropdown, labels, 24))
+		{
+			printf("The opened Dropdown does not cover any Label.\n");
+			return 1;
+		}
+		if (g_labelDraws)
+		{
+			printf("The Dropdown drew %d Labels again.\n", g_labelDraws);
+			return 1;
+		}
+		if (!Surface_IsComposited(&application))
+		{
+			printf("The Layers were not composited correctly.\n");
+			return 1;
+		}
+	}
+
+	// once closed, only the base Layer is drawn again, and a toast skips the Layers between
+	TREE_Application_Step(&application);
+	if (application.occupiedLayers != 1 << TREE_LAYER_BASE)
+	{
+		printf("The closed Dropdown left its Layer drawn.\n");
+		return 1;
+	}
+	TREE_Control_SetLayer(&labels[0], TREE_LAYER_TOAST);
+	labels[0].transform->localOffset = (TREE_Offset){ 10, 12 };
+	labels[0].transform->dirty = TREE_TRUE;
+	TREE_Application_Step(&application);
+	if (application.occupiedLayers != ((1 << TREE_LAYER_BASE) | (1 << TREE_LAYER_TOAST)) || !Surface_IsComposited(&application))
+	{
+		printf("The toast Layer was not composited correctly.\n");
+		return 1;
+	}
+
+	TREE_Application_Free(&application);
+	for (int i = 0; i < 24; ++i)
+	{
+		TREE_Control_Free(&labels[i]);
+	}
+	TREE_Control_LabelData_Free(&labelData);
+	TREE_Control_Free(&dropdown);
+	TREE_Control_DropdownData_Free(&dropdownData);
+	TREE_Theme_Free(&theme);
+
+	return 0;
+}
+
+// makes an empty file outside of the working directory, writing its path into the given buffer of at least TEMP_PATH_SIZE
+#define TEMP_PATH_SIZE (L_tmpnam > 260 ? L_tmpnam : 260)
+int TempFile_Create(char* path)
+{
+#ifdef __linux__
+	char const* directory = getenv("TMPDIR");
+	snprintf(path, TEMP_PATH_SIZE, "%s/TREE_XXXXXX", directory && *directory ? directory : "/tmp");
+	int descriptor = mkstemp(path);
+	if (descriptor < 0)
+	{
+		return 1;
+	}
+	close(descriptor);
+	return 0;
+#else
+	return !tmpnam(path) || TREE_File_Write(path, "");
+#endif
+}
+
+int Benchmark_ImageFile_At(TREE_String path)
+{
+	TREE_Extent extent = { 400, 120 };
+	int loads = 1000;
+
+	// a pre-rendered screen
+	TREE_Image image;
+	if (TREE_Image_Init(&image, extent))
+	{
+		printf("Failed to create test image.\n");
+		return 1;
+	}
+	for (TREE_Int y = 0; y < extent.height; ++y)
+	{
+		for (TREE_Int x = 0; x < extent.width; x += 20)
+		{
+			TREE_Image_DrawString(&image, (TREE_Offset){ x + y % 7, y }, "/\\ splash |_|", (TREE_ColorPair)((x + y) % 256));
+		}
+	}
+	if (TREE_Image_Save(&image, path))
+	{
+		printf("TREE_Image_Save failed.\n");
+		return 1;
+	}
+
+	// loads the same as it was saved
+	TREE_ImageFile file;
+	if (TREE_ImageFile_Load(&file, path) || !Image_Equals(&file.image, &image) || file.image.text[extent.width * extent.height] != '\0')
+	{
+		printf("TREE_ImageFile_Load did not load the saved image.\n");
+		return 1;
+	}
+
+	// drawing onto it does not change the file
+	TREE_Image_Clear(&file.image, (TREE_Pixel){ '#', 0 });
+	TREE_ImageFile_Free(&file);
+	clock_t begin = clock();
+	for (int i = 0; i < loads; ++i)
+	{
+		if (TREE_ImageFile_Load(&file, path))
+		{
+			printf("TREE_ImageFile_Load failed.\n");
+			return 1;
+		}
+		if (i < loads - 1)
+		{
+			TREE_ImageFile_Free(&file);
+		}
+	}
+	double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+	if (!Image_Equals(&file.image, &image))
+	{
+		printf("Drawing onto a loaded image changed its file.\n");
+		return 1;
+	}
+	TREE_ImageFile_Free(&file);
+
+	// a header too big for the rest of the file is not loaded, even where its size would wrap around
+	unsigned char header[17] = { 0 };
+	FILE* headerFile = fopen(path, "rb");
+	if (!headerFile || fread(header, 1, 8, headerFile) != 8)
+	{
+		printf("Failed to read the image header.\n");
+		return 1;
+	}
+	fclose(headerFile);
+	header[10] = 1;
+	header[14] = 1;
+	headerFile = fopen(path, "wb");
+	fwrite(header, 1, sizeof(header), headerFile);
+	fclose(headerFile);
+	if (TREE_ImageFile_Load(&file, path) != TREE_ERROR_FILE_READ)
+	{
+		printf("TREE_ImageFile_Load loaded a 65536x65536 image from %d bytes.\n", (int)sizeof(header));
+		return 1;
+	}
+
+	// anything else is not loaded
+	TREE_File_Write(path, "not an image, only some text that is long enough for a header");
+	if (TREE_ImageFile_Load(&file, path) != TREE_ERROR_FILE_READ)
+	{
+		printf("TREE_ImageFile_Load loaded a file that is not an image.\n");
+		return 1;
+	}
+
+	printf("TREE_ImageFile_Load %dx%d: %.1f us\n", extent.width, extent.height, seconds * 1e6 / loads);
+
+	TREE_Image_Free(&image);
+
+	return 0;
+}
+
+int Benchmark_ImageFile()
+{
+	// the file is removed however the benchmark ends
+	char path[TEMP_PATH_SIZE];
+	if (TempFile_Create(path))
+	{
+		printf("Failed to create a temporary file.\n");
+		return 1;
+	}
+	int result = Benchmark_ImageFile_At(path);
+	TREE_File_Delete(path);
+	return result;
+}
+
+#ifdef __linux__
+// reads what is in the pipe without waiting, keeping up to the given size
+TREE_Size Pipe_Drain(int descriptor, char* buffer, TREE_Size size)
+{
+	char discard[4096];
+	TREE_Size total = 0;
+	ssize_t count;
+	while ((count = read(descriptor, discard, sizeof(discard))) > 0)
+	{
+		TREE_Size keep = (TREE_Size)count < size - total ? (TREE_Size)count : size - total;
+		if (buffer && keep)
+		{
+			memcpy(&buffer[total], discard, keep);
+			total += keep;
+		}
+	}
+	return total;
+}
+
+// puts the given text on the standard input, as if the terminal sent it all at once
+int Terminal_Write(TREE_String path, char const* text, TREE_Size size)
+{
+	FILE* file = fopen(path, "wb");
+	if (!file || fwrite(text, 1, size, file) != size || fclose(file))
+	{
+		return 1;
+	}
+	int descriptor = open(path, O_RDONLY);
+	if (descriptor < 0 || dup2(descriptor, STDIN_FILENO) < 0)
+	{
+		return 1;
+	}
+	close(descriptor);
+	return 0;
+}
+
+// makes the terminal backend read the given text from the standard input
+int Terminal_Send(TREE_Input* input, TREE_String path, char const* text, TREE_Size size)
+{
+	return Terminal_Write(path, text, size) || TREE_Input_Refresh(input) != TREE_OK;
+}
+
+// finds where the given key was pressed with at least the given modifiers in the last refresh, or -1
+int Input_FindPress(TREE_Input const* input, TREE_Key key, TREE_KeyModifierFlags modifiers)
+{
+	for (TREE_Size i = 0; i < input->deltaCount; ++i)
+	{
+		TREE_InputDelta const* delta = &input->deltas[i];
+		if (delta->key == key && delta->state == TREE_INPUT_STATE_PRESSED && (delta->modifiers & modifiers) == modifiers)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+int Test_TerminalKeys_At(TREE_String path)
+{
+	TREE_Input input;
+	if (TREE_Input_Init(&input))
+	{
+		printf("Failed to create terminal input.\n");
+		return 1;
+	}
+	input.timeout = 0;
+
+	// an escape with one character after it, and nothing left to read, is that character with alt held
+	if (Terminal_Send(&input, path, "\033[", 2) || Input_FindPress(&input, TREE_KEY_LEFT_BRACKET, TREE_KEY_MODIFIER_FLAGS_ALT) < 0)
+	{
+		printf("The terminal did not read \\033[ as alt and [.\n");
+		return 1;
+	}
+	if (Terminal_Send(&input, path, "\033O", 2) || Input_FindPress(&input, TREE_KEY_O, TREE_KEY_MODIFIER_FLAGS_ALT | TREE_KEY_MODIFIER_FLAGS_SHIFT) < 0)
+	{
+		printf("The terminal did not read \\033O as alt and O.\n");
+		return 1;
+	}
+
+	// a letter that does not end an SS3 sequence is a key of its own, after alt and O
+	if (Terminal_Send(&input, path, "\033Oz", 3) ||
+		Input_FindPress(&input, TREE_KEY_O, TREE_KEY_MODIFIER_FLAGS_ALT | TREE_KEY_MODIFIER_FLAGS_SHIFT) < 0 ||
+		Input_FindPress(&input, TREE_KEY_Z, TREE_KEY_MODIFIER_FLAGS_NONE) < Input_FindPress(&input, TREE_KEY_O, TREE_KEY_MODIFIER_FLAGS_NONE))
+	{
+		printf("The terminal did not read \\033Oz as alt and O, then z.\n");
+		return 1;
+	}
+	if (Terminal_Send(&input, path, "\033OA", 3) || Input_FindPress(&input, TREE_KEY_UP_ARROW, TREE_KEY_MODIFIER_FLAGS_NONE) < 0)
+	{
+		printf("The terminal did not read \\033OA as the up arrow.\n");
+		return 1;
+	}
+
+	TREE_Input_Free(&input);
+
+	return 0;
+}
+
+int Benchmark_TerminalPaste_At(TREE_String path)
+{
+	TREE_Size const pasteSize = 100 * 1024;
+
+	// a paste of many lines, as the terminal sends it
+	char* text = (char*)malloc(pasteSize + 12);
+	if (!text)
+	{
+		printf("Failed to create paste.\n");
+		return 1;
+	}
+	memcpy(text, "\033[200~", 6);
+	for (TREE_Size i = 0; i < pasteSize; ++i)
+	{
+		text[6 + i] = i % 80 == 79 ? '\r' : (char)('a' + i % 26);
+	}
+	memcpy(&text[6 + pasteSize], "\033[201~", 6);
+
+	// a text box being typed into
+	TREE_Theme theme;
+	TREE_Application application;
+	TREE_Control_TextInputData textInputData;
+	TREE_Control textInput;
+	TREE_Input input;
+	if (TREE_Theme_Init(&theme) || TREE_Application_InitHeadless(&application, 1, NULL, (TREE_Extent){ 80, 24 }) ||
+		TREE_Control_TextInputData_Init(&textInputData, "", pasteSize + 1, "", TREE_CONTROL_TEXT_INPUT_TYPE_NORMAL, NULL, NULL, &theme) ||
+		TREE_Control_TextInput_Init(&textInput, NULL, &textInputData) ||
+		TREE_Application_AddControl(&application, &textInput) ||
+		TREE_Input_Init(&input))
+	{
+		printf("Failed to create paste application.\n");
+		return 1;
+	}
+	input.timeout = 0;
+	TREE_InputDelta enter = { TREE_KEY_ENTER, TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0 };
+	TREE_Application_PushInput(&application, &enter);
+	enter.state = TREE_INPUT_STATE_RELEASED;
+	TREE_Application_PushInput(&application, &enter);
+	if (TREE_Application_Step(&application) || Terminal_Write(path, text, pasteSize + 12))
+	{
+		printf("Failed to start pasting.\n");
+		return 1;
+	}
+
+	// read it from the terminal, and paste it into the text box
+	clock_t begin = clock();
+	if (TREE_Input_Refresh(&input) || !input.pasteText)
+	{
+		printf("The terminal did not read the paste.\n");
+		return 1;
+	}
+	TREE_EventData_Paste pasteData = { input.pasteText, input.pasteSize };
+	TREE_Event event;
+	event.type = TREE_EVENT_TYPE_PASTE;
+	event.application = &application;
+	event.control = NULL;
+	event.data = &pasteData;
+	if (TREE_Application_DispatchEvent(&application, &event))
+	{
+		printf("Failed to paste.\n");
+		return 1;
+	}
+	double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	// every character is pasted, with the line breaks as spaces
+	if (strlen(textInputData.text) != pasteSize || textInputData.text[79] != ' ')
+	{
+		printf("Pasted %llu of %llu characters.\n", (unsigned long long)strlen(textInputData.text), (unsigned long long)pasteSize);
+		return 1;
+	}
+	printf("Terminal paste %llu KB: %.2f ms\n", (unsigned long long)(pasteSize / 1024), seconds * 1e3);
+
+	TREE_Input_Free(&input);
+	TREE_Application_Free(&application);
+	TREE_Control_Free(&textInput);
+	TREE_Control_TextInputData_Free(&textInputData);
+	TREE_Theme_Free(&theme);
+	free(text);
+
+	return 0;
+}
+
+// runs the given test with the terminal backend reading from a file standing in for the terminal
+int Terminal_Run(int (*test)(TREE_String path))
+{
+	char path[TEMP_PATH_SIZE];
+	int standardInput = dup(STDIN_FILENO);
+	if (standardInput < 0 || TempFile_Create(path) || TREE_Input_SetBackend(TREE_INPUT_BACKEND_TERMINAL))
+	{
+		printf("Failed to set up the terminal input.\n");
+		return 1;
+	}
+	int result = test(path);
+	TREE_Input_SetBackend(TREE_INPUT_BACKEND_AUTOMATIC);
+	dup2(standardInput, STDIN_FILENO);
+	close(standardInput);
+	TREE_File_Delete(path);
+	return result;
+}
+
+int Test_TerminalKeys()
+{
+	if (TREE_Input_SetBackend((TREE_InputBackend)7) != TREE_ERROR_ARG_OUT_OF_RANGE)
+	{
+		printf("TREE_Input_SetBackend took a backend that does not exist.\n");
+		return 1;
+	}
+	return Terminal_Run(Test_TerminalKeys_At);
+}
+
+int Benchmark_TerminalPaste()
+{
+	return Terminal_Run(Benchmark_TerminalPaste_At);
+}
+
+int Test_DroppedFrame()
+{
+	TREE_Surface surface;
+	if (TREE_Surface_Init(&surface, (TREE_Extent){ 40, 4 }))
+	{
+		printf("Failed to create test surface.\n");
+		return 1;
+	}
+
+	// a terminal that is busy: a full pipe
+	int pipes[2];
+	fflush(stdout);
+	int output = dup(STDOUT_FILENO);
+	if (output < 0 || pipe(pipes) < 0 || dup2(pipes[1], STDOUT_FILENO) < 0)
+	{
+		printf("Failed to redirect the output.\n");
+		return 1;
+	}
+	fcntl(pipes[0], F_SETFL, O_NONBLOCK);
+	TREE_Window_SetNonBlocking(TREE_TRUE);
+	char fill[4096];
+	memset(fill, '-', sizeof(fill));
+	while (write(STDOUT_FILENO, fill, sizeof(fill)) > 0);
+
+	// the first frame cannot be written, and the second is dropped while it is being written
+	TREE_Rect rect = { { 0, 1 }, { 40, 1 } };
+	TREE_ColorPair color = TREE_ColorPair_CreateDefault();
+	TREE_Image_DrawString(&surface.image, rect.offset, "first frame", color);
+	TREE_Surface_Damage(&surface, &rect);
+	TREE_Surface_Refresh(&surface);
+	TREE_Window_Present(&surface);
+	TREE_Bool partial = TREE_Window_IsPresenting(&surface);
+	TREE_Image_DrawString(&surface.image, rect.offset, "second frame", color);
+	TREE_Surface_Damage(&surface, &rect);
+	TREE_Surface_Refresh(&surface);
+
+	// once the terminal catches up, only the first frame is left to write
+	static char written[65536];
+	TREE_Size writtenSize = 0;
+	Pipe_Drain(pipes[0], NULL, 0);
+	for (int i = 0; i < 100 && TREE_Window_IsPresenting(&surface); ++i)
+	{
+		TREE_Window_Present(&surface);
+		writtenSize += Pipe_Drain(pipes[0], &written[writtenSize], sizeof(written) - 1 - writtenSize);
+	}
+	written[writtenSize] = '\0';
+
+	// put the output back
+	TREE_Window_SetNonBlocking(TREE_FALSE);
+	dup2(output, STDOUT_FILENO);
+	close(output);
+	close(pipes[0]);
+	close(pipes[1]);
+
+	if (!partial || surface.droppedFrames != 1)
+	{
+		printf("The frame was not dropped during a partial write.\n");
+		return 1;
+	}
+	if (TREE_Window_IsPresenting(&surface) || !strstr(written, "second frame") || !Image_Equals(&surface.front, &surface.image))
+	{
+		printf("The dropped frame was not written once the terminal caught up.\n");
+		return 1;
+	}
+
+	TREE_Surface_Free(&surface);
+
+	return 0;
+}
+#endif
+
+int Benchmark_HeadlessApplication()
+{
+	TREE_Extent extent = { 200, 60 };
+	int frames = 2000;
+
+	// an Application that only draws into memory
+	TREE_Theme theme;
+	TREE_Application application;
+	if (TREE_Theme_Init(&theme) || TREE_Application_InitHeadless(&application, 4, NULL, extent))
+	{
+		printf("Failed to create headless application.\n");
+		return 1;
+	}
+	TREE_Application_SetFrameRate(&application, 0);
+
+	// a text box to type into, next to a list that stays the same
+	TREE_String options[] = { "Option 1", "Option 2", "Option 3", "Option 4", "Option 5", "Option 6", "Option 7", "Option 8" };
+	TREE_Control_TextInputData textInputData;
+	TREE_Control_ListData listData;
+	TREE_Control textInput, list;
+	if (TREE_Control_TextInputData_Init(&textInputData, "", (TREE_Size)frames + 1, "Type here", TREE_CONTROL_TEXT_INPUT_TYPE_NORMAL, NULL, NULL, &theme) ||
+		TREE_Control_TextInput_Init(&textInput, NULL, &textInputData) ||
+		TREE_Control_ListData_Init(&listData, TREE_CONTROL_LIST_FLAGS_NONE, options, sizeof(options) / sizeof(options[0]), NULL, NULL, &theme) ||
+		TREE_Control_List_Init(&list, NULL, &listData) ||
+		TREE_Application_AddControl(&application, &textInput) ||
+		TREE_Application_AddControl(&application, &list))
+	{
+		printf("Failed to create headless application controls.\n");
+		return 1;
+	}
+	textInput.transform->localExtent.width = 100;
+	list.transform->localOffset.x = 110;
+
+	// start typing, as enter does
+	TREE_InputDelta enter = { TREE_KEY_ENTER, TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0 };
+	TREE_Application_PushInput(&application, &enter);
+	enter.state = TREE_INPUT_STATE_RELEASED;
+	TREE_Application_PushInput(&application, &enter);
+	if (TREE_Application_Step(&application))
+	{
+		printf("TREE_Application_Step failed.\n");
+		return 1;
+	}
+
+	// type one letter per frame
+	clock_t begin = clock();
+	for (int i = 0; i < frames; ++i)
+	{
+		TREE_InputDelta delta = { (TREE_Key)(TREE_KEY_A + i % 26), TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0 };
+		TREE_Application_PushInput(&application, &delta);
+		delta.state = TREE_INPUT_STATE_RELEASED;
+		TREE_Application_PushInput(&application, &delta);
+		if (TREE_Application_Step(&application))
+		{
+			printf("TREE_Application_Step failed.\n");
+			return 1;
+		}
+	}
+	double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+
+	// every letter must have been typed
+	if (strlen(textInputData.text) != (size_t)frames)
+	{
+		printf("Headless application typed %llu of %d letters.\n", (unsigned long long)strlen(textInputData.text), frames);
+		return 1;
+	}
+
+	// every typed letter must be measured, the latency itself depends on the machine, so it is only reported
+	TREE_Microseconds p50 = TREE_Application_GetInputLatency(&application, 50.0);
+	TREE_Microseconds p99 = TREE_Application_GetInputLatency(&application, 99.0);
+	printf("Headless application %dx%d: %.0f frames/s (input latency p50: %lld us, p99: %lld us)\n",
+		extent.width, extent.height,
+		frames / (seconds > 0.0 ? seconds : 1e-9),
+		p50, p99);
+	if (application.inputLatencyCount < (TREE_Size)frames || p50 < 0)
+	{
+		printf("Headless application measured the input latency of %llu of %d frames.\n", (unsigned long long)application.inputLatencyCount, frames);
+		return 1;
+	}
+
+	// a key change is measured from when it happened, not from when the Application took it
+	TREE_InputDelta late = { TREE_KEY_A, TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0, TREE_Time_NowMicroseconds() - 20000 };
+	TREE_Application_PushInput(&application, &late);
+	if (TREE_Application_Step(&application) || TREE_Application_GetInputLatency(&application, 100.0) < 20000)
+	{
+		printf("Headless application did not measure the input latency from the source time.\n");
+		return 1;
+	}
+
+	TREE_Application_Free(&application);
+	TREE_Control_Free(&textInput);
+	TREE_Control_Free(&list);
+	TREE_Control_TextInputData_Free(&textInputData);
+	TREE_Control_ListData_Free(&listData);
+	TREE_Theme_Free(&theme);
+
+	return 0;
+}
+
+// an input event an Application dispatched
+typedef struct InputLogEntry
+{
+	TREE_EventType type;
+	TREE_Key key;
+	TREE_KeyModifierFlags modifiers;
+	TREE_Time time;
+	char text[16];
+} InputLogEntry;
+
+#define INPUT_LOG_CAPACITY 16
+
+// the input events of the last two Applications, one log each
+static InputLogEntry g_inputLogs[2][INPUT_LOG_CAPACITY];
+static int g_inputLogSizes[2] = { 0, 0 };
+static int g_inputLog = 0;
+
+TREE_Result InputLog_EventHandler(TREE_Event const* event)
+{
+	if ((event->type != TREE_EVENT_TYPE_KEY_DOWN && event->type != TREE_EVENT_TYPE_KEY_UP && event->type != TREE_EVENT_TYPE_PASTE) ||
+		g_inputLogSizes[g_inputLog] >= INPUT_LOG_CAPACITY)
+	{
+		return TREE_OK;
+	}
+	InputLogEntry* entry = &g_inputLogs[g_inputLog][g_inputLogSizes[g_inputLog]++];
+	memset(entry, 0, sizeof(InputLogEntry));
+	entry->type = event->type;
+	if (event->type == TREE_EVENT_TYPE_PASTE)
+	{
+		TREE_EventData_Paste const* pasteData = (TREE_EventData_Paste const*)event->data;
+		snprintf(entry->text, sizeof(entry->text), "%s", pasteData->text);
+	}
+	else
+	{
+		TREE_EventData_Key const* keyData = (TREE_EventData_Key const*)event->data;
+		entry->key = keyData->key;
+		entry->modifiers = keyData->modifiers;
+		entry->time = keyData->time;
+	}
+	return TREE_OK;
+}
+
+// pushes a key being typed at the given time, or now if 0
+void Application_PushKey(TREE_Application* application, TREE_Key key, TREE_KeyModifierFlags modifiers, TREE_Time time)
+{
+	TREE_InputDelta delta = { key, TREE_INPUT_STATE_PRESSED, modifiers, time };
+	TREE_Application_PushInput(application, &delta);
+	delta.state = TREE_INPUT_STATE_RELEASED;
+	TREE_Application_PushInput(application, &delta);
+}
+
+int Test_InputRecording_At(TREE_String path)
+{
+	// record some keys and a paste, as they are dispatched
+	TREE_Extent extent = { 40, 5 };
+	TREE_Application recorded;
+	g_inputLog = 0;
+	g_inputLogSizes[0] = 0;
+	if (TREE_Application_InitHeadless(&recorded, 1, InputLog_EventHandler, extent) ||
+		TREE_Application_StartRecording(&recorded, path))
+	{
+		printf("Failed to start recording.\n");
+		return 1;
+	}
+	TREE_Time now = TREE_Time_Now();
+	Application_PushKey(&recorded, TREE_KEY_H, TREE_KEY_MODIFIER_FLAGS_SHIFT, now);
+	TREE_Application_PushPaste(&recorded, "pasted");
+	Application_PushKey(&recorded, TREE_KEY_ENTER, TREE_KEY_MODIFIER_FLAGS_NONE, now + 20);
+	if (TREE_Application_Step(&recorded) || TREE_Application_StopRecording(&recorded))
+	{
+		printf("Failed to record.\n");
+		return 1;
+	}
+	TREE_Application_Free(&recorded);
+
+	// replay them, in real time, until the replay is over
+	TREE_Application replayed;
+	g_inputLog = 1;
+	g_inputLogSizes[1] = 0;
+	if (TREE_Application_InitHeadless(&replayed, 1, InputLog_EventHandler, extent) ||
+		TREE_Application_StartReplay(&replayed, path, TREE_REPLAY_FLAGS_NONE))
+	{
+		printf("Failed to start replaying.\n");
+		return 1;
+	}
+	clock_t begin = clock();
+	while (replayed.replay && (double)(clock() - begin) / CLOCKS_PER_SEC < 5.0)
+	{
+		if (TREE_Application_Step(&replayed))
+		{
+			printf("Failed to replay.\n");
+			return 1;
+		}
+	}
+	TREE_Application_Free(&replayed);
+
+	// the same events, the same time apart
+	if (g_inputLogSizes[0] != 5 || g_inputLogSizes[1] != g_inputLogSizes[0] || g_inputLogs[0][4].time - g_inputLogs[0][0].time != 20)
+	{
+		printf("Replayed %d of %d input events.\n", g_inputLogSizes[1], g_inputLogSizes[0]);
+		return 1;
+	}
+	for (int i = 0; i < g_inputLogSizes[0]; ++i)
+	{
+		InputLogEntry const* expected = &g_inputLogs[0][i];
+		InputLogEntry const* actual = &g_inputLogs[1][i];
+		if (expected->type != actual->type || expected->key != actual->key || expected->modifiers != actual->modifiers ||
+			strcmp(expected->text, actual->text) != 0 ||
+			(expected->time && expected->time - g_inputLogs[0][0].time != actual->time - g_inputLogs[1][0].time))
+		{
+			printf("Replayed input event %d differs from the recorded one.\n", i);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+int Test_InputRecording()
+{
+	char path[TEMP_PATH_SIZE];
+	if (TempFile_Create(path))
+	{
+		printf("Failed to create a temporary file.\n");
+		return 1;
+	}
+	int result = Test_InputRecording_At(path);
+	TREE_File_Delete(path);
+	return result;
+}
+
+int Test_PasteOrder_At(TREE_String path)
+{
+	// two pastes with a key typed between them, all before the next frame
+	TREE_Application recorded;
+	if (TREE_Application_InitHeadless(&recorded, 1, NULL, (TREE_Extent){ 40, 5 }) ||
+		TREE_Application_StartRecording(&recorded, path))
+	{
+		printf("Failed to start recording.\n");
+		return 1;
+	}
+	TREE_Application_PushPaste(&recorded, "ab");
+	Application_PushKey(&recorded, TREE_KEY_X, TREE_KEY_MODIFIER_FLAGS_NONE, 0);
+	TREE_Application_PushPaste(&recorded, "cd");
+	if (TREE_Application_StopRecording(&recorded))
+	{
+		printf("Failed to record.\n");
+		return 1;
+	}
+	TREE_Application_Free(&recorded);
+
+	TREE_Extent extent = { 40, 5 };
+	TREE_Theme theme;
+	TREE_Application application;
+	TREE_Control_TextInputData textInputData;
+	TREE_Control textInput;
+	if (TREE_Theme_Init(&theme) || TREE_Application_InitHeadless(&application, 1, NULL, extent) ||
+		TREE_Control_TextInputData_Init(&textInputData, "", 16, "", TREE_CONTROL_TEXT_INPUT_TYPE_NORMAL, NULL, NULL, &theme) ||
+		TREE_Control_TextInput_Init(&textInput, NULL, &textInputData) ||
+		TREE_Application_AddControl(&application, &textInput))
+	{
+		printf("Failed to create paste order application.\n");
+		return 1;
+	}
+
+	// start typing, then play the recording
+	TREE_InputDelta enter = { TREE_KEY_ENTER, TREE_INPUT_STATE_PRESSED, TREE_KEY_MODIFIER_FLAGS_NONE, 0 };
+	TREE_Application_PushInput(&application, &enter);
+	enter.state = TREE_INPUT_STATE_RELEASED;
+	TREE_Application_PushInput(&application, &enter);
+	if (TREE_Application_Step(&application) ||
+		TREE_Application_StartReplay(&application, path, TREE_REPLAY_FLAGS_MAXIMUM_SPEED) ||
+		TREE_Application_Step(&application))
+	{
+		printf("Failed to replay the pastes.\n");
+		return 1;
+	}
+
+	// each paste goes where it was made
+	if (strcmp(textInputData.text, "abxcd") != 0)
+	{
+		printf("Pastes and keys were typed out of order: \"%s\".\n", textInputData.text);
+		return 1;
+	}
+
+	TREE_Application_Free(&application);
+	TREE_Control_Free(&textInput);
+	TREE_Control_TextInputData_Free(&textInputData);
+	TREE_Theme_Free(&theme);
+
+	return 0;
+}
+
+int Test_PasteOrder()
+{
+	char path[TEMP_PATH_SIZE];
+	if (TempFile_Create(path))
+	{
+		printf("Failed to create a temporary file.\n");
+		return 1;
+	}
+	int result = Test_PasteOrder_At(path);
+	TREE_File_Delete(path);
+	return result;
+}
+
 int main()
 {
+	if (Benchmark_FindDifference())
+	{
+		return 1;
+	}
+	if (Benchmark_Fill())
+	{
+		return 1;
+	}
+	if (Test_ImageView())
+	{
+		return 1;
+	}
+	if (Test_ImagePool())
+	{
+		return 1;
+	}
+	if (Test_Layers())
+	{
+		return 1;
+	}
+	if (Benchmark_ImageFile())
+	{
+		return 1;
+	}
+	if (Test_InputRecording())
+	{
+		return 1;
+	}
+	if (Test_PasteOrder())
+	{
+		return 1;
+	}
+#ifdef __linux__
+	if (Test_TerminalKeys())
+	{
+		return 1;
+	}
+	if (Benchmark_TerminalPaste())
+	{
+		return 1;
+	}
+	if (Test_DroppedFrame())
+	{
+		return 1;
+	}
+#endif
+	if (Benchmark_HeadlessApplication())
+	{
+		return 1;
+	}
+
 	printf("Application ran successfully!\n");
 
 	return 0;